@@ -75,9 +75,11 @@ void MqttLogger::sendBuffer()
     {
         bool doSerial = this->mode==MqttLoggerMode::SerialOnly || this->mode==MqttLoggerMode::MqttAndSerial || this->mode==MqttLoggerMode::MqttAndSerialAndWeb || this->mode==MqttLoggerMode::SerialAndWeb;
         bool doWebSerial = this->mode==MqttLoggerMode::MqttAndSerialAndWeb || this->mode==MqttLoggerMode::SerialAndWeb;
-        if (this->mode!=MqttLoggerMode::SerialOnly && this->mode!=MqttLoggerMode::SerialAndWeb && this->client != NULL && this->client->connected()) 
+        // log lines are shed while the outbox is congested, they fall back to serial like when disconnected
+        if (this->mode!=MqttLoggerMode::SerialOnly && this->mode!=MqttLoggerMode::SerialAndWeb && this->client != NULL && this->client->connected() &&
+            !this->client->congested(espMqttClientTypes::Priority::BACKGROUND))
         {
-            this->client->publish(topic, 0, true, this->buffer, this->bufferCnt);
+            this->client->publish(topic, 0, true, this->buffer, this->bufferCnt, espMqttClientTypes::Priority::BACKGROUND);
         }
         else if (this->mode == MqttLoggerMode::MqttAndSerialFallback)
         {
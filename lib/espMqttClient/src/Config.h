@@ -16,6 +16,10 @@ the LICENSE file.
 #define EMC_RX_BUFFER_SIZE 1440
 #endif
 
+#ifndef EMC_RX_MAX_READS
+#define EMC_RX_MAX_READS 4
+#endif
+
 #ifndef EMC_TX_BUFFER_SIZE
 #define EMC_TX_BUFFER_SIZE 1440
 #endif
@@ -28,10 +32,17 @@ the LICENSE file.
 #define EMC_PAYLOAD_BUFFER_SIZE 32
 #endif
 
+// the SUBACK return codes, one per topic, have to fit in the payload buffer
+#define EMC_MAX_SUBSCRIBE_TOPICS (EMC_PAYLOAD_BUFFER_SIZE - 1)
+
 #ifndef EMC_MIN_FREE_MEMORY
 #define EMC_MIN_FREE_MEMORY 16384
 #endif
 
+#ifndef EMC_OUTBOX_BUDGET
+#define EMC_OUTBOX_BUDGET 0
+#endif
+
 #ifndef EMC_ESP8266_MULTITHREADING
 #define EMC_ESP8266_MULTITHREADING 0
 #endif
@@ -65,6 +76,38 @@ the LICENSE file.
 #define EMC_USE_MEMPOOL 0
 #endif
 
+#ifndef EMC_USE_SLAB_POOLS
+#define EMC_USE_SLAB_POOLS 0
+#endif
+
+#if EMC_USE_MEMPOOL && EMC_USE_SLAB_POOLS
+  #error "EMC_USE_MEMPOOL and EMC_USE_SLAB_POOLS are mutually exclusive"
+#endif
+
+#if EMC_USE_SLAB_POOLS
+  #ifndef EMC_SLAB_SMALL_SIZE
+    #define EMC_SLAB_SMALL_SIZE 16
+  #endif
+  #ifndef EMC_SLAB_SMALL_COUNT
+    #define EMC_SLAB_SMALL_COUNT 32
+  #endif
+  #ifndef EMC_SLAB_MEDIUM_SIZE
+    #define EMC_SLAB_MEDIUM_SIZE 128
+  #endif
+  #ifndef EMC_SLAB_MEDIUM_COUNT
+    #define EMC_SLAB_MEDIUM_COUNT 32
+  #endif
+  #ifndef EMC_SLAB_LARGE_SIZE
+    #define EMC_SLAB_LARGE_SIZE 1024
+  #endif
+  #ifndef EMC_SLAB_LARGE_COUNT
+    #define EMC_SLAB_LARGE_COUNT 8
+  #endif
+  #ifndef EMC_SLAB_NODE_COUNT
+    #define EMC_SLAB_NODE_COUNT 64
+  #endif
+#endif
+
 #if EMC_USE_MEMPOOL
   #ifndef EMC_NUM_POOL_ELEMENTS
     #define EMC_NUM_POOL_ELEMENTS 32
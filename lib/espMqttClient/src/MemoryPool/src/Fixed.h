@@ -62,6 +62,10 @@ class Fixed {
     _head = reinterpret_cast<unsigned char*>(ptr);
   }
 
+  bool contains(const void* ptr) const {
+    return ptr >= static_cast<const void*>(_buffer) && ptr < static_cast<const void*>(_buffer + sizeof(_buffer));
+  }
+
   std::size_t freeMemory() {
     #if _GLIBCXX_HAS_GTHREADS
     const std::lock_guard<std::mutex> lockGuard(_mutex);
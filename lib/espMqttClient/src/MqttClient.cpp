@@ -38,6 +38,7 @@ MqttClient::MqttClient(espMqttClientTypes::UseInternalTask useInternalTask, uint
 , _willQos(0)
 , _willRetain(false)
 , _timeout(EMC_TX_TIMEOUT)
+, _outboxBudget(EMC_OUTBOX_BUDGET)
 , _state(State::disconnected)
 , _generatedClientId{0}
 , _packetId(0)
@@ -47,7 +48,13 @@ MqttClient::MqttClient(espMqttClientTypes::UseInternalTask useInternalTask, uint
 #endif
 , _rxBuffer{0}
 , _outbox()
+, _outboxBytes(0)
 , _bytesSent(0)
+, _txBuffer(nullptr)
+, _txBufferSize(0)
+, _txLength(0)
+, _txDeadline(0)
+, _txBufferedSince(0)
 , _parser()
 , _lastClientActivity(0)
 , _lastServerActivity(0)
@@ -75,6 +82,7 @@ MqttClient::MqttClient(espMqttClientTypes::UseInternalTask useInternalTask, uint
 MqttClient::~MqttClient() {
   disconnect(true);
   _clearQueue(2);
+  delete[] _txBuffer;
 #if defined(ARDUINO_ARCH_ESP32)
   vSemaphoreDelete(_xSemaphore);
   if (_useInternalTask == espMqttClientTypes::UseInternalTask::YES) {
@@ -140,7 +148,7 @@ bool MqttClient::disconnect(bool force) {
   return false;
 }
 
-uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length) {
+uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length, espMqttClientTypes::Priority priority, bool coalesce) {
   #if !EMC_ALLOW_NOT_CONNECTED_PUBLISH
   if (_state != State::connected) {
   #else
@@ -149,24 +157,41 @@ uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, const
     return 0;
   }
   EMC_SEMAPHORE_TAKE();
+  uint16_t supersededId = 0;
+  if (coalesce && retain && _supersedePublish(topic, qos, retain, [payload](uint8_t* data, size_t len) {
+        memcpy(data, payload, len);
+        return len;
+      }, length, &supersededId)) {
+    EMC_SEMAPHORE_GIVE();
+    return supersededId;
+  }
+  if (!_admitPublish(topic, qos, length, priority)) {
+    emc_log_w("Outbox budget exceeded, PUBLISH rejected");
+    EMC_SEMAPHORE_GIVE();
+    _onError(0, Error::OUTBOX_FULL);
+    return 0;
+  }
   uint16_t packetId = (qos > 0) ? _getNextPacketId() : 1;
-  if (!_addPacket(packetId, topic, payload, length, qos, retain)) {
+  Outbox::Iterator it = _addPacket(packetId, topic, payload, length, qos, retain);
+  if (!it) {
     emc_log_e("Could not create PUBLISH packet");
     EMC_SEMAPHORE_GIVE();
     _onError(packetId, Error::OUT_OF_MEMORY);
     EMC_SEMAPHORE_TAKE();
     packetId = 0;
+  } else if (coalesce && retain) {
+    _outbox.tag(it, _topicTag(topic));
   }
   EMC_SEMAPHORE_GIVE();
   return packetId;
 }
 
-uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, const char* payload) {
+uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, const char* payload, espMqttClientTypes::Priority priority, bool coalesce) {
   size_t len = strlen(payload);
-  return publish(topic, qos, retain, reinterpret_cast<const uint8_t*>(payload), len);
+  return publish(topic, qos, retain, reinterpret_cast<const uint8_t*>(payload), len, priority, coalesce);
 }
 
-uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadCallback callback, size_t length) {
+uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadCallback callback, size_t length, espMqttClientTypes::Priority priority) {
   #if !EMC_ALLOW_NOT_CONNECTED_PUBLISH
   if (_state != State::connected) {
   #else
@@ -175,6 +200,12 @@ uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqt
     return 0;
   }
   EMC_SEMAPHORE_TAKE();
+  if (!_admitPublish(topic, qos, length, priority)) {
+    emc_log_w("Outbox budget exceeded, PUBLISH rejected");
+    EMC_SEMAPHORE_GIVE();
+    _onError(0, Error::OUTBOX_FULL);
+    return 0;
+  }
   uint16_t packetId = (qos > 0) ? _getNextPacketId() : 1;
   if (!_addPacket(packetId, topic, callback, length, qos, retain)) {
     emc_log_e("Could not create PUBLISH packet");
@@ -187,6 +218,85 @@ uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqt
   return packetId;
 }
 
+uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadWriter writer, size_t length, espMqttClientTypes::Priority priority, bool coalesce) {
+  #if !EMC_ALLOW_NOT_CONNECTED_PUBLISH
+  if (_state != State::connected) {
+  #else
+  if (_state > State::connected) {
+  #endif
+    return 0;
+  }
+  EMC_SEMAPHORE_TAKE();
+  uint16_t supersededId = 0;
+  if (coalesce && retain && _supersedePublish(topic, qos, retain, writer, length, &supersededId)) {
+    EMC_SEMAPHORE_GIVE();
+    return supersededId;
+  }
+  if (!_admitPublish(topic, qos, length, priority)) {
+    emc_log_w("Outbox budget exceeded, PUBLISH rejected");
+    EMC_SEMAPHORE_GIVE();
+    _onError(0, Error::OUTBOX_FULL);
+    return 0;
+  }
+  uint16_t packetId = (qos > 0) ? _getNextPacketId() : 1;
+  Outbox::Iterator it = _addPacket(packetId, topic, writer, length, qos, retain);
+  if (!it) {
+    emc_log_e("Could not create PUBLISH packet");
+    EMC_SEMAPHORE_GIVE();
+    _onError(packetId, Error::OUT_OF_MEMORY);
+    EMC_SEMAPHORE_TAKE();
+    packetId = 0;
+  } else if (coalesce && retain) {
+    _outbox.tag(it, _topicTag(topic));
+  }
+  EMC_SEMAPHORE_GIVE();
+  return packetId;
+}
+
+bool MqttClient::congested(espMqttClientTypes::Priority priority) const {
+  return _outboxBudget > 0 && _outboxBytes >= _outboxLimit(priority);
+}
+
+uint16_t MqttClient::subscribe(const espMqttClientTypes::Subscription* subscriptions, size_t count) {
+  uint16_t packetId = 0;
+  if (_state != State::connected) {
+    return packetId;
+  } else if (count == 0 || count > EMC_MAX_SUBSCRIBE_TOPICS) {
+    emc_log_e("Invalid number of topics to subscribe: %zu", count);
+    return packetId;
+  } else {
+    EMC_SEMAPHORE_TAKE();
+    packetId = _getNextPacketId();
+    if (!_addPacket(packetId, subscriptions, count)) {
+      emc_log_e("Could not create SUBSCRIBE packet");
+      packetId = 0;
+    }
+    EMC_SEMAPHORE_GIVE();
+  }
+  return packetId;
+}
+
+size_t MqttClient::outboxBytes() const {
+  return _outboxBytes;
+}
+
+void MqttClient::_setTxCoalescing(size_t size, uint32_t deadline) {
+  EMC_SEMAPHORE_TAKE();
+  delete[] _txBuffer;
+  _txBuffer = size > 0 ? new (std::nothrow) uint8_t[size] : nullptr;
+  _txBufferSize = _txBuffer ? size : 0;
+  _txLength = 0;
+  _txDeadline = deadline;
+  EMC_SEMAPHORE_GIVE();
+}
+
+size_t MqttClient::poolStats(espMqttClientTypes::PoolStats* stats, size_t count) const {
+  // packet buffer size classes followed by the outbox nodes
+  size_t n = espMqttClientInternals::Packet::poolStats(stats, count);
+  if (n > 0 && n < count && _outbox.poolStats(&stats[n])) ++n;
+  return n;
+}
+
 void MqttClient::clearQueue(bool deleteSessionData) {
   EMC_SEMAPHORE_TAKE();
   _clearQueue(deleteSessionData ? 2 : 0);
@@ -227,6 +337,7 @@ void MqttClient::loop() {
     case State::connectingTcp2:
       if (_transport->connected()) {
         _parser.reset();
+        _txLength = 0;
         _lastClientActivity = _lastServerActivity = millis();
         _setState(State::connectingMqtt);
       }  else if (_transport->disconnected()) {  // sync: implemented as "not connected"; async: depending on state of pcb in underlying lib
@@ -297,6 +408,7 @@ void MqttClient::loop() {
         _clearQueue(0);
         EMC_SEMAPHORE_GIVE();
         _bytesSent = 0;
+        _txLength = 0;
         _setState(State::disconnected);
         if (_onDisconnectCallback) {
           _onDisconnectCallback(_disconnectReason);
@@ -343,6 +455,10 @@ uint16_t MqttClient::_getNextPacketId() {
 }
 
 void MqttClient::_checkOutbox() {
+  if (_txBuffer) {
+    _coalesceOutbox();
+    return;
+  }
   while (_sendPacket() > 0) {
     if (!_advanceOutbox()) {
       break;
@@ -350,6 +466,49 @@ void MqttClient::_checkOutbox() {
   }
 }
 
+void MqttClient::_coalesceOutbox() {
+  OutgoingPacket* packet = _outbox.getCurrent();
+  while (packet) {
+    size_t length = packet->packet.size();
+    if (_bytesSent > 0 ||
+        packet->packet.chunked() ||
+        length > _txBufferSize ||
+        packet->packet.packetType() == PacketType.DISCONNECT) {
+      // write directly, after everything that was buffered before
+      if (!_flushTx() || _sendPacket() == 0) return;
+    } else if (_txLength + length > _txBufferSize) {
+      if (!_flushTx()) return;
+      continue;
+    } else {
+      if (_txLength == 0) _txBufferedSince = millis();
+      memcpy(&_txBuffer[_txLength], packet->packet.data(0), length);
+      _txLength += length;
+      packet->timeSent = millis();
+      _bytesSent = length;
+      emc_log_i("tx buffered %zu/%zu (%02x)", length, _txLength, packet->packet.packetType());
+    }
+    if (!_advanceOutbox()) break;
+    packet = _outbox.getCurrent();
+  }
+  // nothing left to add: write when the oldest buffered byte reaches the deadline
+  if (_txLength > 0 && millis() - _txBufferedSince >= _txDeadline) {
+    _flushTx();
+  }
+}
+
+bool MqttClient::_flushTx() {
+  if (_txLength == 0) return true;
+  size_t written = _transport->write(_txBuffer, _txLength);
+  if (written > _txLength) written = 0;  // write error
+  if (written > 0) {
+    _lastClientActivity = millis();
+    _txLength -= written;
+    memmove(_txBuffer, &_txBuffer[written], _txLength);
+  }
+  emc_log_i("tx flushed %zu (%zu left)", written, _txLength);
+  return _txLength == 0;
+}
+
 int MqttClient::_sendPacket() {
   OutgoingPacket* packet = _outbox.getCurrent();
 
@@ -376,7 +535,7 @@ bool MqttClient::_advanceOutbox() {
       _disconnectReason = DisconnectReason::USER_OK;
     }
     if (packet->packet.removable()) {
-      _outbox.removeCurrent();
+      _removeCurrentPacket();
     } else {
       // we already set 'dup' here, in case we have to retry
       if ((packet->packet.packetType()) == PacketType.PUBLISH) packet->packet.setDup();
@@ -389,8 +548,11 @@ bool MqttClient::_advanceOutbox() {
 }
 
 void MqttClient::_checkIncoming() {
-  int32_t remainingBufferLength = _transport->read(_rxBuffer, EMC_RX_BUFFER_SIZE);
-  if (remainingBufferLength > 0) {
+  // keep reading while the transport fills the buffer, bounded to not starve outgoing packets
+  for (size_t reads = 0; reads < EMC_RX_MAX_READS; ++reads) {
+    int32_t remainingBufferLength = _transport->read(_rxBuffer, EMC_RX_BUFFER_SIZE);
+    if (remainingBufferLength <= 0) return;
+    bool bufferFull = remainingBufferLength == EMC_RX_BUFFER_SIZE;
     _lastServerActivity = millis();
     emc_log_i("rx len %i", remainingBufferLength);
     size_t bytesParsed = 0;
@@ -448,6 +610,7 @@ void MqttClient::_checkIncoming() {
       emc_log_i("Parsed %zu - remaining %i", bytesParsed, remainingBufferLength);
       bytesParsed = 0;
     }
+    if (!bufferFull) return;
   }
 }
 
@@ -478,7 +641,7 @@ void MqttClient::_checkPing() {
 }
 
 void MqttClient::_checkTimeout() {
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
+  Outbox::Iterator it = _outbox.front();
   // check that we're not busy sending
   // don't check when first item hasn't been sent yet
   if (it && _bytesSent == 0 && it.get() != _outbox.getCurrent()) {
@@ -523,14 +686,9 @@ void MqttClient::_onPublish() {
       }
     }
   } else if (qos == 2) {
-    espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
-    while (it) {
-      if ((it.get()->packet.packetType()) == PacketType.PUBREC && it.get()->packet.packetId() == packetId) {
-        callback = false;
-        emc_log_e("QoS2 packet previously delivered");
-        break;
-      }
-      ++it;
+    if (_outbox.find(OutgoingPacketKey::key(PacketType.PUBREC, packetId))) {
+      callback = false;
+      emc_log_e("QoS2 packet previously delivered");
     }
     if (p.payload.index + p.payload.length == p.payload.total) {
       if (!_addPacket(PacketType.PUBREC, packetId)) {
@@ -553,20 +711,10 @@ void MqttClient::_onPublish() {
 void MqttClient::_onPuback() {
   bool callback = false;
   uint16_t idToMatch = _parser.getPacket().variableHeader.fixed.packetId;
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
-  while (it) {
-    // PUBACKs come in the order PUBs are sent. So we only check the first PUB packet in outbox
-    // if it doesn't match the ID, return
-    if ((it.get()->packet.packetType()) == PacketType.PUBLISH) {
-      if (it.get()->packet.packetId() == idToMatch) {
-        callback = true;
-        _outbox.remove(it);
-        break;
-      }
-      emc_log_w("Received out of order PUBACK");
-      break;
-    }
-    ++it;
+  Outbox::Iterator it = _outbox.find(OutgoingPacketKey::key(PacketType.PUBLISH, idToMatch));
+  if (it) {
+    callback = true;
+    _removePacket(it);
   }
   if (callback) {
     if (_onPublishCallback) {
@@ -582,23 +730,13 @@ void MqttClient::_onPuback() {
 void MqttClient::_onPubrec() {
   bool success = false;
   uint16_t idToMatch = _parser.getPacket().variableHeader.fixed.packetId;
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
-  while (it) {
-    // PUBRECs come in the order PUBs are sent. So we only check the first PUB packet in outbox
-    // if it doesn't match the ID, return
-    if ((it.get()->packet.packetType()) == PacketType.PUBLISH) {
-      if (it.get()->packet.packetId() == idToMatch) {
-        if (!_addPacket(PacketType.PUBREL, idToMatch)) {
-          emc_log_e("Could not create PUBREL packet");
-        }
-        _outbox.remove(it);
-        success = true;
-        break;
-      }
-      emc_log_w("Received out of order PUBREC");
-      break;
+  Outbox::Iterator it = _outbox.find(OutgoingPacketKey::key(PacketType.PUBLISH, idToMatch));
+  if (it) {
+    if (!_addPacket(PacketType.PUBREL, idToMatch)) {
+      emc_log_e("Could not create PUBREL packet");
     }
-    ++it;
+    _removePacket(it);
+    success = true;
   }
   if (!success) {
     emc_log_w("No matching PUBLISH packet found");
@@ -608,23 +746,13 @@ void MqttClient::_onPubrec() {
 void MqttClient::_onPubrel() {
   bool success = false;
   uint16_t idToMatch = _parser.getPacket().variableHeader.fixed.packetId;
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
-  while (it) {
-    // PUBRELs come in the order PUBRECs are sent. So we only check the first PUBREC packet in outbox
-    // if it doesn't match the ID, return
-    if ((it.get()->packet.packetType()) == PacketType.PUBREC) {
-      if (it.get()->packet.packetId() == idToMatch) {
-        if (!_addPacket(PacketType.PUBCOMP, idToMatch)) {
-          emc_log_e("Could not create PUBCOMP packet");
-        }
-        _outbox.remove(it);
-        success = true;
-        break;
-      }
-      emc_log_w("Received out of order PUBREL");
-      break;
+  Outbox::Iterator it = _outbox.find(OutgoingPacketKey::key(PacketType.PUBREC, idToMatch));
+  if (it) {
+    if (!_addPacket(PacketType.PUBCOMP, idToMatch)) {
+      emc_log_e("Could not create PUBCOMP packet");
     }
-    ++it;
+    _removePacket(it);
+    success = true;
   }
   if (!success) {
     emc_log_w("No matching PUBREC packet found");
@@ -633,21 +761,11 @@ void MqttClient::_onPubrel() {
 
 void MqttClient::_onPubcomp() {
   bool callback = false;
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
   uint16_t idToMatch = _parser.getPacket().variableHeader.fixed.packetId;
-  while (it) {
-    // PUBCOMPs come in the order PUBRELs are sent. So we only check the first PUBREL packet in outbox
-    // if it doesn't match the ID, return
-    if ((it.get()->packet.packetType()) == PacketType.PUBREL) {
-      if (it.get()->packet.packetId() == idToMatch) {
-        callback = true;
-        _outbox.remove(it);
-        break;
-      }
-      emc_log_w("Received out of order PUBCOMP");
-      break;
-    }
-    ++it;
+  Outbox::Iterator it = _outbox.find(OutgoingPacketKey::key(PacketType.PUBREL, idToMatch));
+  if (it) {
+    callback = true;
+    _removePacket(it);
   }
   if (callback) {
     if (_onPublishCallback) {
@@ -663,14 +781,10 @@ void MqttClient::_onPubcomp() {
 void MqttClient::_onSuback() {
   bool callback = false;
   uint16_t idToMatch = _parser.getPacket().variableHeader.fixed.packetId;
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
-  while (it) {
-    if (((it.get()->packet.packetType()) == PacketType.SUBSCRIBE) && it.get()->packet.packetId() == idToMatch) {
-      callback = true;
-      _outbox.remove(it);
-      break;
-    }
-    ++it;
+  Outbox::Iterator it = _outbox.find(OutgoingPacketKey::key(PacketType.SUBSCRIBE, idToMatch));
+  if (it) {
+    callback = true;
+    _removePacket(it);
   }
   if (callback) {
     if (_onSubscribeCallback) {
@@ -685,15 +799,11 @@ void MqttClient::_onSuback() {
 
 void MqttClient::_onUnsuback() {
   bool callback = false;
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
   uint16_t idToMatch = _parser.getPacket().variableHeader.fixed.packetId;
-  while (it) {
-    if (it.get()->packet.packetId() == idToMatch) {
-      callback = true;
-      _outbox.remove(it);
-      break;
-    }
-    ++it;
+  Outbox::Iterator it = _outbox.find(OutgoingPacketKey::key(PacketType.UNSUBSCRIBE, idToMatch));
+  if (it) {
+    callback = true;
+    _removePacket(it);
   }
   if (callback) {
     if (_onUnsubscribeCallback) {
@@ -706,9 +816,75 @@ void MqttClient::_onUnsuback() {
   }
 }
 
+uint32_t MqttClient::OutgoingPacketKey::get(const OutgoingPacket& p) {
+  espMqttClientInternals::MQTTPacketType type = p.packet.packetType();
+  if (p.packet.packetId() == 0) return 0;
+  if (type == PacketType.PUBLISH || type == PacketType.PUBREC || type == PacketType.PUBREL ||
+      type == PacketType.SUBSCRIBE || type == PacketType.UNSUBSCRIBE) {
+    return key(type, p.packet.packetId());
+  }
+  return 0;
+}
+
+void MqttClient::_removePacket(Outbox::Iterator& it) {
+  _outboxBytes -= it.get()->packet.size();
+  _outbox.remove(it);
+}
+
+void MqttClient::_removeCurrentPacket() {
+  _outboxBytes -= _outbox.getCurrent()->packet.size();
+  _outbox.removeCurrent();
+}
+
+size_t MqttClient::_outboxLimit(espMqttClientTypes::Priority priority) const {
+  switch (priority) {
+    case espMqttClientTypes::Priority::BACKGROUND: return _outboxBudget / 2;
+    case espMqttClientTypes::Priority::NORMAL:     return _outboxBudget - _outboxBudget / 5;
+    default:                                       return _outboxBudget;
+  }
+}
+
+bool MqttClient::_admitPublish(const char* topic, uint8_t qos, size_t length, espMqttClientTypes::Priority priority) const {
+  if (_outboxBudget == 0) return true;
+  // a class is admitted while the outbox is below its share, the full budget is never exceeded
+  // fixed header (max 5) + topic length (2) + topic + packet id (2) + payload
+  size_t size = 5 + 2 + strlen(topic) + (qos > 0 ? 2 : 0) + length;
+  return _outboxBytes < _outboxLimit(priority) && _outboxBytes + size <= _outboxBudget;
+}
+
+uint32_t MqttClient::_topicTag(const char* topic) {
+  // FNV-1a, 0 means untagged
+  uint32_t hash = 2166136261u;
+  for (; *topic; ++topic) {
+    hash = (hash ^ static_cast<uint8_t>(*topic)) * 16777619u;
+  }
+  return hash ? hash : 1;
+}
+
+bool MqttClient::_supersedePublish(const char* topic, uint8_t qos, bool retain, const espMqttClientTypes::PayloadWriter& writer, size_t length, uint16_t* packetId) {
+  // only publishes made with coalesce are tagged, so this doesn't scan the outbox
+  OutgoingPacket* current = _outbox.getCurrent();
+  size_t bytesSent = _bytesSent;
+  Outbox::Iterator it = _outbox.findTagged(_topicTag(topic), [&](const OutgoingPacket& p) {
+    // the current packet may already be partially written
+    if (&p == current && bytesSent > 0) return false;
+    return p.packet.supersedable(topic, qos, retain);
+  });
+  if (!it) return false;
+
+  OutgoingPacket* match = it.get();
+  size_t oldSize = match->packet.size();
+  if (!match->packet.replacePayload(writer, length)) return false;
+  _outboxBytes -= oldSize;
+  _outboxBytes += match->packet.size();
+  *packetId = (qos > 0) ? match->packet.packetId() : 1;
+  emc_log_i("PUBLISH %s superseded (%u)", topic, *packetId);
+  return true;
+}
+
 void MqttClient::_clearQueue(int clearData) {
   emc_log_i("clearing queue (clear session: %d)", clearData);
-  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
+  Outbox::Iterator it = _outbox.front();
   if (clearData == 0) {
     // keep PUB (qos > 0, aka packetID != 0), PUBREC and PUBREL
     // Spec only mentions PUB and PUBREL but this lib implements method B from point 4.3.3 (Fig. 4.3)
@@ -720,7 +896,7 @@ void MqttClient::_clearQueue(int clearData) {
          (type == PacketType.PUBLISH && it.get()->packet.packetId() != 0)) {
         ++it;
       } else {
-        _outbox.remove(it);
+        _removePacket(it);
       }
     }
   } else if (clearData == 1) {
@@ -729,12 +905,12 @@ void MqttClient::_clearQueue(int clearData) {
       if (it.get()->packet.packetType() == PacketType.PUBLISH) {
         ++it;
       } else {
-        _outbox.remove(it);
+        _removePacket(it);
       }
     }
   } else {  // clearData == 2
     while (it) {
-      _outbox.remove(it);
+      _removePacket(it);
     }
   }
 }
@@ -13,6 +13,8 @@ the LICENSE file.
 
 #include <atomic>
 #include <utility>
+#include <new>
+#include <string.h>
 
 #include "Helpers.h"
 #include "Config.h"
@@ -46,6 +48,7 @@ class MqttClient {
     }
     return packetId;
   }
+  uint16_t subscribe(const espMqttClientTypes::Subscription* subscriptions, size_t count);
   template <typename... Args>
   uint16_t unsubscribe(const char* topic, Args&&... args) {
     uint16_t packetId = 0;
@@ -62,9 +65,17 @@ class MqttClient {
     }
     return packetId;
   }
-  uint16_t publish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length);
-  uint16_t publish(const char* topic, uint8_t qos, bool retain, const char* payload);
-  uint16_t publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadCallback callback, size_t length);
+  uint16_t publish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length,
+                   espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL, bool coalesce = false);
+  uint16_t publish(const char* topic, uint8_t qos, bool retain, const char* payload,
+                   espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL, bool coalesce = false);
+  uint16_t publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadCallback callback, size_t length,
+                   espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL);
+  uint16_t publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadWriter writer, size_t length,
+                   espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL, bool coalesce = false);
+  bool congested(espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL) const;
+  size_t outboxBytes() const;
+  size_t poolStats(espMqttClientTypes::PoolStats* stats, size_t count) const;
   void clearQueue(bool deleteSessionData = false);  // Not MQTT compliant and may cause unpredictable results when `deleteSessionData` = true!
   const char* getClientId() const;
   size_t queueSize();  // No const because of mutex
@@ -98,6 +109,8 @@ class MqttClient {
   uint8_t _willQos;
   bool _willRetain;
   uint32_t _timeout;
+  size_t _outboxBudget;
+  void _setTxCoalescing(size_t size, uint32_t deadline);
 
   // state is protected to allow state changes by the transport system, defined in child classes
   // eg. to allow AsyncTCP
@@ -138,8 +151,22 @@ class MqttClient {
       timeSent(t),
       packet(error, std::forward<Args>(args) ...) {}
   };
-  espMqttClientInternals::Outbox<OutgoingPacket> _outbox;
+  struct OutgoingPacketKey {
+    static uint32_t key(espMqttClientInternals::MQTTPacketType type, uint16_t packetId) {
+      return (static_cast<uint32_t>(type) << 16) | packetId;
+    }
+    // only packets that wait for an acknowledgement are indexed
+    static uint32_t get(const OutgoingPacket& p);
+  };
+  typedef espMqttClientInternals::Outbox<OutgoingPacket, OutgoingPacketKey> Outbox;
+  Outbox _outbox;
+  std::atomic<size_t> _outboxBytes;  // written with the semaphore held, read lock-free by congested()
   size_t _bytesSent;
+  uint8_t* _txBuffer;  // coalesces small packets into a single transport write, nullptr when disabled
+  size_t _txBufferSize;
+  size_t _txLength;
+  uint32_t _txDeadline;
+  uint32_t _txBufferedSince;
   espMqttClientInternals::Parser _parser;
   uint32_t _lastClientActivity;
   uint32_t _lastServerActivity;
@@ -148,31 +175,42 @@ class MqttClient {
 
   uint16_t _getNextPacketId();
 
+  // iterator is invalid when the packet could not be created
   template <typename... Args>
-  bool _addPacket(Args&&... args) {
+  Outbox::Iterator _addPacket(Args&&... args) {
     espMqttClientTypes::Error error(espMqttClientTypes::Error::SUCCESS);
-    espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.emplace(0, error, std::forward<Args>(args) ...);
+    Outbox::Iterator it = _outbox.emplace(0, error, std::forward<Args>(args) ...);
     if (it && error == espMqttClientTypes::Error::SUCCESS) {
-      return true;
-    } else {
-      if (it) _outbox.remove(it);
-      return false;
+      _outboxBytes += it.get()->packet.size();
+    } else if (it) {
+      _outbox.remove(it);  // not yet counted in _outboxBytes, leaves it invalid
     }
+    return it;
   }
 
   template <typename... Args>
   bool _addPacketFront(Args&&... args) {
     espMqttClientTypes::Error error(espMqttClientTypes::Error::SUCCESS);
-    espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.emplaceFront(0, error, std::forward<Args>(args) ...);
+    Outbox::Iterator it = _outbox.emplaceFront(0, error, std::forward<Args>(args) ...);
     if (it && error == espMqttClientTypes::Error::SUCCESS) {
+      _outboxBytes += it.get()->packet.size();
       return true;
     } else {
-      if (it) _outbox.remove(it);
+      if (it) _outbox.remove(it);  // not yet counted in _outboxBytes
       return false;
     }
   }
 
+  void _removePacket(Outbox::Iterator& it);  // NOLINT(runtime/references)
+  void _removeCurrentPacket();
+  size_t _outboxLimit(espMqttClientTypes::Priority priority) const;
+  bool _admitPublish(const char* topic, uint8_t qos, size_t length, espMqttClientTypes::Priority priority) const;
+  static uint32_t _topicTag(const char* topic);
+  bool _supersedePublish(const char* topic, uint8_t qos, bool retain, const espMqttClientTypes::PayloadWriter& writer, size_t length, uint16_t* packetId);
+
   void _checkOutbox();
+  void _coalesceOutbox();
+  bool _flushTx();
   int _sendPacket();
   bool _advanceOutbox();
   void _checkIncoming();
@@ -78,6 +78,16 @@ class MqttClientSetup : public MqttClient {
     return static_cast<T&>(*this);
   }
 
+  T& setOutboxBudget(size_t bytes) {
+    _outboxBudget = bytes;  // 0 disables the budget
+    return static_cast<T&>(*this);
+  }
+
+  T& setTxCoalescing(size_t size, uint32_t deadline = 0) {
+    _setTxCoalescing(size, deadline);  // 0 size disables coalescing
+    return static_cast<T&>(*this);
+  }
+
   T& onConnect(espMqttClientTypes::OnConnectCallback callback, uint32_t id = 0) {
     #if EMC_MULTIPLE_CALLBACKS
     _onConnectCallbacks.emplace_back(callback, id);
@@ -9,24 +9,179 @@ the LICENSE file.
 
 #pragma once
 
+#include "Config.h"
+#include "TypeDefs.h"
 #if EMC_USE_MEMPOOL
   #include "MemoryPool/src/MemoryPool.h"
-  #include "Config.h"
+#elif EMC_USE_SLAB_POOLS
+  #include <stdlib.h>  // malloc, free
+  #include <new>  // placement new
+  #include "SlabPool.h"
 #else
   #include <new>  // new (std::nothrow)
 #endif
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
 #include <utility>  // std::forward
 
 namespace espMqttClientInternals {
 
 /**
- * @brief Singly linked queue with builtin non-invalidating forward iterator
+ * @brief Default key for outbox items: items are not indexed
+ *
+ * A key type provides `static uint32_t get(const T&)`. Items with key 0 are not indexed.
+ */
+template <typename T>
+struct OutboxNoKey {
+  static uint32_t get(const T&) { return 0; }
+};
+
+// smallest power of two >= n
+constexpr size_t outboxIndexSize(size_t n, size_t p = 1) {
+  return p >= n ? p : outboxIndexSize(n, p * 2);
+}
+
+/**
+ * @brief Open addressing table from a key stored in the node (KeyMember) to outbox nodes
+ *
+ * Several nodes may share a key, find() visits all of them. Nodes with key 0 are not indexed.
+ * In mempool builds the table has a fixed size, otherwise it grows on demand. When growing fails
+ * the table is dropped and valid() returns false, the outbox then scans the queue instead.
+ */
+template <typename Node, uint32_t Node::*KeyMember>
+class OutboxIndex {
+ public:
+  OutboxIndex()
+  #if EMC_USE_MEMPOOL
+  : _slots(_buffer)
+  , _size(_fixedSize)
+  #else
+  : _slots(nullptr)
+  , _size(0)
+  #endif
+  , _count(0) {
+    #if EMC_USE_MEMPOOL
+    for (size_t i = 0; i < _size; ++i) _slots[i].node = nullptr;
+    #endif
+  }
+  ~OutboxIndex() {
+    #if !EMC_USE_MEMPOOL
+    delete[] _slots;
+    #endif
+  }
+
+  bool valid() const {
+    return _slots != nullptr;
+  }
+
+  // first is the front of the queue, used to rebuild the table when it grows
+  void insert(Node* node, Node* first) {
+    if (node->*KeyMember == 0) return;
+    #if !EMC_USE_MEMPOOL
+    if (_size == 0 || (_count + 1) * 2 > _size) {
+      if (!_grow(first)) return;
+    }
+    #else
+    (void) first;
+    #endif
+    if (!_slots) return;
+    _put(node);
+  }
+
+  void remove(Node* node) {
+    if (node->*KeyMember == 0 || !_slots) return;
+    size_t mask = _size - 1;
+    size_t i = _hash(node->*KeyMember) & mask;
+    while (_slots[i].node && _slots[i].node != node) i = (i + 1) & mask;
+    if (!_slots[i].node) return;
+    // backward shift deletion keeps probe sequences intact without tombstones
+    size_t j = i;
+    while (true) {
+      j = (j + 1) & mask;
+      if (!_slots[j].node) break;
+      size_t home = _hash(_slots[j].key) & mask;
+      if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+        _slots[i] = _slots[j];
+        i = j;
+      }
+    }
+    _slots[i].node = nullptr;
+    --_count;
+  }
+
+  // first node with the given key for which match(node) returns true, requires valid()
+  template <typename Match>
+  Node* find(uint32_t key, Match match) const {
+    size_t mask = _size - 1;
+    for (size_t i = _hash(key) & mask; _slots[i].node; i = (i + 1) & mask) {
+      if (_slots[i].key == key && match(_slots[i].node)) return _slots[i].node;
+    }
+    return nullptr;
+  }
+
+ private:
+  struct Slot {
+    uint32_t key;
+    Node* node;
+  };
+  #if EMC_USE_MEMPOOL
+  // the pool limits the number of nodes, so the table never has to grow
+  static constexpr size_t _fixedSize = outboxIndexSize(EMC_NUM_POOL_ELEMENTS * 2);
+  Slot _buffer[_fixedSize];
+  #endif
+  Slot* _slots;
+  size_t _size;
+  size_t _count;
+
+  static size_t _hash(uint32_t key) {
+    // Fibonacci hashing, packet ids are mostly sequential
+    return static_cast<size_t>((key * 2654435761u) >> 8);
+  }
+
+  void _put(Node* node) {
+    size_t mask = _size - 1;
+    size_t i = _hash(node->*KeyMember) & mask;
+    while (_slots[i].node) i = (i + 1) & mask;
+    _slots[i].key = node->*KeyMember;
+    _slots[i].node = node;
+    ++_count;
+  }
+
+  #if !EMC_USE_MEMPOOL
+  bool _grow(Node* first) {
+    size_t newSize = _size ? _size * 2 : 16;
+    Slot* newSlots = new(std::nothrow) Slot[newSize];
+    if (!newSlots) {
+      // fall back to scanning the queue
+      delete[] _slots;
+      _slots = nullptr;
+      _size = 0;
+      _count = 0;
+      return false;
+    }
+    for (size_t i = 0; i < newSize; ++i) newSlots[i].node = nullptr;
+    delete[] _slots;
+    _slots = newSlots;
+    _size = newSize;
+    _count = 0;
+    for (Node* n = first; n; n = n->next) {
+      if (n->*KeyMember != 0) _put(n);
+    }
+    return true;
+  }
+  #endif
+};
+
+/**
+ * @brief Doubly linked queue with builtin non-invalidating forward iterator
  * 
  * Queue items can only be emplaced, at front and back of the queue.
  * Remove items using an iterator or the builtin iterator.
+ * Items with a non-zero key are indexed in an open addressing table and can be found in constant time.
+ * Items can additionally be tagged with a value that several items may share, see tag() and findTagged().
  */
 
-template <typename T>
+template <typename T, typename Key = OutboxNoKey<T>>
 class Outbox {
  public:
   Outbox()
@@ -37,16 +192,14 @@ class Outbox {
   #if EMC_USE_MEMPOOL
   , _memPool()
   #endif
-  {}
+  , _index()
+  , _tags() {
+    // empty
+  }
   ~Outbox() {
     while (_first) {
       Node* n = _first->next;
-      #if EMC_USE_MEMPOOL
-      _first->~Node();
-      _memPool.free(_first);
-      #else
-      delete _first;
-      #endif
+      _destroyNode(_first);
       _first = n;
     }
   }
@@ -56,12 +209,18 @@ class Outbox {
     template <typename... Args>
     explicit Node(Args&&... args)
     : data(std::forward<Args>(args) ...)
-    , next(nullptr) {
+    , next(nullptr)
+    , prev(nullptr)
+    , key(0)
+    , tag(0) {
       // empty
     }
 
     T data;
     Node* next;
+    Node* prev;
+    uint32_t key;
+    uint32_t tag;
   };
 
   class Iterator {
@@ -93,15 +252,7 @@ class Outbox {
   template <class... Args>
   Iterator emplace(Args&&... args) {
     Iterator it;
-    #if EMC_USE_MEMPOOL
-    void* buf = _memPool.malloc();
-    Node* node = nullptr;
-    if (buf) {
-      node = new(buf) Node(std::forward<Args>(args) ...);
-    }
-    #else
-    Node* node = new(std::nothrow) Node(std::forward<Args>(args) ...);
-    #endif
+    Node* node = _createNode(std::forward<Args>(args) ...);
     if (node != nullptr) {
       if (!_first) {
         // queue is empty
@@ -109,6 +260,7 @@ class Outbox {
       } else {
         // queue has at least one item
         _last->next = node;
+        node->prev = _last;
         it._prev = _last;
       }
       _last = node;
@@ -117,6 +269,7 @@ class Outbox {
       if (!_current) {
         _current = _last;
       }
+      _indexInsert(node);
     }
     return it;
   }
@@ -125,15 +278,7 @@ class Outbox {
   template <class... Args>
   Iterator emplaceFront(Args&&... args) {
     Iterator it;
-    #if EMC_USE_MEMPOOL
-    void* buf = _memPool.malloc();
-    Node* node = nullptr;
-    if (buf) {
-      node = new(buf) Node(std::forward<Args>(args) ...);
-    }
-    #else
-    Node* node = new(std::nothrow) Node(std::forward<Args>(args) ...);
-    #endif
+    Node* node = _createNode(std::forward<Args>(args) ...);
     if (node != nullptr) {
       if (!_first) {
         // queue is empty
@@ -141,10 +286,12 @@ class Outbox {
       } else {
         // queue has at least one item
         node->next = _first;
+        _first->prev = node;
       }
       _current = _first = node;
       _prev = nullptr;
       it._node = node;
+      _indexInsert(node);
     }
     return it;
   }
@@ -179,6 +326,25 @@ class Outbox {
     return it;
   }
 
+  // Find an item by its key, iterator is invalid when no item matches
+  Iterator find(uint32_t key) const {
+    return _find(_index, &Node::key, key, [](const T&) { return true; });
+  }
+
+  // Tag an item, tag 0 removes it from the tag index
+  void tag(const Iterator& it, uint32_t tag) {
+    if (!it) return;
+    _tags.remove(it._node);
+    it._node->tag = tag;
+    _tags.insert(it._node, _first);
+  }
+
+  // Find the first item with the given tag for which match(item) returns true, iterator is invalid when no item matches
+  template <typename Match>
+  Iterator findTagged(uint32_t tag, Match match) const {
+    return _find(_tags, &Node::tag, tag, match);
+  }
+
   // Advance current item
   void next() {
     if (_current) {
@@ -193,6 +359,17 @@ class Outbox {
     return false;
   }
 
+  // statistics of the node pool, returns false without slab pools
+  bool poolStats(espMqttClientTypes::PoolStats* stats) const {
+    #if EMC_USE_SLAB_POOLS
+    _slabPool.stats(stats);
+    return true;
+    #else
+    (void) stats;
+    return false;
+    #endif
+  }
+
   size_t size() const {
     Node* n = _first;
     size_t count = 0;
@@ -210,11 +387,75 @@ class Outbox {
   Node* _prev;  // element just before _current
   #if EMC_USE_MEMPOOL
   MemoryPool::Fixed<EMC_NUM_POOL_ELEMENTS, sizeof(Node)> _memPool;
+  #elif EMC_USE_SLAB_POOLS
+  SlabPool<EMC_SLAB_NODE_COUNT, sizeof(Node)> _slabPool;
   #endif
 
+  template <class... Args>
+  Node* _createNode(Args&&... args) {
+    #if EMC_USE_MEMPOOL || EMC_USE_SLAB_POOLS
+    #if EMC_USE_MEMPOOL
+    void* buf = _memPool.malloc();
+    #else
+    void* buf = _slabPool.malloc();
+    if (!buf) buf = malloc(sizeof(Node));  // pool exhausted, counted as fallback
+    #endif
+    if (!buf) return nullptr;
+    return new(buf) Node(std::forward<Args>(args) ...);
+    #else
+    return new(std::nothrow) Node(std::forward<Args>(args) ...);
+    #endif
+  }
+
+  void _destroyNode(Node* node) {
+    #if EMC_USE_MEMPOOL
+    node->~Node();
+    _memPool.free(node);
+    #elif EMC_USE_SLAB_POOLS
+    node->~Node();
+    if (!_slabPool.free(node)) free(node);
+    #else
+    delete node;
+    #endif
+  }
+
+  OutboxIndex<Node, &Node::key> _index;
+  OutboxIndex<Node, &Node::tag> _tags;
+
+  void _indexInsert(Node* node) {
+    node->key = Key::get(node->data);
+    _index.insert(node, _first);
+  }
+
+  template <typename Index, typename Match>
+  Iterator _find(const Index& index, uint32_t Node::*member, uint32_t key, Match match) const {
+    Iterator it;
+    if (key == 0) return it;
+    Node* node = nullptr;
+    if (index.valid()) {
+      node = index.find(key, [&match](Node* n) { return match(n->data); });
+    } else {
+      // index could not be allocated
+      for (Node* n = _first; n; n = n->next) {
+        if (n->*member == key && match(n->data)) {
+          node = n;
+          break;
+        }
+      }
+    }
+    if (node) {
+      it._node = node;
+      it._prev = node->prev;
+    }
+    return it;
+  }
+
   void _remove(Node* prev, Node* node) {
     if (!node) return;
 
+    _index.remove(node);
+    _tags.remove(node);
+
     // set current to next, node->next may be nullptr
     if (_current == node) {
       _current = node->next;
@@ -231,6 +472,7 @@ class Outbox {
     // delete first el in longer outbox
     } else if (_first == node) {
       _first = node->next;
+      _first->prev = nullptr;
 
     // delete last in longer outbox
     } else if (_last == node) {
@@ -240,15 +482,11 @@ class Outbox {
     // delete somewhere in the middle
     } else {
       prev->next = node->next;
+      node->next->prev = prev;
     }
 
     // finally, delete the node
-      #if EMC_USE_MEMPOOL
-      node->~Node();
-      _memPool.free(node);
-      #else
-      delete node;
-      #endif
+    _destroyNode(node);
   }
 };
 
@@ -12,14 +12,14 @@ namespace espMqttClientInternals {
 
 #if EMC_USE_MEMPOOL
 MemoryPool::Variable<EMC_NUM_POOL_ELEMENTS, EMC_SIZE_POOL_ELEMENTS> Packet::_memPool;
+#elif EMC_USE_SLAB_POOLS
+SlabPool<EMC_SLAB_SMALL_COUNT, EMC_SLAB_SMALL_SIZE> Packet::_smallPool;
+SlabPool<EMC_SLAB_MEDIUM_COUNT, EMC_SLAB_MEDIUM_SIZE> Packet::_mediumPool;
+SlabPool<EMC_SLAB_LARGE_COUNT, EMC_SLAB_LARGE_SIZE> Packet::_largePool;
 #endif
 
 Packet::~Packet() {
-  #if EMC_USE_MEMPOOL
-  _memPool.free(_data);
-  #else
-  free(_data);
-  #endif
+  _free(_data);
 }
 
 size_t Packet::available(size_t index) {
@@ -41,6 +41,10 @@ size_t Packet::size() const {
   return _size;
 }
 
+bool Packet::chunked() const {
+  return static_cast<bool>(_getPayload);
+}
+
 void Packet::setDup() {
   if (!_data) return;
   if (packetType() != PacketType.PUBLISH) return;
@@ -63,6 +67,59 @@ bool Packet::removable() const {
   return false;
 }
 
+bool Packet::supersedable(const char* topic, uint8_t qos, bool retain) const {
+  if (!_data || _getPayload) return false;
+  uint8_t header = PacketType.PUBLISH;
+  if (retain) header |= HeaderFlag.PUBLISH_RETAIN;
+  if (qos == 1) header |= HeaderFlag.PUBLISH_QOS1;
+  else if (qos == 2) header |= HeaderFlag.PUBLISH_QOS2;
+  if (_data[0] != header) return false;  // also rejects packets with dup set
+
+  size_t pos = 1 + remainingLengthLength(decodeRemainingLength(&_data[1]));
+  size_t topicLength = (static_cast<size_t>(_data[pos]) << 8) | _data[pos + 1];
+  return strlen(topic) == topicLength && memcmp(&_data[pos + 2], topic, topicLength) == 0;
+}
+
+bool Packet::replacePayload(const uint8_t* payload, size_t payloadLength) {
+  return replacePayload([payload](uint8_t* data, size_t length) {
+    memcpy(data, payload, length);
+    return length;
+  }, payloadLength);
+}
+
+bool Packet::replacePayload(const espMqttClientTypes::PayloadWriter& payloadWriter, size_t payloadLength) {
+  if (!_data || _getPayload || packetType() != PacketType.PUBLISH) return false;
+
+  size_t headerStart = 1 + remainingLengthLength(decodeRemainingLength(&_data[1]));
+  size_t topicLength = (static_cast<size_t>(_data[headerStart]) << 8) | _data[headerStart + 1];
+  size_t variableHeaderLength = 2 + topicLength + (_packetId != 0 ? 2 : 0);
+  size_t remainingLength = variableHeaderLength + payloadLength;
+
+  uint8_t* oldData = _data;
+  size_t oldSize = _size;
+  if (!_allocate(remainingLength, true)) {
+    _data = oldData;
+    _size = oldSize;
+    return false;
+  }
+
+  // fixed header and variable header (topic, packet id) are reused
+  size_t pos = 0;
+  _data[pos++] = oldData[0];
+  pos += encodeRemainingLength(remainingLength, &_data[pos]);
+  memcpy(&_data[pos], &oldData[headerStart], variableHeaderLength);
+  pos += variableHeaderLength;
+  if (payloadWriter(&_data[pos], payloadLength) != payloadLength) {
+    emc_log_e("Payload writer size mismatch");
+    _free(_data);
+    _data = oldData;
+    _size = oldSize;
+    return false;
+  }
+  _free(oldData);
+  return true;
+}
+
 Packet::Packet(espMqttClientTypes::Error& error,
                bool cleanSession,
                const char* username,
@@ -239,6 +296,47 @@ Packet::Packet(espMqttClientTypes::Error& error,
   error = espMqttClientTypes::Error::SUCCESS;
 }
 
+Packet::Packet(espMqttClientTypes::Error& error,
+               uint16_t packetId,
+               const char* topic,
+               const espMqttClientTypes::PayloadWriter& payloadWriter,
+               size_t payloadLength,
+               uint8_t qos,
+               bool retain)
+: _packetId(packetId)
+, _data(nullptr)
+, _size(0)
+, _payloadIndex(0)
+, _payloadStartIndex(0)
+, _payloadEndIndex(0)
+, _getPayload(nullptr) {
+  size_t remainingLength =
+    2 + strlen(topic) +  // topic length + topic
+    2 +                  // packet ID
+    payloadLength;
+
+  if (qos == 0) {
+    remainingLength -= 2;
+    _packetId = 0;
+  }
+
+  if (!_allocate(remainingLength, true)) {
+    error = espMqttClientTypes::Error::OUT_OF_MEMORY;
+    return;
+  }
+
+  size_t pos = _fillPublishHeader(packetId, topic, remainingLength, qos, retain);
+
+  // PAYLOAD
+  if (payloadWriter(&_data[pos], payloadLength) != payloadLength) {
+    emc_log_e("Payload writer size mismatch");
+    error = espMqttClientTypes::Error::MALFORMED_PARAMETER;
+    return;
+  }
+
+  error = espMqttClientTypes::Error::SUCCESS;
+}
+
 Packet::Packet(espMqttClientTypes::Error& error, uint16_t packetId, const char* topic, uint8_t qos)
 : _packetId(packetId)
 , _data(nullptr)
@@ -251,6 +349,17 @@ Packet::Packet(espMqttClientTypes::Error& error, uint16_t packetId, const char*
   _createSubscribe(error, list, 1);
 }
 
+Packet::Packet(espMqttClientTypes::Error& error, uint16_t packetId, const espMqttClientTypes::Subscription* list, size_t numberTopics)
+: _packetId(packetId)
+, _data(nullptr)
+, _size(0)
+, _payloadIndex(0)
+, _payloadStartIndex(0)
+, _payloadEndIndex(0)
+, _getPayload(nullptr) {
+  _createSubscribe(error, list, numberTopics);
+}
+
 Packet::Packet(espMqttClientTypes::Error& error, MQTTPacketType type, uint16_t packetId)
 : _packetId(packetId)
 , _data(nullptr)
@@ -309,19 +418,23 @@ Packet::Packet(espMqttClientTypes::Error& error, MQTTPacketType type)
 
 
 bool Packet::_allocate(size_t remainingLength, bool check) {
-  #if EMC_USE_MEMPOOL
-  (void) check;
-  #else
-  if (check && EMC_GET_FREE_MEMORY() < EMC_MIN_FREE_MEMORY) {
-    emc_log_w("Packet buffer not allocated: low memory");
-    return false;
-  }
-  #endif
   _size = 1 + remainingLengthLength(remainingLength) + remainingLength;
+  _data = nullptr;
   #if EMC_USE_MEMPOOL
+  (void) check;
   _data = reinterpret_cast<uint8_t*>(_memPool.malloc(_size));
   #else
-  _data = reinterpret_cast<uint8_t*>(malloc(_size));
+  #if EMC_USE_SLAB_POOLS
+  _data = _slabMalloc(_size);
+  #endif
+  if (!_data) {
+    if (check && EMC_GET_FREE_MEMORY() < EMC_MIN_FREE_MEMORY) {
+      emc_log_w("Packet buffer not allocated: low memory");
+      _size = 0;
+      return false;
+    }
+    _data = reinterpret_cast<uint8_t*>(malloc(_size));
+  }
   #endif
   if (!_data) {
     _size = 0;
@@ -333,6 +446,46 @@ bool Packet::_allocate(size_t remainingLength, bool check) {
   return true;
 }
 
+void Packet::_free(uint8_t* data) {
+  #if EMC_USE_MEMPOOL
+  _memPool.free(data);
+  #else
+  #if EMC_USE_SLAB_POOLS
+  if (_slabFree(data)) return;
+  #endif
+  free(data);
+  #endif
+}
+
+#if EMC_USE_SLAB_POOLS
+uint8_t* Packet::_slabMalloc(size_t size) {
+  // smallest size class that fits, a full class doesn't spill into the next one
+  if (size <= EMC_SLAB_SMALL_SIZE) return reinterpret_cast<uint8_t*>(_smallPool.malloc());
+  if (size <= EMC_SLAB_MEDIUM_SIZE) return reinterpret_cast<uint8_t*>(_mediumPool.malloc());
+  if (size <= EMC_SLAB_LARGE_SIZE) return reinterpret_cast<uint8_t*>(_largePool.malloc());
+  _largePool.countFallback();
+  return nullptr;
+}
+
+bool Packet::_slabFree(uint8_t* data) {
+  return _smallPool.free(data) || _mediumPool.free(data) || _largePool.free(data);
+}
+#endif
+
+size_t Packet::poolStats(espMqttClientTypes::PoolStats* stats, size_t count) {
+  #if EMC_USE_SLAB_POOLS
+  if (count < 3) return 0;
+  _smallPool.stats(&stats[0]);
+  _mediumPool.stats(&stats[1]);
+  _largePool.stats(&stats[2]);
+  return 3;
+  #else
+  (void) stats;
+  (void) count;
+  return 0;
+  #endif
+}
+
 size_t Packet::_fillPublishHeader(uint16_t packetId,
                                   const char* topic,
                                   size_t remainingLength,
@@ -363,7 +516,7 @@ size_t Packet::_fillPublishHeader(uint16_t packetId,
 }
 
 void Packet::_createSubscribe(espMqttClientTypes::Error& error,
-                              SubscribeItem* list,
+                              const SubscribeItem* list,
                               size_t numberTopics) {
   // Calculate size
   size_t payload = 0;
@@ -21,6 +21,8 @@ the LICENSE file.
 
 #if EMC_USE_MEMPOOL
   #include "MemoryPool/src/MemoryPool.h"
+#elif EMC_USE_SLAB_POOLS
+  #include "../SlabPool.h"
 #endif
 
 namespace espMqttClientInternals {
@@ -36,6 +38,15 @@ class Packet {
   uint16_t packetId() const;
   MQTTPacketType packetType() const;
   bool removable() const;
+  // payload is fetched in chunks by a callback while sending
+  bool chunked() const;
+  // statistics of the packet buffer size classes, returns the number of entries written (0 without slab pools)
+  static size_t poolStats(espMqttClientTypes::PoolStats* stats, size_t count);
+  // true for a PUBLISH with this topic, qos and retain flag that was never transmitted (no dup flag)
+  bool supersedable(const char* topic, uint8_t qos, bool retain) const;
+  // replaces the payload of a buffered PUBLISH, keeps the packet untouched when allocation or the writer fails
+  bool replacePayload(const uint8_t* payload, size_t payloadLength);
+  bool replacePayload(const espMqttClientTypes::PayloadWriter& payloadWriter, size_t payloadLength);
 
  protected:
   uint16_t _packetId;  // save as separate variable: will be accessed frequently
@@ -48,10 +59,7 @@ class Packet {
   size_t _payloadEndIndex;
   espMqttClientTypes::PayloadCallback _getPayload;
 
-  struct SubscribeItem {
-    const char* topic;
-    uint8_t qos;
-  };
+  typedef espMqttClientTypes::Subscription SubscribeItem;
 
  public:
   // CONNECT
@@ -81,6 +89,14 @@ class Packet {
          size_t payloadLength,
          uint8_t qos,
          bool retain);
+  // payload is written straight into the packet buffer, must write exactly payloadLength bytes
+  Packet(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
+         uint16_t packetId,
+         const char* topic,
+         const espMqttClientTypes::PayloadWriter& payloadWriter,
+         size_t payloadLength,
+         uint8_t qos,
+         bool retain);
   // SUBSCRIBE
   Packet(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
          uint16_t packetId,
@@ -106,6 +122,10 @@ class Packet {
     SubscribeItem list[numberTopics] = {topic1, qos1, topic2, qos2, args...};
     _createSubscribe(error, list, numberTopics);
   }
+  Packet(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
+         uint16_t packetId,
+         const espMqttClientTypes::Subscription* list,
+         size_t numberTopics);
   // UNSUBSCRIBE
   Packet(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
          uint16_t packetId,
@@ -138,6 +158,7 @@ class Packet {
  private:
   // pass remainingLength = total size - header - remainingLengthLength!
   bool _allocate(size_t remainingLength, bool check);
+  void _free(uint8_t* data);
 
   // fills header and returns index of next available byte in buffer
   size_t _fillPublishHeader(uint16_t packetId,
@@ -146,7 +167,7 @@ class Packet {
                             uint8_t qos,
                             bool retain);
   void _createSubscribe(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
-                        SubscribeItem* list,
+                        const SubscribeItem* list,
                         size_t numberTopics);
   void _createUnsubscribe(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
                           const char** list,
@@ -157,6 +178,12 @@ class Packet {
 
   #if EMC_USE_MEMPOOL
   static MemoryPool::Variable<EMC_NUM_POOL_ELEMENTS, EMC_SIZE_POOL_ELEMENTS> _memPool;
+  #elif EMC_USE_SLAB_POOLS
+  static uint8_t* _slabMalloc(size_t size);
+  static bool _slabFree(uint8_t* data);
+  static SlabPool<EMC_SLAB_SMALL_COUNT, EMC_SLAB_SMALL_SIZE> _smallPool;
+  static SlabPool<EMC_SLAB_MEDIUM_COUNT, EMC_SLAB_MEDIUM_SIZE> _mediumPool;
+  static SlabPool<EMC_SLAB_LARGE_COUNT, EMC_SLAB_LARGE_SIZE> _largePool;
   #endif
 };
 
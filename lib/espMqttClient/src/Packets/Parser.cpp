@@ -6,6 +6,8 @@ For a copy, see <https://opensource.org/licenses/MIT> or
 the LICENSE file.
 */
 
+#include <string.h>
+
 #include "Parser.h"
 
 namespace espMqttClientInternals {
@@ -211,6 +213,10 @@ ParserResult Parser::_varHeaderConnack2(Parser* p) {
 
 ParserResult Parser::_varHeaderPacketId1(Parser* p) {
   p->_packet.variableHeader.fixed.packetId |= p->_data[p->_bytesRead] << 8;
+  if (p->_bytesRead + 1 < p->_len) {  // second byte available: no need to return to the parse-loop
+    ++p->_bytesRead;
+    return _varHeaderPacketId2(p);
+  }
   p->_parse = _varHeaderPacketId2;
   return ParserResult::awaitData;
 }
@@ -243,6 +249,10 @@ ParserResult Parser::_varHeaderPacketId2(Parser* p) {
 
 ParserResult Parser::_varHeaderTopicLength1(Parser* p) {
   p->_packet.variableHeader.topicLength = p->_data[p->_bytesRead] << 8;
+  if (p->_bytesRead + 1 < p->_len) {  // second byte available: no need to return to the parse-loop
+    ++p->_bytesRead;
+    return _varHeaderTopicLength2(p);
+  }
   p->_parse = _varHeaderTopicLength2;
   return ParserResult::awaitData;
 }
@@ -253,7 +263,7 @@ ParserResult Parser::_varHeaderTopicLength2(Parser* p) {
     p->_packet.fixedHeader.remainingLength.remainingLength
     - 2  // topic length bytes
     - ((p->_packet.fixedHeader.packetType & (HeaderFlag.PUBLISH_QOS1 | HeaderFlag.PUBLISH_QOS2)) ? 2 : 0);
-  if (p->_packet.variableHeader.topicLength <= maxTopicLength) {
+  if (0 < p->_packet.variableHeader.topicLength && p->_packet.variableHeader.topicLength <= maxTopicLength) {
     p->_parse = _varHeaderTopic;
     p->_bytePos = 0;
     p->_packet.payload.total = p->_packet.fixedHeader.remainingLength.remainingLength - 2 - p->_packet.variableHeader.topicLength;
@@ -266,10 +276,15 @@ ParserResult Parser::_varHeaderTopicLength2(Parser* p) {
 
 ParserResult Parser::_varHeaderTopic(Parser* p) {
   // no checking for character [MQTT-3.3.2-1] [MQTT-3.3.2-2]
-  p->_packet.variableHeader.topic[p->_bytePos] = static_cast<char>(p->_data[p->_bytesRead]);
-  p->_bytePos++;
-  if (p->_bytePos == p->_packet.variableHeader.topicLength || p->_bytePos == EMC_MAX_TOPIC_LENGTH) {
-    p->_packet.variableHeader.topic[p->_bytePos] = 0x00;  // add c-string delimiter
+  // copy all topic bytes available in the buffer at once, bytes beyond EMC_MAX_TOPIC_LENGTH are skipped
+  size_t length = std::min(p->_len - p->_bytesRead, p->_packet.variableHeader.topicLength - p->_bytePos);
+  if (p->_bytePos < EMC_MAX_TOPIC_LENGTH) {
+    memcpy(&p->_packet.variableHeader.topic[p->_bytePos], &p->_data[p->_bytesRead], std::min(length, EMC_MAX_TOPIC_LENGTH - p->_bytePos));
+  }
+  p->_bytePos += length;
+  p->_bytesRead += length - 1;  // compensate for increment in _parse-loop
+  if (p->_bytePos == p->_packet.variableHeader.topicLength) {
+    p->_packet.variableHeader.topic[std::min(p->_bytePos, static_cast<size_t>(EMC_MAX_TOPIC_LENGTH))] = 0x00;  // add c-string delimiter
     emc_log_i("Packet variable header topic complete");
     if (p->_packet.fixedHeader.packetType & (HeaderFlag.PUBLISH_QOS1 | HeaderFlag.PUBLISH_QOS2)) {
       p->_parse = _varHeaderPacketId1;
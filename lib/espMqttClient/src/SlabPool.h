@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2022 Bert Melis. All rights reserved.
+
+This work is licensed under the terms of the MIT license.  
+For a copy, see <https://opensource.org/licenses/MIT> or
+the LICENSE file.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>  // size_t
+
+#include "MemoryPool/src/MemoryPool.h"
+#include "TypeDefs.h"
+
+namespace espMqttClientInternals {
+
+/**
+ * @brief Fixed size block pool that keeps occupancy statistics
+ *
+ * malloc() returns nullptr when the pool is exhausted, the caller then falls back to the heap.
+ * free() only releases blocks that belong to the pool and returns false otherwise.
+ */
+
+template <size_t nrBlocks, size_t blocksize>
+class SlabPool {
+ public:
+  SlabPool()
+  : _pool()
+  , _used(0)
+  , _highWater(0)
+  , _fallbacks(0) {}
+
+  void* malloc() {
+    void* ptr = _pool.malloc();
+    if (!ptr) {
+      ++_fallbacks;
+      return nullptr;
+    }
+    size_t used = ++_used;
+    size_t highWater = _highWater;
+    while (used > highWater && !_highWater.compare_exchange_weak(highWater, used)) {}
+    return ptr;
+  }
+
+  bool free(void* ptr) {
+    if (!_pool.contains(ptr)) return false;
+    _pool.free(ptr);
+    --_used;
+    return true;
+  }
+
+  // allocation that doesn't fit any pool and is served by the heap
+  void countFallback() {
+    ++_fallbacks;
+  }
+
+  void stats(espMqttClientTypes::PoolStats* stats) const {
+    stats->blockSize = blocksize;
+    stats->blocks = nrBlocks;
+    stats->used = _used;
+    stats->highWater = _highWater;
+    stats->fallbacks = _fallbacks;
+  }
+
+ private:
+  MemoryPool::Fixed<nrBlocks, blocksize> _pool;
+  std::atomic<size_t> _used;
+  std::atomic<size_t> _highWater;
+  std::atomic<size_t> _fallbacks;
+};
+
+}  // end namespace espMqttClientInternals
@@ -44,11 +44,32 @@ enum class Error : uint8_t {
   OUT_OF_MEMORY = 1,
   MAX_RETRIES = 2,
   MALFORMED_PARAMETER = 3,
-  MISC_ERROR = 4
+  MISC_ERROR = 4,
+  OUTBOX_FULL = 5
 };
 
 const char* errorToString(Error error);
 
+// Admission class of a PUBLISH when the outbox has a byte budget
+enum class Priority : uint8_t {
+  BACKGROUND = 0,  // may use half of the budget
+  NORMAL = 1,      // may use 80% of the budget
+  CRITICAL = 2     // may use the full budget
+};
+
+struct Subscription {
+  const char* topic;
+  uint8_t qos;
+};
+
+struct PoolStats {
+  size_t blockSize;
+  size_t blocks;
+  size_t used;
+  size_t highWater;
+  size_t fallbacks;  // allocations served by the heap because the pool was full or the size didn't fit
+};
+
 struct MessageProperties {
   uint8_t qos;
   bool dup;
@@ -63,6 +84,7 @@ typedef std::function<void(uint16_t packetId)> OnUnsubscribeCallback;
 typedef std::function<void(const MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total)> OnMessageCallback;
 typedef std::function<void(uint16_t packetId)> OnPublishCallback;
 typedef std::function<size_t(uint8_t* data, size_t maxSize, size_t index)> PayloadCallback;
+typedef std::function<size_t(uint8_t* data, size_t length)> PayloadWriter;
 typedef std::function<void(uint16_t packetId, Error error)> OnErrorCallback;
 
 enum class UseInternalTask {
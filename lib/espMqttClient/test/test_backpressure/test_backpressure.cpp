@@ -0,0 +1,182 @@
+#include <unity.h>
+#include <string>
+#include <espMqttClient.h>  // espMqttClient for Linux also defines millis()
+
+using espMqttClientTypes::Priority;
+using espMqttClientTypes::Error;
+
+void setUp() {}
+void tearDown() {}
+
+/*
+
+Transport that accepts the connection and answers CONNECT with a CONNACK.
+While stalled, nothing can be written so the outbox only grows.
+
+*/
+class FakeTransport : public espMqttClientInternals::Transport {
+ public:
+  bool connect(IPAddress ip, uint16_t port) override {
+    (void) ip;
+    (void) port;
+    _connected = true;
+    return true;
+  }
+  bool connect(const char* host, uint16_t port) override {
+    (void) host;
+    (void) port;
+    _connected = true;
+    return true;
+  }
+  size_t write(const uint8_t* buf, size_t size) override {
+    if (stalled) return 0;
+    if (written.empty() && size > 0 && buf[0] == 0x10) _connackPending = true;
+    written.append(reinterpret_cast<const char*>(buf), size);
+    return size;
+  }
+  int read(uint8_t* buf, size_t size) override {
+    if (!_connackPending || size < 4) return 0;
+    _connackPending = false;
+    const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+    memcpy(buf, connack, sizeof(connack));
+    return sizeof(connack);
+  }
+  void stop() override {
+    _connected = false;
+  }
+  bool connected() override {
+    return _connected;
+  }
+  bool disconnected() override {
+    return !_connected;
+  }
+
+  bool stalled = false;
+  std::string written;
+
+ private:
+  bool _connected = false;
+  bool _connackPending = false;
+};
+
+class FakeClient : public MqttClientSetup<FakeClient> {
+ public:
+  FakeClient()
+  : MqttClientSetup(espMqttClientTypes::UseInternalTask::NO)
+  , transport()
+  , lastError(Error::SUCCESS) {
+    _transport = &transport;
+    _onErrorCallback = [this](uint16_t packetId, Error error) {
+      (void) packetId;
+      lastError = error;
+    };
+  }
+
+  FakeTransport transport;
+  Error lastError;
+};
+
+const uint8_t payload[20] = {0};
+
+void connectClient(FakeClient& client) {
+  client.setServer("fake", 1883);
+  client.connect();
+  for (int i = 0; i < 10 && !client.connected(); ++i) {
+    client.loop();
+  }
+  TEST_ASSERT_TRUE(client.connected());
+}
+
+size_t fill(FakeClient& client, const char* topic, Priority priority) {
+  size_t accepted = 0;
+  while (client.publish(topic, 0, false, payload, sizeof(payload), priority) != 0) {
+    ++accepted;
+    TEST_ASSERT_LESS_THAN_UINT32(100, accepted);
+  }
+  return accepted;
+}
+
+/*
+
+- without budget, the outbox is never congested
+
+*/
+void test_noBudget() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  for (int i = 0; i < 20; ++i) {
+    TEST_ASSERT_NOT_EQUAL(0, client.publish("telemetry", 0, false, payload, sizeof(payload), Priority::BACKGROUND));
+  }
+  TEST_ASSERT_FALSE(client.congested(Priority::BACKGROUND));
+  TEST_ASSERT_GREATER_THAN_UINT32(20 * sizeof(payload), client.outboxBytes());
+}
+
+/*
+
+- stall the transport and flood the outbox with each priority class
+- lower classes are refused first, the outbox never exceeds the budget
+- high priority messages still get in and go out once the transport drains
+
+*/
+void test_saturate() {
+  FakeClient client;
+  client.setOutboxBudget(400);
+  connectClient(client);
+  TEST_ASSERT_EQUAL_UINT32(0, client.outboxBytes());
+  client.transport.stalled = true;
+
+  size_t telemetry = fill(client, "telemetry", Priority::BACKGROUND);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, telemetry);
+  TEST_ASSERT_TRUE(client.congested(Priority::BACKGROUND));
+  TEST_ASSERT_FALSE(client.congested(Priority::CRITICAL));
+  TEST_ASSERT_LESS_THAN_UINT32(200 + 40, client.outboxBytes());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(Error::OUTBOX_FULL), static_cast<uint8_t>(client.lastError));
+
+  size_t config = fill(client, "config", Priority::NORMAL);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, config);
+  TEST_ASSERT_TRUE(client.congested(Priority::NORMAL));
+  TEST_ASSERT_LESS_THAN_UINT32(320 + 40, client.outboxBytes());
+
+  size_t state = fill(client, "lock/state", Priority::CRITICAL);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, state);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(400, client.outboxBytes());
+  TEST_ASSERT_EQUAL(0, client.publish("telemetry", 0, false, payload, sizeof(payload), Priority::BACKGROUND));
+
+  client.transport.stalled = false;
+  client.transport.written.clear();
+  for (int i = 0; i < 50 && client.outboxBytes() > 0; ++i) {
+    client.loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, client.outboxBytes());
+  TEST_ASSERT_FALSE(client.congested(Priority::BACKGROUND));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, client.transport.written.find("lock/state"));
+  TEST_ASSERT_EQUAL_UINT32(0, client.queueSize());
+}
+
+/*
+
+- bytes of packets dropped from the queue are released from the budget
+
+*/
+void test_clearQueue() {
+  FakeClient client;
+  client.setOutboxBudget(400);
+  connectClient(client);
+  client.transport.stalled = true;
+
+  fill(client, "config", Priority::NORMAL);
+  TEST_ASSERT_TRUE(client.congested(Priority::NORMAL));
+  client.clearQueue(true);
+  TEST_ASSERT_EQUAL_UINT32(0, client.outboxBytes());
+  TEST_ASSERT_FALSE(client.congested(Priority::BACKGROUND));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_noBudget);
+  RUN_TEST(test_saturate);
+  RUN_TEST(test_clearQueue);
+  return UNITY_END();
+}
@@ -1,6 +1,7 @@
 #include <unity.h>
 #include <thread>
 #include <iostream>
+#include <string>
 #include <espMqttClient.h>  // espMqttClient for Linux also defines millis()
 
 void setUp() {}
@@ -108,6 +109,40 @@ void test_subscribe() {
 
 /*
 
+- subscribe to a runtime list of topics in one packet
+- one SUBACK with a return code per topic is received
+
+*/
+void test_subscribe_list() {
+  std::atomic<bool> subscribeTest(false);
+  mqttClient.onSubscribe([&](uint16_t packetId, const espMqttClientTypes::SubscribeReturncode* returncodes, size_t len) mutable {
+    (void) packetId;
+    if (len == 3 &&
+        returncodes[0] == espMqttClientTypes::SubscribeReturncode::QOS0 &&
+        returncodes[1] == espMqttClientTypes::SubscribeReturncode::QOS1 &&
+        returncodes[2] == espMqttClientTypes::SubscribeReturncode::QOS0) {
+      subscribeTest = true;
+    }
+  }, onSubscribeCbId);
+  const espMqttClientTypes::Subscription subscriptions[] = {{"test/list1", 0}, {"test/list2", 1}, {"test/list3", 0}};
+  TEST_ASSERT_EQUAL_UINT16(0, mqttClient.subscribe(subscriptions, 0));
+  TEST_ASSERT_NOT_EQUAL(0, mqttClient.subscribe(subscriptions, 3));
+  uint32_t start = millis();
+  while (millis() - start < 2000) {
+    if (subscribeTest) {
+      break;
+    }
+    std::this_thread::yield();
+  }
+
+  TEST_ASSERT_TRUE(mqttClient.connected());
+  TEST_ASSERT_TRUE(subscribeTest);
+
+  mqttClient.removeOnSubscribe(onSubscribeCbId);
+}
+
+/*
+
 - client publishes using all three qos levels
 - all publish get packetID returned > 0 (equal to 1 for qos 0)
 - 2 pubacks are received
@@ -186,6 +221,50 @@ void test_publish_empty() {
 
 /*
 
+- client publishes with a payload writer at qos 1
+- the payload is written into the packet and acknowledged like a regular publish
+
+*/
+void test_publish_writer() {
+  std::atomic<int> publishSendWriterTest(0);
+  mqttClient.onPublish([&](uint16_t packetId) mutable {
+    (void) packetId;
+    publishSendWriterTest++;
+  }, onPublishCbId);
+  std::atomic<int> publishReceiveWriterTest(0);
+  std::string payloadWriterTest;
+  mqttClient.onMessage([&](const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total) mutable {
+    (void) properties;
+    (void) topic;
+    (void) index;
+    (void) total;
+    payloadWriterTest.assign(reinterpret_cast<const char*>(payload), len);
+    publishReceiveWriterTest++;
+  }, onMessageCbId);
+  uint16_t sendQos1Test = mqttClient.publish("test/test", 1, false, [](uint8_t* data, size_t length) {
+    memcpy(data, "writer", length);
+    return length;
+  }, 6);
+  uint32_t start = millis();
+  while (millis() - start < 3000) {
+    if (publishSendWriterTest == 1 && publishReceiveWriterTest == 1) {
+      break;
+    }
+    std::this_thread::yield();
+  }
+
+  TEST_ASSERT_TRUE(mqttClient.connected());
+  TEST_ASSERT_GREATER_THAN_UINT16(0, sendQos1Test);
+  TEST_ASSERT_EQUAL_INT(1, publishSendWriterTest);
+  TEST_ASSERT_EQUAL_INT(1, publishReceiveWriterTest);
+  TEST_ASSERT_EQUAL_STRING("writer", payloadWriterTest.c_str());
+
+  mqttClient.removeOnPublish(onPublishCbId);
+  mqttClient.removeOnMessage(onMessageCbId);
+}
+
+/*
+
 - subscribe to test/test, qos 1
 - send to test/test, qos 1
 - check if message is received at least once.
@@ -391,8 +470,10 @@ int main() {
   RUN_TEST(test_connect);
   RUN_TEST(test_ping);
   RUN_TEST(test_subscribe);
+  RUN_TEST(test_subscribe_list);
   RUN_TEST(test_publish);
   RUN_TEST(test_publish_empty);
+  RUN_TEST(test_publish_writer);
   RUN_TEST(test_receive1);
   RUN_TEST(test_receive2);
   RUN_TEST(test_unsubscribe);
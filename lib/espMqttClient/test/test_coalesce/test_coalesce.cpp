@@ -0,0 +1,275 @@
+#include <unity.h>
+#include <string>
+#include <espMqttClient.h>  // espMqttClient for Linux also defines millis()
+
+void setUp() {}
+void tearDown() {}
+
+/*
+
+Transport that accepts the connection and answers CONNECT with a CONNACK.
+While stalled, nothing can be written so packets stay queued.
+
+*/
+class FakeTransport : public espMqttClientInternals::Transport {
+ public:
+  bool connect(IPAddress ip, uint16_t port) override {
+    (void) ip;
+    (void) port;
+    _connected = true;
+    return true;
+  }
+  bool connect(const char* host, uint16_t port) override {
+    (void) host;
+    (void) port;
+    _connected = true;
+    return true;
+  }
+  size_t write(const uint8_t* buf, size_t size) override {
+    if (stalled) return 0;
+    if (written.empty() && size > 0 && buf[0] == 0x10) _connackPending = true;
+    written.append(reinterpret_cast<const char*>(buf), size);
+    return size;
+  }
+  int read(uint8_t* buf, size_t size) override {
+    if (!_connackPending || size < 4) return 0;
+    _connackPending = false;
+    const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+    memcpy(buf, connack, sizeof(connack));
+    return sizeof(connack);
+  }
+  void stop() override {
+    _connected = false;
+  }
+  bool connected() override {
+    return _connected;
+  }
+  bool disconnected() override {
+    return !_connected;
+  }
+
+  bool stalled = false;
+  std::string written;
+
+ private:
+  bool _connected = false;
+  bool _connackPending = false;
+};
+
+class FakeClient : public MqttClientSetup<FakeClient> {
+ public:
+  FakeClient()
+  : MqttClientSetup(espMqttClientTypes::UseInternalTask::NO)
+  , transport() {
+    _transport = &transport;
+  }
+
+  FakeTransport transport;
+};
+
+void connectClient(FakeClient& client) {
+  client.setServer("fake", 1883);
+  client.connect();
+  for (int i = 0; i < 10 && !client.connected(); ++i) {
+    client.loop();
+  }
+  TEST_ASSERT_TRUE(client.connected());
+  client.transport.written.clear();
+}
+
+void drain(FakeClient& client) {
+  client.transport.stalled = false;
+  for (int i = 0; i < 10; ++i) {
+    client.loop();
+  }
+}
+
+size_t count(const std::string& haystack, const char* needle) {
+  size_t n = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+/*
+
+- without coalesce, every publish is queued and sent
+
+*/
+void test_disabled() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  client.publish("lock/json", 0, true, "state-1");
+  client.publish("lock/json", 0, true, "state-2");
+  client.publish("lock/json", 0, true, "state-3");
+  TEST_ASSERT_EQUAL_UINT32(3, client.queueSize());
+
+  drain(client);
+  TEST_ASSERT_EQUAL_UINT32(3, count(client.transport.written, "lock/json"));
+}
+
+/*
+
+- a queued retained publish is superseded by the next one on the same topic
+- other topics, non-retained publishes and other QoS are not touched
+
+*/
+void test_supersede() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  TEST_ASSERT_EQUAL_UINT16(1, client.publish("lock/json", 0, true, "state-1", espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT16(1, client.publish("lock/state", 0, true, "locked", espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT16(1, client.publish("lock/json", 0, true, "state-2", espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT16(1, client.publish("lock/json", 0, true, "state-3-longer", espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT16(1, client.publish("lock/json", 0, false, "event", espMqttClientTypes::Priority::NORMAL, true));
+  uint16_t packetId = client.publish("lock/json", 1, true, "qos-1", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_NOT_EQUAL(0, packetId);
+  TEST_ASSERT_EQUAL_UINT16(packetId, client.publish("lock/json", 1, true, "qos-2", espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT32(4, client.queueSize());
+
+  drain(client);
+  const std::string& written = client.transport.written;
+  TEST_ASSERT_EQUAL_UINT32(3, count(written, "lock/json"));
+  TEST_ASSERT_EQUAL_UINT32(0, count(written, "state-1"));
+  TEST_ASSERT_EQUAL_UINT32(0, count(written, "state-2"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "state-3-longer"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "event"));
+  TEST_ASSERT_EQUAL_UINT32(0, count(written, "qos-1"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "qos-2"));
+  // order is kept: the superseded packet stays in front of the later topic
+  TEST_ASSERT_TRUE(written.find("state-3-longer") < written.find("locked"));
+}
+
+/*
+
+- a publish with a payload writer supersedes the queued packet as well
+
+*/
+void test_supersedeWriter() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  client.publish("lock/json", 0, true, "state-1", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_EQUAL_UINT16(1, client.publish("lock/json", 0, true, [](uint8_t* data, size_t length) {
+    memcpy(data, "state-2", length);
+    return length;
+  }, 7, espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT32(1, client.queueSize());
+
+  drain(client);
+  TEST_ASSERT_EQUAL_UINT32(0, count(client.transport.written, "state-1"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(client.transport.written, "state-2"));
+}
+
+/*
+
+- packets that went out (awaiting acknowledgement) are never modified
+
+*/
+void test_sentNotSuperseded() {
+  FakeClient client;
+  connectClient(client);
+
+  uint16_t first = client.publish("lock/json", 1, true, "sent", espMqttClientTypes::Priority::NORMAL, true);
+  drain(client);
+  TEST_ASSERT_EQUAL_UINT32(1, count(client.transport.written, "sent"));
+
+  uint16_t second = client.publish("lock/json", 1, true, "queued", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_NOT_EQUAL(0, second);
+  TEST_ASSERT_NOT_EQUAL(first, second);
+  TEST_ASSERT_EQUAL_UINT32(2, client.queueSize());
+}
+
+/*
+
+- the outbox byte count follows the payload size of the superseded packet
+
+*/
+void test_outboxBytes() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  client.publish("lock/json", 0, true, "12345", espMqttClientTypes::Priority::NORMAL, true);
+  size_t before = client.outboxBytes();
+  client.publish("lock/json", 0, true, "1234567890", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_EQUAL_UINT32(before + 5, client.outboxBytes());
+  client.publish("lock/json", 0, true, "1", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_EQUAL_UINT32(before - 4, client.outboxBytes());
+
+  drain(client);
+  TEST_ASSERT_EQUAL_UINT32(0, client.outboxBytes());
+}
+
+/*
+
+- coalescing is per publish: a queued coalesced packet is not replaced by a publish without coalesce
+  and a packet published without coalesce is not replaced by a coalesced one
+
+*/
+void test_perPublish() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  client.publish("lock/rollingLog", 1, true, "entry-1");
+  client.publish("lock/rollingLog", 1, true, "entry-2");
+  client.publish("lock/json", 1, true, "state-1", espMqttClientTypes::Priority::NORMAL, true);
+  client.publish("lock/json", 1, true, "state-2");
+  client.publish("lock/rollingLog", 1, true, "entry-3", espMqttClientTypes::Priority::NORMAL, true);
+  client.publish("lock/json", 1, true, "state-3", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_EQUAL_UINT32(5, client.queueSize());
+
+  drain(client);
+  const std::string& written = client.transport.written;
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "entry-1"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "entry-2"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "entry-3"));
+  TEST_ASSERT_EQUAL_UINT32(0, count(written, "state-1"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "state-2"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "state-3"));
+}
+
+/*
+
+- a packet that was superseded and then sent is replaced by a new packet, the tag follows the packet
+
+*/
+void test_supersedeAfterSend() {
+  FakeClient client;
+  connectClient(client);
+  client.transport.stalled = true;
+
+  client.publish("lock/json", 1, true, "state-1", espMqttClientTypes::Priority::NORMAL, true);
+  client.publish("lock/json", 1, true, "state-2", espMqttClientTypes::Priority::NORMAL, true);
+  drain(client);
+  client.transport.stalled = true;
+
+  uint16_t packetId = client.publish("lock/json", 1, true, "state-3", espMqttClientTypes::Priority::NORMAL, true);
+  TEST_ASSERT_EQUAL_UINT16(packetId, client.publish("lock/json", 1, true, "state-4", espMqttClientTypes::Priority::NORMAL, true));
+  TEST_ASSERT_EQUAL_UINT32(2, client.queueSize());
+
+  drain(client);
+  const std::string& written = client.transport.written;
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "state-2"));
+  TEST_ASSERT_EQUAL_UINT32(0, count(written, "state-3"));
+  TEST_ASSERT_EQUAL_UINT32(1, count(written, "state-4"));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled);
+  RUN_TEST(test_supersede);
+  RUN_TEST(test_supersedeWriter);
+  RUN_TEST(test_sentNotSuperseded);
+  RUN_TEST(test_outboxBytes);
+  RUN_TEST(test_perPublish);
+  RUN_TEST(test_supersedeAfterSend);
+  return UNITY_END();
+}
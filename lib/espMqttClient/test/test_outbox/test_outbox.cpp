@@ -1,9 +1,23 @@
 #include <unity.h>
+#include <chrono>
+#include <vector>
+#include <stdio.h>
 
+// the benchmark below keeps up to 1000 packets in flight
+#define EMC_NUM_POOL_ELEMENTS 1024
 #include <Outbox.h>
 
 using espMqttClientInternals::Outbox;
 
+struct Item {
+  explicit Item(uint16_t i) : id(i) {}
+  uint16_t id;
+};
+
+struct ItemKey {
+  static uint32_t get(const Item& item) { return item.id; }
+};
+
 void setUp() {}
 void tearDown() {}
 
@@ -159,6 +173,165 @@ void test_outbox_removeCurrent() {
   // Valgrind should not detect a leak here
 }
 
+void test_outbox_find() {
+  Outbox<Item, ItemKey> outbox;
+  outbox.emplace(1);
+  outbox.emplace(0);  // not indexed
+  outbox.emplace(2);
+  outbox.emplace(3);
+
+  Outbox<Item, ItemKey>::Iterator it = outbox.find(2);
+  TEST_ASSERT_NOT_NULL(it.get());
+  TEST_ASSERT_EQUAL_UINT16(2, it.get()->id);
+  outbox.remove(it);
+  // 1 0 3, it points to 3
+  TEST_ASSERT_NOT_NULL(it.get());
+  TEST_ASSERT_EQUAL_UINT16(3, it.get()->id);
+
+  TEST_ASSERT_NULL(outbox.find(2).get());
+  TEST_ASSERT_NULL(outbox.find(0).get());
+  TEST_ASSERT_NULL(outbox.find(4).get());
+
+  it = outbox.find(3);
+  outbox.remove(it);
+  // 1 0
+  TEST_ASSERT_NULL(it.get());
+  outbox.emplace(4);
+  it = outbox.find(1);
+  outbox.remove(it);
+  // 0 4
+  TEST_ASSERT_NOT_NULL(it.get());
+  TEST_ASSERT_EQUAL_UINT16(0, it.get()->id);
+  TEST_ASSERT_NOT_NULL(outbox.find(4).get());
+  TEST_ASSERT_EQUAL_UINT16(0, outbox.front().get()->id);
+  TEST_ASSERT_EQUAL_size_t(2, outbox.size());
+}
+
+void test_outbox_findCollisions() {
+  // keys are spread over the whole table so probe sequences wrap and collide
+  Outbox<Item, ItemKey> outbox;
+  for (uint16_t i = 1; i <= 500; ++i) {
+    outbox.emplace(static_cast<uint16_t>(i * 131));
+  }
+  for (uint16_t i = 1; i <= 500; i += 2) {
+    Outbox<Item, ItemKey>::Iterator it = outbox.find(static_cast<uint16_t>(i * 131));
+    TEST_ASSERT_NOT_NULL(it.get());
+    outbox.remove(it);
+  }
+  for (uint16_t i = 1; i <= 500; ++i) {
+    Item* item = outbox.find(static_cast<uint16_t>(i * 131)).get();
+    if (i % 2) {
+      TEST_ASSERT_NULL(item);
+    } else {
+      TEST_ASSERT_NOT_NULL(item);
+      TEST_ASSERT_EQUAL_UINT16(static_cast<uint16_t>(i * 131), item->id);
+    }
+  }
+  TEST_ASSERT_EQUAL_size_t(250, outbox.size());
+}
+
+void test_outbox_tags() {
+  // items share tags, lookups pick the first one the predicate accepts
+  Outbox<Item, ItemKey> outbox;
+  for (uint16_t i = 1; i <= 300; ++i) {
+    Outbox<Item, ItemKey>::Iterator it = outbox.emplace(i);
+    outbox.tag(it, i % 3);  // tag 0 is not indexed
+  }
+
+  Outbox<Item, ItemKey>::Iterator it = outbox.findTagged(2, [](const Item& item) { return item.id == 152; });
+  TEST_ASSERT_NOT_NULL(it.get());
+  TEST_ASSERT_EQUAL_UINT16(152, it.get()->id);
+  TEST_ASSERT_NULL(outbox.findTagged(2, [](const Item& item) { return item.id == 153; }).get());
+  TEST_ASSERT_NULL(outbox.findTagged(0, [](const Item&) { return true; }).get());
+
+  // removed items leave the tag index
+  outbox.remove(it);
+  TEST_ASSERT_NULL(outbox.findTagged(2, [](const Item& item) { return item.id == 152; }).get());
+  size_t tagged = 0;
+  for (uint16_t i = 1; i <= 300; ++i) {
+    if (outbox.findTagged(1, [i](const Item& item) { return item.id == i; })) ++tagged;
+  }
+  TEST_ASSERT_EQUAL_size_t(100, tagged);
+
+  // retagging moves the item, the packet id index is not affected
+  it = outbox.find(4);
+  outbox.tag(it, 7);
+  TEST_ASSERT_NULL(outbox.findTagged(1, [](const Item& item) { return item.id == 4; }).get());
+  TEST_ASSERT_NOT_NULL(outbox.findTagged(7, [](const Item& item) { return item.id == 4; }).get());
+  TEST_ASSERT_NOT_NULL(outbox.find(4).get());
+  TEST_ASSERT_EQUAL_size_t(299, outbox.size());
+}
+
+/*
+- keep n packets in flight
+- acknowledge them newest first, which is the worst case for a linear scan
+*/
+static uint16_t nextPacketId(uint16_t id) {
+  return id == 0xFFFF ? 1 : id + 1;
+}
+
+static void benchmarkAcks(size_t inFlight) {
+  Outbox<Item, ItemKey>* outbox = new Outbox<Item, ItemKey>;
+  std::vector<uint16_t> ids(inFlight);
+  const size_t totalAcks = 20000;
+  size_t acks = 0;
+  size_t scanned = 0;
+  uint16_t id = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  while (acks < totalAcks) {
+    for (size_t i = 0; i < inFlight; ++i) {
+      id = nextPacketId(id);
+      ids[i] = id;
+      outbox->emplace(id);
+    }
+    for (size_t i = inFlight; i > 0; --i) {
+      Outbox<Item, ItemKey>::Iterator it = outbox->find(ids[i - 1]);
+      TEST_ASSERT_NOT_NULL(it.get());
+      outbox->remove(it);
+      ++acks;
+    }
+  }
+  std::chrono::steady_clock::duration indexed = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  acks = 0;
+  while (acks < totalAcks) {
+    for (size_t i = 0; i < inFlight; ++i) {
+      id = nextPacketId(id);
+      ids[i] = id;
+      outbox->emplace(id);
+    }
+    for (size_t i = inFlight; i > 0; --i) {
+      Outbox<Item, ItemKey>::Iterator it = outbox->front();
+      while (it && it.get()->id != ids[i - 1]) {
+        ++it;
+        ++scanned;
+      }
+      TEST_ASSERT_NOT_NULL(it.get());
+      outbox->remove(it);
+      ++acks;
+    }
+  }
+  std::chrono::steady_clock::duration linear = std::chrono::steady_clock::now() - start;
+  TEST_ASSERT_TRUE(outbox->empty());
+  delete outbox;
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%4zu in flight: indexed %6.1f ns/ack, linear scan %8.1f ns/ack (%zu nodes visited)",
+           inFlight,
+           std::chrono::duration<double, std::nano>(indexed).count() / totalAcks,
+           std::chrono::duration<double, std::nano>(linear).count() / totalAcks,
+           scanned);
+  TEST_MESSAGE(msg);
+}
+
+void test_outbox_benchmark() {
+  benchmarkAcks(10);
+  benchmarkAcks(100);
+  benchmarkAcks(1000);
+}
+
 int main() {
   UNITY_BEGIN();
   RUN_TEST(test_outbox_create);
@@ -167,5 +340,9 @@ int main() {
   RUN_TEST(test_outbox_remove1);
   RUN_TEST(test_outbox_remove2);
   RUN_TEST(test_outbox_removeCurrent);
+  RUN_TEST(test_outbox_find);
+  RUN_TEST(test_outbox_findCollisions);
+  RUN_TEST(test_outbox_tags);
+  RUN_TEST(test_outbox_benchmark);
   return UNITY_END();
 }
@@ -263,6 +263,76 @@ void test_encodePublish1() {
   TEST_ASSERT_EQUAL_UINT8_ARRAY(checkDup, packet.data(0), length);
 }
 
+void test_encodePublishWriter() {
+  const uint8_t check[] = {
+    0b00110011,                 // header, dup, qos, retain
+    0x0B,
+    0x00,0x03,'t','o','p',      // topic
+    0x00,0x16,                  // packet Id
+    0x01,0x02,0x03,0x04         // payload
+  };
+  const uint32_t length = 13;
+
+  const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04};
+  espMqttClientTypes::Error error = espMqttClientTypes::Error::MISC_ERROR;
+  espMqttClientTypes::PayloadWriter writer = [&](uint8_t* data, size_t len) {
+    memcpy(data, payload, len);
+    return len;
+  };
+
+  Packet packet(error, 22, "top", writer, 4, 1, true);
+
+  TEST_ASSERT_EQUAL_UINT8(espMqttClientTypes::Error::SUCCESS, error);
+  TEST_ASSERT_EQUAL_UINT32(length, packet.size());
+  TEST_ASSERT_EQUAL_UINT32(length, packet.available(0));
+  TEST_ASSERT_FALSE(packet.removable());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(check, packet.data(0), length);
+
+  // payload stays in the packet, a retransmission only sets the dup flag
+  packet.setDup();
+  TEST_ASSERT_EQUAL_UINT8(0b00111011, packet.data(0)[0]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&check[1], packet.data(1), length - 1);
+
+  espMqttClientTypes::PayloadWriter shortWriter = [](uint8_t* data, size_t len) {
+    (void) data;
+    return len - 1;
+  };
+  Packet shortPacket(error, 23, "top", shortWriter, 4, 1, true);
+  TEST_ASSERT_EQUAL_UINT8(espMqttClientTypes::Error::MALFORMED_PARAMETER, error);
+}
+
+void test_replacePublishPayload() {
+  const uint8_t check[] = {
+    0b00110011,                 // header, dup, qos, retain
+    0x0A,
+    0x00,0x03,'t','o','p',      // topic
+    0x00,0x16,                  // packet Id
+    0x05,0x06,0x07              // payload
+  };
+  const uint32_t length = 12;
+
+  const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04};
+  const uint8_t newPayload[] = {0x05, 0x06, 0x07};
+  espMqttClientTypes::Error error = espMqttClientTypes::Error::MISC_ERROR;
+
+  Packet packet(error, 22, "top", payload, 4, 1, true);
+
+  TEST_ASSERT_EQUAL_UINT8(espMqttClientTypes::Error::SUCCESS, error);
+  TEST_ASSERT_TRUE(packet.supersedable("top", 1, true));
+  TEST_ASSERT_FALSE(packet.supersedable("top", 1, false));
+  TEST_ASSERT_FALSE(packet.supersedable("top", 0, true));
+  TEST_ASSERT_FALSE(packet.supersedable("to", 1, true));
+  TEST_ASSERT_FALSE(packet.supersedable("topi", 1, true));
+
+  TEST_ASSERT_TRUE(packet.replacePayload(newPayload, 3));
+  TEST_ASSERT_EQUAL_UINT32(length, packet.size());
+  TEST_ASSERT_EQUAL_UINT16(22, packet.packetId());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(check, packet.data(0), length);
+
+  packet.setDup();
+  TEST_ASSERT_FALSE(packet.supersedable("top", 1, true));
+}
+
 void test_encodePublish2() {
   const uint8_t check[] = {
     0b00110101,                 // header, dup, qos, retain
@@ -479,6 +549,33 @@ void test_encodeMultiSubscribe3() {
   TEST_ASSERT_EQUAL_UINT16(packetId, packet.packetId());
 }
 
+void test_encodeSubscribeList() {
+  const uint8_t check[] = {
+    0b10000010,                 // header
+    0x14,                       // remaining length
+    0x00,0x16,                  // packet Id
+    0x00, 0x03, 'a', '/', 'b',  // topic1
+    0x01,                       // qos1
+    0x00, 0x03, 'c', '/', 'd',  // topic2
+    0x02,                       // qos2
+    0x00, 0x03, 'e', '/', 'f',  // topic3
+    0x00                        // qos3
+  };
+  const uint32_t length = 22;
+  const espMqttClientTypes::Subscription list[] = {{"a/b", 1}, {"c/d", 2}, {"e/f", 0}};
+  uint16_t packetId = 22;
+  espMqttClientTypes::Error error = espMqttClientTypes::Error::MISC_ERROR;
+
+  Packet packet(error, packetId, list, 3);
+
+  TEST_ASSERT_EQUAL_UINT8(espMqttClientTypes::Error::SUCCESS, error);
+  TEST_ASSERT_EQUAL_UINT32(length, packet.size());
+  TEST_ASSERT_EQUAL_UINT8(PacketType.SUBSCRIBE, packet.packetType());
+  TEST_ASSERT_FALSE(packet.removable());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(check, packet.data(0), length);
+  TEST_ASSERT_EQUAL_UINT16(packetId, packet.packetId());
+}
+
 void test_encodeUnsubscribe() {
   const uint8_t check[] = {
     0b10100010,                 // header
@@ -697,6 +794,8 @@ int main() {
   RUN_TEST(test_encodePublish0);
   RUN_TEST(test_encodePublish1);
   RUN_TEST(test_encodePublish2);
+  RUN_TEST(test_encodePublishWriter);
+  RUN_TEST(test_replacePublishPayload);
   RUN_TEST(test_encodePubAck);
   RUN_TEST(test_encodePubRec);
   RUN_TEST(test_encodePubRel);
@@ -704,6 +803,7 @@ int main() {
   RUN_TEST(test_encodeSubscribe);
   RUN_TEST(test_encodeMultiSubscribe2);
   RUN_TEST(test_encodeMultiSubscribe3);
+  RUN_TEST(test_encodeSubscribeList);
   RUN_TEST(test_encodeUnsubscribe);
   RUN_TEST(test_encodeMultiUnsubscribe2);
   RUN_TEST(test_encodeMultiUnsubscribe3);
@@ -1,4 +1,10 @@
 #include <unity.h>
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <Packets/Parser.h>
 
@@ -336,6 +342,138 @@ void test_longStream() {
   TEST_ASSERT_FALSE(parser.getPacket().dup());
 }
 
+void test_Publish_splitTopic() {
+  const uint8_t stream[] = {
+    0b00110000,                           // header
+    0x0A,                                 // remaining length
+    0x00, 0x07, 'f', 'o', 'o', '/', 'b', 'a',  // topic
+    'r', 0x01                             // topic cont'd + payload
+  };
+  const size_t lengths[] = {6, 1, 3, 2};
+
+  size_t bytesRead = 0;
+  ParserResult result = ParserResult::awaitData;
+  for (size_t i = 0; i < 4; ++i) {
+    size_t read = 0;
+    result = parser.parse(&stream[bytesRead], lengths[i], &read);
+    TEST_ASSERT_EQUAL_UINT32(lengths[i], read);
+    bytesRead += read;
+  }
+
+  TEST_ASSERT_EQUAL_INT32(ParserResult::packet, result);
+  TEST_ASSERT_EQUAL_STRING("foo/bar", parser.getPacket().variableHeader.topic);
+  TEST_ASSERT_EQUAL_UINT32(1, parser.getPacket().payload.total);
+  TEST_ASSERT_EQUAL_UINT8(0x01, parser.getPacket().payload.data[0]);
+}
+
+void test_Publish_longTopic() {
+  const size_t topicLength = EMC_MAX_TOPIC_LENGTH + 10;
+  uint8_t stream[5 + topicLength + 2];
+  stream[0] = 0b00110000;
+  stream[1] = 0x80 | ((topicLength + 4) & 0x7F);  // remaining length
+  stream[2] = (topicLength + 4) >> 7;
+  stream[3] = topicLength >> 8;
+  stream[4] = topicLength & 0xFF;
+  memset(&stream[5], 'a', topicLength);
+  stream[5 + topicLength] = 0x01;                 // payload
+  stream[6 + topicLength] = 0x02;
+
+  size_t bytesRead = 0;
+  ParserResult result = parser.parse(stream, sizeof(stream), &bytesRead);
+
+  TEST_ASSERT_EQUAL_INT32(ParserResult::packet, result);
+  TEST_ASSERT_EQUAL_UINT32(sizeof(stream), bytesRead);
+  TEST_ASSERT_EQUAL_UINT32(EMC_MAX_TOPIC_LENGTH, strlen(parser.getPacket().variableHeader.topic));
+  TEST_ASSERT_EQUAL_UINT32(2, parser.getPacket().payload.total);
+  TEST_ASSERT_EQUAL_UINT8(0x01, parser.getPacket().payload.data[0]);
+}
+
+/*
+Throughput of the parser when fed in chunks of EMC_RX_BUFFER_SIZE, like MqttClient does.
+- large retained payloads: (HA discovery) configuration messages
+- bursts of small QoS 1 publishes, each followed by an ack
+Logging is muted but still part of the measurement on Linux.
+*/
+static void appendPublish(std::vector<uint8_t>* stream, const char* topic, size_t payloadLength, uint8_t qos, bool retain, uint16_t packetId) {
+  size_t topicLength = strlen(topic);
+  size_t remainingLength = 2 + topicLength + (qos ? 2 : 0) + payloadLength;
+  stream->push_back(espMqttClientInternals::PacketType.PUBLISH | (qos << 1) | (retain ? 1 : 0));
+  do {
+    uint8_t encoded = remainingLength % 128;
+    remainingLength /= 128;
+    stream->push_back(remainingLength > 0 ? encoded | 0x80 : encoded);
+  } while (remainingLength > 0);
+  stream->push_back(topicLength >> 8);
+  stream->push_back(topicLength & 0xFF);
+  stream->insert(stream->end(), topic, topic + topicLength);
+  if (qos) {
+    stream->push_back(packetId >> 8);
+    stream->push_back(packetId & 0xFF);
+  }
+  stream->insert(stream->end(), payloadLength, 'x');
+}
+
+static void appendPuback(std::vector<uint8_t>* stream, uint16_t packetId) {
+  const uint8_t puback[] = {espMqttClientInternals::PacketType.PUBACK, 0x02, static_cast<uint8_t>(packetId >> 8), static_cast<uint8_t>(packetId & 0xFF)};
+  stream->insert(stream->end(), puback, puback + sizeof(puback));
+}
+
+static void benchmarkStream(const char* name, const std::vector<uint8_t>& stream, size_t packets) {
+  const size_t rounds = 20;
+  size_t parsed = 0;
+
+  std::cout.flush();
+  fflush(stdout);
+  int savedStdout = dup(STDOUT_FILENO);
+  int devNull = open("/dev/null", O_WRONLY);
+  dup2(devNull, STDOUT_FILENO);
+  close(devNull);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (size_t index = 0; index < stream.size(); index += EMC_RX_BUFFER_SIZE) {
+      size_t chunk = std::min(stream.size() - index, static_cast<size_t>(EMC_RX_BUFFER_SIZE));
+      size_t bytesRead = 0;
+      while (bytesRead < chunk) {
+        ParserResult result = parser.parse(&stream[index + bytesRead], chunk - bytesRead, &bytesRead);
+        if (result != ParserResult::packet) continue;
+        const IncomingPacket& packet = parser.getPacket();
+        if ((packet.fixedHeader.packetType & 0xF0) != espMqttClientInternals::PacketType.PUBLISH ||
+            packet.payload.index + packet.payload.length == packet.payload.total) {
+          ++parsed;
+        }
+      }
+    }
+  }
+  std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - start;
+
+  std::cout.flush();
+  fflush(stdout);
+  dup2(savedStdout, STDOUT_FILENO);
+  close(savedStdout);
+
+  TEST_ASSERT_EQUAL_UINT32(packets * rounds, parsed);
+  double seconds = std::chrono::duration<double>(duration).count();
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%s: %.1f MB/s, %.0f packets/s", name, stream.size() * rounds / seconds / 1e6, parsed / seconds);
+  TEST_MESSAGE(msg);
+}
+
+void test_parser_benchmark() {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < 64; ++i) {
+    appendPublish(&stream, "homeassistant/lock/nukihub/configuration", 8192, 0, true, 0);
+  }
+  benchmarkStream("large retained", stream, 64);
+
+  stream.clear();
+  for (uint16_t i = 1; i <= 1000; ++i) {
+    appendPublish(&stream, "nukihub/lock/state", 16, 1, false, i);
+    appendPuback(&stream, i);
+  }
+  benchmarkStream("small bursts", stream, 2000);
+}
+
 int main() {
   UNITY_BEGIN();
   RUN_TEST(test_Connack);
@@ -351,5 +489,8 @@ int main() {
   RUN_TEST(test_UnsubAck);
   RUN_TEST(test_PingResp);
   RUN_TEST(test_longStream);
+  RUN_TEST(test_Publish_splitTopic);
+  RUN_TEST(test_Publish_longTopic);
+  RUN_TEST(test_parser_benchmark);
   return UNITY_END();
 }
@@ -0,0 +1,191 @@
+#include <unity.h>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <espMqttClient.h>  // espMqttClient for Linux also defines millis()
+
+#ifndef EMC_SOAK_CYCLES
+#define EMC_SOAK_CYCLES 1000000
+#endif
+
+void setUp() {}
+void tearDown() {}
+
+/*
+
+Broker side of a transport: accepts the connection, answers CONNECT with CONNACK
+and acknowledges every PUBLISH (PUBACK or PUBREC) and PUBREL (PUBCOMP) it receives.
+
+*/
+class AckingTransport : public espMqttClientInternals::Transport {
+ public:
+  bool connect(IPAddress ip, uint16_t port) override {
+    (void) ip;
+    (void) port;
+    _connected = true;
+    return true;
+  }
+  bool connect(const char* host, uint16_t port) override {
+    (void) host;
+    (void) port;
+    _connected = true;
+    return true;
+  }
+  size_t write(const uint8_t* buf, size_t size) override {
+    _rx.insert(_rx.end(), buf, buf + size);
+    _parse();
+    return size;
+  }
+  int read(uint8_t* buf, size_t size) override {
+    size_t n = std::min(size, _tx.size());
+    if (n == 0) return 0;
+    memcpy(buf, _tx.data(), n);
+    _tx.erase(_tx.begin(), _tx.begin() + n);
+    return n;
+  }
+  void stop() override {
+    _connected = false;
+  }
+  bool connected() override {
+    return _connected;
+  }
+  bool disconnected() override {
+    return !_connected;
+  }
+
+ private:
+  void _parse() {
+    while (_rx.size() >= 2) {
+      size_t remainingLength = 0;
+      size_t pos = 1;
+      for (size_t shift = 0; ; shift += 7) {
+        if (pos >= _rx.size()) return;
+        remainingLength |= static_cast<size_t>(_rx[pos] & 0x7F) << shift;
+        if ((_rx[pos++] & 0x80) == 0) break;
+      }
+      if (_rx.size() < pos + remainingLength) return;
+
+      uint8_t type = _rx[0] & 0xF0;
+      uint8_t qos = (_rx[0] >> 1) & 0x03;
+      if (type == 0x10) {
+        _reply(0x20, 0x00, 0x00);  // CONNACK
+      } else if (type == 0x30 && qos > 0) {
+        size_t idPos = pos + 2 + ((static_cast<size_t>(_rx[pos]) << 8) | _rx[pos + 1]);
+        _reply(qos == 1 ? 0x40 : 0x50, _rx[idPos], _rx[idPos + 1]);  // PUBACK or PUBREC
+      } else if (type == 0x60) {
+        _reply(0x70, _rx[pos], _rx[pos + 1]);  // PUBCOMP
+      }
+      _rx.erase(_rx.begin(), _rx.begin() + pos + remainingLength);
+    }
+  }
+
+  void _reply(uint8_t type, uint8_t b1, uint8_t b2) {
+    const uint8_t packet[] = {type, 0x02, b1, b2};
+    _tx.insert(_tx.end(), packet, packet + sizeof(packet));
+  }
+
+  bool _connected = false;
+  std::vector<uint8_t> _rx;
+  std::vector<uint8_t> _tx;
+};
+
+// The library logs every packet on Linux, mute stdout while cycling
+class QuietStdout {
+ public:
+  QuietStdout() {
+    std::cout.flush();
+    fflush(stdout);
+    _saved = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+  }
+  ~QuietStdout() {
+    std::cout.flush();
+    fflush(stdout);
+    dup2(_saved, STDOUT_FILENO);
+    close(_saved);
+  }
+
+ private:
+  int _saved;
+};
+
+class SoakClient : public MqttClientSetup<SoakClient> {
+ public:
+  SoakClient()
+  : MqttClientSetup(espMqttClientTypes::UseInternalTask::NO)
+  , transport() {
+    _transport = &transport;
+  }
+
+  AckingTransport transport;
+};
+
+/*
+
+- run publish/ack cycles at all QoS levels with payloads spanning every size class
+- all pool blocks are returned, the pools never overflow for this traffic pattern
+- print occupancy, high-water marks and heap fallbacks
+
+*/
+void test_soak() {
+  #if !EMC_USE_SLAB_POOLS
+  TEST_IGNORE_MESSAGE("slab pools disabled");
+  #else
+  SoakClient client;
+  client.setServer("fake", 1883);
+  client.connect();
+  for (int i = 0; i < 10 && !client.connected(); ++i) {
+    client.loop();
+  }
+  TEST_ASSERT_TRUE(client.connected());
+
+  static uint8_t payload[EMC_SLAB_LARGE_SIZE] = {0};
+  const size_t payloadSizes[] = {0, 8, 60, 100, 400, 900};
+  uint32_t seed = 1;
+  size_t published = 0;
+
+  {
+  QuietStdout quiet;
+  for (uint32_t cycle = 0; cycle < EMC_SOAK_CYCLES; ++cycle) {
+    seed = seed * 1103515245u + 12345u;
+    size_t length = payloadSizes[(seed >> 16) % (sizeof(payloadSizes) / sizeof(payloadSizes[0]))];
+    uint8_t qos = (seed >> 8) % 3;
+    if (client.publish("soak/topic", qos, false, payload, length) != 0) ++published;
+    // queue bursts of six publishes before letting the client drain them
+    if (cycle % 6 == 5) {
+      for (int i = 0; i < 64 && client.queueSize() > 0; ++i) {
+        client.loop();
+      }
+    }
+  }
+  for (int i = 0; i < 1000 && client.queueSize() > 0; ++i) {
+    client.loop();
+  }
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(EMC_SOAK_CYCLES, published);
+  TEST_ASSERT_EQUAL_UINT32(0, client.queueSize());
+
+  espMqttClientTypes::PoolStats stats[4];
+  const char* names[] = {"small", "medium", "large", "nodes"};
+  TEST_ASSERT_EQUAL_UINT32(4, client.poolStats(stats, 4));
+  for (size_t i = 0; i < 4; ++i) {
+    char message[128];
+    snprintf(message, sizeof(message), "%-6s block %4zu: %2zu/%2zu used, high-water %2zu, heap fallbacks %zu",
+             names[i], stats[i].blockSize, stats[i].used, stats[i].blocks, stats[i].highWater, stats[i].fallbacks);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[i].used);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(stats[i].blocks, stats[i].highWater);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[i].fallbacks);
+  }
+  #endif
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_soak);
+  return UNITY_END();
+}
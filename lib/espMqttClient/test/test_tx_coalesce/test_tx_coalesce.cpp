@@ -0,0 +1,310 @@
+#include <unity.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <espMqttClient.h>  // espMqttClient for Linux also defines millis()
+
+void setUp() {}
+void tearDown() {}
+
+/*
+
+Minimal broker on the loopback interface: answers CONNECT and QoS 1 publishes and records the payload
+of every PUBLISH it receives. Accepts one connection at a time.
+
+*/
+class LoopbackBroker {
+ public:
+  LoopbackBroker()
+  : port(0)
+  , _listenFd(-1)
+  , _stop(false) {
+    _listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    ::bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    ::listen(_listenFd, 1);
+    ::getsockname(_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    _thread = std::thread(&LoopbackBroker::_run, this);
+  }
+
+  ~LoopbackBroker() {
+    _stop = true;
+    _thread.join();
+    ::close(_listenFd);
+  }
+
+  std::vector<std::string> payloads() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _payloads;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _payloads.clear();
+  }
+
+  uint16_t port;
+
+ private:
+  void _run() {
+    while (!_stop) {
+      pollfd listening = {_listenFd, POLLIN, 0};
+      if (::poll(&listening, 1, 10) <= 0) continue;
+      int fd = ::accept(_listenFd, nullptr, nullptr);
+      std::vector<uint8_t> stream;
+      while (!_stop) {
+        pollfd connection = {fd, POLLIN, 0};
+        if (::poll(&connection, 1, 10) <= 0) continue;
+        uint8_t buffer[1500];
+        ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        stream.insert(stream.end(), buffer, buffer + received);
+        _parse(fd, &stream);
+      }
+      ::close(fd);
+    }
+  }
+
+  void _parse(int fd, std::vector<uint8_t>* stream) {
+    while (stream->size() >= 2) {
+      size_t remainingLength = 0;
+      size_t pos = 1;
+      for (size_t shift = 0; ; shift += 7) {
+        if (pos >= stream->size()) return;
+        remainingLength |= static_cast<size_t>((*stream)[pos] & 0x7F) << shift;
+        if (((*stream)[pos++] & 0x80) == 0) break;
+      }
+      if (stream->size() < pos + remainingLength) return;
+
+      const uint8_t* packet = stream->data();
+      uint8_t type = packet[0] & 0xF0;
+      uint8_t qos = (packet[0] >> 1) & 0x03;
+      if (type == 0x10) {
+        const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+        ::send(fd, connack, sizeof(connack), 0);
+      } else if (type == 0x30) {
+        size_t topicEnd = pos + 2 + ((static_cast<size_t>(packet[pos]) << 8) | packet[pos + 1]);
+        size_t payloadStart = topicEnd + (qos ? 2 : 0);
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _payloads.emplace_back(reinterpret_cast<const char*>(&packet[payloadStart]), pos + remainingLength - payloadStart);
+        }
+        if (qos == 1) {
+          const uint8_t puback[] = {0x40, 0x02, packet[topicEnd], packet[topicEnd + 1]};
+          ::send(fd, puback, sizeof(puback), 0);
+        }
+      }
+      stream->erase(stream->begin(), stream->begin() + pos + remainingLength);
+    }
+  }
+
+  int _listenFd;
+  std::atomic<bool> _stop;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::vector<std::string> _payloads;
+};
+
+// tcp_info as filled by Linux, glibc's definition stops before the segment counters
+struct TcpInfoSegments {
+  struct tcp_info info;
+  uint64_t pacingRate;
+  uint64_t maxPacingRate;
+  uint64_t bytesAcked;
+  uint64_t bytesReceived;
+  uint32_t segmentsOut;
+  uint32_t segmentsIn;
+};
+
+class CountingTransport : public espMqttClientInternals::ClientPosix {
+ public:
+  size_t write(const uint8_t* buf, size_t size) override {
+    ++writes;
+    return ClientPosix::write(buf, size);
+  }
+
+  // 0 when the kernel doesn't report segment counters
+  uint32_t segmentsOut() {
+    TcpInfoSegments info;
+    memset(&info, 0, sizeof(info));
+    socklen_t length = sizeof(info);
+    if (::getsockopt(_sockfd, IPPROTO_TCP, TCP_INFO, &info, &length) != 0 || length < sizeof(info)) return 0;
+    return info.segmentsOut;
+  }
+
+  size_t writes = 0;
+};
+
+class CoalescingClient : public MqttClientSetup<CoalescingClient> {
+ public:
+  CoalescingClient()
+  : MqttClientSetup(espMqttClientTypes::UseInternalTask::NO)
+  , transport() {
+    _transport = &transport;
+  }
+
+  CountingTransport transport;
+};
+
+LoopbackBroker* broker = nullptr;
+
+static void connectClient(CoalescingClient* client) {
+  client->setServer(IPAddress(127, 0, 0, 1), broker->port);
+  client->connect();
+  uint32_t start = millis();
+  while (!client->connected() && millis() - start < 2000) {
+    client->loop();
+  }
+  TEST_ASSERT_TRUE(client->connected());
+}
+
+// loop until the broker has received the given number of publishes
+static void deliver(CoalescingClient* client, size_t publishes) {
+  uint32_t start = millis();
+  while ((client->queueSize() > 0 || broker->payloads().size() < publishes) && millis() - start < 2000) {
+    client->loop();
+    std::this_thread::yield();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, client->queueSize());
+  TEST_ASSERT_EQUAL_UINT32(publishes, broker->payloads().size());
+}
+
+static void disconnectClient(CoalescingClient* client) {
+  client->disconnect();
+  uint32_t start = millis();
+  while (!client->disconnected() && millis() - start < 2000) {
+    client->loop();
+  }
+  broker->clear();
+}
+
+/*
+
+- queue small publishes, a QoS 1 publish and one larger than the coalescing buffer
+- everything arrives in order with fewer writes than packets
+
+*/
+void test_burst() {
+  CoalescingClient client;
+  client.setTxCoalescing(256);
+  connectClient(&client);
+
+  std::vector<std::string> expected;
+  for (size_t i = 0; i < 20; ++i) {
+    expected.push_back(std::to_string(i));
+  }
+  expected.push_back(std::string(1000, 'x'));  // bypasses the buffer
+  for (size_t i = 20; i < 30; ++i) {
+    expected.push_back(std::to_string(i));
+  }
+
+  size_t writes = client.transport.writes;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    TEST_ASSERT_NOT_EQUAL(0, client.publish("test/burst", i == 5 ? 1 : 0, true, expected[i].c_str()));
+  }
+  deliver(&client, expected.size());
+  writes = client.transport.writes - writes;
+
+  std::vector<std::string> received = broker->payloads();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), received[i].c_str());
+  }
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(5, writes);
+
+  disconnectClient(&client);
+}
+
+/*
+
+- with a flush deadline, buffered packets wait for more packets until the deadline passes
+
+*/
+void test_deadline() {
+  CoalescingClient client;
+  client.setTxCoalescing(256, 50);
+  connectClient(&client);
+
+  size_t writes = client.transport.writes;
+  client.publish("test/deadline", 0, false, "1");
+  client.loop();
+  client.publish("test/deadline", 0, false, "2");
+  client.loop();
+  TEST_ASSERT_EQUAL_UINT32(writes, client.transport.writes);
+  TEST_ASSERT_EQUAL_UINT32(0, broker->payloads().size());
+
+  deliver(&client, 2);
+  TEST_ASSERT_EQUAL_UINT32(writes + 1, client.transport.writes);
+
+  disconnectClient(&client);
+}
+
+/*
+
+- a lock state change publishes a burst of up to 40 small retained topics
+- compare transport writes and TCP segments per burst with and without coalescing
+
+*/
+#if EMC_USE_MEMPOOL
+const size_t burstSize = EMC_NUM_POOL_ELEMENTS - 8;  // the memory pool limits the number of queued packets
+#else
+const size_t burstSize = 40;
+#endif
+
+static void benchmarkBurst(size_t bufferSize) {
+  const size_t bursts = 50;
+  CoalescingClient client;
+  client.setTxCoalescing(bufferSize);
+  connectClient(&client);
+
+  size_t writes = client.transport.writes;
+  uint32_t segments = client.transport.segmentsOut();
+  uint32_t start = millis();
+  for (size_t burst = 0; burst < bursts; ++burst) {
+    for (size_t i = 0; i < burstSize; ++i) {
+      char topic[64];
+      snprintf(topic, sizeof(topic), "nukihub/lock/attribute%zu", i);
+      client.publish(topic, 0, true, burst % 2 ? "locked" : "unlocked");
+    }
+    deliver(&client, (burst + 1) * burstSize);
+  }
+  uint32_t duration = millis() - start;
+  writes = client.transport.writes - writes;
+  segments = client.transport.segmentsOut() - segments;
+
+  char message[160];
+  snprintf(message, sizeof(message), "buffer %4zu: %5.1f writes/burst, %5.1f segments/burst, %u ms",
+           bufferSize, static_cast<double>(writes) / bursts, static_cast<double>(segments) / bursts, duration);
+  TEST_MESSAGE(message);
+  if (bufferSize > 0) {
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(bursts * 2, writes);
+  } else {
+    TEST_ASSERT_EQUAL_UINT32(bursts * burstSize, writes);
+  }
+
+  disconnectClient(&client);
+}
+
+void test_benchmark() {
+  benchmarkBurst(0);
+  benchmarkBurst(EMC_TX_BUFFER_SIZE > 1440 ? EMC_TX_BUFFER_SIZE : 1440);
+}
+
+int main() {
+  broker = new LoopbackBroker;
+  UNITY_BEGIN();
+  RUN_TEST(test_burst);
+  RUN_TEST(test_deadline);
+  RUN_TEST(test_benchmark);
+  int result = UNITY_END();
+  delete broker;
+  return result;
+}
@@ -0,0 +1,107 @@
+#include "ActionLatency.h"
+#include <cstdio>
+
+ActionLatency::ActionLatency(const char* const* actionNames, uint8_t actionCount, bool enabled)
+    : _actionNames(actionNames),
+      _actionCount(actionCount)
+{
+    if(enabled)
+    {
+        _stages.reset(new Stages[actionCount]);
+    }
+}
+
+bool ActionLatency::enabled() const
+{
+    return _stages != nullptr;
+}
+
+void ActionLatency::sent(int action, int64_t receivedTs, int64_t sentTs)
+{
+    _action = enabled() && action < _actionCount ? action : -1;
+    _waitingForState = false;
+    _receivedTs = receivedTs;
+    _sentTs = sentTs;
+}
+
+void ActionLatency::completed(bool success, int64_t ts)
+{
+    if(_action < 0 || !success)
+    {
+        _action = -1;
+        return;
+    }
+
+    Stages& stages = _stages[_action];
+    stages.queue.record(elapsed(_receivedTs, _sentTs));
+    stages.ble.record(elapsed(_sentTs, ts));
+    _resultTs = ts;
+    _waitingForState = true;
+}
+
+int ActionLatency::statePublished(int64_t ts)
+{
+    if(!_waitingForState)
+    {
+        return -1;
+    }
+
+    Stages& stages = _stages[_action];
+    stages.state.record(elapsed(_resultTs, ts));
+    stages.total.record(elapsed(_receivedTs, ts));
+    _waitingForState = false;
+
+    int action = _action;
+    _action = -1;
+    return action;
+}
+
+uint8_t ActionLatency::actionCount() const
+{
+    return _actionCount;
+}
+
+const char* ActionLatency::actionName(uint8_t action) const
+{
+    return _actionNames[action];
+}
+
+const ActionLatency::Stages& ActionLatency::stages(uint8_t action) const
+{
+    return _stages[action];
+}
+
+void ActionLatency::writeJson(uint8_t action, JsonWriter& json) const
+{
+    const Stages& stages = _stages[action];
+
+    json.add("count", stages.total.count());
+    writeStage(json, "queue", stages.queue);
+    writeStage(json, "ble", stages.ble);
+    writeStage(json, "state", stages.state);
+    writeStage(json, "total", stages.total);
+}
+
+uint32_t ActionLatency::elapsed(int64_t startTs, int64_t endTs)
+{
+    // timestamps come from different tasks, a command received after the sender read the clock counts as 0
+    if(endTs <= startTs)
+    {
+        return 0;
+    }
+    return endTs - startTs > UINT32_MAX ? UINT32_MAX : endTs - startTs;
+}
+
+void ActionLatency::writeStage(JsonWriter& json, const char* name, const LatencyHistogram& histogram)
+{
+    char key[20];
+
+    snprintf(key, sizeof(key), "%sP50", name);
+    json.add(key, histogram.percentile(50));
+    snprintf(key, sizeof(key), "%sP90", name);
+    json.add(key, histogram.percentile(90));
+    snprintf(key, sizeof(key), "%sP99", name);
+    json.add(key, histogram.percentile(99));
+    snprintf(key, sizeof(key), "%sMax", name);
+    json.add(key, histogram.max());
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "util/LatencyHistogram.h"
+#include "util/JsonWriter.h"
+
+// End to end latency of lock actions, tracked per action type in four stages:
+// queue: command received (MQTT message, GPIO) until the Nuki task sends it over BLE
+// ble: BLE command sent until the final result, including retries
+// state: BLE result until the next lock state is published
+// total: command received until the next lock state is published
+// Only successful actions are recorded. Updated by the Nuki task only, other tasks just read.
+// The histograms take about 1.8 KB per action and are only allocated when enabled.
+class ActionLatency
+{
+public:
+    struct Stages
+    {
+        LatencyHistogram queue;
+        LatencyHistogram ble;
+        LatencyHistogram state;
+        LatencyHistogram total;
+    };
+
+    ActionLatency(const char* const* actionNames, uint8_t actionCount, bool enabled);
+    ActionLatency(const ActionLatency&) = delete;
+    ActionLatency& operator=(const ActionLatency&) = delete;
+
+    bool enabled() const;
+
+    // action is an index into the action names, -1 for actions that aren't tracked
+    void sent(int action, int64_t receivedTs, int64_t sentTs);
+    void completed(bool success, int64_t ts);
+    // Returns the action whose latency was completed by this publish, -1 if none
+    int statePublished(int64_t ts);
+
+    uint8_t actionCount() const;
+    const char* actionName(uint8_t action) const;
+    // Only valid when enabled
+    const Stages& stages(uint8_t action) const;
+    // Count, p50, p90, p99 and max of each stage
+    void writeJson(uint8_t action, JsonWriter& json) const;
+
+private:
+    static uint32_t elapsed(int64_t startTs, int64_t endTs);
+    static void writeStage(JsonWriter& json, const char* name, const LatencyHistogram& histogram);
+
+    const char* const* _actionNames;
+    const uint8_t _actionCount;
+    std::unique_ptr<Stages[]> _stages;
+
+    int _action = -1;
+    bool _waitingForState = false;
+    int64_t _receivedTs = 0;
+    int64_t _sentTs = 0;
+    int64_t _resultTs = 0;
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include "Config.h"
+#include "EspMillis.h"
+
+enum class CommandSource : uint8_t
+{
+    Local = 0,
+    Mqtt = 1,
+    Gpio = 2,
+    Hybrid = 3
+};
+
+enum class CommandPriority : uint8_t
+{
+    High = 0,
+    Normal = 1
+};
+
+// Coalescing rules, applied to a command and the command queued right before it
+#define COMMAND_COALESCE_DUPLICATES 1   // the same action twice runs once
+#define COMMAND_COALESCE_OPPOSITES 2    // an action followed by its opposite (e.g. unlock, lock) cancels both
+
+template<typename Action>
+struct QueuedCommand
+{
+    Action action;
+    CommandSource source;
+    CommandPriority priority;
+    uint32_t id;
+    int64_t enqueueTs;
+};
+
+// Hands lock actions from the network task, GPIO and hybrid handling to the Nuki task.
+// Any number of producers push without locking into a bounded ring (Vyukov style, each cell
+// carries a sequence number), the Nuki task is the only consumer. On pop the consumer moves new
+// commands into its own pending list, applies the coalescing rules and returns the oldest command
+// of the highest priority. While the pending list is full, commands stay in the ring, and once the
+// ring is full as well push rejects new ones. Queued commands are never dropped silently.
+// Commands carry an id and their enqueue time for latency accounting.
+template<typename Action, size_t Capacity>
+class CommandQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    typedef bool (*OppositeFunction)(Action first, Action second);
+
+    CommandQueue()
+    {
+        for(size_t i = 0; i < Capacity; i++)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void setCoalescing(uint8_t rules, OppositeFunction opposite)
+    {
+        _rules = rules;
+        _opposite = opposite;
+    }
+
+    // Producer side, safe from any task. Returns the command id, 0 if the queue is full.
+    uint32_t push(Action action, CommandSource source, CommandPriority priority)
+    {
+        uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while(true)
+        {
+            cell = &_cells[pos & (Capacity - 1)];
+            int32_t diff = (int32_t)(cell->sequence.load(std::memory_order_acquire) - pos);
+
+            if(diff == 0)
+            {
+                if(_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(diff < 0)
+            {
+                _rejected.fetch_add(1, std::memory_order_relaxed);
+                return 0;
+            }
+            else
+            {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        uint32_t id = _nextId.fetch_add(1, std::memory_order_relaxed);
+        cell->command = { action, source, priority, id, espMillis() };
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Consumer side, only called from the Nuki task
+    bool pop(QueuedCommand<Action>& command)
+    {
+        drain();
+
+        size_t next = _pendingCount;
+        for(size_t i = 0; i < _pendingCount; i++)
+        {
+            if(next == _pendingCount || _pending[i].priority < _pending[next].priority)
+            {
+                next = i;
+            }
+        }
+
+        if(next == _pendingCount)
+        {
+            return false;
+        }
+
+        command = _pending[next];
+        removePending(next);
+        return true;
+    }
+
+    bool empty()
+    {
+        drain();
+        return _pendingCount == 0;
+    }
+
+    // Commands dropped by coalescing and rejected because the queue was full
+    uint32_t coalesced() const
+    {
+        return _coalesced;
+    }
+
+    uint32_t rejected() const
+    {
+        return _rejected.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint32_t> sequence;
+        QueuedCommand<Action> command;
+    };
+
+    void drain()
+    {
+        while(_pendingCount < Capacity)
+        {
+            Cell* cell = &_cells[_dequeuePos & (Capacity - 1)];
+            int32_t diff = (int32_t)(cell->sequence.load(std::memory_order_acquire) - (_dequeuePos + 1));
+
+            if(diff < 0)
+            {
+                return;
+            }
+
+            QueuedCommand<Action> command = cell->command;
+            cell->sequence.store(_dequeuePos + Capacity, std::memory_order_release);
+            _dequeuePos++;
+            addPending(command);
+        }
+    }
+
+    void addPending(const QueuedCommand<Action>& command)
+    {
+        if(_pendingCount > 0)
+        {
+            QueuedCommand<Action>& last = _pending[_pendingCount - 1];
+
+            if((_rules & COMMAND_COALESCE_DUPLICATES) != 0 && last.action == command.action)
+            {
+                // runs once, but as soon as the more urgent of the two would have
+                if(command.priority < last.priority)
+                {
+                    last.priority = command.priority;
+                }
+                _coalesced++;
+                return;
+            }
+            if((_rules & COMMAND_COALESCE_OPPOSITES) != 0 && _opposite != nullptr && _opposite(last.action, command.action))
+            {
+                _coalesced += 2;
+                removePending(_pendingCount - 1);
+                return;
+            }
+        }
+
+        _pending[_pendingCount++] = command;
+    }
+
+    void removePending(size_t index)
+    {
+        for(size_t i = index + 1; i < _pendingCount; i++)
+        {
+            _pending[i - 1] = _pending[i];
+        }
+        _pendingCount--;
+    }
+
+    Cell _cells[Capacity];
+    std::atomic<uint32_t> _enqueuePos{0};
+    std::atomic<uint32_t> _nextId{1};
+    std::atomic<uint32_t> _rejected{0};
+
+    // consumer owned
+    uint32_t _dequeuePos = 0;
+    QueuedCommand<Action> _pending[Capacity];
+    size_t _pendingCount = 0;
+    uint32_t _coalesced = 0;
+    uint8_t _rules = 0;
+    OppositeFunction _opposite = nullptr;
+};
@@ -114,12 +114,34 @@
 #endif
 #endif
 
+#define NETWORK_DISCONNECTED_LOOP_DELAY 20
+
 #ifndef NUKI_HUB_UPDATER
 #define MQTT_QOS_LEVEL 1
 #define MQTT_CLEAN_SESSIONS false
 #define MQTT_KEEP_ALIVE 60
+#define MQTT_MAX_INBOUND_PAYLOAD_SIZE 4096
+#define MQTT_TOPIC_REGISTRY_SIZE 128
+#define MQTT_OUTBOX_BUDGET 98304
+#define MQTT_TX_COALESCE_SIZE 1436
+#define MQTT_TX_COALESCE_DEADLINE 5
+#define MQTT_PUBLISH_DIGEST_RTC_SIZE 256
+#define MQTT_PUBLISH_DIGEST_STORE_INTERVAL 5000
+#define EVENT_JOURNAL_SIZE 32
+#define EVENT_JOURNAL_SOURCES 2
+#define EVENT_JOURNAL_REPLAY_INTERVAL 200
+#define EVENT_JOURNAL_RTC 0
+#define MQTT_SNAPSHOT_VERSION 1
+#define MQTT_RSSI_DEADBAND 3
+#define MQTT_BATTERY_VOLTAGE_DEADBAND 0.05
+#define MQTT_BATTERY_DRAIN_DEADBAND 100
+#define MQTT_BATTERY_CURRENT_DEADBAND 0.05
+#define MQTT_UPTIME_MIN_INTERVAL 300000
 #define GPIO_DEBOUNCE_TIME 200
 #define CHAR_BUFFER_SIZE 4096
+#define JSON_WRITER_BUFFER_SIZE 1024
+#define NUKI_COMMAND_QUEUE_SIZE 8
+#define NUKI_COMMAND_COALESCE 1 // COMMAND_COALESCE_* flags from CommandQueue.h
 #define NUKI_TASK_SIZE 8192
 #define MAX_AUTHLOG 5
 #define MAX_KEYPAD 10
@@ -1,7 +1,16 @@
 #pragma once
 #include <cstdint>
 
+#ifdef NUKI_HUB_SIM
+#include "sim/SimulatedClock.h"
+
+inline int64_t espMillis()
+{
+    return SimulatedClock::millis();
+}
+#else
 inline int64_t espMillis()
 {
     return esp_timer_get_time() / 1000;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,123 @@
+#include <cstring>
+#include "EventJournal.h"
+
+#define EVENT_JOURNAL_MAGIC 0x45564a33
+
+void EventJournal::begin(Storage* storage)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _storage = storage;
+
+    if(_storage->magic != EVENT_JOURNAL_MAGIC || _storage->head >= EVENT_JOURNAL_SIZE || _storage->count > EVENT_JOURNAL_SIZE)
+    {
+        memset(_storage, 0, sizeof(Storage));
+        _storage->magic = EVENT_JOURNAL_MAGIC;
+        for(uint8_t source = 0; source < EVENT_JOURNAL_SOURCES; source++)
+        {
+            _storage->nextSequence[source] = 1;
+            _storage->replaySequence[source] = 1;
+        }
+        return;
+    }
+
+    _storage->boot++;
+}
+
+void EventJournal::record(uint8_t source, const char* type, const char* value, const char* detail, int64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_storage == nullptr || source >= EVENT_JOURNAL_SOURCES)
+    {
+        return;
+    }
+
+    if(_storage->count == EVENT_JOURNAL_SIZE)
+    {
+        _storage->head = (_storage->head + 1) % EVENT_JOURNAL_SIZE;
+        _storage->count--;
+    }
+
+    Event& event = _storage->events[(_storage->head + _storage->count) % EVENT_JOURNAL_SIZE];
+    event.timestamp = timestamp;
+    event.sequence = _storage->nextSequence[source]++;
+    event.boot = _storage->boot;
+    event.source = source;
+    copy(event.type, type, sizeof(event.type));
+    copy(event.value, value, sizeof(event.value));
+    copy(event.detail, detail, sizeof(event.detail));
+    _storage->count++;
+}
+
+bool EventJournal::peek(Event& event)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_storage == nullptr || !pending())
+    {
+        return false;
+    }
+
+    // events of a source are in sequence order, the first one at or after its replay sequence is next
+    for(uint16_t i = 0; i < _storage->count; i++)
+    {
+        const Event& candidate = _storage->events[(_storage->head + i) % EVENT_JOURNAL_SIZE];
+        if(candidate.source < EVENT_JOURNAL_SOURCES && candidate.sequence >= _storage->replaySequence[candidate.source])
+        {
+            event = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventJournal::published(uint8_t source, uint32_t sequence)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_storage != nullptr && source < EVENT_JOURNAL_SOURCES && sequence >= _storage->replaySequence[source])
+    {
+        _storage->replaySequence[source] = sequence + 1;
+    }
+}
+
+void EventJournal::replayAfter(uint8_t source, uint32_t sequence)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_storage == nullptr || source >= EVENT_JOURNAL_SOURCES)
+    {
+        return;
+    }
+
+    // a sequence from the future means the journal was reset since, e.g. by a power loss
+    uint32_t next = sequence < _storage->nextSequence[source] ? sequence + 1 : 0;
+    if(next < _storage->replaySequence[source])
+    {
+        _storage->replaySequence[source] = next;
+    }
+}
+
+uint32_t EventJournal::boot() const
+{
+    return _storage == nullptr ? 0 : _storage->boot;
+}
+
+bool EventJournal::pending() const
+{
+    for(uint8_t source = 0; source < EVENT_JOURNAL_SOURCES; source++)
+    {
+        if(_storage->replaySequence[source] < _storage->nextSequence[source])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventJournal::copy(char* destination, const char* source, size_t size)
+{
+    if(source == nullptr)
+    {
+        destination[0] = '\0';
+        return;
+    }
+    strncpy(destination, source, size - 1);
+    destination[size - 1] = '\0';
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include "Config.h"
+
+// Bounded ring of the last lock and opener events. Each source (device) numbers its events with its own
+// sequence that increases by one, so the events topic of a device has no gaps from the other device.
+// Events are published in order once MQTT is connected and stay in the ring afterwards, so a consumer can
+// ask for the events of a source after the last sequence it has seen. When the ring is full the oldest
+// event is dropped, which shows as a gap in the sequence of its source. The storage is owned by the caller,
+// so it can be placed in RTC memory to keep events across soft restarts.
+class EventJournal
+{
+public:
+    // Plain data, the storage must not be initialized when it lives in RTC memory
+    struct Event
+    {
+        int64_t timestamp;
+        uint32_t sequence;
+        uint32_t boot;
+        uint8_t source;
+        char type[15];
+        char value[32];
+        char detail[33];
+    };
+
+    struct Storage
+    {
+        uint32_t magic;
+        uint32_t boot;
+        uint16_t head;
+        uint16_t count;
+        uint32_t nextSequence[EVENT_JOURNAL_SOURCES];
+        uint32_t replaySequence[EVENT_JOURNAL_SOURCES];
+        Event events[EVENT_JOURNAL_SIZE];
+    };
+
+    // Keeps events from a previous boot if the storage is intact, clears it otherwise
+    void begin(Storage* storage);
+    // Events of sources from EVENT_JOURNAL_SOURCES on are ignored
+    void record(uint8_t source, const char* type, const char* value, const char* detail, int64_t timestamp);
+    // Oldest event not published yet, skips events that were already dropped from the ring
+    bool peek(Event& event);
+    void published(uint8_t source, uint32_t sequence);
+    // Publishes the events of the source after the given sequence again, all its events in the ring if it's unknown
+    void replayAfter(uint8_t source, uint32_t sequence);
+    uint32_t boot() const;
+
+private:
+    static void copy(char* destination, const char* source, size_t size);
+    bool pending() const;
+
+    Storage* _storage = nullptr;
+    std::mutex _mutex;
+};
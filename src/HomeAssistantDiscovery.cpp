@@ -4,9 +4,10 @@
 #include "PreferencesKeys.h"
 #include "MqttTopics.h"
 
-HomeAssistantDiscovery::HomeAssistantDiscovery(NetworkDevice* device, Preferences *preferences, char* buffer, size_t bufferSize)
+HomeAssistantDiscovery::HomeAssistantDiscovery(NetworkDevice* device, Preferences *preferences, MqttPublishCache* publishCache, char* buffer, size_t bufferSize)
     : _device(device),
       _preferences(preferences),
+      _publishCache(publishCache),
       _buffer(buffer),
       _bufferSize(bufferSize)
 {
@@ -19,6 +20,24 @@ HomeAssistantDiscovery::HomeAssistantDiscovery(NetworkDevice* device, Preference
     sprintf(_nukiHubUidString, "%u", _preferences->getUInt(preference_device_id_lock, 0));
 }
 
+void HomeAssistantDiscovery::publishConfig(const char* path, const char* payload)
+{
+    // Discovery configs are retained, unchanged configs are still held by the broker after a reconnect
+    if(!_publishCache->changed(path, payload))
+    {
+        return;
+    }
+
+    if(_device->mqttPublish(path, MQTT_QOS_LEVEL, true, payload) == 0)
+    {
+        _publishCache->invalidate(path);
+    }
+    else
+    {
+        _publishCache->queued(path, MQTT_QOS_LEVEL);
+    }
+}
+
 void HomeAssistantDiscovery::setupHASS(int type, uint32_t nukiId, char* nukiName, const char* firmwareVersion, const char* hardwareVersion, bool hasDoorSensor, bool hasKeypad)
 {
     char uidString[20];
@@ -125,7 +144,7 @@ void HomeAssistantDiscovery::publishHASSNukiHubConfig()
     path.concat(_nukiHubUidString);
     path.concat("/reset/config");
 
-    _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+    publishConfig(path.c_str(), _buffer);
 
 #ifndef CONFIG_IDF_TARGET_ESP32H2
     publishHassTopic("sensor",
@@ -512,7 +531,7 @@ void HomeAssistantDiscovery::publishHASSDeviceConfig(char* deviceType, const cha
     path.concat(uidString);
     path.concat("/smartlock/config");
 
-    _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+    publishConfig(path.c_str(), _buffer);
 
 
     // Firmware version
@@ -1171,7 +1190,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][4] = "Intelligent";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "fob_action_1", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1189,7 +1208,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][4] = "Intelligent";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "fob_action_2", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1207,7 +1226,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][4] = "Intelligent";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "fob_action_3", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1224,7 +1243,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][3] = "Slowest";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "advertising_mode", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1285,7 +1304,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
 
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "timezone", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1445,7 +1464,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][6] = "Show Status";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "single_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1465,7 +1484,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][6] = "Show Status";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "double_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -1511,7 +1530,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalLockEntities(char *devic
         json["options"][2] = "Lithium";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "battery_type", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2005,7 +2024,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
     json["event_types"][2] = "standby";
     serializeJson(json, _buffer, _bufferSize);
     String path = createHassTopicPath("event", "ring", uidString);
-    _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+    publishConfig(path.c_str(), _buffer);
 
     if((int)basicOpenerConfigAclPrefs[5] == 1)
     {
@@ -2201,7 +2220,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][5] = "Ring";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "fob_action_1", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2220,7 +2239,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][5] = "Ring";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "fob_action_2", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2239,7 +2258,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][5] = "Ring";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "fob_action_3", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2256,7 +2275,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][3] = "Slowest";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "advertising_mode", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2317,7 +2336,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
 
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "timezone", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2346,7 +2365,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][15] = "Spare";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "operating_mode", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2570,7 +2589,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][7] = "CM & RTO & Ring";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "doorbell_suppression", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2616,7 +2635,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][3] = "Sound 3";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "sound_ring", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2633,7 +2652,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][3] = "Sound 3";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "sound_open", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2650,7 +2669,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][3] = "Sound 3";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "sound_rto", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2667,7 +2686,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][3] = "Sound 3";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "sound_cm", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2718,7 +2737,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][7] = "Open";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "single_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2739,7 +2758,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][7] = "Open";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "double_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2755,7 +2774,7 @@ void HomeAssistantDiscovery::publishHASSConfigAdditionalOpenerEntities(char *dev
         json["options"][2] = "Lithium";
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath("select", "battery_type", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
     else
     {
@@ -2944,7 +2963,7 @@ void HomeAssistantDiscovery::publishHassTopic(const String& mqttDeviceType,
         json = createHassJson(uidString, uidStringPostfix, displayName, name, baseTopic, stateTopic, deviceType, deviceClass, stateClass, entityCat, commandTopic, additionalEntries);
         serializeJson(json, _buffer, _bufferSize);
         String path = createHassTopicPath(mqttDeviceType, mqttDeviceName, uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        publishConfig(path.c_str(), _buffer);
     }
 }
 
@@ -2967,7 +2986,7 @@ void HomeAssistantDiscovery::removeHassTopic(const String& mqttDeviceType, const
     if (_discoveryTopic != "")
     {
         String path = createHassTopicPath(mqttDeviceType, mqttDeviceName, uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, "");
+        publishConfig(path.c_str(), "");
     }
 }
 
@@ -2,11 +2,12 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include "networkDevices/NetworkDevice.h"
+#include "MqttPublishCache.h"
 
 class HomeAssistantDiscovery
 {
 public:
-    explicit HomeAssistantDiscovery(NetworkDevice* device, Preferences* preferences, char* buffer, size_t bufferSize);
+    explicit HomeAssistantDiscovery(NetworkDevice* device, Preferences* preferences, MqttPublishCache* publishCache, char* buffer, size_t bufferSize);
     void setupHASS(int type, uint32_t nukiId, char* nukiName, const char* firmwareVersion, const char* hardwareVersion, bool hasDoorSensor, bool hasKeypad);
     void disableHASS();
     void removeHassTopic(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString);
@@ -26,6 +27,7 @@ public:
                           std::vector<std::pair<char*, char*>> additionalEntries = {}
                           );    
 private:
+    void publishConfig(const char* path, const char* payload);
     void publishHASSConfig(char *deviceType, const char *baseTopic, char *name, char *uidString, const char *softwareVersion, const char *hardwareVersion, const bool& hasDoorSensor, const bool& hasKeypad, const bool& publishAuthData, char *lockAction, char *unlockAction, char *openAction);
     void publishHASSDeviceConfig(char* deviceType, const char* baseTopic, char* name, char* uidString, const char *softwareVersion, const char *hardwareVersion, const char* availabilityTopic, const bool& hasKeypad, char* lockAction, char* unlockAction, char* openAction);
     void publishHASSNukiHubConfig();
@@ -58,6 +60,7 @@ private:
 
     NetworkDevice* _device = nullptr;
     Preferences* _preferences = nullptr;
+    MqttPublishCache* _publishCache = nullptr;
     
     String _discoveryTopic;
     String _baseTopic;
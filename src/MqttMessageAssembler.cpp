@@ -0,0 +1,79 @@
+#include <cstring>
+#include "MqttMessageAssembler.h"
+
+MqttMessageAssembler::MqttMessageAssembler(size_t maxSize)
+    : _maxSize(maxSize)
+{
+}
+
+MqttMessageAssembler::~MqttMessageAssembler()
+{
+    delete[] _buffer;
+}
+
+uint8_t* MqttMessageAssembler::add(const espMqttClientTypes::MessageProperties &properties, const uint8_t *payload, size_t len, size_t index, size_t total)
+{
+    if(index == 0)
+    {
+        if(_active)
+        {
+            // previous message never completed
+            drop();
+        }
+
+        if(total > _maxSize)
+        {
+            ++_droppedMessages;
+            return nullptr;
+        }
+
+        if(_buffer == nullptr)
+        {
+            _buffer = new uint8_t[_maxSize + 1];
+        }
+
+        _packetId = properties.packetId;
+        _received = 0;
+        _total = total;
+        _active = true;
+    }
+    else if(!_active)
+    {
+        // remaining chunks of a dropped message
+        return nullptr;
+    }
+    else if(properties.packetId != _packetId || index != _received || total != _total)
+    {
+        drop();
+        return nullptr;
+    }
+
+    if(_received + len > _total)
+    {
+        drop();
+        return nullptr;
+    }
+
+    memcpy(_buffer + _received, payload, len);
+    _received += len;
+
+    if(_received < _total)
+    {
+        return nullptr;
+    }
+
+    _buffer[_total] = 0x00;
+    _active = false;
+    return _buffer;
+}
+
+uint32_t MqttMessageAssembler::droppedMessages() const
+{
+    return _droppedMessages;
+}
+
+void MqttMessageAssembler::drop()
+{
+    _active = false;
+    ++_droppedMessages;
+}
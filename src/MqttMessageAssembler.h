@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "espMqttClient.h"
+
+// Collects the chunks espMqttClient delivers for a PUBLISH into one null terminated buffer.
+// The buffer is allocated once and reused for every message, messages larger than maxSize are dropped.
+class MqttMessageAssembler
+{
+public:
+    explicit MqttMessageAssembler(size_t maxSize);
+    ~MqttMessageAssembler();
+
+    // Returns the complete payload once the last chunk has been added, nullptr otherwise
+    uint8_t* add(const espMqttClientTypes::MessageProperties& properties, const uint8_t* payload, size_t len, size_t index, size_t total);
+    uint32_t droppedMessages() const;
+
+private:
+    void drop();
+
+    const size_t _maxSize;
+    uint8_t* _buffer = nullptr;
+    uint16_t _packetId = 0;
+    size_t _received = 0;
+    size_t _total = 0;
+    bool _active = false;
+    uint32_t _droppedMessages = 0;
+};
@@ -0,0 +1,195 @@
+#include <cstring>
+#include "MqttPublishCache.h"
+
+bool MqttPublishCache::changed(const char* topic, const char* payload)
+{
+    Digest digest;
+    digest.write((const uint8_t*)payload, strlen(payload));
+    return changed(topic, digest);
+}
+
+bool MqttPublishCache::changed(const char* topic, const Digest& payloadDigest)
+{
+    size_t topicLength = 0;
+    uint32_t topicHash = hash(topic, topicLength);
+    uint32_t digest = payloadDigest.value();
+    size_t payloadLength = payloadDigest.length();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = _entries[topicHash];
+
+    if(entry.forced)
+    {
+        return true;
+    }
+    if(entry.valid && entry.digest == digest && entry.length == payloadLength)
+    {
+        return false;
+    }
+
+    entry.digest = digest;
+    entry.length = payloadLength;
+    entry.queuedRevision = 0;
+    entry.valid = true;
+    ++_revision;
+    return true;
+}
+
+void MqttPublishCache::queued(const char* topic, uint8_t qos)
+{
+    size_t length = 0;
+    uint32_t topicHash = hash(topic, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(topicHash);
+    if(it != _entries.end() && it->second.valid)
+    {
+        it->second.queuedRevision = ++_revision;
+        it->second.qos = qos;
+    }
+}
+
+void MqttPublishCache::delivered(uint32_t revision)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(revision > _deliveredRevision)
+    {
+        _deliveredRevision = revision;
+    }
+}
+
+void MqttPublishCache::discardUndelivered()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(auto& it : _entries)
+    {
+        if(!isDelivered(it.second))
+        {
+            it.second.valid = false;
+        }
+    }
+    ++_revision;
+}
+
+void MqttPublishCache::setForced(const char* topic, bool forced)
+{
+    size_t length = 0;
+    uint32_t topicHash = hash(topic, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = _entries[topicHash];
+    entry.forced = forced;
+    entry.valid = false;
+}
+
+void MqttPublishCache::invalidate(const char* topic)
+{
+    size_t length = 0;
+    uint32_t topicHash = hash(topic, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(topicHash);
+    if(it != _entries.end())
+    {
+        it->second.valid = false;
+        ++_revision;
+    }
+}
+
+void MqttPublishCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(auto& it : _entries)
+    {
+        it.second.valid = false;
+    }
+    ++_revision;
+}
+
+size_t MqttPublishCache::snapshot(Record* records, size_t maxRecords)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    for(const auto& it : _entries)
+    {
+        if(count == maxRecords)
+        {
+            break;
+        }
+        if(!it.second.forced && isDelivered(it.second))
+        {
+            records[count++] = { it.first, it.second.digest, it.second.length };
+        }
+    }
+    return count;
+}
+
+void MqttPublishCache::restore(const Record* records, size_t count)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    // snapshots only hold delivered values
+    uint32_t revision = ++_revision;
+    for(size_t i = 0; i < count; i++)
+    {
+        Entry& entry = _entries[records[i].topic];
+        if(entry.forced)
+        {
+            continue;
+        }
+        entry.digest = records[i].digest;
+        entry.length = records[i].length;
+        entry.queuedRevision = revision;
+        entry.qos = 1;
+        entry.valid = true;
+    }
+    if(revision > _deliveredRevision)
+    {
+        _deliveredRevision = revision;
+    }
+}
+
+uint32_t MqttPublishCache::revision()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _revision;
+}
+
+uint32_t MqttPublishCache::deliveredRevision()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _deliveredRevision;
+}
+
+bool MqttPublishCache::isDelivered(const Entry& entry) const
+{
+    return entry.valid && entry.qos > 0 && entry.queuedRevision != 0 && entry.queuedRevision <= _deliveredRevision;
+}
+
+uint32_t MqttPublishCache::hash(const char* data, size_t& length)
+{
+    return Fnv1a::hash(data, length);
+}
+
+size_t MqttPublishCache::Digest::write(uint8_t c)
+{
+    _hash = Fnv1a::add(_hash, c);
+    ++_length;
+    return 1;
+}
+
+size_t MqttPublishCache::Digest::write(const uint8_t* data, size_t length)
+{
+    _hash = Fnv1a::hash(data, length, _hash);
+    _length += length;
+    return length;
+}
+
+uint32_t MqttPublishCache::Digest::value() const
+{
+    return _hash;
+}
+
+size_t MqttPublishCache::Digest::length() const
+{
+    return _length;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include "util/Fnv1a.h"
+
+// Last-value cache for retained publishes. Stores a digest of the last payload sent per topic hash,
+// so values that didn't change since the last publish can be skipped.
+//
+// An entry only proves the broker holds the value once its packet has left the outbox: QoS 0 packets
+// are dropped on disconnect and the whole outbox is lost on restart. queued() stamps an entry with the
+// revision at which its packet was queued, delivered() is called with a revision read before the outbox
+// was seen empty. Entries queued at or before that revision with QoS > 0 are delivered, only those are
+// kept by discardUndelivered() after a reconnect and by snapshot().
+class MqttPublishCache
+{
+public:
+    // Streams a payload into the digest compared by changed(), can be used as ArduinoJson writer.
+    class Digest
+    {
+    public:
+        size_t write(uint8_t c);
+        size_t write(const uint8_t* data, size_t length);
+        uint32_t value() const;
+        size_t length() const;
+
+    private:
+        uint32_t _hash = Fnv1a::OffsetBasis;
+        size_t _length = 0;
+    };
+
+    // Compact form of a valid entry, used to keep the cache across restarts
+    struct Record
+    {
+        uint32_t topic;
+        uint32_t digest;
+        uint32_t length;
+    };
+
+    bool changed(const char* topic, const char* payload);
+    bool changed(const char* topic, const Digest& digest);
+    // Call once the publish of the value accepted by changed() has been queued
+    void queued(const char* topic, uint8_t qos);
+    void delivered(uint32_t revision);
+    void discardUndelivered();
+    void setForced(const char* topic, bool forced = true);
+    void invalidate(const char* topic);
+    void invalidate();
+    size_t snapshot(Record* records, size_t maxRecords);
+    void restore(const Record* records, size_t count);
+    uint32_t revision();
+    uint32_t deliveredRevision();
+
+private:
+    struct Entry
+    {
+        uint32_t digest = 0;
+        uint32_t length = 0;
+        // revision at which the value was queued, 0 while it isn't
+        uint32_t queuedRevision = 0;
+        uint8_t qos = 0;
+        bool valid = false;
+        bool forced = false;
+    };
+
+    static uint32_t hash(const char* data, size_t& length);
+    bool isDelivered(const Entry& entry) const;
+
+    std::unordered_map<uint32_t, Entry> _entries;
+    uint32_t _revision = 0;
+    uint32_t _deliveredRevision = 0;
+    std::mutex _mutex;
+};
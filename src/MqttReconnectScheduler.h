@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+// When to attempt the next MQTT connection, driven by timestamps only. An attempt starts once the
+// backoff has expired and then waits for the CONNACK. A refused connect, a disconnect or a CONNACK
+// that doesn't arrive in time schedules the next attempt with exponential backoff starting at 5 seconds,
+// capped at 2 minutes, plus up to 25% jitter so several hubs don't hit a restarted broker at the same time.
+class MqttReconnectScheduler
+{
+public:
+    enum class State
+    {
+        Idle,
+        AwaitingConnAck
+    };
+
+    static const int64_t InitialBackoff = 5000;
+    static const int64_t MaxBackoff = 120000;
+    static const int64_t ConnAckTimeout = 60000;
+
+    State state() const
+    {
+        return _state;
+    }
+
+    // Idle and the backoff of the last failed attempt has expired
+    bool attemptDue(int64_t ts) const
+    {
+        return _state == State::Idle && ts >= _nextAttemptTs;
+    }
+
+    // The connect was sent, wait for the CONNACK
+    void attemptStarted(int64_t ts)
+    {
+        _state = State::AwaitingConnAck;
+        _connAckTimeoutTs = ts + ConnAckTimeout;
+    }
+
+    bool connAckTimedOut(int64_t ts) const
+    {
+        return _state == State::AwaitingConnAck && ts >= _connAckTimeoutTs;
+    }
+
+    // random picks the jitter, any value is fine
+    void attemptFailed(int64_t ts, uint32_t random)
+    {
+        int64_t backoff = InitialBackoff << (_failedAttempts < 5 ? _failedAttempts : 5);
+        if(backoff > MaxBackoff)
+        {
+            backoff = MaxBackoff;
+        }
+        backoff += random % (backoff / 4 + 1);
+
+        _state = State::Idle;
+        _nextAttemptTs = ts + backoff;
+        if(_failedAttempts < 255)
+        {
+            _failedAttempts++;
+        }
+    }
+
+    // Try again after delay without counting a failed attempt, e.g. while no broker is configured
+    void retryIn(int64_t ts, int64_t delay)
+    {
+        _state = State::Idle;
+        _nextAttemptTs = ts + delay;
+    }
+
+    void connected()
+    {
+        _state = State::Idle;
+        _failedAttempts = 0;
+    }
+
+    int64_t nextAttemptTs() const
+    {
+        return _nextAttemptTs;
+    }
+
+    uint8_t failedAttempts() const
+    {
+        return _failedAttempts;
+    }
+
+private:
+    State _state = State::Idle;
+    int64_t _nextAttemptTs = 0;
+    int64_t _connAckTimeoutTs = 0;
+    uint8_t _failedAttempts = 0;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "espMqttClient.h"
+
+// Tracks whether the broker session holds this boot's subscriptions. A subscription round only counts once
+// every SUBSCRIBE packet has been acknowledged without a failure code. SUBSCRIBE packets that are still
+// queued are dropped on disconnect, so a round that is interrupted before all SUBACKs arrived doesn't count
+// and the next connect subscribes again, even when the broker reports a present session.
+class MqttSubscriptionTracker
+{
+public:
+    // A new round of topicCount topics is about to be sent
+    void started(size_t topicCount)
+    {
+        _pending.clear();
+        _failed = false;
+        _roundTopics = topicCount;
+        _sessionTopics = 0;
+    }
+
+    // packetId is the id returned for a SUBSCRIBE packet of the round, 0 if it couldn't be queued
+    void sent(uint16_t packetId)
+    {
+        if(packetId == 0)
+        {
+            _failed = true;
+            return;
+        }
+        _pending.push_back(packetId);
+    }
+
+    // Call from the SUBACK callback
+    void acknowledged(uint16_t packetId, const espMqttClientTypes::SubscribeReturncode* returnCodes, size_t count)
+    {
+        bool found = false;
+        for(size_t i = 0; i < _pending.size(); i++)
+        {
+            if(_pending[i] == packetId)
+            {
+                _pending.erase(_pending.begin() + i);
+                found = true;
+                break;
+            }
+        }
+        if(!found)
+        {
+            return;
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+            if(returnCodes[i] == espMqttClientTypes::SubscribeReturncode::FAIL)
+            {
+                _failed = true;
+            }
+        }
+
+        if(_pending.empty() && !_failed)
+        {
+            _sessionTopics = _roundTopics;
+        }
+    }
+
+    void disconnected()
+    {
+        if(!_pending.empty())
+        {
+            _pending.clear();
+            _failed = true;
+        }
+    }
+
+    // All topicCount topics were acknowledged by the broker in this boot
+    bool subscribed(size_t topicCount) const
+    {
+        return _sessionTopics > 0 && _sessionTopics == topicCount;
+    }
+
+    bool pending() const
+    {
+        return !_pending.empty();
+    }
+
+private:
+    std::vector<uint16_t> _pending;
+    bool _failed = false;
+    size_t _roundTopics = 0;
+    size_t _sessionTopics = 0;
+};
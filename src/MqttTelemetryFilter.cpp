@@ -0,0 +1,56 @@
+#include <cmath>
+#include <cstdlib>
+#include "MqttTelemetryFilter.h"
+#include "MqttTopicRouter.h"
+
+bool MqttTelemetryFilter::accept(const char* path, const char* value, const MqttTopicPolicy& policy, int64_t ts)
+{
+    if(policy.deadband <= 0 && policy.minInterval == 0)
+    {
+        return true;
+    }
+
+    char* end = nullptr;
+    float number = strtof(value, &end);
+    if(end == value)
+    {
+        return true;
+    }
+
+    uint32_t hash = MqttTopicRouter::hashTopic(path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(hash);
+
+    if(it != _entries.end())
+    {
+        // values are published as rounded strings, a change of exactly the deadband must pass
+        if(fabsf(number - it->second.value) + 0.0001f < policy.deadband)
+        {
+            return false;
+        }
+        if(ts - it->second.ts < policy.minInterval)
+        {
+            return false;
+        }
+    }
+
+    Entry& entry = _entries[hash];
+    entry.value = number;
+    entry.ts = ts;
+    return true;
+}
+
+void MqttTelemetryFilter::invalidate(const char* path)
+{
+    uint32_t hash = MqttTopicRouter::hashTopic(path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.erase(hash);
+}
+
+void MqttTelemetryFilter::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
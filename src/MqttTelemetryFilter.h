@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include "MqttTopicPolicy.h"
+
+// Suppresses numeric telemetry that changed by less than the deadband of its topic policy,
+// or that would be published again before the minimum interval of the policy has passed.
+class MqttTelemetryFilter
+{
+public:
+    // Returns true if the value should be published and remembers it as the last published value
+    bool accept(const char* path, const char* value, const MqttTopicPolicy& policy, int64_t ts);
+    void invalidate(const char* path);
+    void clear();
+
+private:
+    struct Entry
+    {
+        float value = 0;
+        int64_t ts = 0;
+    };
+
+    std::unordered_map<uint32_t, Entry> _entries;
+    std::mutex _mutex;
+};
@@ -0,0 +1,74 @@
+#include <cstring>
+#include "MqttTopicPolicy.h"
+#include "MqttTopics.h"
+#include "Config.h"
+
+static const MqttTopicPolicy defaultPolicy = { nullptr, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, false };
+
+// Telemetry that is republished periodically goes out at QoS 0, a lost value is replaced by the next one.
+// Lock state and command results stay at QoS 1 and are sent before everything else.
+// Noisy measurements additionally get a deadband and a minimum interval, see MqttTelemetryFilter.
+// State and configuration topics coalesce: while a value is still queued only the latest one is sent.
+static const MqttTopicPolicy policies[] =
+{
+    { mqtt_topic_lock_rssi, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, MQTT_RSSI_DEADBAND, 0, false },
+    { mqtt_topic_battery_voltage, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, MQTT_BATTERY_VOLTAGE_DEADBAND, 0, false },
+    { mqtt_topic_battery_drain, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, MQTT_BATTERY_DRAIN_DEADBAND, 0, false },
+    { mqtt_topic_battery_max_turn_current, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, MQTT_BATTERY_CURRENT_DEADBAND, 0, false },
+    { mqtt_topic_uptime, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, 0, MQTT_UPTIME_MIN_INTERVAL, false },
+    { mqtt_topic_wifi_rssi, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, MQTT_RSSI_DEADBAND, 0, false },
+    { mqtt_topic_freeheap, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, 0, 0, false },
+    { mqtt_topic_mqtt_dropped_messages, 0, MqttRetainPolicy::Caller, MqttPublishPriority::Low, 0, 0, false },
+    { mqtt_topic_lock_state, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, true },
+    { mqtt_topic_lock_binary_state, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, true },
+    { mqtt_topic_lock_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, true },
+    { mqtt_topic_lock_snapshot, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, true },
+    { mqtt_topic_lock_door_sensor_state, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, true },
+    { mqtt_topic_lock_action_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_query_lockstate_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_config_action_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_keypad_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_keypad_json_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_timecontrol_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_auth_command_result, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::High, 0, 0, false },
+    { mqtt_topic_mqtt_connection_state, MQTT_QOS_LEVEL, MqttRetainPolicy::Always, MqttPublishPriority::High, 0, 0, true },
+    { mqtt_topic_config_basic_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_config_advanced_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_battery_basic_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_battery_advanced_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_keypad_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_timecontrol_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_auth_json, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_lock_action_latency, MQTT_QOS_LEVEL, MqttRetainPolicy::Caller, MqttPublishPriority::Normal, 0, 0, true },
+    { mqtt_topic_events, MQTT_QOS_LEVEL, MqttRetainPolicy::Never, MqttPublishPriority::Normal, 0, 0, false },
+};
+
+bool MqttTopicPolicy::applyRetain(bool retain) const
+{
+    switch(this->retain)
+    {
+    case MqttRetainPolicy::Always:
+        return true;
+    case MqttRetainPolicy::Never:
+        return false;
+    default:
+        return retain;
+    }
+}
+
+const MqttTopicPolicy& MqttTopicPolicy::get(const char* topic)
+{
+    for(const MqttTopicPolicy& policy : policies)
+    {
+        if(policy.topic == topic || strcmp(policy.topic, topic) == 0)
+        {
+            return policy;
+        }
+    }
+    return defaultPolicy;
+}
+
+const MqttTopicPolicy& MqttTopicPolicy::getDefault()
+{
+    return defaultPolicy;
+}
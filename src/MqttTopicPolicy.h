@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include "enums/MqttPublishPriority.h"
+
+enum class MqttRetainPolicy
+{
+    Caller,
+    Always,
+    Never
+};
+
+struct MqttTopicPolicy
+{
+    const char* topic;
+    uint8_t qos;
+    MqttRetainPolicy retain;
+    MqttPublishPriority priority;
+    // Numeric values that changed by less than the deadband or within minInterval (ms) of the last publish are not published
+    float deadband;
+    uint32_t minInterval;
+    // A queued, not yet sent retained publish is replaced by the next one. Only for topics where the last value is all that
+    // matters, never for event-like topics like /rollingLog or /ring whose intermediate values must all reach the broker.
+    bool coalesce;
+
+    bool applyRetain(bool retain) const;
+
+    // Looks up the policy for a topic constant from MqttTopics.h, topics without an entry get the default policy
+    static const MqttTopicPolicy& get(const char* topic);
+    static const MqttTopicPolicy& getDefault();
+};
@@ -0,0 +1,60 @@
+#include "MqttTopicRegistry.h"
+#include "MqttTopicRouter.h"
+
+MqttTopicRegistry::MqttTopicRegistry(const char* prefix, size_t capacity)
+    : _prefix(prefix),
+      _capacity(capacity)
+{
+    // entries are never moved, path() can hand out pointers without holding the lock
+    _entries.reserve(capacity);
+}
+
+uint16_t MqttTopicRegistry::intern(const char* topic)
+{
+    uint32_t hash = MqttTopicRouter::hashTopic(topic);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _ids.find(hash);
+    if(it != _ids.end())
+    {
+        // hash collisions aren't interned, the caller falls back to building the path
+        const Entry& entry = _entries[it->second];
+        return strcmp(entry.path.c_str() + entry.topicOffset, topic) == 0 ? it->second : InvalidId;
+    }
+
+    if(_entries.size() >= _capacity)
+    {
+        return InvalidId;
+    }
+
+    Entry entry;
+    entry.path = _prefix;
+    if(entry.path.length() > 0 && topic[0] != '/')
+    {
+        entry.path += '/';
+    }
+    entry.topicOffset = entry.path.length();
+    entry.path += topic;
+    entry.policy = &MqttTopicPolicy::get(topic);
+
+    uint16_t id = _entries.size();
+    _entries.push_back(std::move(entry));
+    _ids[hash] = id;
+    return id;
+}
+
+const char* MqttTopicRegistry::path(uint16_t id) const
+{
+    return _entries[id].path.c_str();
+}
+
+const MqttTopicPolicy& MqttTopicRegistry::policy(uint16_t id) const
+{
+    return *_entries[id].policy;
+}
+
+size_t MqttTopicRegistry::size() const
+{
+    return _entries.size();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MqttTopicPolicy.h"
+
+// Interns the full topics below a fixed prefix. Each topic is built once and gets a small integer id,
+// publishing by id afterwards doesn't need any string concatenation.
+class MqttTopicRegistry
+{
+public:
+    static const uint16_t InvalidId = 0xFFFF;
+
+    MqttTopicRegistry(const char* prefix, size_t capacity);
+
+    uint16_t intern(const char* topic);
+    const char* path(uint16_t id) const;
+    const MqttTopicPolicy& policy(uint16_t id) const;
+    size_t size() const;
+
+private:
+    struct Entry
+    {
+        std::string path;
+        size_t topicOffset;
+        const MqttTopicPolicy* policy;
+    };
+
+    const char* _prefix;
+    const size_t _capacity;
+    std::vector<Entry> _entries;
+    std::unordered_map<uint32_t, uint16_t> _ids;
+    std::mutex _mutex;
+};
@@ -0,0 +1,102 @@
+#include <cstring>
+#include <utility>
+#include "MqttTopicRouter.h"
+#include "util/Fnv1a.h"
+
+void MqttTopicRouter::add(const char* prefix, const char* path)
+{
+    Route route;
+    route.topic = prefix;
+    if(route.topic.length() > 0 && path[0] != '/')
+    {
+        route.topic += '/';
+    }
+    route.topic += path;
+    route.hash = hashTopic(route.topic.c_str());
+    route.path = path;
+
+    if((_count + 1) * 2 > _routes.size())
+    {
+        grow();
+    }
+
+    insert(route);
+}
+
+const char* MqttTopicRouter::match(const char* topic) const
+{
+    if(_count == 0 || topic == nullptr)
+    {
+        return nullptr;
+    }
+
+    uint32_t hash = hashTopic(topic);
+    size_t mask = _routes.size() - 1;
+
+    for(size_t i = hash & mask; _routes[i].path != nullptr; i = (i + 1) & mask)
+    {
+        if(_routes[i].hash == hash && strcmp(_routes[i].topic.c_str(), topic) == 0)
+        {
+            return _routes[i].path;
+        }
+    }
+
+    return nullptr;
+}
+
+void MqttTopicRouter::clear()
+{
+    _routes.clear();
+    _count = 0;
+}
+
+size_t MqttTopicRouter::size() const
+{
+    return _count;
+}
+
+bool MqttTopicRouter::equals(const char* matchedPath, const char* path)
+{
+    return matchedPath != nullptr && strcmp(matchedPath, path) == 0;
+}
+
+uint32_t MqttTopicRouter::hashTopic(const char* topic)
+{
+    return Fnv1a::hash(topic);
+}
+
+void MqttTopicRouter::insert(Route& route)
+{
+    size_t mask = _routes.size() - 1;
+
+    for(size_t i = route.hash & mask; ; i = (i + 1) & mask)
+    {
+        if(_routes[i].path == nullptr)
+        {
+            _routes[i] = std::move(route);
+            ++_count;
+            return;
+        }
+        if(_routes[i].hash == route.hash && _routes[i].topic == route.topic)
+        {
+            _routes[i].path = route.path;
+            return;
+        }
+    }
+}
+
+void MqttTopicRouter::grow()
+{
+    std::vector<Route> routes;
+    routes.swap(_routes);
+    _routes.resize(routes.empty() ? 16 : routes.size() * 2);
+    _count = 0;
+
+    for(Route& route : routes)
+    {
+        if(route.path != nullptr)
+        {
+            insert(route);
+        }
+    }
+}
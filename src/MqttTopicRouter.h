@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Maps the full topics a receiver subscribed to back to the sub path they were registered with.
+// Full topics are built once in add(), match() hashes the incoming topic once and doesn't need any path buffer.
+class MqttTopicRouter
+{
+public:
+    void add(const char* prefix, const char* path);
+    const char* match(const char* topic) const;
+    void clear();
+    size_t size() const;
+
+    static bool equals(const char* matchedPath, const char* path);
+    static uint32_t hashTopic(const char* topic);
+
+private:
+    struct Route
+    {
+        uint32_t hash = 0;
+        std::string topic;
+        const char* path = nullptr;
+    };
+
+    void insert(Route& route);
+    void grow();
+
+    std::vector<Route> _routes;
+    size_t _count = 0;
+};
@@ -6,6 +6,7 @@
 #define mqtt_topic_lock_state (char*)"/state"
 #define mqtt_topic_lock_ha_state (char*)"/hastate"
 #define mqtt_topic_lock_json (char*)"/json"
+#define mqtt_topic_lock_snapshot (char*)"/snapshot"
 #define mqtt_topic_lock_binary_state (char*)"/binaryState"
 #define mqtt_topic_lock_continuous_mode (char*)"/continuousMode"
 #define mqtt_topic_lock_ring (char*)"/ring"
@@ -24,6 +25,7 @@
 #define mqtt_topic_lock_rssi (char*)"/rssi"
 #define mqtt_topic_lock_address (char*)"/address"
 #define mqtt_topic_lock_retry (char*)"/retry"
+#define mqtt_topic_lock_action_latency (char*)"/actionLatency"
 
 #define mqtt_topic_official_lock_action (char*)"/lockAction"
 //#define mqtt_topic_official_mode (char*)"/mode"
@@ -107,11 +109,15 @@
 #define mqtt_topic_wifi_rssi (char*)"/maintenance/wifiRssi"
 #define mqtt_topic_log (char*)"/maintenance/log"
 #define mqtt_topic_freeheap (char*)"/maintenance/freeHeap"
+#define mqtt_topic_mqtt_dropped_messages (char*)"/maintenance/mqttDroppedMessages"
+#define mqtt_topic_mqtt_pool_stats (char*)"/maintenance/mqttPools"
 #define mqtt_topic_restart_reason_fw (char*)"/maintenance/restartReasonNukiHub"
 #define mqtt_topic_restart_reason_esp (char*)"/maintenance/restartReasonNukiEsp"
 #define mqtt_topic_mqtt_connection_state (char*)"/maintenance/mqttConnectionState"
 #define mqtt_topic_network_device (char*)"/maintenance/networkDevice"
 #define mqtt_topic_hybrid_state (char*)"/hybridConnected"
+#define mqtt_topic_events (char*)"/events"
+#define mqtt_topic_events_since (char*)"/events/since"
 
 #define mqtt_topic_gpio_prefix (char*)"/gpio"
 #define mqtt_topic_gpio_pin (char*)"/pin_"
@@ -123,7 +129,7 @@ class MqttTopics
 private:
     std::vector<char*> _keys =
     {
-        mqtt_topic_lock_action, mqtt_topic_lock_status_updated, mqtt_topic_lock_state, mqtt_topic_lock_ha_state, mqtt_topic_lock_json, mqtt_topic_lock_binary_state,
+        mqtt_topic_lock_action, mqtt_topic_lock_status_updated, mqtt_topic_lock_state, mqtt_topic_lock_ha_state, mqtt_topic_lock_json, mqtt_topic_lock_snapshot, mqtt_topic_lock_binary_state,
         mqtt_topic_lock_continuous_mode, mqtt_topic_lock_ring, mqtt_topic_lock_binary_ring, mqtt_topic_lock_trigger, mqtt_topic_lock_last_lock_action, mqtt_topic_lock_log,
         mqtt_topic_lock_log_latest, mqtt_topic_lock_log_rolling, mqtt_topic_lock_log_rolling_last, mqtt_topic_lock_auth_id, mqtt_topic_lock_auth_name, mqtt_topic_lock_completionStatus,
         mqtt_topic_lock_action_command_result, mqtt_topic_lock_door_sensor_state, mqtt_topic_lock_rssi, mqtt_topic_lock_address, mqtt_topic_lock_retry, mqtt_topic_config_action,
@@ -138,7 +144,7 @@ private:
         mqtt_topic_timecontrol_json, mqtt_topic_timecontrol_action, mqtt_topic_timecontrol_command_result, mqtt_topic_auth, mqtt_topic_auth_entries, 
         mqtt_topic_auth_json, mqtt_topic_auth_action, mqtt_topic_auth_command_result, mqtt_topic_info_hardware_version, mqtt_topic_info_firmware_version, 
         mqtt_topic_info_nuki_hub_version, mqtt_topic_info_nuki_hub_build, mqtt_topic_info_nuki_hub_latest, mqtt_topic_info_nuki_hub_ip, mqtt_topic_reset, 
-        mqtt_topic_update, mqtt_topic_webserver_state, mqtt_topic_webserver_action, mqtt_topic_uptime, mqtt_topic_wifi_rssi, mqtt_topic_log, mqtt_topic_freeheap, 
+        mqtt_topic_update, mqtt_topic_webserver_state, mqtt_topic_webserver_action, mqtt_topic_uptime, mqtt_topic_wifi_rssi, mqtt_topic_log, mqtt_topic_freeheap, mqtt_topic_mqtt_dropped_messages,
         mqtt_topic_restart_reason_fw, mqtt_topic_restart_reason_esp, mqtt_topic_mqtt_connection_state, mqtt_topic_network_device, mqtt_topic_hybrid_state
     };
 public:
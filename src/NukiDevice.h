@@ -0,0 +1,17 @@
+#pragma once
+
+// The devices the wrappers talk to. Firmware builds use the nuki_ble library, NUKI_HUB_SIM builds
+// the in-memory devices of src/sim, which implement the same calls, so the wrappers can run against them.
+#ifdef NUKI_HUB_SIM
+#include "sim/SimulatedNukiLock.h"
+#include "sim/SimulatedNukiOpener.h"
+
+typedef SimulatedNukiLock NukiLockDevice;
+typedef SimulatedNukiOpener NukiOpenerDevice;
+#else
+#include "NukiLock.h"
+#include "NukiOpener.h"
+
+typedef NukiLock::NukiLock NukiLockDevice;
+typedef NukiOpener::NukiOpener NukiOpenerDevice;
+#endif
@@ -6,6 +6,7 @@
 #include <HTTPClient.h>
 #include <NetworkClientSecure.h>
 #include "util/NetworkDeviceInstantiator.h"
+#include "util/Fnv1a.h"
 #ifndef CONFIG_IDF_TARGET_ESP32H2
 #include "networkDevices/WifiDevice.h"
 #endif
@@ -19,6 +20,33 @@ extern bool forceEnableWebServer;
 extern const uint8_t x509_crt_imported_bundle_bin_start[] asm("_binary_x509_crt_bundle_start");
 extern const uint8_t x509_crt_imported_bundle_bin_end[]   asm("_binary_x509_crt_bundle_end");
 
+#ifndef NUKI_HUB_UPDATER
+#define PUBLISH_DIGEST_MAGIC 0x50444731
+
+// Digest of the retained values last published, survives soft restarts so they aren't all published again
+struct RtcPublishDigest
+{
+    uint32_t magic;
+    uint32_t count;
+    uint32_t checksum;
+    MqttPublishCache::Record records[MQTT_PUBLISH_DIGEST_RTC_SIZE];
+};
+
+RTC_NOINIT_ATTR static RtcPublishDigest rtcPublishDigest;
+
+static uint32_t publishDigestChecksum(const RtcPublishDigest& digest)
+{
+    uint32_t hash = Fnv1a::hash((const uint8_t*)digest.records, digest.count * sizeof(MqttPublishCache::Record));
+    return hash ^ digest.count;
+}
+
+#if EVENT_JOURNAL_RTC
+RTC_NOINIT_ATTR static EventJournal::Storage eventJournalStorage;
+#else
+static EventJournal::Storage eventJournalStorage;
+#endif
+#endif
+
 #ifndef NUKI_HUB_UPDATER
 NukiNetwork::NukiNetwork(Preferences *preferences, Gpio* gpio, const String& maintenancePathPrefix, char* buffer, size_t bufferSize)
     : _preferences(preferences),
@@ -40,6 +68,8 @@ NukiNetwork::NukiNetwork(Preferences *preferences)
     _webEnabled = _preferences->getBool(preference_webserver_enabled, true);
 
 #ifndef NUKI_HUB_UPDATER
+    _eventJournal.begin(&eventJournalStorage);
+
     memset(_maintenancePathPrefix, 0, sizeof(_maintenancePathPrefix));
     size_t len = maintenancePathPrefix.length();
     for(int i=0; i < len; i++)
@@ -141,8 +171,12 @@ void NukiNetwork::setupDevice()
     {
         onMqttDisconnect(reason);
     });
+    _device->mqttOnSubscribe([&](uint16_t packetId, const espMqttClientTypes::SubscribeReturncode* returnCodes, size_t count)
+    {
+        _subscriptionTracker.acknowledged(packetId, returnCodes, count);
+    });
 
-    _hadiscovery = new HomeAssistantDiscovery(_device, _preferences, _buffer, _bufferSize);
+    _hadiscovery = new HomeAssistantDiscovery(_device, _preferences, &_publishCache, _buffer, _bufferSize);
 #endif
 
 }
@@ -304,6 +338,9 @@ void NukiNetwork::initialize()
         char gpioPath[250];
         bool rebGpio = rebuildGpio();
 
+        buildMqttPath(_gpioPinPath, {_lockPath.c_str(), mqtt_topic_gpio_prefix, mqtt_topic_gpio_pin});
+        _gpioPinPathLength = strlen(_gpioPinPath);
+
         if(rebGpio)
         {
             Log->println(F("Rebuild MQTT GPIO structure"));
@@ -339,6 +376,7 @@ void NukiNetwork::initialize()
         }
 
         readSettings();
+        restorePublishDigest();
     }
 }
 
@@ -408,13 +446,11 @@ bool NukiNetwork::update()
         _firstDisconnected = true;
     }
 
-    if(!_device->mqttConnected() && _device->isConnected())
+    if((!_device->mqttConnected() || _reconnectScheduler.state() == MqttReconnectScheduler::State::AwaitingConnAck) && _device->isConnected())
     {
         bool success = reconnect();
         if(!success)
         {
-            delay(2000);
-            _mqttConnectCounter++;
             return false;
         }
 
@@ -429,7 +465,6 @@ bool NukiNetwork::update()
         {
             forceEnableWebServer = false;
         }
-        delay(2000);
     }
 
     if(!_device->mqttConnected() || !_device->isConnected())
@@ -444,25 +479,41 @@ bool NukiNetwork::update()
             delay(200);
             restartEsp(RestartReason::NetworkTimeoutWatchdog);
         }
-        delay(2000);
         return false;
     }
 
     _lastConnectedTs = ts;
 
-    if(_device->signalStrength() != 127 && _rssiPublishInterval > 0 && ts - _lastRssiTs > _rssiPublishInterval)
+    // read before checking the outbox, everything queued up to this revision has left it once it is empty
+    uint32_t publishRevision = _publishCache.revision();
+    if(_device->mqttOutboxBytes() == 0)
     {
-        _lastRssiTs = ts;
-        int8_t rssi = _device->signalStrength();
+        _publishCache.delivered(publishRevision);
+    }
 
-        if(rssi != _lastRssi)
-        {
-            publishInt(_maintenancePathPrefix, mqtt_topic_wifi_rssi, _device->signalStrength(), true);
-            _lastRssi = rssi;
-        }
+    if(ts - _lastPublishDigestTs > MQTT_PUBLISH_DIGEST_STORE_INTERVAL)
+    {
+        _lastPublishDigestTs = ts;
+        storePublishDigest();
     }
 
-    if(_lastMaintenanceTs == 0 || (ts - _lastMaintenanceTs) > 30000)
+    if(ts - _lastEventReplayTs >= EVENT_JOURNAL_REPLAY_INTERVAL && _mqttConnectionState == 2)
+    {
+        _lastEventReplayTs = ts;
+        publishJournalEvent(ts);
+    }
+
+    // defer periodic maintenance topics until the outbox has drained
+    bool congested = _device->mqttCongested(espMqttClientTypes::Priority::BACKGROUND);
+
+    if(!congested && _device->signalStrength() != 127 && _rssiPublishInterval > 0 && ts - _lastRssiTs > _rssiPublishInterval)
+    {
+        _lastRssiTs = ts;
+        // unchanged values and changes within the deadband are filtered when publishing
+        publishInt(_maintenancePathPrefix, mqtt_topic_wifi_rssi, _device->signalStrength(), true);
+    }
+
+    if(!congested && (_lastMaintenanceTs == 0 || (ts - _lastMaintenanceTs) > 30000))
     {
         int64_t curUptime = ts / 1000 / 60;
         if(curUptime > _publishedUpTime)
@@ -482,6 +533,8 @@ bool NukiNetwork::update()
         if(_publishDebugInfo)
         {
             publishUInt(_maintenancePathPrefix, mqtt_topic_freeheap, esp_get_free_heap_size(), true);
+            publishULong(_maintenancePathPrefix, mqtt_topic_mqtt_dropped_messages, _messageAssembler.droppedMessages(), true);
+            publishMqttPoolStats();
         }
         _lastMaintenanceTs = ts;
     }
@@ -579,11 +632,48 @@ bool NukiNetwork::update()
 void NukiNetwork::onMqttConnect(const bool &sessionPresent)
 {
     _connectReplyReceived = true;
+    _sessionPresent = sessionPresent;
+}
+
+void NukiNetwork::restorePublishDigest()
+{
+    if(rtcPublishDigest.magic != PUBLISH_DIGEST_MAGIC || rtcPublishDigest.count > MQTT_PUBLISH_DIGEST_RTC_SIZE ||
+            rtcPublishDigest.checksum != publishDigestChecksum(rtcPublishDigest))
+    {
+        rtcPublishDigest.magic = 0;
+        return;
+    }
+
+    _publishCache.restore(rtcPublishDigest.records, rtcPublishDigest.count);
+    _storedPublishRevision = _publishCache.deliveredRevision();
+    Log->print(F("Restored publish digest for "));
+    Log->print(rtcPublishDigest.count);
+    Log->println(F(" topics"));
+}
+
+void NukiNetwork::storePublishDigest()
+{
+    // only delivered values are stored, they change with the delivered revision
+    uint32_t revision = _publishCache.deliveredRevision();
+    if(revision == _storedPublishRevision)
+    {
+        return;
+    }
+
+    // Invalidate first, a restart while writing leaves a digest that is rejected on boot
+    rtcPublishDigest.magic = 0;
+    rtcPublishDigest.count = _publishCache.snapshot(rtcPublishDigest.records, MQTT_PUBLISH_DIGEST_RTC_SIZE);
+    rtcPublishDigest.checksum = publishDigestChecksum(rtcPublishDigest);
+    rtcPublishDigest.magic = PUBLISH_DIGEST_MAGIC;
+    _storedPublishRevision = revision;
 }
 
 void NukiNetwork::onMqttDisconnect(const espMqttClientTypes::DisconnectReason &reason)
 {
     _connectReplyReceived = false;
+    _disconnectReceived = true;
+    // queued SUBSCRIBE packets are dropped with the connection
+    _subscriptionTracker.disconnected();
     Log->print("MQTT disconnected. Reason: ");
     switch(reason)
     {
@@ -620,19 +710,26 @@ void NukiNetwork::onMqttDisconnect(const espMqttClientTypes::DisconnectReason &r
 bool NukiNetwork::reconnect()
 {
     _mqttConnectionState = 0;
+    int64_t ts = espMillis();
 
-    while (!_device->mqttConnected() && espMillis() > _nextReconnect)
+    if(_reconnectScheduler.state() == MqttReconnectScheduler::State::Idle)
     {
+        if(!_reconnectScheduler.attemptDue(ts))
+        {
+            return false;
+        }
+
         if(strcmp(_mqttBrokerAddr, "") == 0)
         {
             Log->println(F("MQTT Broker not configured, aborting connection attempt."));
-            _nextReconnect = espMillis() + 5000;
+            _reconnectScheduler.retryIn(ts, 5000);
             return false;
         }
 
         Log->println(F("Attempting MQTT connection"));
 
         _connectReplyReceived = false;
+        _disconnectReceived = false;
 
         if(strlen(_mqttUser) == 0)
         {
@@ -647,141 +744,178 @@ bool NukiNetwork::reconnect()
 
         _device->mqttSetWill(_mqttConnectionStateTopic, 1, true, _lastWillPayload);
         _device->mqttSetServer(_mqttBrokerAddr, _mqttPort);
-        _device->mqttConnect();
 
-        int64_t timeout = espMillis() + 60000;
+        if(!_device->mqttConnect())
+        {
+            Log->println(F("MQTT connect failed"));
+            scheduleReconnect(ts);
+            return false;
+        }
 
-        while(!_connectReplyReceived && espMillis() < timeout)
+        _reconnectScheduler.attemptStarted(ts);
+        return false;
+    }
+
+    if(!_device->mqttConnected())
+    {
+        if(!_connectReplyReceived && !_disconnectReceived && !_reconnectScheduler.connAckTimedOut(ts))
         {
-            delay(50);
-            _device->update();
             if(_keepAliveCallback != nullptr)
             {
                 _keepAliveCallback();
             }
+            return false;
         }
 
-        if (_device->mqttConnected())
+        Log->println(F("MQTT connect failed"));
+        if(!_disconnectReceived)
         {
-            Log->println(F("MQTT connected"));
-            _mqttConnectedTs = millis();
-            _mqttConnectionState = 1;
-            delay(100);
-            _device->mqttOnMessage(onMqttDataReceivedCallback);
+            _device->mqttDisconnect(true);
+        }
+        scheduleReconnect(ts);
+        return false;
+    }
 
-            if(_firstConnect)
-            {
-                _firstConnect = false;
+    _reconnectScheduler.connected();
 
-                if(_preferences->getBool(preference_reset_mqtt_topics, false))
-                {
-                    char mqttLockPath[181] = {0};
-                    char mqttOpenerPath[181] = {0};
-                    char mqttOldOpenerPath[181] = {0};
-                    char mqttOldOpenerPath2[181] = {0};
-                    String mqttPath = _preferences->getString(preference_mqtt_lock_path, "");
-                    mqttPath.concat("/lock");
-
-                    size_t len = mqttPath.length();
-                    for(int i=0; i < len; i++)
-                    {
-                        mqttLockPath[i] = mqttPath.charAt(i);
-                    }
+    Log->println(F("MQTT connected"));
+    _mqttConnectedTs = millis();
+    _mqttConnectionState = 1;
 
-                    mqttPath = _preferences->getString(preference_mqtt_lock_path, "");
-                    mqttPath.concat("/opener");
+    // Retained values the broker already holds from the previous session don't have to be published again.
+    // Values that hadn't left the outbox may have been dropped with the connection, they are published again.
+    if(_sessionPresent)
+    {
+        Log->println(F("MQTT session present, only publishing changed values"));
+        _publishCache.discardUndelivered();
+    }
+    else
+    {
+        _publishCache.invalidate();
+    }
+    _telemetryFilter.clear();
+    // The last will may have replaced the connection state while disconnected
+    _publishCache.invalidate(_mqttConnectionStateTopic);
+    _device->mqttOnMessage(onMqttDataReceivedCallback);
 
-                    len = mqttPath.length();
-                    for(int i=0; i < len; i++)
-                    {
-                        mqttOpenerPath[i] = mqttPath.charAt(i);
-                    }
+    if(_firstConnect)
+    {
+        _firstConnect = false;
 
-                    mqttPath = _preferences->getString(preference_mqtt_opener_path, "");
+        if(_preferences->getBool(preference_reset_mqtt_topics, false))
+        {
+            char mqttLockPath[181] = {0};
+            char mqttOpenerPath[181] = {0};
+            char mqttOldOpenerPath[181] = {0};
+            char mqttOldOpenerPath2[181] = {0};
+            String mqttPath = _preferences->getString(preference_mqtt_lock_path, "");
+            mqttPath.concat("/lock");
+
+            size_t len = mqttPath.length();
+            for(int i=0; i < len; i++)
+            {
+                mqttLockPath[i] = mqttPath.charAt(i);
+            }
 
-                    len = mqttPath.length();
-                    for(int i=0; i < len; i++)
-                    {
-                        mqttOldOpenerPath[i] = mqttPath.charAt(i);
-                    }
+            mqttPath = _preferences->getString(preference_mqtt_lock_path, "");
+            mqttPath.concat("/opener");
 
-                    mqttPath = _preferences->getString(preference_mqtt_opener_path, "");
-                    mqttPath.concat("/lock");
+            len = mqttPath.length();
+            for(int i=0; i < len; i++)
+            {
+                mqttOpenerPath[i] = mqttPath.charAt(i);
+            }
 
-                    len = mqttPath.length();
-                    for(int i=0; i < len; i++)
-                    {
-                        mqttOldOpenerPath2[i] = mqttPath.charAt(i);
-                    }
+            mqttPath = _preferences->getString(preference_mqtt_opener_path, "");
 
-                    MqttTopics mqttTopics;
+            len = mqttPath.length();
+            for(int i=0; i < len; i++)
+            {
+                mqttOldOpenerPath[i] = mqttPath.charAt(i);
+            }
 
-                    const std::vector<char*> mqttTopicsKeys = mqttTopics.getMqttTopics();
+            mqttPath = _preferences->getString(preference_mqtt_opener_path, "");
+            mqttPath.concat("/lock");
 
-                    for(const auto& topic : mqttTopicsKeys)
-                    {
-                        removeTopic(_maintenancePathPrefix, topic);
-                        removeTopic(mqttLockPath, topic);
-                        removeTopic(mqttOpenerPath, topic);
-                        if (len > 5)
-                        {
-                            removeTopic(mqttOldOpenerPath, topic);
-                            removeTopic(mqttOldOpenerPath2, topic);
-                        }
-                    }
+            len = mqttPath.length();
+            for(int i=0; i < len; i++)
+            {
+                mqttOldOpenerPath2[i] = mqttPath.charAt(i);
+            }
 
-                    _preferences->putBool(preference_reset_mqtt_topics, false);
-                }
+            MqttTopics mqttTopics;
 
-                publishString(_maintenancePathPrefix, mqtt_topic_network_device, _device->deviceName().c_str(), true);
+            const std::vector<char*> mqttTopicsKeys = mqttTopics.getMqttTopics();
 
-                if(_preferences->getBool(preference_mqtt_hass_enabled, false))
+            for(const auto& topic : mqttTopicsKeys)
+            {
+                removeTopic(_maintenancePathPrefix, topic);
+                removeTopic(mqttLockPath, topic);
+                removeTopic(mqttOpenerPath, topic);
+                if (len > 5)
                 {
-                    setupHASS(0, 0, {0}, {0}, {0}, false, false);
+                    removeTopic(mqttOldOpenerPath, topic);
+                    removeTopic(mqttOldOpenerPath2, topic);
                 }
+            }
 
-                initTopic(_maintenancePathPrefix, mqtt_topic_reset, "0");
-                subscribe(_maintenancePathPrefix, mqtt_topic_reset);
+            _preferences->putBool(preference_reset_mqtt_topics, false);
+        }
 
-                if(_preferences->getBool(preference_update_from_mqtt, false))
-                {
-                    initTopic(_maintenancePathPrefix, mqtt_topic_update, "0");
-                    subscribe(_maintenancePathPrefix, mqtt_topic_update);
-                }
+        publishString(_maintenancePathPrefix, mqtt_topic_network_device, _device->deviceName().c_str(), true);
 
-                initTopic(_maintenancePathPrefix, mqtt_topic_webserver_action, "--");
-                subscribe(_maintenancePathPrefix, mqtt_topic_webserver_action);
-                initTopic(_maintenancePathPrefix, mqtt_topic_webserver_state, (_preferences->getBool(preference_webserver_enabled, true) || forceEnableWebServer ? "1" : "0"));
+        if(_preferences->getBool(preference_mqtt_hass_enabled, false))
+        {
+            setupHASS(0, 0, {0}, {0}, {0}, false, false);
+        }
 
-                for(const auto& it : _initTopics)
-                {
-                    publish(it.first.c_str(), it.second.c_str(), true);
-                }
-            }
+        initTopic(_maintenancePathPrefix, mqtt_topic_reset, "0");
+        subscribe(_maintenancePathPrefix, mqtt_topic_reset);
+        _topicRouter.add(_maintenancePathPrefix, mqtt_topic_reset);
 
-            for(const String& topic : _subscribedTopics)
-            {
-                subscribe(topic.c_str(), MQTT_QOS_LEVEL);
-            }
+        if(_preferences->getBool(preference_update_from_mqtt, false))
+        {
+            initTopic(_maintenancePathPrefix, mqtt_topic_update, "0");
+            subscribe(_maintenancePathPrefix, mqtt_topic_update);
+            _topicRouter.add(_maintenancePathPrefix, mqtt_topic_update);
+        }
 
-            publishString(_maintenancePathPrefix, mqtt_topic_mqtt_connection_state, "online", true);
-            publishString(_maintenancePathPrefix, mqtt_topic_info_nuki_hub_ip, _device->localIP().c_str(), true);
+        initTopic(_maintenancePathPrefix, mqtt_topic_webserver_action, "--");
+        subscribe(_maintenancePathPrefix, mqtt_topic_webserver_action);
+        _topicRouter.add(_maintenancePathPrefix, mqtt_topic_webserver_action);
+        initTopic(_maintenancePathPrefix, mqtt_topic_webserver_state, (_preferences->getBool(preference_webserver_enabled, true) || forceEnableWebServer ? "1" : "0"));
 
-            _mqttConnectionState = 2;
-            for(const auto& callback : _reconnectedCallbacks)
-            {
-                callback();
-            }
-        }
-        else
+        for(const auto& it : _initTopics)
         {
-            Log->print(F("MQTT connect failed"));
-            _mqttConnectionState = 0;
-            _nextReconnect = espMillis() + 5000;
-            //_device->mqttDisconnect(true);
+            publish(it.first.c_str(), it.second.c_str(), true);
         }
     }
-    return _mqttConnectionState > 0;
+
+    // The broker keeps the subscriptions of a present session, as long as this boot's were all acknowledged
+    if(_sessionPresent && _subscriptionTracker.subscribed(_subscribedTopics.size()))
+    {
+        Log->println(F("MQTT session present, skipping resubscribe"));
+    }
+    else
+    {
+        subscribeTopics();
+    }
+
+    publishString(_maintenancePathPrefix, mqtt_topic_mqtt_connection_state, "online", true);
+    publishString(_maintenancePathPrefix, mqtt_topic_info_nuki_hub_ip, _device->localIP().c_str(), true);
+
+    _mqttConnectionState = 2;
+    for(const auto& callback : _reconnectedCallbacks)
+    {
+        callback();
+    }
+    return true;
+}
+
+void NukiNetwork::scheduleReconnect(int64_t ts)
+{
+    _reconnectScheduler.attemptFailed(ts, random(INT32_MAX));
+    _mqttConnectCounter++;
 }
 
 void NukiNetwork::subscribe(const char* prefix, const char *path)
@@ -789,6 +923,8 @@ void NukiNetwork::subscribe(const char* prefix, const char *path)
     char prefixedPath[500];
     buildMqttPath(prefixedPath, { prefix, path });
     _subscribedTopics.push_back(prefixedPath);
+    // Subscribed topics are also written by other clients, the retained value may differ from what was last published here
+    _publishCache.setForced(prefixedPath);
 }
 
 void NukiNetwork::initTopic(const char *prefix, const char *path, const char *value)
@@ -800,32 +936,6 @@ void NukiNetwork::initTopic(const char *prefix, const char *path, const char *va
     _initTopics[pathStr] = valueStr;
 }
 
-void NukiNetwork::buildMqttPath(const char *path, char *outPath)
-{
-    int offset = 0;
-    char inPath[181] = {0};
-
-    memcpy(inPath, _nukiHubPath, sizeof(_nukiHubPath));
-
-    for(const char& c : inPath)
-    {
-        if(c == 0x00)
-        {
-            break;
-        }
-        outPath[offset] = c;
-        ++offset;
-    }
-    int i=0;
-    while(outPath[i] != 0x00)
-    {
-        outPath[offset] = path[i];
-        ++i;
-        ++offset;
-    }
-    outPath[i+1] = 0x00;
-}
-
 void NukiNetwork::buildMqttPath(char* outPath, std::initializer_list<const char*> paths)
 {
     int offset = 0;
@@ -859,16 +969,15 @@ void NukiNetwork::registerMqttReceiver(MqttReceiver* receiver)
 
 void NukiNetwork::onMqttDataReceivedCallback(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total)
 {
-    uint8_t value[800] = {0};
-
-    size_t l = min(len, sizeof(value)-1);
+    uint8_t* value = _inst->_messageAssembler.add(properties, payload, len, index, total);
 
-    for(int i=0; i<l; i++)
+    if(value == nullptr)
     {
-        value[i] = payload[i];
+        return;
     }
 
-    _inst->onMqttDataReceived(properties, topic, value, len, index, total);
+    size_t valueIndex = 0;
+    _inst->onMqttDataReceived(properties, topic, value, total, valueIndex, total);
 }
 
 void NukiNetwork::onMqttDataReceived(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total)
@@ -880,26 +989,32 @@ void NukiNetwork::onMqttDataReceived(const espMqttClientTypes::MessageProperties
 
     parseGpioTopics(properties, topic, payload, len, index, total);
 
-    onMqttDataReceived(topic, (byte*)payload, index);
+    onMqttDataReceived(topic, (byte*)payload, len);
 
     for(auto receiver : _mqttReceivers)
     {
-        receiver->onMqttDataReceived(topic, (byte*)payload, index);
+        receiver->onMqttDataReceived(topic, (byte*)payload, len);
     }
 }
 
 void NukiNetwork::onMqttDataReceived(const char* topic, byte* payload, const unsigned int length)
 {
     char* data = (char*)payload;
+    const char* subTopic = _topicRouter.match(topic);
+
+    if(subTopic == nullptr)
+    {
+        return;
+    }
 
-    if(comparePrefixedPath(topic, mqtt_topic_reset) && strcmp(data, "1") == 0 && !mqttRecentlyConnected())
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_reset) && strcmp(data, "1") == 0 && !mqttRecentlyConnected())
     {
         Log->println(F("Restart requested via MQTT."));
         clearWifiFallback();
         delay(200);
         restartEsp(RestartReason::RequestedViaMqtt);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_update) && strcmp(data, "1") == 0 && _preferences->getBool(preference_update_from_mqtt, false))
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_update) && strcmp(data, "1") == 0 && _preferences->getBool(preference_update_from_mqtt, false))
     {
         Log->println(F("Update requested via MQTT."));
 
@@ -1004,7 +1119,7 @@ void NukiNetwork::onMqttDataReceived(const char* topic, byte* payload, const uns
             Log->println(F("Failed to retrieve OTA manifest, OTA update aborted."));
         }
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_webserver_action))
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_webserver_action))
     {
         if(strcmp(data, "") == 0 ||
                 strcmp(data, "--") == 0)
@@ -1040,11 +1155,9 @@ void NukiNetwork::onMqttDataReceived(const char* topic, byte* payload, const uns
 
 void NukiNetwork::parseGpioTopics(const espMqttClientTypes::MessageProperties &properties, const char *topic, const uint8_t *payload, size_t& len, size_t& index, size_t& total)
 {
-    char gpioPath[250];
-    buildMqttPath(gpioPath, {_lockPath.c_str(), mqtt_topic_gpio_prefix, mqtt_topic_gpio_pin});
 //    /nuki_t/gpio/pin_17/state
-    size_t gpioLen = strlen(gpioPath);
-    if(strncmp(gpioPath, topic, gpioLen) == 0)
+    size_t gpioLen = _gpioPinPathLength;
+    if(gpioLen > 0 && strncmp(_gpioPinPath, topic, gpioLen) == 0)
     {
         char pinStr[3] = {0};
         pinStr[0] = topic[gpioLen];
@@ -1089,13 +1202,6 @@ bool NukiNetwork::mqttRecentlyConnected()
     return _mqttConnectedTs != -1 && (millis() - _mqttConnectedTs < 6000);
 }
 
-bool NukiNetwork::pathEquals(const char* prefix, const char* path, const char* referencePath)
-{
-    char prefixedPath[500];
-    buildMqttPath(prefixedPath, { prefix, path });
-    return strcmp(prefixedPath, referencePath) == 0;
-}
-
 void NukiNetwork::publishFloat(const char* prefix, const char* topic, const float value, bool retain, const uint8_t precision)
 {
     char str[30];
@@ -1147,12 +1253,207 @@ void NukiNetwork::publish(const char* prefix, const char *topic, const char *val
 {
     char path[200] = {0};
     buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, value);
+    publish(path, value, retain, MqttTopicPolicy::get(topic));
 }
 
 void NukiNetwork::publish(const char* path, const char *value, bool retain)
 {
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, value);
+    publish(path, value, retain, MqttTopicPolicy::getDefault());
+}
+
+void NukiNetwork::publish(const char* path, const char *value, bool retain, const MqttTopicPolicy& policy)
+{
+    retain = policy.applyRetain(retain);
+    espMqttClientTypes::Priority priority = clientPriority(policy.priority);
+
+    // shed telemetry while the outbox is congested, checked before the cache so the value is sent again later
+    if(policy.priority == MqttPublishPriority::Low && _device->mqttCongested(priority))
+    {
+        return;
+    }
+
+    if(!_telemetryFilter.accept(path, value, policy, espMillis()))
+    {
+        return;
+    }
+
+    if(retain && !_publishCache.changed(path, value))
+    {
+        return;
+    }
+
+    if(_device->mqttPublish(path, policy.qos, retain, value, priority, policy.coalesce) == 0)
+    {
+        _telemetryFilter.invalidate(path);
+        if(retain)
+        {
+            _publishCache.invalidate(path);
+        }
+    }
+    else if(retain)
+    {
+        _publishCache.queued(path, policy.qos);
+    }
+}
+
+espMqttClientTypes::Priority NukiNetwork::clientPriority(MqttPublishPriority priority)
+{
+    switch(priority)
+    {
+        case MqttPublishPriority::Low:
+            return espMqttClientTypes::Priority::BACKGROUND;
+        case MqttPublishPriority::High:
+            return espMqttClientTypes::Priority::CRITICAL;
+        default:
+            return espMqttClientTypes::Priority::NORMAL;
+    }
+}
+
+void NukiNetwork::publishMqttPoolStats()
+{
+    espMqttClientTypes::PoolStats stats[4];
+    size_t count = _device->mqttPoolStats(stats, 4);
+    if(count == 0)
+    {
+        return;
+    }
+
+    JsonDocument doc;
+    for(size_t i = 0; i < count; i++)
+    {
+        JsonObject pool = doc.add<JsonObject>();
+        pool["blockSize"] = stats[i].blockSize;
+        pool["blocks"] = stats[i].blocks;
+        pool["used"] = stats[i].used;
+        pool["highWater"] = stats[i].highWater;
+        pool["fallbacks"] = stats[i].fallbacks;
+    }
+    publishJson(_maintenancePathPrefix, mqtt_topic_mqtt_pool_stats, doc.as<JsonVariantConst>(), true);
+}
+
+void NukiNetwork::publishJson(const char* prefix, const char* topic, JsonVariantConst json, bool retain)
+{
+    char path[200] = {0};
+    buildMqttPath(path, { prefix, topic });
+    publishJson(path, json, retain, MqttTopicPolicy::get(topic));
+}
+
+void NukiNetwork::publishJson(const char* path, JsonVariantConst json, bool retain, const MqttTopicPolicy& policy)
+{
+    retain = policy.applyRetain(retain);
+    espMqttClientTypes::Priority priority = clientPriority(policy.priority);
+
+    if(policy.priority == MqttPublishPriority::Low && _device->mqttCongested(priority))
+    {
+        return;
+    }
+
+    // one pass to digest and measure, the second one serializes straight into the packet buffer
+    MqttPublishCache::Digest digest;
+    serializeJson(json, digest);
+
+    if(retain && !_publishCache.changed(path, digest))
+    {
+        return;
+    }
+
+    auto writer = [json](uint8_t* data, size_t length)
+    {
+        return serializeJson(json, data, length);
+    };
+
+    if(!retain)
+    {
+        _device->mqttPublish(path, policy.qos, retain, writer, digest.length(), priority, policy.coalesce);
+    }
+    else if(_device->mqttPublish(path, policy.qos, retain, writer, digest.length(), priority, policy.coalesce) == 0)
+    {
+        _publishCache.invalidate(path);
+    }
+    else
+    {
+        _publishCache.queued(path, policy.qos);
+    }
+}
+
+uint8_t NukiNetwork::addEventSource(const char* mqttPath)
+{
+    _eventSources.push_back(mqttPath);
+    return _eventSources.size() - 1;
+}
+
+void NukiNetwork::recordEvent(uint8_t source, const char* type, const char* value, const char* detail)
+{
+    _eventJournal.record(source, type, value, detail, espMillis());
+}
+
+void NukiNetwork::replayEvents(uint8_t source, uint32_t sequence)
+{
+    _eventJournal.replayAfter(source, sequence);
+}
+
+void NukiNetwork::publishJournalEvent(int64_t ts)
+{
+    EventJournal::Event event;
+
+    if(!_eventJournal.peek(event))
+    {
+        return;
+    }
+
+    // sources are registered in the same order every boot, events of an unknown source can't be published
+    if(event.source >= _eventSources.size())
+    {
+        _eventJournal.published(event.source, event.sequence);
+        return;
+    }
+
+    const MqttTopicPolicy& policy = MqttTopicPolicy::get(mqtt_topic_events);
+    espMqttClientTypes::Priority priority = clientPriority(policy.priority);
+
+    if(_device->mqttCongested(priority))
+    {
+        return;
+    }
+
+    JsonDocument json;
+    json["sequence"] = event.sequence;
+    json["type"] = event.type;
+    json["value"] = event.value;
+    if(event.detail[0] != '\0')
+    {
+        json["detail"] = event.detail;
+    }
+    if(event.boot == _eventJournal.boot())
+    {
+        json["age"] = ts - event.timestamp;
+    }
+    else
+    {
+        json["previousBoot"] = true;
+    }
+
+    char path[200] = {0};
+    buildMqttPath(path, { _eventSources[event.source], mqtt_topic_events });
+
+    size_t length = measureJson(json);
+    auto writer = [&json](uint8_t* data, size_t length)
+    {
+        return serializeJson(json, data, length);
+    };
+
+    // the event is published again with the next interval if it couldn't be queued
+    if(_device->mqttPublish(path, policy.qos, policy.applyRetain(false), writer, length, priority) != 0)
+    {
+        _eventJournal.published(event.source, event.sequence);
+    }
+}
+
+void NukiNetwork::setForcePublish(const char* prefix, const char* topic, bool force)
+{
+    char path[200] = {0};
+    buildMqttPath(path, { prefix, topic });
+    _publishCache.setForced(path, force);
 }
 
 void NukiNetwork::removeTopic(const String& mqttPath, const String& mqttTopic)
@@ -1201,195 +1502,30 @@ void NukiNetwork::removeHassTopic(const String& mqttDeviceType, const String& mq
     _hadiscovery->removeHassTopic(mqttDeviceType, mqttDeviceName, uidString);
 }
 
-void NukiNetwork::batteryTypeToString(const Nuki::BatteryType battype, char* str)
+void NukiNetwork::subscribeTopics()
 {
-    switch (battype)
-    {
-    case Nuki::BatteryType::Alkali:
-        strcpy(str, "Alkali");
-        break;
-    case Nuki::BatteryType::Accumulators:
-        strcpy(str, "Accumulators");
-        break;
-    case Nuki::BatteryType::Lithium:
-        strcpy(str, "Lithium");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
+    // Batch the topics into as few SUBSCRIBE packets as the SUBACK size allows
+    espMqttClientTypes::Subscription subscriptions[EMC_MAX_SUBSCRIBE_TOPICS];
+    size_t count = 0;
 
-void NukiNetwork::advertisingModeToString(const Nuki::AdvertisingMode advmode, char* str)
-{
-    switch (advmode)
-    {
-    case Nuki::AdvertisingMode::Automatic:
-        strcpy(str, "Automatic");
-        break;
-    case Nuki::AdvertisingMode::Normal:
-        strcpy(str, "Normal");
-        break;
-    case Nuki::AdvertisingMode::Slow:
-        strcpy(str, "Slow");
-        break;
-    case Nuki::AdvertisingMode::Slowest:
-        strcpy(str, "Slowest");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
+    _subscriptionTracker.started(_subscribedTopics.size());
 
-void NukiNetwork::timeZoneIdToString(const Nuki::TimeZoneId timeZoneId, char* str)
-{
-    switch (timeZoneId)
+    for(size_t i = 0; i < _subscribedTopics.size(); i++)
     {
-    case Nuki::TimeZoneId::Africa_Cairo:
-        strcpy(str, "Africa/Cairo");
-        break;
-    case Nuki::TimeZoneId::Africa_Lagos:
-        strcpy(str, "Africa/Lagos");
-        break;
-    case Nuki::TimeZoneId::Africa_Maputo:
-        strcpy(str, "Africa/Maputo");
-        break;
-    case Nuki::TimeZoneId::Africa_Nairobi:
-        strcpy(str, "Africa/Nairobi");
-        break;
-    case Nuki::TimeZoneId::America_Anchorage:
-        strcpy(str, "America/Anchorage");
-        break;
-    case Nuki::TimeZoneId::America_Argentina_Buenos_Aires:
-        strcpy(str, "America/Argentina/Buenos_Aires");
-        break;
-    case Nuki::TimeZoneId::America_Chicago:
-        strcpy(str, "America/Chicago");
-        break;
-    case Nuki::TimeZoneId::America_Denver:
-        strcpy(str, "America/Denver");
-        break;
-    case Nuki::TimeZoneId::America_Halifax:
-        strcpy(str, "America/Halifax");
-        break;
-    case Nuki::TimeZoneId::America_Los_Angeles:
-        strcpy(str, "America/Los_Angeles");
-        break;
-    case Nuki::TimeZoneId::America_Manaus:
-        strcpy(str, "America/Manaus");
-        break;
-    case Nuki::TimeZoneId::America_Mexico_City:
-        strcpy(str, "America/Mexico_City");
-        break;
-    case Nuki::TimeZoneId::America_New_York:
-        strcpy(str, "America/New_York");
-        break;
-    case Nuki::TimeZoneId::America_Phoenix:
-        strcpy(str, "America/Phoenix");
-        break;
-    case Nuki::TimeZoneId::America_Regina:
-        strcpy(str, "America/Regina");
-        break;
-    case Nuki::TimeZoneId::America_Santiago:
-        strcpy(str, "America/Santiago");
-        break;
-    case Nuki::TimeZoneId::America_Sao_Paulo:
-        strcpy(str, "America/Sao_Paulo");
-        break;
-    case Nuki::TimeZoneId::America_St_Johns:
-        strcpy(str, "America/St_Johns");
-        break;
-    case Nuki::TimeZoneId::Asia_Bangkok:
-        strcpy(str, "Asia/Bangkok");
-        break;
-    case Nuki::TimeZoneId::Asia_Dubai:
-        strcpy(str, "Asia/Dubai");
-        break;
-    case Nuki::TimeZoneId::Asia_Hong_Kong:
-        strcpy(str, "Asia/Hong_Kong");
-        break;
-    case Nuki::TimeZoneId::Asia_Jerusalem:
-        strcpy(str, "Asia/Jerusalem");
-        break;
-    case Nuki::TimeZoneId::Asia_Karachi:
-        strcpy(str, "Asia/Karachi");
-        break;
-    case Nuki::TimeZoneId::Asia_Kathmandu:
-        strcpy(str, "Asia/Kathmandu");
-        break;
-    case Nuki::TimeZoneId::Asia_Kolkata:
-        strcpy(str, "Asia/Kolkata");
-        break;
-    case Nuki::TimeZoneId::Asia_Riyadh:
-        strcpy(str, "Asia/Riyadh");
-        break;
-    case Nuki::TimeZoneId::Asia_Seoul:
-        strcpy(str, "Asia/Seoul");
-        break;
-    case Nuki::TimeZoneId::Asia_Shanghai:
-        strcpy(str, "Asia/Shanghai");
-        break;
-    case Nuki::TimeZoneId::Asia_Tehran:
-        strcpy(str, "Asia/Tehran");
-        break;
-    case Nuki::TimeZoneId::Asia_Tokyo:
-        strcpy(str, "Asia/Tokyo");
-        break;
-    case Nuki::TimeZoneId::Asia_Yangon:
-        strcpy(str, "Asia/Yangon");
-        break;
-    case Nuki::TimeZoneId::Australia_Adelaide:
-        strcpy(str, "Australia/Adelaide");
-        break;
-    case Nuki::TimeZoneId::Australia_Brisbane:
-        strcpy(str, "Australia/Brisbane");
-        break;
-    case Nuki::TimeZoneId::Australia_Darwin:
-        strcpy(str, "Australia/Darwin");
-        break;
-    case Nuki::TimeZoneId::Australia_Hobart:
-        strcpy(str, "Australia/Hobart");
-        break;
-    case Nuki::TimeZoneId::Australia_Perth:
-        strcpy(str, "Australia/Perth");
-        break;
-    case Nuki::TimeZoneId::Australia_Sydney:
-        strcpy(str, "Australia/Sydney");
-        break;
-    case Nuki::TimeZoneId::Europe_Berlin:
-        strcpy(str, "Europe/Berlin");
-        break;
-    case Nuki::TimeZoneId::Europe_Helsinki:
-        strcpy(str, "Europe/Helsinki");
-        break;
-    case Nuki::TimeZoneId::Europe_Istanbul:
-        strcpy(str, "Europe/Istanbul");
-        break;
-    case Nuki::TimeZoneId::Europe_London:
-        strcpy(str, "Europe/London");
-        break;
-    case Nuki::TimeZoneId::Europe_Moscow:
-        strcpy(str, "Europe/Moscow");
-        break;
-    case Nuki::TimeZoneId::Pacific_Auckland:
-        strcpy(str, "Pacific/Auckland");
-        break;
-    case Nuki::TimeZoneId::Pacific_Guam:
-        strcpy(str, "Pacific/Guam");
-        break;
-    case Nuki::TimeZoneId::Pacific_Honolulu:
-        strcpy(str, "Pacific/Honolulu");
-        break;
-    case Nuki::TimeZoneId::Pacific_Pago_Pago:
-        strcpy(str, "Pacific/Pago_Pago");
-        break;
-    case Nuki::TimeZoneId::None:
-        strcpy(str, "None");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
+        Log->print("Subscribing to MQTT topic: ");
+        Log->println(_subscribedTopics[i]);
+        subscriptions[count++] = { _subscribedTopics[i].c_str(), MQTT_QOS_LEVEL };
+
+        if(count == EMC_MAX_SUBSCRIBE_TOPICS || i == _subscribedTopics.size() - 1)
+        {
+            uint16_t packetId = _device->mqttSubscribe(subscriptions, count);
+            if(packetId == 0)
+            {
+                Log->println(F("MQTT subscribe failed"));
+            }
+            _subscriptionTracker.sent(packetId);
+            count = 0;
+        }
     }
 }
 
@@ -1400,14 +1536,6 @@ uint16_t NukiNetwork::subscribe(const char *topic, uint8_t qos)
     return _device->mqttSubscribe(topic, qos);
 }
 
-bool NukiNetwork::comparePrefixedPath(const char *fullPath, const char *subPath)
-{
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-
-    return strcmp(fullPath, prefixedPath) == 0;
-}
-
 void NukiNetwork::addReconnectedCallback(std::function<void()> reconnectedCallback)
 {
     _reconnectedCallbacks.push_back(reconnectedCallback);
@@ -12,6 +12,15 @@
 #ifndef NUKI_HUB_UPDATER
 #include "MqttReceiver.h"
 #include "MqttTopics.h"
+#include "MqttTopicRouter.h"
+#include "MqttPublishCache.h"
+#include "MqttTelemetryFilter.h"
+#include "MqttMessageAssembler.h"
+#include "MqttReconnectScheduler.h"
+#include "MqttSubscriptionTracker.h"
+#include "MqttTopicPolicy.h"
+#include "EventJournal.h"
+#include "Config.h"
 #include "Gpio.h"
 #include <ArduinoJson.h>
 #include "NukiConstants.h"
@@ -59,10 +68,11 @@ public:
     void publishString(const char* prefix, const char* topic, const char* value, bool retain);
     void publish(const char* prefix, const char *topic, const char *value, bool retain);
     void publish(const char* path, const char *value, bool retain);
+    void publish(const char* path, const char *value, bool retain, const MqttTopicPolicy& policy);
+    void publishJson(const char* prefix, const char* topic, JsonVariantConst json, bool retain);
+    void publishJson(const char* path, JsonVariantConst json, bool retain, const MqttTopicPolicy& policy);
+    void setForcePublish(const char* prefix, const char* topic, bool force = true);
     void removeTopic(const String& mqttPath, const String& mqttTopic);
-    void batteryTypeToString(const Nuki::BatteryType battype, char* str);
-    void advertisingModeToString(const Nuki::AdvertisingMode advmode, char* str);
-    void timeZoneIdToString(const Nuki::TimeZoneId timeZoneId, char* str);
 
     void setupHASS(int type, uint32_t nukiId, char* nukiName, const char* firmwareVersion, const char* hardwareVersion, bool hasDoorSensor, bool hasKeypad);
     void disableHASS();
@@ -83,9 +93,13 @@ public:
                           );
     void removeHassTopic(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString);
 
+    // Events are journaled and published in order to <mqttPath>/events, including those that happened while offline
+    uint8_t addEventSource(const char* mqttPath);
+    void recordEvent(uint8_t source, const char* type, const char* value, const char* detail = "");
+    void replayEvents(uint8_t source, uint32_t sequence);
+
     int mqttConnectionState(); // 0 = not connected; 1 = connected; 2 = connected and mqtt processed
     bool mqttRecentlyConnected();
-    bool pathEquals(const char* prefix, const char* path, const char* referencePath);
     uint16_t subscribe(const char* topic, uint8_t qos);
     void addReconnectedCallback(std::function<void()> reconnectedCallback);
     #endif
@@ -118,27 +132,41 @@ private:
     void onMqttDisconnect(const espMqttClientTypes::DisconnectReason& reason);
     void parseGpioTopics(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total);
     void gpioActionCallback(const GpioAction& action, const int& pin);
-    bool comparePrefixedPath(const char* fullPath, const char* subPath);
-    void buildMqttPath(const char *path, char *outPath);
     void buildMqttPath(char* outPath, std::initializer_list<const char*> paths);
+    static espMqttClientTypes::Priority clientPriority(MqttPublishPriority priority);
+    void scheduleReconnect(int64_t ts);
+    void publishMqttPoolStats();
+    void subscribeTopics();
+    void restorePublishDigest();
+    void storePublishDigest();
+    void publishJournalEvent(int64_t ts);
 
     const char* _lastWillPayload = "offline";
     char _mqttConnectionStateTopic[211] = {0};
     String _lockPath;
 
     HomeAssistantDiscovery* _hadiscovery = nullptr;
+    MqttTopicRouter _topicRouter;
+    MqttPublishCache _publishCache;
+    MqttTelemetryFilter _telemetryFilter;
+    EventJournal _eventJournal;
+    std::vector<const char*> _eventSources;
+    MqttMessageAssembler _messageAssembler{MQTT_MAX_INBOUND_PAYLOAD_SIZE};
 
     Gpio* _gpio;
 
     int _mqttConnectionState = 0;
+    MqttReconnectScheduler _reconnectScheduler;
     int _mqttConnectCounter = 0;
     int _mqttPort = 1883;
     long _mqttConnectedTs = -1;
     bool _connectReplyReceived = false;
+    bool _sessionPresent = false;
+    MqttSubscriptionTracker _subscriptionTracker;
+    bool _disconnectReceived = false;
     bool _firstDisconnected = true;
 
     int64_t _publishedUpTime = 0;
-    int64_t _nextReconnect = 0;
     char _mqttBrokerAddr[101] = {0};
     char _mqttUser[31] = {0};
     char _mqttPass[31] = {0};
@@ -155,15 +183,19 @@ private:
     std::map<String, String> _initTopics;
     int64_t _lastConnectedTs = 0;
     int64_t _lastMaintenanceTs = 0;
+    int64_t _lastPublishDigestTs = 0;
+    uint32_t _storedPublishRevision = 0;
+    int64_t _lastEventReplayTs = 0;
     int64_t _lastUpdateCheckTs = 0;
     int64_t _lastRssiTs = 0;
     bool _mqttEnabled = true;
     int _rssiPublishInterval = 0;
     std::map<uint8_t, int64_t> _gpioTs;
+    char _gpioPinPath[250] = {0};
+    size_t _gpioPinPathLength = 0;
 
     char* _buffer;
     const size_t _bufferSize;
 
-    int8_t _lastRssi = 127;
     #endif
 };
\ No newline at end of file
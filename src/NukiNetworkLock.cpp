@@ -1,4 +1,5 @@
 #include "NukiNetworkLock.h"
+#include "NukiPayloads.h"
 #include "Arduino.h"
 #include "Config.h"
 #include "MqttTopics.h"
@@ -20,6 +21,7 @@ NukiNetworkLock::NukiNetworkLock(NukiNetwork* network, NukiOfficial* nukiOfficia
       _bufferSize(bufferSize)
 {
     _nukiPublisher = new NukiPublisher(network, _mqttPath);
+    _eventSource = _network->addEventSource(_mqttPath);
     _nukiOfficial->setPublisher(_nukiPublisher);
 
     memset(_authName, 0, sizeof(_authName));
@@ -45,18 +47,44 @@ void NukiNetworkLock::initialize()
 
     _haEnabled = _preferences->getString(preference_mqtt_hass_discovery, "") != "";
     _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+    _snapshotEnabled = _preferences->getBool(preference_publish_snapshot, false);
+
+    // published on every lock state update
+    _keyTurnerTopics.state = _nukiPublisher->internTopic(mqtt_topic_lock_state);
+    _keyTurnerTopics.trigger = _nukiPublisher->internTopic(mqtt_topic_lock_trigger);
+    _keyTurnerTopics.lastLockAction = _nukiPublisher->internTopic(mqtt_topic_lock_last_lock_action);
+    _keyTurnerTopics.completionStatus = _nukiPublisher->internTopic(mqtt_topic_lock_completionStatus);
+    _keyTurnerTopics.doorSensorState = _nukiPublisher->internTopic(mqtt_topic_lock_door_sensor_state);
+    _keyTurnerTopics.batteryCritical = _nukiPublisher->internTopic(mqtt_topic_battery_critical);
+    _keyTurnerTopics.batteryCharging = _nukiPublisher->internTopic(mqtt_topic_battery_charging);
+    _keyTurnerTopics.batteryLevel = _nukiPublisher->internTopic(mqtt_topic_battery_level);
+    _keyTurnerTopics.keypadBatteryCritical = _nukiPublisher->internTopic(mqtt_topic_battery_keypad_critical);
+    _keyTurnerTopics.batteryBasicJson = _nukiPublisher->internTopic(mqtt_topic_battery_basic_json);
+    _keyTurnerTopics.json = _nukiPublisher->internTopic(mqtt_topic_lock_json);
+
+    // Command results and retries are responses to a request and must be sent even if unchanged
+    _network->setForcePublish(_mqttPath, mqtt_topic_lock_action_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_query_lockstate_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_config_action_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_keypad_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_keypad_json_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_timecontrol_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_auth_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_lock_retry);
 
     _network->initTopic(_mqttPath, mqtt_topic_lock_action, "--");
-    _network->subscribe(_mqttPath, mqtt_topic_lock_action);
+    subscribe(mqtt_topic_lock_action);
     _network->initTopic(_mqttPath, mqtt_topic_config_action, "--");
-    _network->subscribe(_mqttPath, mqtt_topic_config_action);
+    subscribe(mqtt_topic_config_action);
 
     _network->initTopic(_mqttPath, mqtt_topic_query_config, "0");
     _network->initTopic(_mqttPath, mqtt_topic_query_lockstate, "0");
     _network->initTopic(_mqttPath, mqtt_topic_query_battery, "0");
-    _network->subscribe(_mqttPath, mqtt_topic_query_config);
-    _network->subscribe(_mqttPath, mqtt_topic_query_lockstate);
-    _network->subscribe(_mqttPath, mqtt_topic_query_battery);
+    subscribe(mqtt_topic_query_config);
+    subscribe(mqtt_topic_query_lockstate);
+    subscribe(mqtt_topic_query_battery);
+    _network->initTopic(_mqttPath, mqtt_topic_events_since, "--");
+    subscribe(mqtt_topic_events_since);
 
     if(_disableNonJSON)
     {
@@ -103,29 +131,29 @@ void NukiNetworkLock::initialize()
             _network->initTopic(_mqttPath, mqtt_topic_keypad_command_name, "--");
             _network->initTopic(_mqttPath, mqtt_topic_keypad_command_code, "000000");
             _network->initTopic(_mqttPath, mqtt_topic_keypad_command_enabled, "1");
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_action);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_id);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_name);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_code);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_enabled);
+            subscribe(mqtt_topic_keypad_command_action);
+            subscribe(mqtt_topic_keypad_command_id);
+            subscribe(mqtt_topic_keypad_command_name);
+            subscribe(mqtt_topic_keypad_command_code);
+            subscribe(mqtt_topic_keypad_command_enabled);
         }
 
         _network->initTopic(_mqttPath, mqtt_topic_query_keypad, "0");
         _network->initTopic(_mqttPath, mqtt_topic_keypad_json_action, "--");
-        _network->subscribe(_mqttPath, mqtt_topic_query_keypad);
-        _network->subscribe(_mqttPath, mqtt_topic_keypad_json_action);
+        subscribe(mqtt_topic_query_keypad);
+        subscribe(mqtt_topic_keypad_json_action);
     }
 
     if(_preferences->getBool(preference_timecontrol_control_enabled))
     {
         _network->initTopic(_mqttPath, mqtt_topic_timecontrol_action, "--");
-        _network->subscribe(_mqttPath, mqtt_topic_timecontrol_action);
+        subscribe(mqtt_topic_timecontrol_action);
     }
 
     if(_preferences->getBool(preference_auth_control_enabled))
     {
         _network->initTopic(_mqttPath, mqtt_topic_auth_action, "--");
-        _network->subscribe(_mqttPath, mqtt_topic_auth_action);
+        subscribe(mqtt_topic_auth_action);
     }
 
     if(_nukiOfficial->getOffEnabled())
@@ -140,7 +168,7 @@ void NukiNetworkLock::initialize()
 
     if(_preferences->getBool(preference_publish_authdata, false))
     {
-        _network->subscribe(_mqttPath, mqtt_topic_lock_log_rolling_last);
+        subscribe(mqtt_topic_lock_log_rolling_last);
     }
 /*
     _network->addReconnectedCallback([&]()
@@ -161,14 +189,35 @@ void NukiNetworkLock::update()
 void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const unsigned int length)
 {
     char* data = (char*)payload;
+    const char* subTopic = _topicRouter.match(topic);
+    const char* offTopic = _nukiOfficial->getOffEnabled() ? _nukiOfficial->matchOffTopic(topic) : nullptr;
 
-    if(_network->mqttRecentlyConnected() && _network->pathEquals(_mqttPath, mqtt_topic_lock_action, topic))
+    if(subTopic == nullptr && offTopic == nullptr)
+    {
+        return;
+    }
+
+    if(_network->mqttRecentlyConnected() && MqttTopicRouter::equals(subTopic, mqtt_topic_lock_action))
     {
         Log->println("MQTT recently connected, ignoring lock action.");
         return;
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_lock_log_rolling_last))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_events_since))
+    {
+        if(data[0] < '0' || data[0] > '9')
+        {
+            return;
+        }
+
+        Log->print(F("Replaying events after sequence "));
+        Log->println(data);
+        _network->replayEvents(_eventSource, strtoul(data, nullptr, 10));
+        _nukiPublisher->publishString(mqtt_topic_events_since, "--", true);
+        return;
+    }
+
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_lock_log_rolling_last))
     {
         if(strcmp(data, "") == 0 ||
                 strcmp(data, "--") == 0)
@@ -182,21 +231,12 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
         }
     }
 
-    if(_nukiOfficial->getOffEnabled())
+    if(offTopic != nullptr && _officialUpdateReceivedCallback != nullptr)
     {
-        for(auto offTopic : _nukiOfficial->getOffTopics())
-        {
-            if(_nukiOfficial->comparePrefixedPath(topic, offTopic))
-            {
-                if(_officialUpdateReceivedCallback != nullptr)
-                {
-                    _officialUpdateReceivedCallback(offTopic, data);
-                }
-            }
-        }
+        _officialUpdateReceivedCallback(offTopic, data);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_lock_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_lock_action))
     {
         if(strcmp(data, "") == 0 ||
                 strcmp(data, "--") == 0 ||
@@ -235,7 +275,7 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
 
     if(!_disableNonJSON)
     {
-        if(comparePrefixedPath(topic, mqtt_topic_keypad_command_action))
+        if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_action))
         {
             if(_keypadCommandReceivedReceivedCallback != nullptr)
             {
@@ -261,46 +301,46 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
                 _nukiPublisher->publishInt(mqtt_topic_keypad_command_enabled, _keypadCommandEnabled, true);
             }
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_id))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_id))
         {
             _keypadCommandId = atoi(data);
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_name))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_name))
         {
             _keypadCommandName = data;
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_code))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_code))
         {
             _keypadCommandCode = data;
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_enabled))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_enabled))
         {
             _keypadCommandEnabled = atoi(data);
         }
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_query_config) && strcmp(data, "1") == 0)
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_config) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_CONFIG;
         _nukiPublisher->publishInt(mqtt_topic_query_config, 0, true);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_lockstate) && strcmp(data, "1") == 0)
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_lockstate) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_LOCKSTATE;
         _nukiPublisher->publishInt(mqtt_topic_query_lockstate, 0, true);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_keypad) && strcmp(data, "1") == 0)
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_keypad) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_KEYPAD;
         _nukiPublisher->publishInt(mqtt_topic_query_keypad, 0, true);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_battery) && strcmp(data, "1") == 0)
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_battery) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_BATTERY;
         _nukiPublisher->publishInt(mqtt_topic_query_battery, 0, true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_config_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_config_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -315,7 +355,7 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
         _nukiPublisher->publishString(mqtt_topic_config_action, "--", true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_keypad_json_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_json_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -330,7 +370,7 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
         _nukiPublisher->publishString(mqtt_topic_keypad_json_action, "--", true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_timecontrol_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_timecontrol_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -345,7 +385,7 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
         _nukiPublisher->publishString(mqtt_topic_timecontrol_action, "--", true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_auth_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_auth_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -369,19 +409,32 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
     JsonDocument json;
     JsonDocument jsonBattery;
 
+    // in snapshot mode only the topics Home Assistant discovery reads are published next to the snapshot
+    bool fieldTopics = !_snapshotEnabled;
+    bool haTopics = !_snapshotEnabled || _haEnabled;
+
     if(!_nukiOfficial->getOffConnected())
     {
         lockstateToString(keyTurnerState.lockState, str);
 
         if(keyTurnerState.lockState != NukiLock::LockState::Undefined)
         {
-
-            _nukiPublisher->publishString(mqtt_topic_lock_state, str, true);
+            if(fieldTopics)
+            {
+                _nukiPublisher->publishString(_keyTurnerTopics.state, str, true);
+            }
 
             if(_haEnabled)
             {
                 publishState(keyTurnerState.lockState);
             }
+
+            if(!_firstTunerStatePublish && keyTurnerState.lockState != lastKeyTurnerState.lockState)
+            {
+                char trigger[30] = {0};
+                triggerToString(keyTurnerState.trigger, trigger);
+                _network->recordEvent(_eventSource, "lockState", str, trigger);
+            }
         }
 
         json["lock_state"] = str;
@@ -400,9 +453,9 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
     {
         triggerToString(keyTurnerState.trigger, str);
 
-        if(_firstTunerStatePublish || keyTurnerState.trigger != lastKeyTurnerState.trigger)
+        if((_firstTunerStatePublish || keyTurnerState.trigger != lastKeyTurnerState.trigger) && haTopics)
         {
-            _nukiPublisher->publishString(mqtt_topic_lock_trigger, str, true);
+            _nukiPublisher->publishString(_keyTurnerTopics.trigger, str, true);
         }
 
         json["trigger"] = str;
@@ -427,7 +480,17 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
 
         if(_firstTunerStatePublish || keyTurnerState.lastLockAction != lastKeyTurnerState.lastLockAction)
         {
-            _nukiPublisher->publishString(mqtt_topic_lock_last_lock_action, str, true);
+            if(fieldTopics)
+            {
+                _nukiPublisher->publishString(_keyTurnerTopics.lastLockAction, str, true);
+            }
+
+            if(!_firstTunerStatePublish)
+            {
+                char trigger[30] = {0};
+                triggerToString(keyTurnerState.lastLockActionTrigger, trigger);
+                _network->recordEvent(_eventSource, "lockAction", str, trigger);
+            }
         }
 
         json["last_lock_action"] = str;
@@ -445,9 +508,9 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
     memset(&str, 0, sizeof(str));
     NukiLock::completionStatusToString(keyTurnerState.lastLockActionCompletionStatus, str);
 
-    if(_firstTunerStatePublish || keyTurnerState.lastLockActionCompletionStatus != lastKeyTurnerState.lastLockActionCompletionStatus)
+    if((_firstTunerStatePublish || keyTurnerState.lastLockActionCompletionStatus != lastKeyTurnerState.lastLockActionCompletionStatus) && fieldTopics)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_completionStatus, str, true);
+        _nukiPublisher->publishString(_keyTurnerTopics.completionStatus, str, true);
     }
 
     json["lock_completion_status"] = str;
@@ -459,7 +522,15 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
 
         if(_firstTunerStatePublish || keyTurnerState.doorSensorState != lastKeyTurnerState.doorSensorState)
         {
-            _nukiPublisher->publishString(mqtt_topic_lock_door_sensor_state, str, true);
+            if(haTopics)
+            {
+                _nukiPublisher->publishString(_keyTurnerTopics.doorSensorState, str, true);
+            }
+
+            if(!_firstTunerStatePublish)
+            {
+                _network->recordEvent(_eventSource, "doorSensorState", str);
+            }
         }
 
         json["door_sensor_state"] = str;
@@ -474,20 +545,22 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
         jsonBattery["level"] = level;
         jsonBattery["keypadCritical"] = keypadCritical ? "1" : "0";
 
-        if((_firstTunerStatePublish || keyTurnerState.criticalBatteryState != lastKeyTurnerState.criticalBatteryState) && !_disableNonJSON)
+        if((_firstTunerStatePublish || keyTurnerState.criticalBatteryState != lastKeyTurnerState.criticalBatteryState) && !_disableNonJSON && fieldTopics)
         {
-            _nukiPublisher->publishBool(mqtt_topic_battery_critical, critical, true);
-            _nukiPublisher->publishBool(mqtt_topic_battery_charging, charging, true);
-            _nukiPublisher->publishInt(mqtt_topic_battery_level, level, true);
+            _nukiPublisher->publishBool(_keyTurnerTopics.batteryCritical, critical, true);
+            _nukiPublisher->publishBool(_keyTurnerTopics.batteryCharging, charging, true);
+            _nukiPublisher->publishInt(_keyTurnerTopics.batteryLevel, level, true);
         }
 
-        if((_firstTunerStatePublish || keyTurnerState.accessoryBatteryState != lastKeyTurnerState.accessoryBatteryState) && !_disableNonJSON)
+        if((_firstTunerStatePublish || keyTurnerState.accessoryBatteryState != lastKeyTurnerState.accessoryBatteryState) && !_disableNonJSON && fieldTopics)
         {
-            _nukiPublisher->publishBool(mqtt_topic_battery_keypad_critical, keypadCritical, true);
+            _nukiPublisher->publishBool(_keyTurnerTopics.keypadBatteryCritical, keypadCritical, true);
         }
 
-        serializeJson(jsonBattery, _buffer, _bufferSize);
-        _nukiPublisher->publishString(mqtt_topic_battery_basic_json, _buffer, true);
+        if(haTopics)
+        {
+            _nukiPublisher->publishJson(_keyTurnerTopics.batteryBasicJson, jsonBattery, true);
+        }
     }
     else
     {
@@ -498,12 +571,36 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
     json["auth_id"] = getAuthId();
     json["auth_name"] = _authName;
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_lock_json, _buffer, true);
+    if(fieldTopics)
+    {
+        _nukiPublisher->publishJson(_keyTurnerTopics.json, json, true);
+    }
+    else
+    {
+        publishSnapshot(json, jsonBattery);
+    }
 
     _firstTunerStatePublish = false;
 }
 
+void NukiNetworkLock::publishSnapshot(JsonVariantConst state, JsonVariantConst battery)
+{
+    JsonDocument json;
+    json["version"] = MQTT_SNAPSHOT_VERSION;
+    json["state"] = state;
+    if(battery.size() > 0)
+    {
+        json["battery"] = battery;
+    }
+    json["hybridConnected"] = _nukiOfficial->getOffConnected();
+
+    JsonObject lastAuth = json["lastAuth"].to<JsonObject>();
+    lastAuth["id"] = getAuthId();
+    lastAuth["name"] = _authName;
+
+    _nukiPublisher->publishJson(mqtt_topic_lock_snapshot, json, true);
+}
+
 void NukiNetworkLock::publishState(NukiLock::LockState lockState)
 {
     switch(lockState)
@@ -679,22 +776,24 @@ void NukiNetworkLock::publishAuthorizationInfo(const std::list<NukiLock::LogEntr
 
         if(log.index > _lastRollingLog)
         {
+            if(_lastRollingLog > 0)
+            {
+                _network->recordEvent(_eventSource, "authLog", entry["action"] | entry["type"].as<const char*>(), entry["authorizationName"] | "");
+            }
+
             _lastRollingLog = log.index;
-            serializeJson(entry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(mqtt_topic_lock_log_rolling, _buffer, true);
+            _nukiPublisher->publishJson(mqtt_topic_lock_log_rolling, entry, true);
             _nukiPublisher->publishInt(mqtt_topic_lock_log_rolling_last, log.index, true);
         }
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-
     if(latest)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_log_latest, _buffer, true);
+        _nukiPublisher->publishJson(mqtt_topic_lock_log_latest, json, true);
     }
     else
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_log, _buffer, true);
+        _nukiPublisher->publishJson(mqtt_topic_lock_log, json, true);
     }
 
     if(authIndex > 0)
@@ -731,79 +830,22 @@ void NukiNetworkLock::publishBatteryReport(const NukiLock::BatteryReport& batter
         _nukiPublisher->publishInt(mqtt_topic_battery_lock_distance, batteryReport.lockDistance, true); // degrees
     }
 
-    char str[50];
-    memset(&str, 0, sizeof(str));
-
-    JsonDocument json;
-
-    json["batteryDrain"] = batteryReport.batteryDrain;
-    json["batteryVoltage"] = (float)batteryReport.batteryVoltage / 1000.0;
-    json["critical"] = batteryReport.criticalBatteryState;
-    lockactionToString(batteryReport.lockAction, str);
-    json["lockAction"] = str;
-    json["startVoltage"] = (float)batteryReport.startVoltage / 1000.0;
-    json["lowestVoltage"] = (float)batteryReport.lowestVoltage / 1000.0;
-    json["lockDistance"] = (float)batteryReport.lockDistance / 1000.0;
-    json["startTemperature"] = batteryReport.startTemperature;
-    json["maxTurnCurrent"] = (float)batteryReport.maxTurnCurrent / 1000.0;
-    json["batteryResistance"] = (float)batteryReport.batteryResistance / 1000.0;
-
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_battery_advanced_json, _buffer, true);
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    NukiPayloads::lockBatteryReport(json, batteryReport);
+    _nukiPublisher->publishJson(mqtt_topic_battery_advanced_json, json, true);
 }
 
 void NukiNetworkLock::publishConfig(const NukiLock::Config &config)
 {
-    char str[50];
-    char curTime[20];
-    sprintf(curTime, "%04d-%02d-%02d %02d:%02d:%02d", config.currentTimeYear, config.currentTimeMonth, config.currentTimeDay, config.currentTimeHour, config.currentTimeMinute, config.currentTimeSecond);
-    char uidString[20];
-    itoa(config.nukiId, uidString, 16);
-
-    JsonDocument json;
+    char firmwareVersion[12];
+    NukiPayloads::firmwareVersion(config, firmwareVersion, sizeof(firmwareVersion));
+    char hardwareRevision[8];
+    NukiPayloads::hardwareRevision(config, hardwareRevision, sizeof(hardwareRevision));
+    NukiPayloads::name(config, _nukiName, sizeof(_nukiName));
 
-    memset(_nukiName, 0, sizeof(_nukiName));
-    memcpy(_nukiName, config.name, sizeof(config.name));
-
-    json["nukiID"] = uidString;
-    json["name"] = config.name;
-    //json["latitude"] = config.latitude;
-    //json["longitude"] = config.longitude;
-    json["autoUnlatch"] = config.autoUnlatch;
-    json["pairingEnabled"] = config.pairingEnabled;
-    json["buttonEnabled"] = config.buttonEnabled;
-    json["ledEnabled"] = config.ledEnabled;
-    json["ledBrightness"] = config.ledBrightness;
-    json["currentTime"] = curTime;
-    json["timeZoneOffset"] = config.timeZoneOffset;
-    json["dstMode"] = config.dstMode;
-    json["hasFob"] = config.hasFob;
-    memset(str, 0, sizeof(str));
-    fobActionToString(config.fobAction1, str);
-    json["fobAction1"] = str;
-    memset(str, 0, sizeof(str));
-    fobActionToString(config.fobAction2, str);
-    json["fobAction2"] = str;
-    memset(str, 0, sizeof(str));
-    fobActionToString(config.fobAction3, str);
-    json["fobAction3"] = str;
-    json["singleLock"] = config.singleLock;
-    memset(str, 0, sizeof(str));
-    _network->advertisingModeToString(config.advertisingMode, str);
-    json["advertisingMode"] = str;
-    json["hasKeypad"] = config.hasKeypad;
-    json["hasKeypadV2"] = config.hasKeypadV2;
-    json["firmwareVersion"] = std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]);
-    json["hardwareRevision"] = std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]);
-    memset(str, 0, sizeof(str));
-    homeKitStatusToString(config.homeKitStatus, str);
-    json["homeKitStatus"] = str;
-    memset(str, 0, sizeof(str));
-    _network->timeZoneIdToString(config.timeZoneId, str);
-    json["timeZone"] = str;
-
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_config_basic_json, _buffer, true);
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    NukiPayloads::lockConfig(json, config);
+    _nukiPublisher->publishJson(mqtt_topic_config_basic_json, json, true);
 
     if(!_disableNonJSON)
     {
@@ -813,53 +855,15 @@ void NukiNetworkLock::publishConfig(const NukiLock::Config &config)
         _nukiPublisher->publishBool(mqtt_topic_config_single_lock, config.singleLock == 1, true);
     }
 
-    _nukiPublisher->publishString(mqtt_topic_info_firmware_version, std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]), true);
-    _nukiPublisher->publishString(mqtt_topic_info_hardware_version, std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]), true);
+    _nukiPublisher->publishString(mqtt_topic_info_firmware_version, firmwareVersion, true);
+    _nukiPublisher->publishString(mqtt_topic_info_hardware_version, hardwareRevision, true);
 }
 
 void NukiNetworkLock::publishAdvancedConfig(const NukiLock::AdvancedConfig &config)
 {
-    char str[50];
-    char nmst[6];
-    sprintf(nmst, "%02d:%02d", config.nightModeStartTime[0], config.nightModeStartTime[1]);
-    char nmet[6];
-    sprintf(nmet, "%02d:%02d", config.nightModeEndTime[0], config.nightModeEndTime[1]);
-
-    JsonDocument json;
-
-    json["totalDegrees"] = config.totalDegrees;
-    json["unlockedPositionOffsetDegrees"] = config.unlockedPositionOffsetDegrees;
-    json["lockedPositionOffsetDegrees"] = config.lockedPositionOffsetDegrees;
-    json["singleLockedPositionOffsetDegrees"] = config.singleLockedPositionOffsetDegrees;
-    json["unlockedToLockedTransitionOffsetDegrees"] = config.unlockedToLockedTransitionOffsetDegrees;
-    json["lockNgoTimeout"] = config.lockNgoTimeout;
-    memset(str, 0, sizeof(str));
-    buttonPressActionToString(config.singleButtonPressAction, str);
-    json["singleButtonPressAction"] = str;
-    memset(str, 0, sizeof(str));
-    buttonPressActionToString(config.doubleButtonPressAction, str);
-    json["doubleButtonPressAction"] = str;
-    json["detachedCylinder"] = config.detachedCylinder;
-    memset(str, 0, sizeof(str));
-    _network->batteryTypeToString(config.batteryType, str);
-    json["batteryType"] = str;
-    json["automaticBatteryTypeDetection"] = config.automaticBatteryTypeDetection;
-    json["unlatchDuration"] = config.unlatchDuration;
-    json["autoLockTimeOut"] = config.autoLockTimeOut;
-    json["autoUnLockDisabled"] = config.autoUnLockDisabled;
-    json["nightModeEnabled"] = config.nightModeEnabled;
-    json["nightModeStartTime"] = nmst;
-    json["nightModeEndTime"] = nmet;
-    json["nightModeAutoLockEnabled"] = config.nightModeAutoLockEnabled;
-    json["nightModeAutoUnlockDisabled"] = config.nightModeAutoUnlockDisabled;
-    json["nightModeImmediateLockOnStart"] = config.nightModeImmediateLockOnStart;
-    json["autoLockEnabled"] = config.autoLockEnabled;
-    json["immediateAutoLockEnabled"] = config.immediateAutoLockEnabled;
-    json["autoUpdateEnabled"] = config.autoUpdateEnabled;
-    json["rebootNuki"] = 0;
-
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_config_advanced_json, _buffer, true);
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    NukiPayloads::lockAdvancedConfig(json, config);
+    _nukiPublisher->publishJson(mqtt_topic_config_advanced_json, json, true);
 
     if(!_disableNonJSON)
     {
@@ -878,6 +882,16 @@ void NukiNetworkLock::publishRetry(const std::string& message)
     _nukiPublisher->publishString(mqtt_topic_lock_retry, message, true);
 }
 
+void NukiNetworkLock::publishActionLatency(const ActionLatency& latency, uint8_t action)
+{
+    char topic[50];
+    snprintf(topic, sizeof(topic), "%s/%s", mqtt_topic_lock_action_latency, latency.actionName(action));
+
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    latency.writeJson(action, json);
+    _nukiPublisher->publishJson(topic, json, true);
+}
+
 void NukiNetworkLock::publishBleAddress(const std::string &address)
 {
     _nukiPublisher->publishString(mqtt_topic_lock_address, address, true);
@@ -989,8 +1003,7 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
             basePath.concat(std::to_string(index).c_str());
             jsonEntry["name_ha"] = entry.name;
             jsonEntry["index"] = index;
-            serializeJson(jsonEntry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(basePath.c_str(), _buffer, true);
+            _nukiPublisher->publishJson(basePath.c_str(), jsonEntry, true);
 
             String basePathPrefix = "~";
             basePathPrefix.concat(basePath);
@@ -1032,8 +1045,7 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
         ++index;
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_keypad_json, _buffer, true);
+    _nukiPublisher->publishJson(mqtt_topic_keypad_json, json, true);
 
     if(!_disableNonJSON)
     {
@@ -1207,8 +1219,7 @@ void NukiNetworkLock::publishTimeControl(const std::list<NukiLock::TimeControlEn
             basePath.concat("/entries/");
             basePath.concat(std::to_string(index).c_str());
             jsonEntry["index"] = index;
-            serializeJson(jsonEntry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(basePath.c_str(), _buffer, true);
+            _nukiPublisher->publishJson(basePath.c_str(), jsonEntry, true);
 
             String basePathPrefix = "~";
             basePathPrefix.concat(basePath);
@@ -1247,8 +1258,7 @@ void NukiNetworkLock::publishTimeControl(const std::list<NukiLock::TimeControlEn
         ++index;
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_timecontrol_json, _buffer, true);
+    _nukiPublisher->publishJson(mqtt_topic_timecontrol_json, json, true);
 
     for(int j=timeControlEntries.size(); j<maxTimeControlEntryCount; j++)
     {
@@ -1358,8 +1368,7 @@ void NukiNetworkLock::publishAuth(const std::list<NukiLock::AuthorizationEntry>&
             basePath.concat("/entries/");
             basePath.concat(std::to_string(index).c_str());
             jsonEntry["index"] = index;
-            serializeJson(jsonEntry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(basePath.c_str(), _buffer, true);
+            _nukiPublisher->publishJson(basePath.c_str(), jsonEntry, true);
 
             String basePathPrefix = "~";
             basePathPrefix.concat(basePath);
@@ -1398,8 +1407,7 @@ void NukiNetworkLock::publishAuth(const std::list<NukiLock::AuthorizationEntry>&
         ++index;
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_auth_json, _buffer, true);
+    _nukiPublisher->publishJson(mqtt_topic_auth_json, json, true);
 
     for(int j=authEntries.size(); j<maxAuthEntryCount; j++)
     {
@@ -1485,37 +1493,10 @@ void NukiNetworkLock::setAuthCommandReceivedCallback(void (*authCommandReceivedR
     _authCommandReceivedReceivedCallback = authCommandReceivedReceivedCallback;
 }
 
-void NukiNetworkLock::buildMqttPath(const char* path, char* outPath)
+void NukiNetworkLock::subscribe(const char* path)
 {
-    int offset = 0;
-    char inPath[181] = {0};
-
-    memcpy(inPath, _mqttPath, sizeof(_mqttPath));
-
-    for(const char& c : inPath)
-    {
-        if(c == 0x00)
-        {
-            break;
-        }
-        outPath[offset] = c;
-        ++offset;
-    }
-    int i=0;
-    while(outPath[i] != 0x00)
-    {
-        outPath[offset] = path[i];
-        ++i;
-        ++offset;
-    }
-    outPath[i+1] = 0x00;
-}
-
-bool NukiNetworkLock::comparePrefixedPath(const char *fullPath, const char *subPath)
-{
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-    return strcmp(fullPath, prefixedPath) == 0;
+    _network->subscribe(_mqttPath, path);
+    _topicRouter.add(_mqttPath, path);
 }
 
 void NukiNetworkLock::publishOffAction(const int value)
@@ -1547,84 +1528,6 @@ void NukiNetworkLock::setupHASS(int type, uint32_t nukiId, char* nukiName, const
     _network->setupHASS(type, nukiId, nukiName, firmwareVersion, hardwareVersion, hasDoorSensor, hasKeypad);
 }
 
-void NukiNetworkLock::buttonPressActionToString(const NukiLock::ButtonPressAction btnPressAction, char* str)
-{
-    switch (btnPressAction)
-    {
-    case NukiLock::ButtonPressAction::NoAction:
-        strcpy(str, "No Action");
-        break;
-    case NukiLock::ButtonPressAction::Intelligent:
-        strcpy(str, "Intelligent");
-        break;
-    case NukiLock::ButtonPressAction::Unlock:
-        strcpy(str, "Unlock");
-        break;
-    case NukiLock::ButtonPressAction::Lock:
-        strcpy(str, "Lock");
-        break;
-    case NukiLock::ButtonPressAction::Unlatch:
-        strcpy(str, "Unlatch");
-        break;
-    case NukiLock::ButtonPressAction::LockNgo:
-        strcpy(str, "Lock n Go");
-        break;
-    case NukiLock::ButtonPressAction::ShowStatus:
-        strcpy(str, "Show Status");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkLock::homeKitStatusToString(const int hkstatus, char* str)
-{
-    switch (hkstatus)
-    {
-    case 0:
-        strcpy(str, "Not Available");
-        break;
-    case 1:
-        strcpy(str, "Disabled");
-        break;
-    case 2:
-        strcpy(str, "Enabled");
-        break;
-    case 3:
-        strcpy(str, "Enabled & Paired");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkLock::fobActionToString(const int fobact, char* str)
-{
-    switch (fobact)
-    {
-    case 0:
-        strcpy(str, "No Action");
-        break;
-    case 1:
-        strcpy(str, "Unlock");
-        break;
-    case 2:
-        strcpy(str, "Lock");
-        break;
-    case 3:
-        strcpy(str, "Lock n Go");
-        break;
-    case 4:
-        strcpy(str, "Intelligent");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
 const uint32_t NukiNetworkLock::getAuthId() const
 {
     if(_nukiOfficial->hasAuthId())
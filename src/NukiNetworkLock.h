@@ -14,7 +14,9 @@
 #include "LockActionResult.h"
 #include "NukiOfficial.h"
 #include "NukiPublisher.h"
+#include "MqttTopicRouter.h"
 #include "EspMillis.h"
+#include "ActionLatency.h"
 
 class NukiNetworkLock : public MqttReceiver
 {
@@ -36,6 +38,7 @@ public:
     void publishAdvancedConfig(const NukiLock::AdvancedConfig& config);
     void publishRssi(const int& rssi);
     void publishRetry(const std::string& message);
+    void publishActionLatency(const ActionLatency& latency, uint8_t action);
     void publishBleAddress(const std::string& address);
     void publishKeypad(const std::list<NukiLock::KeypadEntry>& entries, uint maxKeypadCodeCount);
     void publishTimeControl(const std::list<NukiLock::TimeControlEntry>& timeControlEntries, uint maxTimeControlEntryCount);
@@ -63,30 +66,45 @@ public:
     uint8_t queryCommands();
 
 private:
-    bool comparePrefixedPath(const char* fullPath, const char* subPath);
+    void subscribe(const char* path);
 
     void publishKeypadEntry(const String topic, NukiLock::KeypadEntry entry);
-    void buttonPressActionToString(const NukiLock::ButtonPressAction btnPressAction, char* str);
-    void homeKitStatusToString(const int hkstatus, char* str);
-    void fobActionToString(const int fobact, char* str);
 
     void (*_officialUpdateReceivedCallback)(const char* path, const char* value) = nullptr;
 
     String concat(String a, String b);
-
-    void buildMqttPath(const char* path, char* outPath);
+    void publishSnapshot(JsonVariantConst state, JsonVariantConst battery);
+
+    struct KeyTurnerTopics
+    {
+        NukiPublisher::Topic state;
+        NukiPublisher::Topic trigger;
+        NukiPublisher::Topic lastLockAction;
+        NukiPublisher::Topic completionStatus;
+        NukiPublisher::Topic doorSensorState;
+        NukiPublisher::Topic batteryCritical;
+        NukiPublisher::Topic batteryCharging;
+        NukiPublisher::Topic batteryLevel;
+        NukiPublisher::Topic keypadBatteryCritical;
+        NukiPublisher::Topic batteryBasicJson;
+        NukiPublisher::Topic json;
+    };
 
     NukiNetwork* _network = nullptr;
     NukiPublisher* _nukiPublisher = nullptr;
+    KeyTurnerTopics _keyTurnerTopics;
     NukiOfficial* _nukiOfficial = nullptr;
     Preferences* _preferences = nullptr;
+    MqttTopicRouter _topicRouter;
 
     std::map<uint32_t, String> _authEntries;
     char _mqttPath[181] = {0};
+    uint8_t _eventSource = 0;
 
     bool _firstTunerStatePublish = true;
     bool _haEnabled = false;
     bool _disableNonJSON = false;
+    bool _snapshotEnabled = false;
 
     String _keypadCommandName = "";
     String _keypadCommandCode = "";
@@ -98,6 +116,7 @@ private:
 
     char _nukiName[33];
     char _authName[33];
+    char _jsonBuffer[JSON_WRITER_BUFFER_SIZE];
 
     char* _buffer;
     size_t _bufferSize;
@@ -1,4 +1,5 @@
 #include "NukiNetworkOpener.h"
+#include "NukiPayloads.h"
 #include "Arduino.h"
 #include "MqttTopics.h"
 #include "PreferencesKeys.h"
@@ -13,6 +14,7 @@ NukiNetworkOpener::NukiNetworkOpener(NukiNetwork* network, Preferences* preferen
       _bufferSize(bufferSize)
 {
     _nukiPublisher = new NukiPublisher(network, _mqttPath);
+    _eventSource = _network->addEventSource(_mqttPath);
 
     memset(_authName, 0, sizeof(_authName));
     _authName[0] = '\0';
@@ -33,20 +35,44 @@ void NukiNetworkOpener::initialize()
 
     _haEnabled = _preferences->getString(preference_mqtt_hass_discovery, "") != "";
     _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+    _snapshotEnabled = _preferences->getBool(preference_publish_snapshot, false);
+
+    // published on every lock state update
+    _keyTurnerTopics.state = _nukiPublisher->internTopic(mqtt_topic_lock_state);
+    _keyTurnerTopics.continuousMode = _nukiPublisher->internTopic(mqtt_topic_lock_continuous_mode);
+    _keyTurnerTopics.trigger = _nukiPublisher->internTopic(mqtt_topic_lock_trigger);
+    _keyTurnerTopics.lastLockAction = _nukiPublisher->internTopic(mqtt_topic_lock_last_lock_action);
+    _keyTurnerTopics.completionStatus = _nukiPublisher->internTopic(mqtt_topic_lock_completionStatus);
+    _keyTurnerTopics.doorSensorState = _nukiPublisher->internTopic(mqtt_topic_lock_door_sensor_state);
+    _keyTurnerTopics.batteryCritical = _nukiPublisher->internTopic(mqtt_topic_battery_critical);
+    _keyTurnerTopics.batteryBasicJson = _nukiPublisher->internTopic(mqtt_topic_battery_basic_json);
+    _keyTurnerTopics.json = _nukiPublisher->internTopic(mqtt_topic_lock_json);
+
+    // Command results and retries are responses to a request and must be sent even if unchanged
+    _network->setForcePublish(_mqttPath, mqtt_topic_lock_action_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_query_lockstate_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_config_action_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_keypad_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_keypad_json_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_timecontrol_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_auth_command_result);
+    _network->setForcePublish(_mqttPath, mqtt_topic_lock_retry);
 
     _network->initTopic(_mqttPath, mqtt_topic_lock_action, "--");
-    _network->subscribe(_mqttPath, mqtt_topic_lock_action);
+    subscribe(mqtt_topic_lock_action);
     _network->initTopic(_mqttPath, mqtt_topic_config_action, "--");
-    _network->subscribe(_mqttPath, mqtt_topic_config_action);
+    subscribe(mqtt_topic_config_action);
 
     _network->initTopic(_mqttPath, mqtt_topic_query_config, "0");
     _network->initTopic(_mqttPath, mqtt_topic_query_lockstate, "0");
     _network->initTopic(_mqttPath, mqtt_topic_query_battery, "0");
     _network->initTopic(_mqttPath, mqtt_topic_lock_binary_ring, "standby");
     _network->initTopic(_mqttPath, mqtt_topic_lock_ring, "standby");
-    _network->subscribe(_mqttPath, mqtt_topic_query_config);
-    _network->subscribe(_mqttPath, mqtt_topic_query_lockstate);
-    _network->subscribe(_mqttPath, mqtt_topic_query_battery);
+    subscribe(mqtt_topic_query_config);
+    subscribe(mqtt_topic_query_lockstate);
+    subscribe(mqtt_topic_query_battery);
+    _network->initTopic(_mqttPath, mqtt_topic_events_since, "--");
+    subscribe(mqtt_topic_events_since);
 
     if(_disableNonJSON)
     {
@@ -87,34 +113,34 @@ void NukiNetworkOpener::initialize()
             _network->initTopic(_mqttPath, mqtt_topic_keypad_command_name, "--");
             _network->initTopic(_mqttPath, mqtt_topic_keypad_command_code, "000000");
             _network->initTopic(_mqttPath, mqtt_topic_keypad_command_enabled, "1");
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_action);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_id);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_name);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_code);
-            _network->subscribe(_mqttPath, mqtt_topic_keypad_command_enabled);
+            subscribe(mqtt_topic_keypad_command_action);
+            subscribe(mqtt_topic_keypad_command_id);
+            subscribe(mqtt_topic_keypad_command_name);
+            subscribe(mqtt_topic_keypad_command_code);
+            subscribe(mqtt_topic_keypad_command_enabled);
         }
 
         _network->initTopic(_mqttPath, mqtt_topic_query_keypad, "0");
         _network->initTopic(_mqttPath, mqtt_topic_keypad_json_action, "--");
-        _network->subscribe(_mqttPath, mqtt_topic_query_keypad);
-        _network->subscribe(_mqttPath, mqtt_topic_keypad_json_action);
+        subscribe(mqtt_topic_query_keypad);
+        subscribe(mqtt_topic_keypad_json_action);
     }
 
     if(_preferences->getBool(preference_timecontrol_control_enabled, false))
     {
         _network->initTopic(_mqttPath, mqtt_topic_timecontrol_action, "--");
-        _network->subscribe(_mqttPath, mqtt_topic_timecontrol_action);
+        subscribe(mqtt_topic_timecontrol_action);
     }
 
     if(_preferences->getBool(preference_auth_control_enabled))
     {
         _network->initTopic(_mqttPath, mqtt_topic_auth_action, "--");
-        _network->subscribe(_mqttPath, mqtt_topic_auth_action);
+        subscribe(mqtt_topic_auth_action);
     }
 
     if(_preferences->getBool(preference_publish_authdata, false))
     {
-        _network->subscribe(_mqttPath, mqtt_topic_lock_log_rolling_last);
+        subscribe(mqtt_topic_lock_log_rolling_last);
     }
 /*
     _network->addReconnectedCallback([&]()
@@ -137,14 +163,34 @@ void NukiNetworkOpener::update()
 void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, const unsigned int length)
 {
     char* data = (char*)payload;
+    const char* subTopic = _topicRouter.match(topic);
 
-    if(_network->mqttRecentlyConnected() && _network->pathEquals(_mqttPath, mqtt_topic_lock_action, topic))
+    if(subTopic == nullptr)
+    {
+        return;
+    }
+
+    if(_network->mqttRecentlyConnected() && MqttTopicRouter::equals(subTopic, mqtt_topic_lock_action))
     {
         Log->println("MQTT recently connected, ignoring opener action.");
         return;
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_lock_log_rolling_last))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_events_since))
+    {
+        if(data[0] < '0' || data[0] > '9')
+        {
+            return;
+        }
+
+        Log->print(F("Replaying events after sequence "));
+        Log->println(data);
+        _network->replayEvents(_eventSource, strtoul(data, nullptr, 10));
+        _nukiPublisher->publishString(mqtt_topic_events_since, "--", true);
+        return;
+    }
+
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_lock_log_rolling_last))
     {
         if(strcmp(data, "") == 0 ||
                 strcmp(data, "--") == 0)
@@ -158,7 +204,7 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
         }
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_lock_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_lock_action))
     {
         if(strcmp(data, "") == 0 ||
                 strcmp(data, "--") == 0 ||
@@ -197,7 +243,7 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
 
     if(!_disableNonJSON)
     {
-        if(comparePrefixedPath(topic, mqtt_topic_keypad_command_action))
+        if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_action))
         {
             if(_keypadCommandReceivedReceivedCallback != nullptr)
             {
@@ -223,46 +269,46 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
                 _nukiPublisher->publishInt(mqtt_topic_keypad_command_enabled, _keypadCommandEnabled, true);
             }
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_id))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_id))
         {
             _keypadCommandId = atoi(data);
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_name))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_name))
         {
             _keypadCommandName = data;
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_code))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_code))
         {
             _keypadCommandCode = data;
         }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_enabled))
+        else if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_command_enabled))
         {
             _keypadCommandEnabled = atoi(data);
         }
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_query_config) && strcmp(data, "1") == 0)
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_config) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_CONFIG;
         _nukiPublisher->publishInt(mqtt_topic_query_config, 0, true);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_lockstate) && strcmp(data, "1") == 0)
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_lockstate) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_LOCKSTATE;
         _nukiPublisher->publishInt(mqtt_topic_query_lockstate, 0, true);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_keypad) && strcmp(data, "1") == 0)
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_keypad) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_KEYPAD;
         _nukiPublisher->publishInt(mqtt_topic_query_keypad, 0, true);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_battery) && strcmp(data, "1") == 0)
+    else if(MqttTopicRouter::equals(subTopic, mqtt_topic_query_battery) && strcmp(data, "1") == 0)
     {
         _queryCommands = _queryCommands | QUERY_COMMAND_BATTERY;
         _nukiPublisher->publishInt(mqtt_topic_query_battery, 0, true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_config_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_config_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -277,7 +323,7 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
         _nukiPublisher->publishString(mqtt_topic_config_action, "--", true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_keypad_json_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_keypad_json_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -292,7 +338,7 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
         _nukiPublisher->publishString(mqtt_topic_keypad_json_action, "--", true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_timecontrol_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_timecontrol_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -307,7 +353,7 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
         _nukiPublisher->publishString(mqtt_topic_timecontrol_action, "--", true);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_auth_action))
+    if(MqttTopicRouter::equals(subTopic, mqtt_topic_auth_action))
     {
         if(strcmp(data, "") == 0 || strcmp(data, "--") == 0)
         {
@@ -331,37 +377,46 @@ void NukiNetworkOpener::publishKeyTurnerState(const NukiOpener::OpenerState& key
     JsonDocument json;
     JsonDocument jsonBattery;
 
+    // in snapshot mode only the topics Home Assistant discovery reads are published next to the snapshot
+    bool fieldTopics = !_snapshotEnabled;
+    bool haTopics = !_snapshotEnabled || _haEnabled;
+
     lockstateToString(keyTurnerState.lockState, str);
 
     if((_firstTunerStatePublish || keyTurnerState.lockState != lastKeyTurnerState.lockState || keyTurnerState.nukiState != lastKeyTurnerState.nukiState) && keyTurnerState.lockState != NukiOpener::LockState::Undefined)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_state, str, true);
+        if(fieldTopics)
+        {
+            _nukiPublisher->publishString(_keyTurnerTopics.state, str, true);
+        }
 
         if(_haEnabled)
         {
             publishState(keyTurnerState);
         }
+
+        if(!_firstTunerStatePublish && keyTurnerState.lockState != lastKeyTurnerState.lockState)
+        {
+            char trigger[30] = {0};
+            triggerToString(keyTurnerState.trigger, trigger);
+            _network->recordEvent(_eventSource, "lockState", str, trigger);
+        }
     }
 
     json["lock_state"] = str;
 
-    if(keyTurnerState.nukiState == NukiOpener::State::ContinuousMode)
+    if(haTopics)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_continuous_mode, "on", true);
-        json["continuous_mode"] = 1;
-    }
-    else
-    {
-        _nukiPublisher->publishString(mqtt_topic_lock_continuous_mode, "off", true);
-        json["continuous_mode"] = 0;
+        _nukiPublisher->publishString(_keyTurnerTopics.continuousMode, keyTurnerState.nukiState == NukiOpener::State::ContinuousMode ? "on" : "off", true);
     }
+    json["continuous_mode"] = keyTurnerState.nukiState == NukiOpener::State::ContinuousMode ? 1 : 0;
 
     memset(&str, 0, sizeof(str));
     triggerToString(keyTurnerState.trigger, str);
 
-    if(_firstTunerStatePublish || keyTurnerState.trigger != lastKeyTurnerState.trigger)
+    if((_firstTunerStatePublish || keyTurnerState.trigger != lastKeyTurnerState.trigger) && haTopics)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_trigger, str, true);
+        _nukiPublisher->publishString(_keyTurnerTopics.trigger, str, true);
     }
 
     json["trigger"] = str;
@@ -376,7 +431,17 @@ void NukiNetworkOpener::publishKeyTurnerState(const NukiOpener::OpenerState& key
 
     if(_firstTunerStatePublish || keyTurnerState.lastLockAction != lastKeyTurnerState.lastLockAction)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_last_lock_action, str, true);
+        if(fieldTopics)
+        {
+            _nukiPublisher->publishString(_keyTurnerTopics.lastLockAction, str, true);
+        }
+
+        if(!_firstTunerStatePublish)
+        {
+            char trigger[30] = {0};
+            triggerToString(keyTurnerState.lastLockActionTrigger, trigger);
+            _network->recordEvent(_eventSource, "lockAction", str, trigger);
+        }
     }
 
     json["last_lock_action"] = str;
@@ -388,9 +453,9 @@ void NukiNetworkOpener::publishKeyTurnerState(const NukiOpener::OpenerState& key
     memset(&str, 0, sizeof(str));
     completionStatusToString(keyTurnerState.lastLockActionCompletionStatus, str);
 
-    if(_firstTunerStatePublish || keyTurnerState.lastLockActionCompletionStatus != lastKeyTurnerState.lastLockActionCompletionStatus)
+    if((_firstTunerStatePublish || keyTurnerState.lastLockActionCompletionStatus != lastKeyTurnerState.lastLockActionCompletionStatus) && fieldTopics)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_completionStatus, str, true);
+        _nukiPublisher->publishString(_keyTurnerTopics.completionStatus, str, true);
     }
 
     json["lock_completion_status"] = str;
@@ -398,9 +463,9 @@ void NukiNetworkOpener::publishKeyTurnerState(const NukiOpener::OpenerState& key
     memset(&str, 0, sizeof(str));
     NukiOpener::doorSensorStateToString(keyTurnerState.doorSensorState, str);
 
-    if(_firstTunerStatePublish || keyTurnerState.doorSensorState != lastKeyTurnerState.doorSensorState)
+    if((_firstTunerStatePublish || keyTurnerState.doorSensorState != lastKeyTurnerState.doorSensorState) && haTopics)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_door_sensor_state, str, true);
+        _nukiPublisher->publishString(_keyTurnerTopics.doorSensorState, str, true);
     }
 
     json["door_sensor_state"] = str;
@@ -408,23 +473,45 @@ void NukiNetworkOpener::publishKeyTurnerState(const NukiOpener::OpenerState& key
     bool critical = (keyTurnerState.criticalBatteryState & 0b00000001) > 0;
     jsonBattery["critical"] = critical ? "1" : "0";
 
-    if((_firstTunerStatePublish || keyTurnerState.criticalBatteryState != lastKeyTurnerState.criticalBatteryState) && !_disableNonJSON)
+    if((_firstTunerStatePublish || keyTurnerState.criticalBatteryState != lastKeyTurnerState.criticalBatteryState) && !_disableNonJSON && fieldTopics)
     {
-        _nukiPublisher->publishBool(mqtt_topic_battery_critical, critical, true);
+        _nukiPublisher->publishBool(_keyTurnerTopics.batteryCritical, critical, true);
     }
 
     json["auth_id"] = _authId;
     json["auth_name"] = _authName;
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_lock_json, _buffer, true);
+    if(fieldTopics)
+    {
+        _nukiPublisher->publishJson(_keyTurnerTopics.json, json, true);
+    }
+    else
+    {
+        publishSnapshot(json, jsonBattery);
+    }
 
-    serializeJson(jsonBattery, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_battery_basic_json, _buffer, true);
+    if(haTopics)
+    {
+        _nukiPublisher->publishJson(_keyTurnerTopics.batteryBasicJson, jsonBattery, true);
+    }
 
     _firstTunerStatePublish = false;
 }
 
+void NukiNetworkOpener::publishSnapshot(JsonVariantConst state, JsonVariantConst battery)
+{
+    JsonDocument json;
+    json["version"] = MQTT_SNAPSHOT_VERSION;
+    json["state"] = state;
+    json["battery"] = battery;
+
+    JsonObject lastAuth = json["lastAuth"].to<JsonObject>();
+    lastAuth["id"] = _authId;
+    lastAuth["name"] = _authName;
+
+    _nukiPublisher->publishJson(mqtt_topic_lock_snapshot, json, true);
+}
+
 void NukiNetworkOpener::publishRing(const bool locked)
 {
     if(locked)
@@ -438,6 +525,7 @@ void NukiNetworkOpener::publishRing(const bool locked)
 
     _nukiPublisher->publishString(mqtt_topic_lock_binary_ring, "ring", true);
     _resetRingStateTs = espMillis() + 2000;
+    _network->recordEvent(_eventSource, "ring", locked ? "ringlocked" : "ring");
 }
 
 void NukiNetworkOpener::publishState(NukiOpener::OpenerState lockState)
@@ -647,10 +735,14 @@ void NukiNetworkOpener::publishAuthorizationInfo(const std::list<NukiOpener::Log
 
         if(log.index > _lastRollingLog)
         {
-            serializeJson(entry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(mqtt_topic_lock_log_rolling, _buffer, true);
+            _nukiPublisher->publishJson(mqtt_topic_lock_log_rolling, entry, true);
             _nukiPublisher->publishInt(mqtt_topic_lock_log_rolling_last, log.index, true);
 
+            if(_lastRollingLog > 0)
+            {
+                _network->recordEvent(_eventSource, "authLog", entry["action"] | entry["type"].as<const char*>(), entry["authorizationName"] | "");
+            }
+
             if(log.loggingType == NukiOpener::LoggingType::DoorbellRecognition && _lastRollingLog > 0)
             {
                 if((log.data[0] & 3) == 0)
@@ -669,15 +761,13 @@ void NukiNetworkOpener::publishAuthorizationInfo(const std::list<NukiOpener::Log
         }
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-
     if(latest)
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_log_latest, _buffer, true);
+        _nukiPublisher->publishJson(mqtt_topic_lock_log_latest, json, true);
     }
     else
     {
-        _nukiPublisher->publishString(mqtt_topic_lock_log, _buffer, true);
+        _nukiPublisher->publishJson(mqtt_topic_lock_log, json, true);
     }
 
     if(authIndex > 0)
@@ -711,74 +801,22 @@ void NukiNetworkOpener::publishBatteryReport(const NukiOpener::BatteryReport& ba
         _nukiPublisher->publishFloat(mqtt_topic_battery_voltage, (float)batteryReport.batteryVoltage / 1000.0, true);
     }
 
-    char str[50];
-    memset(&str, 0, sizeof(str));
-
-    JsonDocument json;
-
-    json["batteryVoltage"] = (float)batteryReport.batteryVoltage / 1000.0;
-    json["critical"] = batteryReport.criticalBatteryState;
-    lockactionToString(batteryReport.lockAction, str);
-    json["lockAction"] = str;
-    json["startVoltage"] = (float)batteryReport.startVoltage / 1000.0;
-    json["lowestVoltage"] = (float)batteryReport.lowestVoltage / 1000.0;
-
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_battery_advanced_json, _buffer, true);
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    NukiPayloads::openerBatteryReport(json, batteryReport);
+    _nukiPublisher->publishJson(mqtt_topic_battery_advanced_json, json, true);
 }
 
 void NukiNetworkOpener::publishConfig(const NukiOpener::Config &config)
 {
-    char str[50];
-    char curTime[20];
-    sprintf(curTime, "%04d-%02d-%02d %02d:%02d:%02d", config.currentTimeYear, config.currentTimeMonth, config.currentTimeDay, config.currentTimeHour, config.currentTimeMinute, config.currentTimeSecond);
-    char uidString[20];
-    itoa(config.nukiId, uidString, 16);
-
-    JsonDocument json;
+    char firmwareVersion[12];
+    NukiPayloads::firmwareVersion(config, firmwareVersion, sizeof(firmwareVersion));
+    char hardwareRevision[8];
+    NukiPayloads::hardwareRevision(config, hardwareRevision, sizeof(hardwareRevision));
+    NukiPayloads::name(config, _nukiName, sizeof(_nukiName));
 
-    memset(_nukiName, 0, sizeof(_nukiName));
-    memcpy(_nukiName, config.name, sizeof(config.name));
-
-    json["nukiID"] = uidString;
-    json["name"] = config.name;
-    //json["latitude"] = config.latitude;
-    //json["longitude"] = config.longitude;
-    memset(str, 0, sizeof(str));
-    capabilitiesToString(config.capabilities, str);
-    json["capabilities"] = str;
-    json["pairingEnabled"] = config.pairingEnabled;
-    json["buttonEnabled"] = config.buttonEnabled;
-    json["ledFlashEnabled"] = config.ledFlashEnabled;
-    json["currentTime"] = curTime;
-    json["timeZoneOffset"] = config.timeZoneOffset;
-    json["dstMode"] = config.dstMode;
-    json["hasFob"] = config.hasFob;
-    memset(str, 0, sizeof(str));
-    fobActionToString(config.fobAction1, str);
-    json["fobAction1"] = str;
-    memset(str, 0, sizeof(str));
-    fobActionToString(config.fobAction2, str);
-    json["fobAction2"] = str;
-    memset(str, 0, sizeof(str));
-    fobActionToString(config.fobAction3, str);
-    json["fobAction3"] = str;
-    memset(str, 0, sizeof(str));
-    operatingModeToString(config.operatingMode, str);
-    json["operatingMode"] = str;
-    memset(str, 0, sizeof(str));
-    _network->advertisingModeToString(config.advertisingMode, str);
-    json["advertisingMode"] = str;
-    json["hasKeypad"] = config.hasKeypad;
-    json["hasKeypadV2"] = config.hasKeypadV2;
-    json["firmwareVersion"] = std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]);
-    json["hardwareRevision"] = std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]);
-    memset(str, 0, sizeof(str));
-    _network->timeZoneIdToString(config.timeZoneId, str);
-    json["timeZone"] = str;
-
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_config_basic_json, _buffer, true);
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    NukiPayloads::openerConfig(json, config);
+    _nukiPublisher->publishJson(mqtt_topic_config_basic_json, json, true);
 
     if(!_disableNonJSON)
     {
@@ -786,56 +824,15 @@ void NukiNetworkOpener::publishConfig(const NukiOpener::Config &config)
         _nukiPublisher->publishBool(mqtt_topic_config_led_enabled, config.ledFlashEnabled == 1, true);
     }
 
-    _nukiPublisher->publishString(mqtt_topic_info_firmware_version, std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]), true);
-    _nukiPublisher->publishString(mqtt_topic_info_hardware_version, std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]), true);
+    _nukiPublisher->publishString(mqtt_topic_info_firmware_version, firmwareVersion, true);
+    _nukiPublisher->publishString(mqtt_topic_info_hardware_version, hardwareRevision, true);
 }
 
 void NukiNetworkOpener::publishAdvancedConfig(const NukiOpener::AdvancedConfig &config)
 {
-    char str[50];
-
-    JsonDocument json;
-
-    json["intercomID"] = config.intercomID;
-    json["busModeSwitch"] = config.busModeSwitch;
-    json["shortCircuitDuration"] = config.shortCircuitDuration;
-    json["electricStrikeDelay"] = config.electricStrikeDelay;
-    json["randomElectricStrikeDelay"] = config.randomElectricStrikeDelay;
-    json["electricStrikeDuration"] = config.electricStrikeDuration;
-    json["disableRtoAfterRing"] = config.disableRtoAfterRing;
-    json["rtoTimeout"] = config.rtoTimeout;
-    memset(str, 0, sizeof(str));
-    doorbellSuppressionToString(config.doorbellSuppression, str);
-    json["doorbellSuppression"] = str;
-    json["doorbellSuppressionDuration"] = config.doorbellSuppressionDuration;
-    memset(str, 0, sizeof(str));
-    soundToString(config.soundRing, str);
-    json["soundRing"] = str;
-    memset(str, 0, sizeof(str));
-    soundToString(config.soundOpen, str);
-    json["soundOpen"] = str;
-    memset(str, 0, sizeof(str));
-    soundToString(config.soundRto, str);
-    json["soundRto"] = str;
-    memset(str, 0, sizeof(str));
-    soundToString(config.soundCm, str);
-    json["soundCm"] = str;
-    json["soundConfirmation"] = config.soundConfirmation;
-    json["soundLevel"] = config.soundLevel;
-    memset(str, 0, sizeof(str));
-    buttonPressActionToString(config.singleButtonPressAction, str);
-    json["singleButtonPressAction"] = str;
-    memset(str, 0, sizeof(str));
-    buttonPressActionToString(config.doubleButtonPressAction, str);
-    json["doubleButtonPressAction"] = str;
-    memset(str, 0, sizeof(str));
-    _network->batteryTypeToString(config.batteryType, str);
-    json["batteryType"] = str;
-    json["automaticBatteryTypeDetection"] = config.automaticBatteryTypeDetection;
-    json["rebootNuki"] = 0;
-
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_config_advanced_json, _buffer, true);
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    NukiPayloads::openerAdvancedConfig(json, config);
+    _nukiPublisher->publishJson(mqtt_topic_config_advanced_json, json, true);
 
     if(!_disableNonJSON)
     {
@@ -853,6 +850,16 @@ void NukiNetworkOpener::publishRetry(const std::string& message)
     _nukiPublisher->publishString(mqtt_topic_lock_retry, message, true);
 }
 
+void NukiNetworkOpener::publishActionLatency(const ActionLatency& latency, uint8_t action)
+{
+    char topic[50];
+    snprintf(topic, sizeof(topic), "%s/%s", mqtt_topic_lock_action_latency, latency.actionName(action));
+
+    JsonWriter json(_jsonBuffer, sizeof(_jsonBuffer));
+    latency.writeJson(action, json);
+    _nukiPublisher->publishJson(topic, json, true);
+}
+
 void NukiNetworkOpener::publishBleAddress(const std::string &address)
 {
     _nukiPublisher->publishString(mqtt_topic_lock_address, address, true);
@@ -964,8 +971,7 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
             basePath.concat(std::to_string(index).c_str());
             jsonEntry["name_ha"] = entry.name;
             jsonEntry["index"] = index;
-            serializeJson(jsonEntry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(basePath.c_str(), _buffer, true);
+            _nukiPublisher->publishJson(basePath.c_str(), jsonEntry, true);
 
             String basePathPrefix = "~";
             basePathPrefix.concat(basePath);
@@ -1007,8 +1013,7 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
         ++index;
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_keypad_json, _buffer, true);
+    _nukiPublisher->publishJson(mqtt_topic_keypad_json, json, true);
 
     if(!_disableNonJSON)
     {
@@ -1151,8 +1156,7 @@ void NukiNetworkOpener::publishTimeControl(const std::list<NukiOpener::TimeContr
             basePath.concat("/entries/");
             basePath.concat(std::to_string(index).c_str());
             jsonEntry["index"] = index;
-            serializeJson(jsonEntry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(basePath.c_str(), _buffer, true);
+            _nukiPublisher->publishJson(basePath.c_str(), jsonEntry, true);
             String basePathPrefix = "~";
             basePathPrefix.concat(basePath);
             const char *basePathPrefixChr = basePathPrefix.c_str();
@@ -1189,8 +1193,7 @@ void NukiNetworkOpener::publishTimeControl(const std::list<NukiOpener::TimeContr
         ++index;
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_timecontrol_json, _buffer, true);
+    _nukiPublisher->publishJson(mqtt_topic_timecontrol_json, json, true);
 
     for(int j=timeControlEntries.size(); j<maxTimeControlEntryCount; j++)
     {
@@ -1300,8 +1303,7 @@ void NukiNetworkOpener::publishAuth(const std::list<NukiOpener::AuthorizationEnt
             basePath.concat("/entries/");
             basePath.concat(std::to_string(index).c_str());
             jsonEntry["index"] = index;
-            serializeJson(jsonEntry, _buffer, _bufferSize);
-            _nukiPublisher->publishString(basePath.c_str(), _buffer, true);
+            _nukiPublisher->publishJson(basePath.c_str(), jsonEntry, true);
 
             String basePathPrefix = "~";
             basePathPrefix.concat(basePath);
@@ -1340,8 +1342,7 @@ void NukiNetworkOpener::publishAuth(const std::list<NukiOpener::AuthorizationEnt
         ++index;
     }
 
-    serializeJson(json, _buffer, _bufferSize);
-    _nukiPublisher->publishString(mqtt_topic_auth_json, _buffer, true);
+    _nukiPublisher->publishJson(mqtt_topic_auth_json, json, true);
 
     for(int j=authEntries.size(); j<maxAuthEntryCount; j++)
     {
@@ -1451,41 +1452,10 @@ void NukiNetworkOpener::publishKeypadEntry(const String topic, NukiLock::KeypadE
     _nukiPublisher->publishInt(concat(topic, "/lockCount").c_str(), entry.lockCount, true);
 }
 
-void NukiNetworkOpener::buildMqttPath(const char* path, char* outPath)
+void NukiNetworkOpener::subscribe(const char* path)
 {
-    int offset = 0;
-    for(const char& c : _mqttPath)
-    {
-        if(c == 0x00)
-        {
-            break;
-        }
-        outPath[offset] = c;
-        ++offset;
-    }
-    int i=0;
-    while(path[i] != 0x00)
-    {
-        outPath[offset] = path[i];
-        ++i;
-        ++offset;
-    }
-    outPath[offset] = 0x00;
-}
-
-void NukiNetworkOpener::subscribe(const char *path)
-{
-    char prefixedPath[500];
-    buildMqttPath(path, prefixedPath);
-    _network->subscribe(prefixedPath, MQTT_QOS_LEVEL);
-}
-
-bool NukiNetworkOpener::comparePrefixedPath(const char *fullPath, const char *subPath)
-{
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-
-    return strcmp(fullPath, prefixedPath) == 0;
+    _network->subscribe(_mqttPath, path);
+    _topicRouter.add(_mqttPath, path);
 }
 
 String NukiNetworkOpener::concat(String a, String b)
@@ -1511,198 +1481,3 @@ void NukiNetworkOpener::setupHASS(int type, uint32_t nukiId, char* nukiName, con
 {
     _network->setupHASS(type, nukiId, nukiName, firmwareVersion, hardwareVersion, hasDoorSensor, hasKeypad);
 }
-
-void NukiNetworkOpener::buttonPressActionToString(const NukiOpener::ButtonPressAction btnPressAction, char* str)
-{
-    switch (btnPressAction)
-    {
-    case NukiOpener::ButtonPressAction::NoAction:
-        strcpy(str, "No Action");
-        break;
-    case NukiOpener::ButtonPressAction::ToggleRTO:
-        strcpy(str, "Toggle RTO");
-        break;
-    case NukiOpener::ButtonPressAction::ActivateRTO:
-        strcpy(str, "Activate RTO");
-        break;
-    case NukiOpener::ButtonPressAction::DeactivateRTO:
-        strcpy(str, "Deactivate RTO");
-        break;
-    case NukiOpener::ButtonPressAction::ToggleCM:
-        strcpy(str, "Toggle CM");
-        break;
-    case NukiOpener::ButtonPressAction::ActivateCM:
-        strcpy(str, "Activate CM");
-        break;
-    case NukiOpener::ButtonPressAction::DectivateCM:
-        strcpy(str, "Deactivate CM");
-        break;
-    case NukiOpener::ButtonPressAction::Open:
-        strcpy(str, "Open");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkOpener::fobActionToString(const int fobact, char* str)
-{
-    switch (fobact)
-    {
-    case 0:
-        strcpy(str, "No Action");
-        break;
-    case 1:
-        strcpy(str, "Toggle RTO");
-        break;
-    case 2:
-        strcpy(str, "Activate RTO");
-        break;
-    case 3:
-        strcpy(str, "Deactivate RTO");
-        break;
-    case 7:
-        strcpy(str, "Open");
-        break;
-    case 8:
-        strcpy(str, "Ring");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkOpener::capabilitiesToString(const int capabilities, char* str)
-{
-    switch (capabilities)
-    {
-    case 0:
-        strcpy(str, "Door opener");
-        break;
-    case 1:
-        strcpy(str, "Both");
-        break;
-    case 2:
-        strcpy(str, "RTO");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkOpener::operatingModeToString(const int opmode, char* str)
-{
-    switch (opmode)
-    {
-    case 0:
-        strcpy(str, "Generic door opener");
-        break;
-    case 1:
-        strcpy(str, "Analogue intercom");
-        break;
-    case 2:
-        strcpy(str, "Digital intercom");
-        break;
-    case 3:
-        strcpy(str, "Siedle");
-        break;
-    case 4:
-        strcpy(str, "TCS");
-        break;
-    case 5:
-        strcpy(str, "Bticino");
-        break;
-    case 6:
-        strcpy(str, "Siedle HTS");
-        break;
-    case 7:
-        strcpy(str, "STR");
-        break;
-    case 8:
-        strcpy(str, "Ritto");
-        break;
-    case 9:
-        strcpy(str, "Fermax");
-        break;
-    case 10:
-        strcpy(str, "Comelit");
-        break;
-    case 11:
-        strcpy(str, "Urmet BiBus");
-        break;
-    case 12:
-        strcpy(str, "Urmet 2Voice");
-        break;
-    case 13:
-        strcpy(str, "Golmar");
-        break;
-    case 14:
-        strcpy(str, "SKS");
-        break;
-    case 15:
-        strcpy(str, "Spare");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkOpener::doorbellSuppressionToString(const int dbsupr, char* str)
-{
-    switch (dbsupr)
-    {
-    case 0:
-        strcpy(str, "Off");
-        break;
-    case 1:
-        strcpy(str, "CM");
-        break;
-    case 2:
-        strcpy(str, "RTO");
-        break;
-    case 3:
-        strcpy(str, "CM & RTO");
-        break;
-    case 4:
-        strcpy(str, "Ring");
-        break;
-    case 5:
-        strcpy(str, "CM & Ring");
-        break;
-    case 6:
-        strcpy(str, "RTO & Ring");
-        break;
-    case 7:
-        strcpy(str, "CM & RTO & Ring");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
-
-void NukiNetworkOpener::soundToString(const int sound, char* str)
-{
-    switch (sound)
-    {
-    case 0:
-        strcpy(str, "No Sound");
-        break;
-    case 1:
-        strcpy(str, "Sound 1");
-        break;
-    case 2:
-        strcpy(str, "Sound 2");
-        break;
-    case 3:
-        strcpy(str, "Sound 3");
-        break;
-    default:
-        strcpy(str, "undefined");
-        break;
-    }
-}
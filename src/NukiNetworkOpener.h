@@ -29,6 +29,7 @@ public:
     void publishAdvancedConfig(const NukiOpener::AdvancedConfig& config);
     void publishRssi(const int& rssi);
     void publishRetry(const std::string& message);
+    void publishActionLatency(const ActionLatency& latency, uint8_t action);
     void publishBleAddress(const std::string& address);
     void publishKeypad(const std::list<NukiLock::KeypadEntry>& entries, uint maxKeypadCodeCount);
     void publishTimeControl(const std::list<NukiOpener::TimeControlEntry>& timeControlEntries, uint maxTimeControlEntryCount);
@@ -54,31 +55,40 @@ public:
     char _nukiName[33];
 
 private:
-    bool comparePrefixedPath(const char* fullPath, const char* subPath);
-
     void publishKeypadEntry(const String topic, NukiLock::KeypadEntry entry);
 
-    void buildMqttPath(const char* path, char* outPath);
     void subscribe(const char* path);
-    void buttonPressActionToString(const NukiOpener::ButtonPressAction btnPressAction, char* str);
-    void fobActionToString(const int fobact, char* str);
-    void operatingModeToString(const int opmode, char* str);
-    void doorbellSuppressionToString(const int dbsupr, char* str);
-    void soundToString(const int sound, char* str);
-    void capabilitiesToString(const int capabilities, char* str);
 
     String concat(String a, String b);
+    void publishSnapshot(JsonVariantConst state, JsonVariantConst battery);
+
+    struct KeyTurnerTopics
+    {
+        NukiPublisher::Topic state;
+        NukiPublisher::Topic continuousMode;
+        NukiPublisher::Topic trigger;
+        NukiPublisher::Topic lastLockAction;
+        NukiPublisher::Topic completionStatus;
+        NukiPublisher::Topic doorSensorState;
+        NukiPublisher::Topic batteryCritical;
+        NukiPublisher::Topic batteryBasicJson;
+        NukiPublisher::Topic json;
+    };
 
     Preferences* _preferences = nullptr;
 
     NukiNetwork* _network = nullptr;
     NukiPublisher* _nukiPublisher = nullptr;
+    KeyTurnerTopics _keyTurnerTopics;
+    MqttTopicRouter _topicRouter;
 
     std::map<uint32_t, String> _authEntries;
     char _mqttPath[181] = {0};
+    uint8_t _eventSource = 0;
     bool _firstTunerStatePublish = true;
     bool _haEnabled = false;
     bool _disableNonJSON = false;
+    bool _snapshotEnabled = false;
 
     String _keypadCommandName = "";
     String _keypadCommandCode = "";
@@ -88,6 +98,7 @@ private:
     uint8_t _queryCommands = 0;
     uint32_t _authId = 0;
     char _authName[33];
+    char _jsonBuffer[JSON_WRITER_BUFFER_SIZE];
     uint32_t _lastRollingLog = 0;
 
     char* _buffer;
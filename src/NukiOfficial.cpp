@@ -35,6 +35,12 @@ void NukiOfficial::setUid(const uint32_t& uid)
     offTopics.push_back((char*)mqtt_topic_official_connected);
     offTopics.push_back((char*)mqtt_topic_official_commandResponse);
     offTopics.push_back((char*)mqtt_topic_official_lockActionEvent);
+
+    _offTopicRouter.clear();
+    for(const auto& offTopic : offTopics)
+    {
+        _offTopicRouter.add(mqttPath, offTopic);
+    }
 }
 
 void NukiOfficial::setPublisher(NukiPublisher *publisher)
@@ -47,37 +53,9 @@ const char *NukiOfficial::getMqttPath() const
     return mqttPath;
 }
 
-void NukiOfficial::buildMqttPath(const char *path, char *outPath)
-{
-    int offset = 0;
-    char inPath[181] = {0};
-
-    memcpy(inPath, mqttPath, sizeof(mqttPath));
-
-    for(const char& c : inPath)
-    {
-        if(c == 0x00)
-        {
-            break;
-        }
-        outPath[offset] = c;
-        ++offset;
-    }
-    int i=0;
-    while(outPath[i] != 0x00)
-    {
-        outPath[offset] = path[i];
-        ++i;
-        ++offset;
-    }
-    outPath[i+1] = 0x00;
-}
-
-bool NukiOfficial::comparePrefixedPath(const char *fullPath, const char *subPath)
+const char* NukiOfficial::matchOffTopic(const char* topic) const
 {
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-    return strcmp(fullPath, prefixedPath) == 0;
+    return _offTopicRouter.match(topic);
 }
 
 void NukiOfficial::onOfficialUpdateReceived(const char *topic, const char *value)
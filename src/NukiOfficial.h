@@ -4,6 +4,7 @@
 #include <vector>
 #include "../lib/nuki_ble/src/NukiLockConstants.h"
 #include "NukiPublisher.h"
+#include "MqttTopicRouter.h"
 
 class NukiOfficial
 {
@@ -23,8 +24,7 @@ public:
     const bool hasAuthId() const;
     void clearAuthId();
 
-    void buildMqttPath(const char* path, char* outPath);
-    bool comparePrefixedPath(const char *fullPath, const char *subPath);
+    const char* matchOffTopic(const char* topic) const;
 
     void onOfficialUpdateReceived(const char* topic, const char* value);
 
@@ -43,6 +43,7 @@ public:
 private:
     char mqttPath[181] = {0};
     std::vector<char*> offTopics;
+    MqttTopicRouter _offTopicRouter;
 
     NukiPublisher* _publisher = nullptr;
     bool _statusUpdated = false;
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "NukiOpener.h"
+#include "NukiDevice.h"
 #include "NukiNetworkOpener.h"
 #include "NukiOpenerConstants.h"
 #include "NukiDataTypes.h"
 #include "BleScanner.h"
 #include "Gpio.h"
 #include "NukiDeviceId.h"
+#include "CommandQueue.h"
+#include "RetryJob.h"
+#include "RetryScheduler.h"
+#include "ActionLatency.h"
 
 class NukiOpenerWrapper : public NukiOpener::SmartlockEventHandler
 {
@@ -18,12 +23,12 @@ public:
     void readSettings();
     void update();
 
-    void electricStrikeActuation();
-    void activateRTO();
-    void activateCM();
-    void deactivateRtoCm();
-    void deactivateRTO();
-    void deactivateCM();
+    void electricStrikeActuation(CommandSource source = CommandSource::Local);
+    void activateRTO(CommandSource source = CommandSource::Local);
+    void activateCM(CommandSource source = CommandSource::Local);
+    void deactivateRtoCm(CommandSource source = CommandSource::Local);
+    void deactivateRTO(CommandSource source = CommandSource::Local);
+    void deactivateCM(CommandSource source = CommandSource::Local);
 
     bool isPinSet();
     bool isPinValid();
@@ -40,6 +45,7 @@ public:
 
     std::string firmwareVersion() const;
     std::string hardwareVersion() const;
+    const ActionLatency& actionLatency() const;
 
     BleScanner::Scanner* bleScanner();
 
@@ -60,6 +66,10 @@ private:
     void onTimeControlCommandReceived(const char* value);
     void onAuthCommandReceived(const char* value);
 
+    bool enqueueLockAction(NukiOpener::LockAction action, CommandSource source);
+    static bool isOppositeLockAction(NukiOpener::LockAction first, NukiOpener::LockAction second);
+    static int latencyAction(NukiOpener::LockAction action);
+
     bool updateKeyTurnerState();
     void updateBatteryState();
     void updateConfig();
@@ -88,7 +98,7 @@ private:
 
     std::string _deviceName;
     NukiDeviceId* _deviceId = nullptr;
-    NukiOpener::NukiOpener _nukiOpener;
+    NukiOpenerDevice _nukiOpener;
     BleScanner::Scanner* _bleScanner = nullptr;
     NukiNetworkOpener* _network = nullptr;
     Gpio* _gpio = nullptr;
@@ -106,7 +116,6 @@ private:
     int _nrOfRetries = 0;
     int _retryDelay = 0;
     int _retryConfigCount = 0;
-    int _retryLockstateCount = 0;
     int64_t _nextRetryTs = 0;
     int64_t _invalidCount = 0;
     int64_t _lastCodeCheck = 0;
@@ -148,11 +157,17 @@ private:
     int64_t _nextKeypadUpdateTs = 0;
     int64_t _nextPairTs = 0;
     int64_t _nextRssiTs = 0;
-    int64_t _lastRssi = 0;
     int64_t _disableBleWatchdogTs = 0;
     uint32_t _basicOpenerConfigAclPrefs[16];
     uint32_t _advancedOpenerConfigAclPrefs[21];
     std::string _firmwareVersion = "";
     std::string _hardwareVersion = "";
-    NukiOpener::LockAction _nextLockAction = (NukiOpener::LockAction)0xff;
+    CommandQueue<NukiOpener::LockAction, NUKI_COMMAND_QUEUE_SIZE> _commandQueue;
+    QueuedCommand<NukiOpener::LockAction> _lockActionCommand;
+    RetryJob _lockActionJob;
+    RetryJob _lockStateJob;
+    RetryJob _batteryJob;
+    RetryJob _configJob;
+    ActionLatency _latency;
+    RetryScheduler<Nuki::CmdResult> _bleJobs;
 };
@@ -0,0 +1,364 @@
+#include "NukiPayloads.h"
+#include "util/JsonFields.h"
+
+static constexpr JsonName batteryTypeNames[] =
+{
+    { (int32_t)Nuki::BatteryType::Alkali, "Alkali" },
+    { (int32_t)Nuki::BatteryType::Accumulators, "Accumulators" },
+    { (int32_t)Nuki::BatteryType::Lithium, "Lithium" },
+};
+
+static constexpr JsonName advertisingModeNames[] =
+{
+    { (int32_t)Nuki::AdvertisingMode::Automatic, "Automatic" },
+    { (int32_t)Nuki::AdvertisingMode::Normal, "Normal" },
+    { (int32_t)Nuki::AdvertisingMode::Slow, "Slow" },
+    { (int32_t)Nuki::AdvertisingMode::Slowest, "Slowest" },
+};
+
+static constexpr JsonName timeZoneNames[] =
+{
+    { (int32_t)Nuki::TimeZoneId::Africa_Cairo, "Africa/Cairo" },
+    { (int32_t)Nuki::TimeZoneId::Africa_Lagos, "Africa/Lagos" },
+    { (int32_t)Nuki::TimeZoneId::Africa_Maputo, "Africa/Maputo" },
+    { (int32_t)Nuki::TimeZoneId::Africa_Nairobi, "Africa/Nairobi" },
+    { (int32_t)Nuki::TimeZoneId::America_Anchorage, "America/Anchorage" },
+    { (int32_t)Nuki::TimeZoneId::America_Argentina_Buenos_Aires, "America/Argentina/Buenos_Aires" },
+    { (int32_t)Nuki::TimeZoneId::America_Chicago, "America/Chicago" },
+    { (int32_t)Nuki::TimeZoneId::America_Denver, "America/Denver" },
+    { (int32_t)Nuki::TimeZoneId::America_Halifax, "America/Halifax" },
+    { (int32_t)Nuki::TimeZoneId::America_Los_Angeles, "America/Los_Angeles" },
+    { (int32_t)Nuki::TimeZoneId::America_Manaus, "America/Manaus" },
+    { (int32_t)Nuki::TimeZoneId::America_Mexico_City, "America/Mexico_City" },
+    { (int32_t)Nuki::TimeZoneId::America_New_York, "America/New_York" },
+    { (int32_t)Nuki::TimeZoneId::America_Phoenix, "America/Phoenix" },
+    { (int32_t)Nuki::TimeZoneId::America_Regina, "America/Regina" },
+    { (int32_t)Nuki::TimeZoneId::America_Santiago, "America/Santiago" },
+    { (int32_t)Nuki::TimeZoneId::America_Sao_Paulo, "America/Sao_Paulo" },
+    { (int32_t)Nuki::TimeZoneId::America_St_Johns, "America/St_Johns" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Bangkok, "Asia/Bangkok" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Dubai, "Asia/Dubai" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Hong_Kong, "Asia/Hong_Kong" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Jerusalem, "Asia/Jerusalem" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Karachi, "Asia/Karachi" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Kathmandu, "Asia/Kathmandu" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Kolkata, "Asia/Kolkata" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Riyadh, "Asia/Riyadh" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Seoul, "Asia/Seoul" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Shanghai, "Asia/Shanghai" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Tehran, "Asia/Tehran" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Tokyo, "Asia/Tokyo" },
+    { (int32_t)Nuki::TimeZoneId::Asia_Yangon, "Asia/Yangon" },
+    { (int32_t)Nuki::TimeZoneId::Australia_Adelaide, "Australia/Adelaide" },
+    { (int32_t)Nuki::TimeZoneId::Australia_Brisbane, "Australia/Brisbane" },
+    { (int32_t)Nuki::TimeZoneId::Australia_Darwin, "Australia/Darwin" },
+    { (int32_t)Nuki::TimeZoneId::Australia_Hobart, "Australia/Hobart" },
+    { (int32_t)Nuki::TimeZoneId::Australia_Perth, "Australia/Perth" },
+    { (int32_t)Nuki::TimeZoneId::Australia_Sydney, "Australia/Sydney" },
+    { (int32_t)Nuki::TimeZoneId::Europe_Berlin, "Europe/Berlin" },
+    { (int32_t)Nuki::TimeZoneId::Europe_Helsinki, "Europe/Helsinki" },
+    { (int32_t)Nuki::TimeZoneId::Europe_Istanbul, "Europe/Istanbul" },
+    { (int32_t)Nuki::TimeZoneId::Europe_London, "Europe/London" },
+    { (int32_t)Nuki::TimeZoneId::Europe_Moscow, "Europe/Moscow" },
+    { (int32_t)Nuki::TimeZoneId::Pacific_Auckland, "Pacific/Auckland" },
+    { (int32_t)Nuki::TimeZoneId::Pacific_Guam, "Pacific/Guam" },
+    { (int32_t)Nuki::TimeZoneId::Pacific_Honolulu, "Pacific/Honolulu" },
+    { (int32_t)Nuki::TimeZoneId::Pacific_Pago_Pago, "Pacific/Pago_Pago" },
+    { (int32_t)Nuki::TimeZoneId::None, "None" },
+};
+
+static constexpr JsonName lockButtonPressActionNames[] =
+{
+    { (int32_t)NukiLock::ButtonPressAction::NoAction, "No Action" },
+    { (int32_t)NukiLock::ButtonPressAction::Intelligent, "Intelligent" },
+    { (int32_t)NukiLock::ButtonPressAction::Unlock, "Unlock" },
+    { (int32_t)NukiLock::ButtonPressAction::Lock, "Lock" },
+    { (int32_t)NukiLock::ButtonPressAction::Unlatch, "Unlatch" },
+    { (int32_t)NukiLock::ButtonPressAction::LockNgo, "Lock n Go" },
+    { (int32_t)NukiLock::ButtonPressAction::ShowStatus, "Show Status" },
+};
+
+static constexpr JsonName lockFobActionNames[] =
+{
+    { 0, "No Action" },
+    { 1, "Unlock" },
+    { 2, "Lock" },
+    { 3, "Lock n Go" },
+    { 4, "Intelligent" },
+};
+
+static constexpr JsonName homeKitStatusNames[] =
+{
+    { 0, "Not Available" },
+    { 1, "Disabled" },
+    { 2, "Enabled" },
+    { 3, "Enabled & Paired" },
+};
+
+static constexpr JsonName openerButtonPressActionNames[] =
+{
+    { (int32_t)NukiOpener::ButtonPressAction::NoAction, "No Action" },
+    { (int32_t)NukiOpener::ButtonPressAction::ToggleRTO, "Toggle RTO" },
+    { (int32_t)NukiOpener::ButtonPressAction::ActivateRTO, "Activate RTO" },
+    { (int32_t)NukiOpener::ButtonPressAction::DeactivateRTO, "Deactivate RTO" },
+    { (int32_t)NukiOpener::ButtonPressAction::ToggleCM, "Toggle CM" },
+    { (int32_t)NukiOpener::ButtonPressAction::ActivateCM, "Activate CM" },
+    { (int32_t)NukiOpener::ButtonPressAction::DectivateCM, "Deactivate CM" },
+    { (int32_t)NukiOpener::ButtonPressAction::Open, "Open" },
+};
+
+static constexpr JsonName openerFobActionNames[] =
+{
+    { 0, "No Action" },
+    { 1, "Toggle RTO" },
+    { 2, "Activate RTO" },
+    { 3, "Deactivate RTO" },
+    { 7, "Open" },
+    { 8, "Ring" },
+};
+
+static constexpr JsonName capabilitiesNames[] =
+{
+    { 0, "Door opener" },
+    { 1, "Both" },
+    { 2, "RTO" },
+};
+
+static constexpr JsonName operatingModeNames[] =
+{
+    { 0, "Generic door opener" },
+    { 1, "Analogue intercom" },
+    { 2, "Digital intercom" },
+    { 3, "Siedle" },
+    { 4, "TCS" },
+    { 5, "Bticino" },
+    { 6, "Siedle HTS" },
+    { 7, "STR" },
+    { 8, "Ritto" },
+    { 9, "Fermax" },
+    { 10, "Comelit" },
+    { 11, "Urmet BiBus" },
+    { 12, "Urmet 2Voice" },
+    { 13, "Golmar" },
+    { 14, "SKS" },
+    { 15, "Spare" },
+};
+
+static constexpr JsonName doorbellSuppressionNames[] =
+{
+    { 0, "Off" },
+    { 1, "CM" },
+    { 2, "RTO" },
+    { 3, "CM & RTO" },
+    { 4, "Ring" },
+    { 5, "CM & Ring" },
+    { 6, "RTO & Ring" },
+    { 7, "CM & RTO & Ring" },
+};
+
+static constexpr JsonName soundNames[] =
+{
+    { 0, "No Sound" },
+    { 1, "Sound 1" },
+    { 2, "Sound 2" },
+    { 3, "Sound 3" },
+};
+
+template<typename T>
+static void nukiId(const T& config, char* buffer, size_t size)
+{
+    snprintf(buffer, size, "%x", (unsigned int)config.nukiId);
+}
+
+template<typename T>
+static void currentTime(const T& config, char* buffer, size_t size)
+{
+    snprintf(buffer, size, "%04d-%02d-%02d %02d:%02d:%02d", config.currentTimeYear, config.currentTimeMonth, config.currentTimeDay, config.currentTimeHour, config.currentTimeMinute, config.currentTimeSecond);
+}
+
+static void nightModeStartTime(const NukiLock::AdvancedConfig& config, char* buffer, size_t size)
+{
+    snprintf(buffer, size, "%02d:%02d", config.nightModeStartTime[0], config.nightModeStartTime[1]);
+}
+
+static void nightModeEndTime(const NukiLock::AdvancedConfig& config, char* buffer, size_t size)
+{
+    snprintf(buffer, size, "%02d:%02d", config.nightModeEndTime[0], config.nightModeEndTime[1]);
+}
+
+// The lock action names come from nuki_ble
+static void lockAction(const NukiLock::BatteryReport& batteryReport, char* buffer, size_t size)
+{
+    NukiLock::lockactionToString(batteryReport.lockAction, buffer);
+}
+
+static void openerLockAction(const NukiOpener::BatteryReport& batteryReport, char* buffer, size_t size)
+{
+    NukiOpener::lockactionToString(batteryReport.lockAction, buffer);
+}
+
+static int64_t noReboot(const NukiLock::AdvancedConfig& config)
+{
+    return 0;
+}
+
+static int64_t openerNoReboot(const NukiOpener::AdvancedConfig& config)
+{
+    return 0;
+}
+
+static constexpr JsonField<NukiLock::BatteryReport> lockBatteryReportFields[] =
+{
+    JSON_NUMBER(NukiLock::BatteryReport, "batteryDrain", batteryDrain),
+    JSON_FIXED(NukiLock::BatteryReport, "batteryVoltage", batteryVoltage, 3),
+    JSON_NUMBER(NukiLock::BatteryReport, "critical", criticalBatteryState),
+    JSON_TEXT(NukiLock::BatteryReport, "lockAction", &lockAction),
+    JSON_FIXED(NukiLock::BatteryReport, "startVoltage", startVoltage, 3),
+    JSON_FIXED(NukiLock::BatteryReport, "lowestVoltage", lowestVoltage, 3),
+    JSON_FIXED(NukiLock::BatteryReport, "lockDistance", lockDistance, 3),
+    JSON_NUMBER(NukiLock::BatteryReport, "startTemperature", startTemperature),
+    JSON_FIXED(NukiLock::BatteryReport, "maxTurnCurrent", maxTurnCurrent, 3),
+    JSON_FIXED(NukiLock::BatteryReport, "batteryResistance", batteryResistance, 3),
+};
+
+static constexpr JsonField<NukiLock::Config> lockConfigFields[] =
+{
+    JSON_TEXT(NukiLock::Config, "nukiID", &nukiId<NukiLock::Config>),
+    JSON_TEXT(NukiLock::Config, "name", &NukiPayloads::name<NukiLock::Config>),
+    JSON_NUMBER(NukiLock::Config, "autoUnlatch", autoUnlatch),
+    JSON_NUMBER(NukiLock::Config, "pairingEnabled", pairingEnabled),
+    JSON_NUMBER(NukiLock::Config, "buttonEnabled", buttonEnabled),
+    JSON_NUMBER(NukiLock::Config, "ledEnabled", ledEnabled),
+    JSON_NUMBER(NukiLock::Config, "ledBrightness", ledBrightness),
+    JSON_TEXT(NukiLock::Config, "currentTime", &currentTime<NukiLock::Config>),
+    JSON_NUMBER(NukiLock::Config, "timeZoneOffset", timeZoneOffset),
+    JSON_NUMBER(NukiLock::Config, "dstMode", dstMode),
+    JSON_NUMBER(NukiLock::Config, "hasFob", hasFob),
+    JSON_NAME(NukiLock::Config, "fobAction1", fobAction1, lockFobActionNames),
+    JSON_NAME(NukiLock::Config, "fobAction2", fobAction2, lockFobActionNames),
+    JSON_NAME(NukiLock::Config, "fobAction3", fobAction3, lockFobActionNames),
+    JSON_NUMBER(NukiLock::Config, "singleLock", singleLock),
+    JSON_NAME(NukiLock::Config, "advertisingMode", advertisingMode, advertisingModeNames),
+    JSON_NUMBER(NukiLock::Config, "hasKeypad", hasKeypad),
+    JSON_NUMBER(NukiLock::Config, "hasKeypadV2", hasKeypadV2),
+    JSON_TEXT(NukiLock::Config, "firmwareVersion", &NukiPayloads::firmwareVersion<NukiLock::Config>),
+    JSON_TEXT(NukiLock::Config, "hardwareRevision", &NukiPayloads::hardwareRevision<NukiLock::Config>),
+    JSON_NAME(NukiLock::Config, "homeKitStatus", homeKitStatus, homeKitStatusNames),
+    JSON_NAME(NukiLock::Config, "timeZone", timeZoneId, timeZoneNames),
+};
+
+static constexpr JsonField<NukiLock::AdvancedConfig> lockAdvancedConfigFields[] =
+{
+    JSON_NUMBER(NukiLock::AdvancedConfig, "totalDegrees", totalDegrees),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "unlockedPositionOffsetDegrees", unlockedPositionOffsetDegrees),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "lockedPositionOffsetDegrees", lockedPositionOffsetDegrees),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "singleLockedPositionOffsetDegrees", singleLockedPositionOffsetDegrees),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "unlockedToLockedTransitionOffsetDegrees", unlockedToLockedTransitionOffsetDegrees),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "lockNgoTimeout", lockNgoTimeout),
+    JSON_NAME(NukiLock::AdvancedConfig, "singleButtonPressAction", singleButtonPressAction, lockButtonPressActionNames),
+    JSON_NAME(NukiLock::AdvancedConfig, "doubleButtonPressAction", doubleButtonPressAction, lockButtonPressActionNames),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "detachedCylinder", detachedCylinder),
+    JSON_NAME(NukiLock::AdvancedConfig, "batteryType", batteryType, batteryTypeNames),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "automaticBatteryTypeDetection", automaticBatteryTypeDetection),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "unlatchDuration", unlatchDuration),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "autoLockTimeOut", autoLockTimeOut),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "autoUnLockDisabled", autoUnLockDisabled),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "nightModeEnabled", nightModeEnabled),
+    JSON_TEXT(NukiLock::AdvancedConfig, "nightModeStartTime", &nightModeStartTime),
+    JSON_TEXT(NukiLock::AdvancedConfig, "nightModeEndTime", &nightModeEndTime),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "nightModeAutoLockEnabled", nightModeAutoLockEnabled),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "nightModeAutoUnlockDisabled", nightModeAutoUnlockDisabled),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "nightModeImmediateLockOnStart", nightModeImmediateLockOnStart),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "autoLockEnabled", autoLockEnabled),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "immediateAutoLockEnabled", immediateAutoLockEnabled),
+    JSON_NUMBER(NukiLock::AdvancedConfig, "autoUpdateEnabled", autoUpdateEnabled),
+    { "rebootNuki", JsonField<NukiLock::AdvancedConfig>::Type::Number, &noReboot, 0, nullptr, 0, nullptr },
+};
+
+static constexpr JsonField<NukiOpener::BatteryReport> openerBatteryReportFields[] =
+{
+    JSON_FIXED(NukiOpener::BatteryReport, "batteryVoltage", batteryVoltage, 3),
+    JSON_NUMBER(NukiOpener::BatteryReport, "critical", criticalBatteryState),
+    JSON_TEXT(NukiOpener::BatteryReport, "lockAction", &openerLockAction),
+    JSON_FIXED(NukiOpener::BatteryReport, "startVoltage", startVoltage, 3),
+    JSON_FIXED(NukiOpener::BatteryReport, "lowestVoltage", lowestVoltage, 3),
+};
+
+static constexpr JsonField<NukiOpener::Config> openerConfigFields[] =
+{
+    JSON_TEXT(NukiOpener::Config, "nukiID", &nukiId<NukiOpener::Config>),
+    JSON_TEXT(NukiOpener::Config, "name", &NukiPayloads::name<NukiOpener::Config>),
+    JSON_NAME(NukiOpener::Config, "capabilities", capabilities, capabilitiesNames),
+    JSON_NUMBER(NukiOpener::Config, "pairingEnabled", pairingEnabled),
+    JSON_NUMBER(NukiOpener::Config, "buttonEnabled", buttonEnabled),
+    JSON_NUMBER(NukiOpener::Config, "ledFlashEnabled", ledFlashEnabled),
+    JSON_TEXT(NukiOpener::Config, "currentTime", &currentTime<NukiOpener::Config>),
+    JSON_NUMBER(NukiOpener::Config, "timeZoneOffset", timeZoneOffset),
+    JSON_NUMBER(NukiOpener::Config, "dstMode", dstMode),
+    JSON_NUMBER(NukiOpener::Config, "hasFob", hasFob),
+    JSON_NAME(NukiOpener::Config, "fobAction1", fobAction1, openerFobActionNames),
+    JSON_NAME(NukiOpener::Config, "fobAction2", fobAction2, openerFobActionNames),
+    JSON_NAME(NukiOpener::Config, "fobAction3", fobAction3, openerFobActionNames),
+    JSON_NAME(NukiOpener::Config, "operatingMode", operatingMode, operatingModeNames),
+    JSON_NAME(NukiOpener::Config, "advertisingMode", advertisingMode, advertisingModeNames),
+    JSON_NUMBER(NukiOpener::Config, "hasKeypad", hasKeypad),
+    JSON_NUMBER(NukiOpener::Config, "hasKeypadV2", hasKeypadV2),
+    JSON_TEXT(NukiOpener::Config, "firmwareVersion", &NukiPayloads::firmwareVersion<NukiOpener::Config>),
+    JSON_TEXT(NukiOpener::Config, "hardwareRevision", &NukiPayloads::hardwareRevision<NukiOpener::Config>),
+    JSON_NAME(NukiOpener::Config, "timeZone", timeZoneId, timeZoneNames),
+};
+
+static constexpr JsonField<NukiOpener::AdvancedConfig> openerAdvancedConfigFields[] =
+{
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "intercomID", intercomID),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "busModeSwitch", busModeSwitch),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "shortCircuitDuration", shortCircuitDuration),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "electricStrikeDelay", electricStrikeDelay),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "randomElectricStrikeDelay", randomElectricStrikeDelay),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "electricStrikeDuration", electricStrikeDuration),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "disableRtoAfterRing", disableRtoAfterRing),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "rtoTimeout", rtoTimeout),
+    JSON_NAME(NukiOpener::AdvancedConfig, "doorbellSuppression", doorbellSuppression, doorbellSuppressionNames),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "doorbellSuppressionDuration", doorbellSuppressionDuration),
+    JSON_NAME(NukiOpener::AdvancedConfig, "soundRing", soundRing, soundNames),
+    JSON_NAME(NukiOpener::AdvancedConfig, "soundOpen", soundOpen, soundNames),
+    JSON_NAME(NukiOpener::AdvancedConfig, "soundRto", soundRto, soundNames),
+    JSON_NAME(NukiOpener::AdvancedConfig, "soundCm", soundCm, soundNames),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "soundConfirmation", soundConfirmation),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "soundLevel", soundLevel),
+    JSON_NAME(NukiOpener::AdvancedConfig, "singleButtonPressAction", singleButtonPressAction, openerButtonPressActionNames),
+    JSON_NAME(NukiOpener::AdvancedConfig, "doubleButtonPressAction", doubleButtonPressAction, openerButtonPressActionNames),
+    JSON_NAME(NukiOpener::AdvancedConfig, "batteryType", batteryType, batteryTypeNames),
+    JSON_NUMBER(NukiOpener::AdvancedConfig, "automaticBatteryTypeDetection", automaticBatteryTypeDetection),
+    { "rebootNuki", JsonField<NukiOpener::AdvancedConfig>::Type::Number, &openerNoReboot, 0, nullptr, 0, nullptr },
+};
+
+void NukiPayloads::lockBatteryReport(JsonWriter& json, const NukiLock::BatteryReport& batteryReport)
+{
+    writeJsonFields(json, batteryReport, lockBatteryReportFields);
+}
+
+void NukiPayloads::lockConfig(JsonWriter& json, const NukiLock::Config& config)
+{
+    writeJsonFields(json, config, lockConfigFields);
+}
+
+void NukiPayloads::lockAdvancedConfig(JsonWriter& json, const NukiLock::AdvancedConfig& config)
+{
+    writeJsonFields(json, config, lockAdvancedConfigFields);
+}
+
+void NukiPayloads::openerBatteryReport(JsonWriter& json, const NukiOpener::BatteryReport& batteryReport)
+{
+    writeJsonFields(json, batteryReport, openerBatteryReportFields);
+}
+
+void NukiPayloads::openerConfig(JsonWriter& json, const NukiOpener::Config& config)
+{
+    writeJsonFields(json, config, openerConfigFields);
+}
+
+void NukiPayloads::openerAdvancedConfig(JsonWriter& json, const NukiOpener::AdvancedConfig& config)
+{
+    writeJsonFields(json, config, openerAdvancedConfigFields);
+}
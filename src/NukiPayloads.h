@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include "NukiConstants.h"
+#include "NukiLockConstants.h"
+#include "NukiOpenerConstants.h"
+#include "util/JsonWriter.h"
+
+// JSON payloads of the battery report, config and advanced config of the lock and the opener.
+// Each payload is a constexpr field list in NukiPayloads.cpp, written straight into the caller's buffer
+// without heap allocations. Doesn't depend on the network code, the native tests build it on the host.
+class NukiPayloads
+{
+public:
+    static void lockBatteryReport(JsonWriter& json, const NukiLock::BatteryReport& batteryReport);
+    static void lockConfig(JsonWriter& json, const NukiLock::Config& config);
+    static void lockAdvancedConfig(JsonWriter& json, const NukiLock::AdvancedConfig& config);
+
+    static void openerBatteryReport(JsonWriter& json, const NukiOpener::BatteryReport& batteryReport);
+    static void openerConfig(JsonWriter& json, const NukiOpener::Config& config);
+    static void openerAdvancedConfig(JsonWriter& json, const NukiOpener::AdvancedConfig& config);
+
+    template<typename T>
+    static void firmwareVersion(const T& config, char* buffer, size_t size)
+    {
+        snprintf(buffer, size, "%d.%d.%d", config.firmwareVersion[0], config.firmwareVersion[1], config.firmwareVersion[2]);
+    }
+
+    template<typename T>
+    static void hardwareRevision(const T& config, char* buffer, size_t size)
+    {
+        snprintf(buffer, size, "%d.%d", config.hardwareRevision[0], config.hardwareRevision[1]);
+    }
+
+    // The name isn't terminated if it uses all of config.name
+    template<typename T>
+    static void name(const T& config, char* buffer, size_t size)
+    {
+        size_t length = size - 1 < sizeof(config.name) ? size - 1 : sizeof(config.name);
+        memcpy(buffer, config.name, length);
+        buffer[length] = '\0';
+    }
+};
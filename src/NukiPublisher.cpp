@@ -1,60 +1,127 @@
 #include <cstring>
 #include "NukiPublisher.h"
+#include "Logger.h"
 
 
 NukiPublisher::NukiPublisher(NukiNetwork *network, const char* mqttPath)
     : _network(network),
-      _mqttPath(mqttPath)
+      _mqttPath(mqttPath),
+      _topics(mqttPath, MQTT_TOPIC_REGISTRY_SIZE)
 {
 }
 
+NukiPublisher::Topic NukiPublisher::internTopic(const char* topic)
+{
+    Topic interned;
+    interned.name = topic;
+    interned.id = _topics.intern(topic);
+    return interned;
+}
+
 void NukiPublisher::publishFloat(const char *topic, const float value, bool retain, const uint8_t precision)
 {
-    _network->publishFloat(_mqttPath, topic, value, retain, precision);
+    char str[30];
+    dtostrf(value, 0, precision, str);
+    publishString(topic, str, retain);
 }
 
 void NukiPublisher::publishInt(const char *topic, const int value, bool retain)
 {
-    _network->publishInt(_mqttPath, topic, value, retain);
+    publishInt(internTopic(topic), value, retain);
+}
+
+void NukiPublisher::publishInt(const Topic& topic, const int value, bool retain)
+{
+    char str[30];
+    itoa(value, str, 10);
+    publishString(topic, str, retain);
 }
 
 void NukiPublisher::publishUInt(const char *topic, const unsigned int value, bool retain)
 {
-    _network->publishUInt(_mqttPath, topic, value, retain);
+    char str[30];
+    utoa(value, str, 10);
+    publishString(topic, str, retain);
 }
 
 void NukiPublisher::publishBool(const char *topic, const bool value, bool retain)
 {
-    _network->publishBool(_mqttPath, topic, value, retain);
+    publishBool(internTopic(topic), value, retain);
 }
 
-void NukiPublisher::publishString(const char *topic, const String &value, bool retain)
+void NukiPublisher::publishBool(const Topic& topic, const bool value, bool retain)
 {
-    char str[value.length() + 1];
-    memset(str, 0, sizeof(str));
-    memcpy(str, value.begin(), value.length());
+    char str[2] = {0};
+    str[0] = value ? '1' : '0';
     publishString(topic, str, retain);
 }
 
+void NukiPublisher::publishString(const char *topic, const String &value, bool retain)
+{
+    publishString(topic, value.c_str(), retain);
+}
+
 void NukiPublisher::publishString(const char *topic, const std::string &value, bool retain)
 {
-    char str[value.size() + 1];
-    memset(str, 0, sizeof(str));
-    memcpy(str, value.data(), value.length());
-    publishString(topic, str, retain);
+    publishString(topic, value.c_str(), retain);
 }
 
 void NukiPublisher::publishString(const char *topic, const char *value, bool retain)
 {
-    _network->publishString(_mqttPath, topic, value, retain);
+    publishString(internTopic(topic), value, retain);
+}
+
+void NukiPublisher::publishString(const Topic& topic, const char *value, bool retain)
+{
+    if(topic.id == MqttTopicRegistry::InvalidId)
+    {
+        _network->publishString(_mqttPath, topic.name, value, retain);
+        return;
+    }
+
+    _network->publish(_topics.path(topic.id), value, retain, _topics.policy(topic.id));
+}
+
+void NukiPublisher::publishJson(const char *topic, JsonVariantConst json, bool retain)
+{
+    publishJson(internTopic(topic), json, retain);
+}
+
+void NukiPublisher::publishJson(const Topic& topic, JsonVariantConst json, bool retain)
+{
+    if(topic.id == MqttTopicRegistry::InvalidId)
+    {
+        _network->publishJson(_mqttPath, topic.name, json, retain);
+        return;
+    }
+
+    _network->publishJson(_topics.path(topic.id), json, retain, _topics.policy(topic.id));
+}
+
+void NukiPublisher::publishJson(const char *topic, JsonWriter& json, bool retain)
+{
+    const char* payload = json.finish();
+
+    if(json.overflowed())
+    {
+        Log->print(F("JSON payload too large, not publishing "));
+        Log->println(topic);
+        return;
+    }
+
+    publishString(topic, payload, retain);
 }
 
 void NukiPublisher::publishULong(const char *topic, const unsigned long value, bool retain)
 {
-    _network->publishULong(_mqttPath, topic, value, retain);
+    char str[30];
+    ultoa(value, str, 10);
+    publishString(topic, str, retain);
 }
 
 void NukiPublisher::publishLongLong(const char *topic, int64_t value, bool retain)
 {
-    _network->publishLongLong(_mqttPath, topic, value, retain);
+    char str[30];
+    lltoa(value, str, 10);
+    publishString(topic, str, retain);
 }
@@ -2,12 +2,24 @@
 
 #include <cstdint>
 #include "NukiNetwork.h"
+#include "MqttTopicRegistry.h"
+#include "util/JsonWriter.h"
 
 class NukiPublisher
 {
 public:
+    // Topic interned up front. Publishing it goes straight to the full path without the per publish topic lookup.
+    struct Topic
+    {
+        const char* name = nullptr;
+        uint16_t id = MqttTopicRegistry::InvalidId;
+    };
+
     NukiPublisher(NukiNetwork* _network, const char* mqttPath);
 
+    // Call after the mqtt path is set
+    Topic internTopic(const char* topic);
+
     void publishFloat(const char* topic, const float value, bool retain, const uint8_t precision = 2);
     void publishInt(const char* topic, const int value, bool retain);
     void publishUInt(const char* topic, const unsigned int value, bool retain);
@@ -17,9 +29,17 @@ public:
     void publishString(const char* topic, const String& value, bool retain);
     void publishString(const char* topic, const std::string& value, bool retain);
     void publishString(const char* topic, const char* value, bool retain);
+    void publishJson(const char* topic, JsonVariantConst json, bool retain);
+    void publishJson(const char* topic, JsonWriter& json, bool retain);
+
+    void publishInt(const Topic& topic, const int value, bool retain);
+    void publishBool(const Topic& topic, const bool value, bool retain);
+    void publishString(const Topic& topic, const char* value, bool retain);
+    void publishJson(const Topic& topic, JsonVariantConst json, bool retain);
 
 private:
     NukiNetwork* _network;
     const char* _mqttPath;
+    MqttTopicRegistry _topics;
 
 };
@@ -7,6 +7,7 @@
 #include "Config.h"
 
 NukiWrapper* nukiInst = nullptr;
+static const char* const latencyActionNames[] = { "lock", "unlock", "unlatch" };
 
 NukiWrapper::NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkLock* network, NukiOfficial* nukiOfficial, Gpio* gpio, Preferences* preferences)
     : _deviceName(deviceName),
@@ -16,7 +17,9 @@ NukiWrapper::NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId,
       _network(network),
       _nukiOfficial(nukiOfficial),
       _gpio(gpio),
-      _preferences(preferences)
+      _preferences(preferences),
+      _latency(latencyActionNames, 3, preferences->getBool(preference_publish_debug_info, false)),
+      _bleJobs(Nuki::CmdResult::Success, [this]() { postponeBleWatchdog(); })
 {
     Log->print("Device id lock: ");
     Log->println(_deviceId->get());
@@ -28,6 +31,7 @@ NukiWrapper::NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId,
     memset(&_batteryReport, sizeof(NukiLock::BatteryReport), 0);
     memset(&_keyTurnerState, sizeof(NukiLock::KeyTurnerState), 0);
     _keyTurnerState.lockState = NukiLock::LockState::Undefined;
+    _commandQueue.setCoalescing(NUKI_COMMAND_COALESCE, isOppositeLockAction);
 
     network->setLockActionReceivedCallback(nukiInst->onLockActionReceivedCallback);
     network->setOfficialUpdateReceivedCallback(nukiInst->onOfficialUpdateReceivedCallback);
@@ -132,6 +136,7 @@ void NukiWrapper::readSettings()
         _retryDelay = 100;
         _preferences->putInt(preference_command_retry_delay, _retryDelay);
     }
+    _bleJobs.setRetryDelay(_retryDelay);
     if(_intervalLockstate == 0)
     {
         Log->println("Invalid intervalLockstate, revert to default (1800)");
@@ -228,73 +233,83 @@ void NukiWrapper::update()
 
     if(_nukiOfficial->getOffCommandExecutedTs() > 0 && ts >= _nukiOfficial->getOffCommandExecutedTs())
     {
-        _nextLockAction = _offCommand;
+        enqueueLockAction(_offCommand, CommandSource::Hybrid);
         _nukiOfficial->clearOffCommandExecutedTs();
     }
-    if(_nextLockAction != (NukiLock::LockAction)0xff)
-    {
-        int retryCount = 0;
-        Nuki::CmdResult cmdResult;
 
-        while(retryCount < _nrOfRetries + 1 && cmdResult != Nuki::CmdResult::Success)
+    bool runLockAction = _lockActionJob.pending() ? _lockActionJob.due(ts) : _commandQueue.pop(_lockActionCommand);
+    if(runLockAction)
+    {
+        if(!_lockActionJob.pending())
         {
-            cmdResult = _nukiLock.lockAction(_nextLockAction, 0, 0);
-            char resultStr[15] = {0};
-            NukiLock::cmdResultToString(cmdResult, resultStr);
-            _network->publishCommandResult(resultStr);
-
-            Log->print(F("Lock action result: "));
-            Log->println(resultStr);
+            _latency.sent(latencyAction(_lockActionCommand.action), _lockActionCommand.enqueueTs, espMillis());
+        }
 
-            if(cmdResult != Nuki::CmdResult::Success)
-            {
-                Log->print(F("Lock: Last command failed, retrying after "));
-                Log->print(_retryDelay);
-                Log->print(F(" milliseconds. Retry "));
-                Log->print(retryCount + 1);
-                Log->print(" of ");
-                Log->println(_nrOfRetries);
+        Nuki::CmdResult cmdResult = _nukiLock.lockAction(_lockActionCommand.action, 0, 0);
+        char resultStr[15] = {0};
+        NukiLock::cmdResultToString(cmdResult, resultStr);
+        _network->publishCommandResult(resultStr);
 
-                _network->publishRetry(std::to_string(retryCount + 1));
+        Log->print(F("Lock action result: "));
+        Log->println(resultStr);
+        postponeBleWatchdog();
 
-                delay(_retryDelay);
+        if(cmdResult != Nuki::CmdResult::Success && _lockActionJob.failed(_nrOfRetries + 1, espMillis() + _retryDelay))
+        {
+            Log->print(F("Lock: Last command failed, retrying after "));
+            Log->print(_retryDelay);
+            Log->print(F(" milliseconds. Retry "));
+            Log->print(_lockActionJob.failures());
+            Log->print(" of ");
+            Log->println(_nrOfRetries);
 
-                ++retryCount;
-            }
-            postponeBleWatchdog();
+            _network->publishRetry(std::to_string(_lockActionJob.failures()));
         }
-
-        if(cmdResult == Nuki::CmdResult::Success)
+        else
         {
-            _nextLockAction = (NukiLock::LockAction) 0xff;
-            _network->publishRetry("--");
-            retryCount = 0;
-            if(!_nukiOfficial->getOffConnected())
+            _lockActionJob.reset();
+            _latency.completed(cmdResult == Nuki::CmdResult::Success, espMillis());
+
+            Log->print(F("Lock action "));
+            Log->print(_lockActionCommand.id);
+            Log->print(F(" from source "));
+            Log->print((int)_lockActionCommand.source);
+            Log->print(F(" completed "));
+            Log->print((long)(espMillis() - _lockActionCommand.enqueueTs));
+            Log->println(F(" ms after it was queued"));
+
+            if(cmdResult == Nuki::CmdResult::Success)
             {
-                _statusUpdated = true;
+                _network->publishRetry("--");
+                if(!_nukiOfficial->getOffConnected())
+                {
+                    _statusUpdated = true;
+                }
+                Log->println(F("Lock: updating status after action"));
+                _statusUpdatedTs = ts;
+                if(_intervalLockstate > 10)
+                {
+                    _nextLockStateUpdateTs = ts + 10 * 1000;
+                }
             }
-            Log->println(F("Lock: updating status after action"));
-            _statusUpdatedTs = ts;
-            if(_intervalLockstate > 10)
+            else
             {
-                _nextLockStateUpdateTs = ts + 10 * 1000;
+                Log->println(F("Lock: Maximum number of retries exceeded, aborting."));
+                _network->publishRetry("failed");
             }
         }
-        else
-        {
-            Log->println(F("Lock: Maximum number of retries exceeded, aborting."));
-            _network->publishRetry("failed");
-            retryCount = 0;
-            _nextLockAction = (NukiLock::LockAction) 0xff;
-        }
     }
     if(_nukiOfficial->getStatusUpdated() || _statusUpdated || _nextLockStateUpdateTs == 0 || ts >= _nextLockStateUpdateTs || (queryCommands & QUERY_COMMAND_LOCKSTATE) > 0)
     {
         Log->println("Updating Lock state based on status, timer or query");
         _statusUpdated = updateKeyTurnerState();
-        _nextLockStateUpdateTs = ts + _intervalLockstate * 1000;
+        _nextLockStateUpdateTs = _lockStateJob.pending() ? _lockStateJob.retryTs() : ts + _intervalLockstate * 1000;
         _network->publishStatusUpdated(_statusUpdated);
     }
+    if(!runLockAction)
+    {
+        _bleJobs.run(ts);
+    }
     if(_network->mqttConnectionState() == 2)
     {
         if(!_statusUpdated)
@@ -340,12 +355,8 @@ void NukiWrapper::update()
             {
                 _nextRssiTs = ts + _rssiPublishInterval;
 
-                int rssi = _nukiLock.getRssi();
-                if(rssi != _lastRssi)
-                {
-                    _network->publishRssi(rssi);
-                    _lastRssi = rssi;
-                }
+                // unchanged values and changes within the deadband are filtered when publishing
+                _network->publishRssi(_nukiLock.getRssi());
             }
             if(_hasKeypad && _keypadEnabled && (_nextKeypadUpdateTs == 0 || ts > _nextKeypadUpdateTs || (queryCommands & QUERY_COMMAND_KEYPAD) > 0))
             {
@@ -369,29 +380,62 @@ void NukiWrapper::update()
     memcpy(&_lastKeyTurnerState, &_keyTurnerState, sizeof(NukiLock::KeyTurnerState));
 }
 
-void NukiWrapper::lock()
+void NukiWrapper::lock(CommandSource source)
+{
+    enqueueLockAction(NukiLock::LockAction::Lock, source);
+}
+
+void NukiWrapper::unlock(CommandSource source)
+{
+    enqueueLockAction(NukiLock::LockAction::Unlock, source);
+}
+
+void NukiWrapper::unlatch(CommandSource source)
+{
+    enqueueLockAction(NukiLock::LockAction::Unlatch, source);
+}
+
+void NukiWrapper::lockngo(CommandSource source)
 {
-    _nextLockAction = NukiLock::LockAction::Lock;
+    enqueueLockAction(NukiLock::LockAction::LockNgo, source);
 }
 
-void NukiWrapper::unlock()
+void NukiWrapper::lockngounlatch(CommandSource source)
 {
-    _nextLockAction = NukiLock::LockAction::Unlock;
+    enqueueLockAction(NukiLock::LockAction::LockNgoUnlatch, source);
 }
 
-void NukiWrapper::unlatch()
+bool NukiWrapper::enqueueLockAction(NukiLock::LockAction action, CommandSource source)
 {
-    _nextLockAction = NukiLock::LockAction::Unlatch;
+    CommandPriority priority = source == CommandSource::Gpio ? CommandPriority::High : CommandPriority::Normal;
+
+    if(_commandQueue.push(action, source, priority) == 0)
+    {
+        Log->println(F("Lock: Command queue full, dropping lock action"));
+        return false;
+    }
+    return true;
 }
 
-void NukiWrapper::lockngo()
+bool NukiWrapper::isOppositeLockAction(NukiLock::LockAction first, NukiLock::LockAction second)
 {
-    _nextLockAction = NukiLock::LockAction::LockNgo;
+    return (first == NukiLock::LockAction::Lock && second == NukiLock::LockAction::Unlock) ||
+           (first == NukiLock::LockAction::Unlock && second == NukiLock::LockAction::Lock);
 }
 
-void NukiWrapper::lockngounlatch()
+int NukiWrapper::latencyAction(NukiLock::LockAction action)
 {
-    _nextLockAction = NukiLock::LockAction::LockNgoUnlatch;
+    switch(action)
+    {
+        case NukiLock::LockAction::Lock:
+            return 0;
+        case NukiLock::LockAction::Unlock:
+            return 1;
+        case NukiLock::LockAction::Unlatch:
+            return 2;
+        default:
+            return -1;
+    }
 }
 
 bool NukiWrapper::isPinSet()
@@ -429,19 +473,13 @@ void NukiWrapper::unpair()
 bool NukiWrapper::updateKeyTurnerState()
 {
     bool updateStatus = false;
-    Nuki::CmdResult result = (Nuki::CmdResult)-1;
-    int retryCount = 0;
 
     Log->println(F("Querying lock state"));
 
-    while(result != Nuki::CmdResult::Success && retryCount < _nrOfRetries + 1)
-    {
-        Log->print(F("Result (attempt "));
-        Log->print(retryCount + 1);
-        Log->print(F("): "));
-        result =_nukiLock.requestKeyTurnerState(&_keyTurnerState);
-        ++retryCount;
-    }
+    Log->print(F("Result (attempt "));
+    Log->print(_lockStateJob.attempt());
+    Log->print(F("): "));
+    Nuki::CmdResult result = _nukiLock.requestKeyTurnerState(&_keyTurnerState);
 
     char resultStr[15];
     memset(&resultStr, 0, sizeof(resultStr));
@@ -451,19 +489,17 @@ bool NukiWrapper::updateKeyTurnerState()
     if(result != Nuki::CmdResult::Success)
     {
         Log->println("Query lock state failed");
-        _retryLockstateCount++;
         postponeBleWatchdog();
-        if(_retryLockstateCount < _nrOfRetries + 1)
+        if(_lockStateJob.failed(_nrOfRetries + 1, espMillis() + _retryDelay))
         {
             Log->print(F("Query lock state retrying in "));
             Log->print(_retryDelay);
             Log->println("ms");
-            _nextLockStateUpdateTs = espMillis() + _retryDelay;
         }
         return false;
     }
 
-    _retryLockstateCount = 0;
+    _lockStateJob.reset();
 
     const NukiLock::LockState& lockState = _keyTurnerState.lockState;
 
@@ -495,6 +531,12 @@ bool NukiWrapper::updateKeyTurnerState()
 
     _network->publishKeyTurnerState(_keyTurnerState, _lastKeyTurnerState);
 
+    int latencyIndex = _latency.statePublished(espMillis());
+    if(latencyIndex >= 0)
+    {
+        _network->publishActionLatency(_latency, latencyIndex);
+    }
+
     char lockStateStr[20];
     lockstateToString(lockState, lockStateStr);
     Log->println(lockStateStr);
@@ -506,33 +548,26 @@ bool NukiWrapper::updateKeyTurnerState()
 
 void NukiWrapper::updateBatteryState()
 {
-    Nuki::CmdResult result = (Nuki::CmdResult)-1;
-    int retryCount = 0;
-
     Log->println("Querying lock battery state");
 
-    while(retryCount < _nrOfRetries + 1)
-    {
-        Log->print(F("Result (attempt "));
-        Log->print(retryCount + 1);
-        Log->print("): ");
-        result = _nukiLock.requestBatteryReport(&_batteryReport);
-
-        if(result != Nuki::CmdResult::Success)
-        {
-            ++retryCount;
-        }
-        else
-        {
-            break;
-        }
-    }
+    Log->print(F("Result (attempt "));
+    Log->print(_batteryJob.attempt());
+    Log->print("): ");
+    Nuki::CmdResult result = _nukiLock.requestBatteryReport(&_batteryReport);
 
     printCommandResult(result);
     if(result == Nuki::CmdResult::Success)
     {
+        _batteryJob.reset();
         _network->publishBatteryReport(_batteryReport);
     }
+    else if(_batteryJob.failed(_nrOfRetries + 1, espMillis() + _retryDelay))
+    {
+        Log->print(F("Query lock battery state retrying in "));
+        Log->print(_retryDelay);
+        Log->println("ms");
+        _nextBatteryReportTs = _batteryJob.retryTs();
+    }
     postponeBleWatchdog();
     Log->println(F("Done querying lock battery state"));
 }
@@ -540,6 +575,7 @@ void NukiWrapper::updateBatteryState()
 void NukiWrapper::updateConfig()
 {
     bool expectedConfig = true;
+    bool readFailed = false;
 
     readConfig();
 
@@ -632,6 +668,7 @@ void NukiWrapper::updateConfig()
     {
         Log->println(F("Invalid/Unexpected lock config received, Config is not valid"));
         expectedConfig = false;
+        readFailed = true;
     }
 
     if(expectedConfig)
@@ -649,16 +686,24 @@ void NukiWrapper::updateConfig()
         {
             Log->println(F("Invalid/Unexpected lock advanced config received, Advanced config is not valid"));
             expectedConfig = false;
+            readFailed = true;
         }
     }
 
     if(expectedConfig && _nukiConfigValid && _nukiAdvancedConfigValid)
     {
+        _configJob.reset();
         _retryConfigCount = 0;
         Log->println(F("Done retrieving lock config and advanced config"));
     }
+    else if(readFailed && _configJob.failed(_nrOfRetries + 1, espMillis() + 1000))
+    {
+        Log->println(F("Failed to retrieve lock config, retrying in 1s"));
+        _nextConfigUpdateTs = _configJob.retryTs();
+    }
     else
     {
+        _configJob.reset();
         ++_retryConfigCount;
         Log->println(F("Invalid/Unexpected lock config and/or advanced config received, retrying in 10 seconds"));
         int64_t ts = espMillis();
@@ -760,28 +805,24 @@ void NukiWrapper::updateKeypad(bool retrieved)
 
     if(!retrieved)
     {
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        if(_bleJobs.pending("keypad"))
+        {
+            return;
+        }
 
-        while(retryCount < _nrOfRetries + 1)
+        _bleJobs.add("keypad", _nrOfRetries + 1, [this]()
         {
             Log->print(F("Querying lock keypad: "));
-            result = _nukiLock.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
-            if(result != Nuki::CmdResult::Success)
-            {
-                ++retryCount;
-            }
-            else
+            return _nukiLock.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+        },
+        [this](Nuki::CmdResult result)
+        {
+            printCommandResult(result);
+            if(result == Nuki::CmdResult::Success)
             {
-                break;
+                _waitKeypadUpdateTs = espMillis() + 5000;
             }
-        }
-
-        printCommandResult(result);
-        if(result == Nuki::CmdResult::Success)
-        {
-            _waitKeypadUpdateTs = espMillis() + 5000;
-        }
+        });
     }
     else
     {
@@ -839,28 +880,24 @@ void NukiWrapper::updateTimeControl(bool retrieved)
 
     if(!retrieved)
     {
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        if(_bleJobs.pending("timecontrol"))
+        {
+            return;
+        }
 
-        while(retryCount < _nrOfRetries + 1)
+        _bleJobs.add("timecontrol", _nrOfRetries + 1, [this]()
         {
             Log->print(F("Querying lock timecontrol: "));
-            result = _nukiLock.retrieveTimeControlEntries();
-            if(result != Nuki::CmdResult::Success)
-            {
-                ++retryCount;
-            }
-            else
+            return _nukiLock.retrieveTimeControlEntries();
+        },
+        [this](Nuki::CmdResult result)
+        {
+            printCommandResult(result);
+            if(result == Nuki::CmdResult::Success)
             {
-                break;
+                _waitTimeControlUpdateTs = espMillis() + 5000;
             }
-        }
-
-        printCommandResult(result);
-        if(result == Nuki::CmdResult::Success)
-        {
-            _waitTimeControlUpdateTs = espMillis() + 5000;
-        }
+        });
     }
     else
     {
@@ -915,29 +952,24 @@ void NukiWrapper::updateAuth(bool retrieved)
 
     if(!retrieved)
     {
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        if(_bleJobs.pending("auth"))
+        {
+            return;
+        }
 
-        while(retryCount < _nrOfRetries)
+        _bleJobs.add("auth", _nrOfRetries, [this]()
         {
             Log->print(F("Querying lock authorization: "));
-            result = _nukiLock.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
-            delay(250);
-            if(result != Nuki::CmdResult::Success)
-            {
-                ++retryCount;
-            }
-            else
+            return _nukiLock.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
+        },
+        [this](Nuki::CmdResult result)
+        {
+            printCommandResult(result);
+            if(result == Nuki::CmdResult::Success)
             {
-                break;
+                _waitAuthUpdateTs = millis() + 5000;
             }
-        }
-
-        printCommandResult(result);
-        if(result == Nuki::CmdResult::Success)
-        {
-            _waitAuthUpdateTs = millis() + 5000;
-        }
+        });
     }
     else
     {
@@ -1057,23 +1089,14 @@ LockActionResult NukiWrapper::onLockActionReceived(const char *value)
 
     if((action == NukiLock::LockAction::Lock && (int)aclPrefs[0] == 1) || (action == NukiLock::LockAction::Unlock && (int)aclPrefs[1] == 1) || (action == NukiLock::LockAction::Unlatch && (int)aclPrefs[2] == 1) || (action == NukiLock::LockAction::LockNgo && (int)aclPrefs[3] == 1) || (action == NukiLock::LockAction::LockNgoUnlatch && (int)aclPrefs[4] == 1) || (action == NukiLock::LockAction::FullLock && (int)aclPrefs[5] == 1) || (action == NukiLock::LockAction::FobAction1 && (int)aclPrefs[6] == 1) || (action == NukiLock::LockAction::FobAction2 && (int)aclPrefs[7] == 1) || (action == NukiLock::LockAction::FobAction3 && (int)aclPrefs[8] == 1))
     {
-        if(!_nukiOfficial->getOffConnected())
-        {
-            nukiInst->_nextLockAction = action;
-        }
-        else
+        if(!_nukiOfficial->getOffConnected() || !_preferences->getBool(preference_official_hybrid_actions, false))
         {
-            if(_preferences->getBool(preference_official_hybrid_actions, false))
-            {
-                _nukiOfficial->setOffCommandExecutedTs(espMillis() + 2000);
-                _offCommand = action;
-                _network->publishOffAction((int)action);
-            }
-            else
-            {
-                nukiInst->_nextLockAction = action;
-            }
+            return nukiInst->enqueueLockAction(action, CommandSource::Mqtt) ? LockActionResult::Success : LockActionResult::Failed;
         }
+
+        _nukiOfficial->setOffCommandExecutedTs(espMillis() + 2000);
+        _offCommand = action;
+        _network->publishOffAction((int)action);
         return LockActionResult::Success;
     }
 
@@ -2396,7 +2419,7 @@ void NukiWrapper::onGpioActionReceived(const GpioAction &action, const int &pin)
     case GpioAction::Lock:
         if(!_nukiOfficial->getOffConnected())
         {
-            nukiInst->lock();
+            nukiInst->lock(CommandSource::Gpio);
         }
         else
         {
@@ -2408,7 +2431,7 @@ void NukiWrapper::onGpioActionReceived(const GpioAction &action, const int &pin)
     case GpioAction::Unlock:
         if(!_nukiOfficial->getOffConnected())
         {
-            nukiInst->unlock();
+            nukiInst->unlock(CommandSource::Gpio);
         }
         else
         {
@@ -2420,7 +2443,7 @@ void NukiWrapper::onGpioActionReceived(const GpioAction &action, const int &pin)
     case GpioAction::Unlatch:
         if(!_nukiOfficial->getOffConnected())
         {
-            nukiInst->unlatch();
+            nukiInst->unlatch(CommandSource::Gpio);
         }
         else
         {
@@ -2432,7 +2455,7 @@ void NukiWrapper::onGpioActionReceived(const GpioAction &action, const int &pin)
     case GpioAction::LockNgo:
         if(!_nukiOfficial->getOffConnected())
         {
-            nukiInst->lockngo();
+            nukiInst->lockngo(CommandSource::Gpio);
         }
         else
         {
@@ -2444,7 +2467,7 @@ void NukiWrapper::onGpioActionReceived(const GpioAction &action, const int &pin)
     case GpioAction::LockNgoUnlatch:
         if(!_nukiOfficial->getOffConnected())
         {
-            nukiInst->lockngounlatch();
+            nukiInst->lockngounlatch(CommandSource::Gpio);
         }
         else
         {
@@ -2485,114 +2508,113 @@ void NukiWrapper::onKeypadCommandReceived(const char *command, const uint &id, c
     bool idExists = std::find(_keypadCodeIds.begin(), _keypadCodeIds.end(), id) != _keypadCodeIds.end();
     int codeInt = code.toInt();
     bool codeValid = codeInt > 100000 && codeInt < 1000000 && (code.indexOf('0') == -1);
-    Nuki::CmdResult result = (Nuki::CmdResult)-1;
-    int retryCount = 0;
+    RetryScheduler<Nuki::CmdResult>::Attempt attempt;
 
-    while(retryCount < _nrOfRetries + 1)
+    if(strcmp(command, "add") == 0)
     {
-        if(strcmp(command, "add") == 0)
+        if(name == "" || name == "--")
         {
-            if(name == "" || name == "--")
-            {
-                _network->publishKeypadCommandResult("MissingParameterName");
-                return;
-            }
-            if(codeInt == 0)
-            {
-                _network->publishKeypadCommandResult("MissingParameterCode");
-                return;
-            }
-            if(!codeValid)
-            {
-                _network->publishKeypadCommandResult("CodeInvalid");
-                return;
-            }
+            _network->publishKeypadCommandResult("MissingParameterName");
+            return;
+        }
+        if(codeInt == 0)
+        {
+            _network->publishKeypadCommandResult("MissingParameterCode");
+            return;
+        }
+        if(!codeValid)
+        {
+            _network->publishKeypadCommandResult("CodeInvalid");
+            return;
+        }
 
-            NukiLock::NewKeypadEntry entry;
-            memset(&entry, 0, sizeof(entry));
-            size_t nameLen = name.length();
-            memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
-            entry.code = codeInt;
-            result = _nukiLock.addKeypadEntry(entry);
+        NukiLock::NewKeypadEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        size_t nameLen = name.length();
+        memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
+        entry.code = codeInt;
+        attempt = [this, entry]()
+        {
+            Nuki::CmdResult result = _nukiLock.addKeypadEntry(entry);
             Log->print("Add keypad code: ");
             Log->println((int)result);
-            updateKeypad(false);
-        }
-        else if(strcmp(command, "delete") == 0)
+            return result;
+        };
+    }
+    else if(strcmp(command, "delete") == 0)
+    {
+        if(!idExists)
         {
-            if(!idExists)
-            {
-                _network->publishKeypadCommandResult("UnknownId");
-                return;
-            }
+            _network->publishKeypadCommandResult("UnknownId");
+            return;
+        }
 
-            result = _nukiLock.deleteKeypadEntry(id);
+        uint16_t codeId = id;
+        attempt = [this, codeId]()
+        {
+            Nuki::CmdResult result = _nukiLock.deleteKeypadEntry(codeId);
             Log->print("Delete keypad code: ");
             Log->println((int)result);
-            updateKeypad(false);
-        }
-        else if(strcmp(command, "update") == 0)
+            return result;
+        };
+    }
+    else if(strcmp(command, "update") == 0)
+    {
+        if(name == "" || name == "--")
         {
-            if(name == "" || name == "--")
-            {
-                _network->publishKeypadCommandResult("MissingParameterName");
-                return;
-            }
-            if(codeInt == 0)
-            {
-                _network->publishKeypadCommandResult("MissingParameterCode");
-                return;
-            }
-            if(!codeValid)
-            {
-                _network->publishKeypadCommandResult("CodeInvalid");
-                return;
-            }
-            if(!idExists)
-            {
-                _network->publishKeypadCommandResult("UnknownId");
-                return;
-            }
-
-            NukiLock::UpdatedKeypadEntry entry;
-            memset(&entry, 0, sizeof(entry));
-            entry.codeId = id;
-            size_t nameLen = name.length();
-            memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
-            entry.code = codeInt;
-            entry.enabled = enabled == 0 ? 0 : 1;
-            result = _nukiLock.updateKeypadEntry(entry);
-            Log->print("Update keypad code: ");
-            Log->println((int)result);
-            updateKeypad(false);
+            _network->publishKeypadCommandResult("MissingParameterName");
+            return;
         }
-        else if(strcmp(command, "--") == 0)
+        if(codeInt == 0)
         {
+            _network->publishKeypadCommandResult("MissingParameterCode");
             return;
         }
-        else
+        if(!codeValid)
         {
-            _network->publishKeypadCommandResult("UnknownCommand");
+            _network->publishKeypadCommandResult("CodeInvalid");
             return;
         }
-
-        if(result != Nuki::CmdResult::Success)
+        if(!idExists)
         {
-            ++retryCount;
+            _network->publishKeypadCommandResult("UnknownId");
+            return;
         }
-        else
+
+        NukiLock::UpdatedKeypadEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.codeId = id;
+        size_t nameLen = name.length();
+        memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
+        entry.code = codeInt;
+        entry.enabled = enabled == 0 ? 0 : 1;
+        attempt = [this, entry]()
         {
-            break;
-        }
+            Nuki::CmdResult result = _nukiLock.updateKeypadEntry(entry);
+            Log->print("Update keypad code: ");
+            Log->println((int)result);
+            return result;
+        };
+    }
+    else if(strcmp(command, "--") == 0)
+    {
+        return;
+    }
+    else
+    {
+        _network->publishKeypadCommandResult("UnknownCommand");
+        return;
     }
 
-    if((int)result != -1)
+    _bleJobs.add("keypadCommand", _nrOfRetries + 1, attempt, [this](Nuki::CmdResult result)
     {
+        updateKeypad(false);
+
         char resultStr[15];
         memset(&resultStr, 0, sizeof(resultStr));
         NukiLock::cmdResultToString(result, resultStr);
         _network->publishKeypadCommandResult(resultStr);
-    }
+    });
 }
 
 void NukiWrapper::onKeypadJsonCommandReceived(const char *value)
@@ -2761,418 +2783,417 @@ void NukiWrapper::onKeypadJsonCommandReceived(const char *value)
         else
         {
 
-            Nuki::CmdResult result = (Nuki::CmdResult)-1;
-            int retryCount = 0;
+            RetryScheduler<Nuki::CmdResult>::Attempt attempt;
 
-            while(retryCount < _nrOfRetries + 1)
+            if(strcmp(action, "delete") == 0)
             {
-                if(strcmp(action, "delete") == 0)
+                if(idExists)
                 {
-                    if(idExists)
+                    attempt = [this, codeId]()
                     {
-                        result = _nukiLock.deleteKeypadEntry(codeId);
+                        Nuki::CmdResult result = _nukiLock.deleteKeypadEntry(codeId);
                         Log->print(F("Delete keypad code: "));
                         Log->println((int)result);
-                    }
-                    else
-                    {
-                        _network->publishKeypadJsonCommandResult("noExistingCodeIdSet");
-                        return;
-                    }
+                        return result;
+                    };
                 }
-                else if(strcmp(action, "add") == 0 || strcmp(action, "update") == 0)
+                else
                 {
-                    if(name.length() < 1)
+                    _network->publishKeypadJsonCommandResult("noExistingCodeIdSet");
+                    return;
+                }
+            }
+            else if(strcmp(action, "add") == 0 || strcmp(action, "update") == 0)
+            {
+                if(name.length() < 1)
+                {
+                    if (strcmp(action, "update") != 0)
                     {
-                        if (strcmp(action, "update") != 0)
-                        {
-                            _network->publishKeypadJsonCommandResult("noNameSet");
-                            return;
-                        }
+                        _network->publishKeypadJsonCommandResult("noNameSet");
+                        return;
                     }
+                }
 
-                    if(code != 12)
-                    {
-                        String codeStr = json["code"].as<String>();
-                        bool codeValid = code > 100000 && code < 1000000 && (codeStr.indexOf('0') == -1);
+                if(code != 12)
+                {
+                    String codeStr = json["code"].as<String>();
+                    bool codeValid = code > 100000 && code < 1000000 && (codeStr.indexOf('0') == -1);
 
-                        if (!codeValid)
-                        {
-                            _network->publishKeypadJsonCommandResult("noValidCodeSet");
-                            return;
-                        }
-                    }
-                    else if (strcmp(action, "update") != 0)
+                    if (!codeValid)
                     {
-                        _network->publishKeypadJsonCommandResult("noCodeSet");
+                        _network->publishKeypadJsonCommandResult("noValidCodeSet");
                         return;
                     }
+                }
+                else if (strcmp(action, "update") != 0)
+                {
+                    _network->publishKeypadJsonCommandResult("noCodeSet");
+                    return;
+                }
 
-                    unsigned int allowedFromAr[6];
-                    unsigned int allowedUntilAr[6];
-                    unsigned int allowedFromTimeAr[2];
-                    unsigned int allowedUntilTimeAr[2];
-                    uint8_t allowedWeekdaysInt = 0;
+                unsigned int allowedFromAr[6];
+                unsigned int allowedUntilAr[6];
+                unsigned int allowedFromTimeAr[2];
+                unsigned int allowedUntilTimeAr[2];
+                uint8_t allowedWeekdaysInt = 0;
 
-                    if(timeLimited == 1)
+                if(timeLimited == 1)
+                {
+                    if(allowedFrom.length() > 0)
                     {
-                        if(allowedFrom.length() > 0)
+                        if(allowedFrom.length() == 19)
                         {
-                            if(allowedFrom.length() == 19)
-                            {
-                                allowedFromAr[0] = (uint16_t)allowedFrom.substring(0, 4).toInt();
-                                allowedFromAr[1] = (uint8_t)allowedFrom.substring(5, 7).toInt();
-                                allowedFromAr[2] = (uint8_t)allowedFrom.substring(8, 10).toInt();
-                                allowedFromAr[3] = (uint8_t)allowedFrom.substring(11, 13).toInt();
-                                allowedFromAr[4] = (uint8_t)allowedFrom.substring(14, 16).toInt();
-                                allowedFromAr[5] = (uint8_t)allowedFrom.substring(17, 19).toInt();
-
-                                if(allowedFromAr[0] < 2000 || allowedFromAr[0] > 3000 || allowedFromAr[1] < 1 || allowedFromAr[1] > 12 || allowedFromAr[2] < 1 || allowedFromAr[2] > 31 || allowedFromAr[3] < 0 || allowedFromAr[3] > 23 || allowedFromAr[4] < 0 || allowedFromAr[4] > 59 || allowedFromAr[5] < 0 || allowedFromAr[5] > 59)
-                                {
-                                    _network->publishKeypadJsonCommandResult("invalidAllowedFrom");
-                                    return;
-                                }
-                            }
-                            else
+                            allowedFromAr[0] = (uint16_t)allowedFrom.substring(0, 4).toInt();
+                            allowedFromAr[1] = (uint8_t)allowedFrom.substring(5, 7).toInt();
+                            allowedFromAr[2] = (uint8_t)allowedFrom.substring(8, 10).toInt();
+                            allowedFromAr[3] = (uint8_t)allowedFrom.substring(11, 13).toInt();
+                            allowedFromAr[4] = (uint8_t)allowedFrom.substring(14, 16).toInt();
+                            allowedFromAr[5] = (uint8_t)allowedFrom.substring(17, 19).toInt();
+
+                            if(allowedFromAr[0] < 2000 || allowedFromAr[0] > 3000 || allowedFromAr[1] < 1 || allowedFromAr[1] > 12 || allowedFromAr[2] < 1 || allowedFromAr[2] > 31 || allowedFromAr[3] < 0 || allowedFromAr[3] > 23 || allowedFromAr[4] < 0 || allowedFromAr[4] > 59 || allowedFromAr[5] < 0 || allowedFromAr[5] > 59)
                             {
                                 _network->publishKeypadJsonCommandResult("invalidAllowedFrom");
                                 return;
                             }
                         }
-
-                        if(allowedUntil.length() > 0)
+                        else
                         {
-                            if(allowedUntil.length() == 19)
-                            {
-                                allowedUntilAr[0] = (uint16_t)allowedUntil.substring(0, 4).toInt();
-                                allowedUntilAr[1] = (uint8_t)allowedUntil.substring(5, 7).toInt();
-                                allowedUntilAr[2] = (uint8_t)allowedUntil.substring(8, 10).toInt();
-                                allowedUntilAr[3] = (uint8_t)allowedUntil.substring(11, 13).toInt();
-                                allowedUntilAr[4] = (uint8_t)allowedUntil.substring(14, 16).toInt();
-                                allowedUntilAr[5] = (uint8_t)allowedUntil.substring(17, 19).toInt();
-
-                                if(allowedUntilAr[0] < 2000 || allowedUntilAr[0] > 3000 || allowedUntilAr[1] < 1 || allowedUntilAr[1] > 12 || allowedUntilAr[2] < 1 || allowedUntilAr[2] > 31 || allowedUntilAr[3] < 0 || allowedUntilAr[3] > 23 || allowedUntilAr[4] < 0 || allowedUntilAr[4] > 59 || allowedUntilAr[5] < 0 || allowedUntilAr[5] > 59)
-                                {
-                                    _network->publishKeypadJsonCommandResult("invalidAllowedUntil");
-                                    return;
-                                }
-                            }
-                            else
+                            _network->publishKeypadJsonCommandResult("invalidAllowedFrom");
+                            return;
+                        }
+                    }
+
+                    if(allowedUntil.length() > 0)
+                    {
+                        if(allowedUntil.length() == 19)
+                        {
+                            allowedUntilAr[0] = (uint16_t)allowedUntil.substring(0, 4).toInt();
+                            allowedUntilAr[1] = (uint8_t)allowedUntil.substring(5, 7).toInt();
+                            allowedUntilAr[2] = (uint8_t)allowedUntil.substring(8, 10).toInt();
+                            allowedUntilAr[3] = (uint8_t)allowedUntil.substring(11, 13).toInt();
+                            allowedUntilAr[4] = (uint8_t)allowedUntil.substring(14, 16).toInt();
+                            allowedUntilAr[5] = (uint8_t)allowedUntil.substring(17, 19).toInt();
+
+                            if(allowedUntilAr[0] < 2000 || allowedUntilAr[0] > 3000 || allowedUntilAr[1] < 1 || allowedUntilAr[1] > 12 || allowedUntilAr[2] < 1 || allowedUntilAr[2] > 31 || allowedUntilAr[3] < 0 || allowedUntilAr[3] > 23 || allowedUntilAr[4] < 0 || allowedUntilAr[4] > 59 || allowedUntilAr[5] < 0 || allowedUntilAr[5] > 59)
                             {
                                 _network->publishKeypadJsonCommandResult("invalidAllowedUntil");
                                 return;
                             }
                         }
+                        else
+                        {
+                            _network->publishKeypadJsonCommandResult("invalidAllowedUntil");
+                            return;
+                        }
+                    }
 
-                        if(allowedFromTime.length() > 0)
+                    if(allowedFromTime.length() > 0)
+                    {
+                        if(allowedFromTime.length() == 5)
                         {
-                            if(allowedFromTime.length() == 5)
-                            {
-                                allowedFromTimeAr[0] = (uint8_t)allowedFromTime.substring(0, 2).toInt();
-                                allowedFromTimeAr[1] = (uint8_t)allowedFromTime.substring(3, 5).toInt();
-
-                                if(allowedFromTimeAr[0] < 0 || allowedFromTimeAr[0] > 23 || allowedFromTimeAr[1] < 0 || allowedFromTimeAr[1] > 59)
-                                {
-                                    _network->publishKeypadJsonCommandResult("invalidAllowedFromTime");
-                                    return;
-                                }
-                            }
-                            else
+                            allowedFromTimeAr[0] = (uint8_t)allowedFromTime.substring(0, 2).toInt();
+                            allowedFromTimeAr[1] = (uint8_t)allowedFromTime.substring(3, 5).toInt();
+
+                            if(allowedFromTimeAr[0] < 0 || allowedFromTimeAr[0] > 23 || allowedFromTimeAr[1] < 0 || allowedFromTimeAr[1] > 59)
                             {
                                 _network->publishKeypadJsonCommandResult("invalidAllowedFromTime");
                                 return;
                             }
                         }
+                        else
+                        {
+                            _network->publishKeypadJsonCommandResult("invalidAllowedFromTime");
+                            return;
+                        }
+                    }
 
-                        if(allowedUntilTime.length() > 0)
+                    if(allowedUntilTime.length() > 0)
+                    {
+                        if(allowedUntilTime.length() == 5)
                         {
-                            if(allowedUntilTime.length() == 5)
-                            {
-                                allowedUntilTimeAr[0] = (uint8_t)allowedUntilTime.substring(0, 2).toInt();
-                                allowedUntilTimeAr[1] = (uint8_t)allowedUntilTime.substring(3, 5).toInt();
-
-                                if(allowedUntilTimeAr[0] < 0 || allowedUntilTimeAr[0] > 23 || allowedUntilTimeAr[1] < 0 || allowedUntilTimeAr[1] > 59)
-                                {
-                                    _network->publishKeypadJsonCommandResult("invalidAllowedUntilTime");
-                                    return;
-                                }
-                            }
-                            else
+                            allowedUntilTimeAr[0] = (uint8_t)allowedUntilTime.substring(0, 2).toInt();
+                            allowedUntilTimeAr[1] = (uint8_t)allowedUntilTime.substring(3, 5).toInt();
+
+                            if(allowedUntilTimeAr[0] < 0 || allowedUntilTimeAr[0] > 23 || allowedUntilTimeAr[1] < 0 || allowedUntilTimeAr[1] > 59)
                             {
                                 _network->publishKeypadJsonCommandResult("invalidAllowedUntilTime");
                                 return;
                             }
                         }
-
-                        if(allowedWeekdays.indexOf("mon") >= 0)
-                        {
-                            allowedWeekdaysInt += 64;
-                        }
-                        if(allowedWeekdays.indexOf("tue") >= 0)
-                        {
-                            allowedWeekdaysInt += 32;
-                        }
-                        if(allowedWeekdays.indexOf("wed") >= 0)
-                        {
-                            allowedWeekdaysInt += 16;
-                        }
-                        if(allowedWeekdays.indexOf("thu") >= 0)
-                        {
-                            allowedWeekdaysInt += 8;
-                        }
-                        if(allowedWeekdays.indexOf("fri") >= 0)
-                        {
-                            allowedWeekdaysInt += 4;
-                        }
-                        if(allowedWeekdays.indexOf("sat") >= 0)
-                        {
-                            allowedWeekdaysInt += 2;
-                        }
-                        if(allowedWeekdays.indexOf("sun") >= 0)
+                        else
                         {
-                            allowedWeekdaysInt += 1;
+                            _network->publishKeypadJsonCommandResult("invalidAllowedUntilTime");
+                            return;
                         }
                     }
 
-                    if(strcmp(action, "add") == 0)
+                    if(allowedWeekdays.indexOf("mon") >= 0)
                     {
-                        NukiLock::NewKeypadEntry entry;
-                        memset(&entry, 0, sizeof(entry));
-                        size_t nameLen = name.length();
-                        memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
-                        entry.code = code;
-                        entry.timeLimited = timeLimited == 1 ? 1 : 0;
+                        allowedWeekdaysInt += 64;
+                    }
+                    if(allowedWeekdays.indexOf("tue") >= 0)
+                    {
+                        allowedWeekdaysInt += 32;
+                    }
+                    if(allowedWeekdays.indexOf("wed") >= 0)
+                    {
+                        allowedWeekdaysInt += 16;
+                    }
+                    if(allowedWeekdays.indexOf("thu") >= 0)
+                    {
+                        allowedWeekdaysInt += 8;
+                    }
+                    if(allowedWeekdays.indexOf("fri") >= 0)
+                    {
+                        allowedWeekdaysInt += 4;
+                    }
+                    if(allowedWeekdays.indexOf("sat") >= 0)
+                    {
+                        allowedWeekdaysInt += 2;
+                    }
+                    if(allowedWeekdays.indexOf("sun") >= 0)
+                    {
+                        allowedWeekdaysInt += 1;
+                    }
+                }
 
-                        if(allowedFrom.length() > 0)
-                        {
-                            entry.allowedFromYear = allowedFromAr[0];
-                            entry.allowedFromMonth = allowedFromAr[1];
-                            entry.allowedFromDay = allowedFromAr[2];
-                            entry.allowedFromHour = allowedFromAr[3];
-                            entry.allowedFromMin = allowedFromAr[4];
-                            entry.allowedFromSec = allowedFromAr[5];
-                        }
+                if(strcmp(action, "add") == 0)
+                {
+                    NukiLock::NewKeypadEntry entry;
+                    memset(&entry, 0, sizeof(entry));
+                    size_t nameLen = name.length();
+                    memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
+                    entry.code = code;
+                    entry.timeLimited = timeLimited == 1 ? 1 : 0;
 
-                        if(allowedUntil.length() > 0)
-                        {
-                            entry.allowedUntilYear = allowedUntilAr[0];
-                            entry.allowedUntilMonth = allowedUntilAr[1];
-                            entry.allowedUntilDay = allowedUntilAr[2];
-                            entry.allowedUntilHour = allowedUntilAr[3];
-                            entry.allowedUntilMin = allowedUntilAr[4];
-                            entry.allowedUntilSec = allowedUntilAr[5];
-                        }
+                    if(allowedFrom.length() > 0)
+                    {
+                        entry.allowedFromYear = allowedFromAr[0];
+                        entry.allowedFromMonth = allowedFromAr[1];
+                        entry.allowedFromDay = allowedFromAr[2];
+                        entry.allowedFromHour = allowedFromAr[3];
+                        entry.allowedFromMin = allowedFromAr[4];
+                        entry.allowedFromSec = allowedFromAr[5];
+                    }
 
-                        entry.allowedWeekdays = allowedWeekdaysInt;
+                    if(allowedUntil.length() > 0)
+                    {
+                        entry.allowedUntilYear = allowedUntilAr[0];
+                        entry.allowedUntilMonth = allowedUntilAr[1];
+                        entry.allowedUntilDay = allowedUntilAr[2];
+                        entry.allowedUntilHour = allowedUntilAr[3];
+                        entry.allowedUntilMin = allowedUntilAr[4];
+                        entry.allowedUntilSec = allowedUntilAr[5];
+                    }
 
-                        if(allowedFromTime.length() > 0)
-                        {
-                            entry.allowedFromTimeHour = allowedFromTimeAr[0];
-                            entry.allowedFromTimeMin = allowedFromTimeAr[1];
-                        }
+                    entry.allowedWeekdays = allowedWeekdaysInt;
 
-                        if(allowedUntilTime.length() > 0)
-                        {
-                            entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
-                            entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
-                        }
+                    if(allowedFromTime.length() > 0)
+                    {
+                        entry.allowedFromTimeHour = allowedFromTimeAr[0];
+                        entry.allowedFromTimeMin = allowedFromTimeAr[1];
+                    }
+
+                    if(allowedUntilTime.length() > 0)
+                    {
+                        entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
+                        entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
+                    }
 
-                        result = _nukiLock.addKeypadEntry(entry);
+                    attempt = [this, entry]()
+                    {
+                        Nuki::CmdResult result = _nukiLock.addKeypadEntry(entry);
                         Log->print(F("Add keypad code: "));
                         Log->println((int)result);
+                        return result;
+                    };
+                }
+                else if (strcmp(action, "update") == 0)
+                {
+                    if(!codeId)
+                    {
+                        _network->publishKeypadJsonCommandResult("noCodeIdSet");
+                        return;
                     }
-                    else if (strcmp(action, "update") == 0)
+
+                    if(!idExists)
                     {
-                        if(!codeId)
-                        {
-                            _network->publishKeypadJsonCommandResult("noCodeIdSet");
-                            return;
-                        }
+                        _network->publishKeypadJsonCommandResult("noExistingCodeIdSet");
+                        return;
+                    }
 
-                        if(!idExists)
-                        {
-                            _network->publishKeypadJsonCommandResult("noExistingCodeIdSet");
-                            return;
-                        }
+                    Nuki::CmdResult resultKp = _nukiLock.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+                    bool foundExisting = false;
 
-                        Nuki::CmdResult resultKp = _nukiLock.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
-                        bool foundExisting = false;
+                    if(resultKp == Nuki::CmdResult::Success)
+                    {
+                        delay(5000);
+                        std::list<NukiLock::KeypadEntry> entries;
+                        _nukiLock.getKeypadEntries(&entries);
 
-                        if(resultKp == Nuki::CmdResult::Success)
+                        for(const auto& entry : entries)
                         {
-                            delay(5000);
-                            std::list<NukiLock::KeypadEntry> entries;
-                            _nukiLock.getKeypadEntries(&entries);
-
-                            for(const auto& entry : entries)
+                            if (codeId != entry.codeId)
                             {
-                                if (codeId != entry.codeId)
-                                {
-                                    continue;
-                                }
-                                else
-                                {
-                                    foundExisting = true;
-                                }
-
-                                if(name.length() < 1)
-                                {
-                                    memset(oldName, 0, sizeof(oldName));
-                                    memcpy(oldName, entry.name, sizeof(entry.name));
-                                }
-                                if(code == 12)
-                                {
-                                    code = entry.code;
-                                }
-                                if(enabled == 2)
-                                {
-                                    enabled = entry.enabled;
-                                }
-                                if(timeLimited == 2)
-                                {
-                                    timeLimited = entry.timeLimited;
-                                }
-                                if(allowedFrom.length() < 1)
-                                {
-                                    allowedFrom = "old";
-                                    allowedFromAr[0] = entry.allowedFromYear;
-                                    allowedFromAr[1] = entry.allowedFromMonth;
-                                    allowedFromAr[2] = entry.allowedFromDay;
-                                    allowedFromAr[3] = entry.allowedFromHour;
-                                    allowedFromAr[4] = entry.allowedFromMin;
-                                    allowedFromAr[5] = entry.allowedFromSec;
-                                }
-                                if(allowedUntil.length() < 1)
-                                {
-                                    allowedUntil = "old";
-                                    allowedUntilAr[0] = entry.allowedUntilYear;
-                                    allowedUntilAr[1] = entry.allowedUntilMonth;
-                                    allowedUntilAr[2] = entry.allowedUntilDay;
-                                    allowedUntilAr[3] = entry.allowedUntilHour;
-                                    allowedUntilAr[4] = entry.allowedUntilMin;
-                                    allowedUntilAr[5] = entry.allowedUntilSec;
-                                }
-                                if(allowedWeekdays.length() < 1)
-                                {
-                                    allowedWeekdaysInt = entry.allowedWeekdays;
-                                }
-                                if(allowedFromTime.length() < 1)
-                                {
-                                    allowedFromTime = "old";
-                                    allowedFromTimeAr[0] = entry.allowedFromTimeHour;
-                                    allowedFromTimeAr[1] = entry.allowedFromTimeMin;
-                                }
-
-                                if(allowedUntilTime.length() < 1)
-                                {
-                                    allowedUntilTime = "old";
-                                    allowedUntilTimeAr[0] = entry.allowedUntilTimeHour;
-                                    allowedUntilTimeAr[1] = entry.allowedUntilTimeMin;
-                                }
+                                continue;
+                            }
+                            else
+                            {
+                                foundExisting = true;
+                            }
 
+                            if(name.length() < 1)
+                            {
+                                memset(oldName, 0, sizeof(oldName));
+                                memcpy(oldName, entry.name, sizeof(entry.name));
+                            }
+                            if(code == 12)
+                            {
+                                code = entry.code;
+                            }
+                            if(enabled == 2)
+                            {
+                                enabled = entry.enabled;
+                            }
+                            if(timeLimited == 2)
+                            {
+                                timeLimited = entry.timeLimited;
+                            }
+                            if(allowedFrom.length() < 1)
+                            {
+                                allowedFrom = "old";
+                                allowedFromAr[0] = entry.allowedFromYear;
+                                allowedFromAr[1] = entry.allowedFromMonth;
+                                allowedFromAr[2] = entry.allowedFromDay;
+                                allowedFromAr[3] = entry.allowedFromHour;
+                                allowedFromAr[4] = entry.allowedFromMin;
+                                allowedFromAr[5] = entry.allowedFromSec;
+                            }
+                            if(allowedUntil.length() < 1)
+                            {
+                                allowedUntil = "old";
+                                allowedUntilAr[0] = entry.allowedUntilYear;
+                                allowedUntilAr[1] = entry.allowedUntilMonth;
+                                allowedUntilAr[2] = entry.allowedUntilDay;
+                                allowedUntilAr[3] = entry.allowedUntilHour;
+                                allowedUntilAr[4] = entry.allowedUntilMin;
+                                allowedUntilAr[5] = entry.allowedUntilSec;
+                            }
+                            if(allowedWeekdays.length() < 1)
+                            {
+                                allowedWeekdaysInt = entry.allowedWeekdays;
+                            }
+                            if(allowedFromTime.length() < 1)
+                            {
+                                allowedFromTime = "old";
+                                allowedFromTimeAr[0] = entry.allowedFromTimeHour;
+                                allowedFromTimeAr[1] = entry.allowedFromTimeMin;
                             }
 
-                            if(!foundExisting)
+                            if(allowedUntilTime.length() < 1)
                             {
-                                _network->publishKeypadJsonCommandResult("failedToRetrieveExistingKeypadEntry");
-                                return;
+                                allowedUntilTime = "old";
+                                allowedUntilTimeAr[0] = entry.allowedUntilTimeHour;
+                                allowedUntilTimeAr[1] = entry.allowedUntilTimeMin;
                             }
+
                         }
-                        else
+
+                        if(!foundExisting)
                         {
                             _network->publishKeypadJsonCommandResult("failedToRetrieveExistingKeypadEntry");
                             return;
                         }
+                    }
+                    else
+                    {
+                        _network->publishKeypadJsonCommandResult("failedToRetrieveExistingKeypadEntry");
+                        return;
+                    }
 
-                        NukiLock::UpdatedKeypadEntry entry;
+                    NukiLock::UpdatedKeypadEntry entry;
 
-                        memset(&entry, 0, sizeof(entry));
-                        entry.codeId = codeId;
-                        entry.code = code;
+                    memset(&entry, 0, sizeof(entry));
+                    entry.codeId = codeId;
+                    entry.code = code;
 
-                        if(name.length() < 1)
-                        {
-                            size_t nameLen = strlen(oldName);
-                            memcpy(&entry.name, oldName, nameLen > 20 ? 20 : nameLen);
-                        }
-                        else
-                        {
-                            size_t nameLen = name.length();
-                            memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
-                        }
-                        entry.enabled = enabled;
-                        entry.timeLimited = timeLimited;
+                    if(name.length() < 1)
+                    {
+                        size_t nameLen = strlen(oldName);
+                        memcpy(&entry.name, oldName, nameLen > 20 ? 20 : nameLen);
+                    }
+                    else
+                    {
+                        size_t nameLen = name.length();
+                        memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
+                    }
+                    entry.enabled = enabled;
+                    entry.timeLimited = timeLimited;
 
-                        if(enabled == 1)
+                    if(enabled == 1)
+                    {
+                        if(timeLimited == 1)
                         {
-                            if(timeLimited == 1)
+                            if(allowedFrom.length() > 0)
                             {
-                                if(allowedFrom.length() > 0)
-                                {
-                                    entry.allowedFromYear = allowedFromAr[0];
-                                    entry.allowedFromMonth = allowedFromAr[1];
-                                    entry.allowedFromDay = allowedFromAr[2];
-                                    entry.allowedFromHour = allowedFromAr[3];
-                                    entry.allowedFromMin = allowedFromAr[4];
-                                    entry.allowedFromSec = allowedFromAr[5];
-                                }
-
-                                if(allowedUntil.length() > 0)
-                                {
-                                    entry.allowedUntilYear = allowedUntilAr[0];
-                                    entry.allowedUntilMonth = allowedUntilAr[1];
-                                    entry.allowedUntilDay = allowedUntilAr[2];
-                                    entry.allowedUntilHour = allowedUntilAr[3];
-                                    entry.allowedUntilMin = allowedUntilAr[4];
-                                    entry.allowedUntilSec = allowedUntilAr[5];
-                                }
-
-                                entry.allowedWeekdays = allowedWeekdaysInt;
-
-                                if(allowedFromTime.length() > 0)
-                                {
-                                    entry.allowedFromTimeHour = allowedFromTimeAr[0];
-                                    entry.allowedFromTimeMin = allowedFromTimeAr[1];
-                                }
-
-                                if(allowedUntilTime.length() > 0)
-                                {
-                                    entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
-                                    entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
-                                }
+                                entry.allowedFromYear = allowedFromAr[0];
+                                entry.allowedFromMonth = allowedFromAr[1];
+                                entry.allowedFromDay = allowedFromAr[2];
+                                entry.allowedFromHour = allowedFromAr[3];
+                                entry.allowedFromMin = allowedFromAr[4];
+                                entry.allowedFromSec = allowedFromAr[5];
+                            }
+
+                            if(allowedUntil.length() > 0)
+                            {
+                                entry.allowedUntilYear = allowedUntilAr[0];
+                                entry.allowedUntilMonth = allowedUntilAr[1];
+                                entry.allowedUntilDay = allowedUntilAr[2];
+                                entry.allowedUntilHour = allowedUntilAr[3];
+                                entry.allowedUntilMin = allowedUntilAr[4];
+                                entry.allowedUntilSec = allowedUntilAr[5];
+                            }
+
+                            entry.allowedWeekdays = allowedWeekdaysInt;
+
+                            if(allowedFromTime.length() > 0)
+                            {
+                                entry.allowedFromTimeHour = allowedFromTimeAr[0];
+                                entry.allowedFromTimeMin = allowedFromTimeAr[1];
+                            }
+
+                            if(allowedUntilTime.length() > 0)
+                            {
+                                entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
+                                entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
                             }
                         }
+                    }
 
-                        result = _nukiLock.updateKeypadEntry(entry);
+                    attempt = [this, entry]()
+                    {
+                        Nuki::CmdResult result = _nukiLock.updateKeypadEntry(entry);
                         Log->print(F("Update keypad code: "));
                         Log->println((int)result);
-                    }
-                }
-                else
-                {
-                    _network->publishKeypadJsonCommandResult("invalidAction");
-                    return;
-                }
-
-                if(result != Nuki::CmdResult::Success)
-                {
-                    ++retryCount;
-                }
-                else
-                {
-                    break;
+                        return result;
+                    };
                 }
             }
+            else
+            {
+                _network->publishKeypadJsonCommandResult("invalidAction");
+                return;
+            }
 
-            updateKeypad(false);
-
-            if((int)result != -1)
+            _bleJobs.add("keypadCommand", _nrOfRetries + 1, attempt, [this](Nuki::CmdResult result)
             {
+                updateKeypad(false);
+
                 char resultStr[15];
                 memset(&resultStr, 0, sizeof(resultStr));
                 NukiLock::cmdResultToString(result, resultStr);
                 _network->publishKeypadJsonCommandResult(resultStr);
-            }
+            });
         }
     }
     else
@@ -3261,203 +3282,202 @@ void NukiWrapper::onTimeControlCommandReceived(const char *value)
             idExists = std::find(_timeControlIds.begin(), _timeControlIds.end(), entryId) != _timeControlIds.end();
         }
 
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        RetryScheduler<Nuki::CmdResult>::Attempt attempt;
 
-        while(retryCount < _nrOfRetries + 1)
+        if(strcmp(action, "delete") == 0)
         {
-            if(strcmp(action, "delete") == 0)
+            if(idExists)
             {
-                if(idExists)
+                attempt = [this, entryId]()
                 {
-                    result = _nukiLock.removeTimeControlEntry(entryId);
+                    Nuki::CmdResult result = _nukiLock.removeTimeControlEntry(entryId);
                     Log->print(F("Delete timecontrol: "));
                     Log->println((int)result);
-                }
-                else
-                {
-                    _network->publishTimeControlCommandResult("noExistingEntryIdSet");
-                    return;
-                }
+                    return result;
+                };
             }
-            else if(strcmp(action, "add") == 0 || strcmp(action, "update") == 0)
+            else
             {
-                uint8_t timeHour;
-                uint8_t timeMin;
-                uint8_t weekdaysInt = 0;
-                unsigned int timeAr[2];
+                _network->publishTimeControlCommandResult("noExistingEntryIdSet");
+                return;
+            }
+        }
+        else if(strcmp(action, "add") == 0 || strcmp(action, "update") == 0)
+        {
+            uint8_t timeHour;
+            uint8_t timeMin;
+            uint8_t weekdaysInt = 0;
+            unsigned int timeAr[2];
 
-                if(time.length() > 0)
+            if(time.length() > 0)
+            {
+                if(time.length() == 5)
                 {
-                    if(time.length() == 5)
-                    {
-                        timeAr[0] = (uint8_t)time.substring(0, 2).toInt();
-                        timeAr[1] = (uint8_t)time.substring(3, 5).toInt();
+                    timeAr[0] = (uint8_t)time.substring(0, 2).toInt();
+                    timeAr[1] = (uint8_t)time.substring(3, 5).toInt();
 
-                        if(timeAr[0] < 0 || timeAr[0] > 23 || timeAr[1] < 0 || timeAr[1] > 59)
-                        {
-                            _network->publishTimeControlCommandResult("invalidTime");
-                            return;
-                        }
-                    }
-                    else
+                    if(timeAr[0] < 0 || timeAr[0] > 23 || timeAr[1] < 0 || timeAr[1] > 59)
                     {
                         _network->publishTimeControlCommandResult("invalidTime");
                         return;
                     }
                 }
-
-                if(weekdays.indexOf("mon") >= 0)
-                {
-                    weekdaysInt += 64;
-                }
-                if(weekdays.indexOf("tue") >= 0)
-                {
-                    weekdaysInt += 32;
-                }
-                if(weekdays.indexOf("wed") >= 0)
-                {
-                    weekdaysInt += 16;
-                }
-                if(weekdays.indexOf("thu") >= 0)
-                {
-                    weekdaysInt += 8;
-                }
-                if(weekdays.indexOf("fri") >= 0)
-                {
-                    weekdaysInt += 4;
-                }
-                if(weekdays.indexOf("sat") >= 0)
-                {
-                    weekdaysInt += 2;
-                }
-                if(weekdays.indexOf("sun") >= 0)
+                else
                 {
-                    weekdaysInt += 1;
+                    _network->publishTimeControlCommandResult("invalidTime");
+                    return;
                 }
+            }
 
-                if(strcmp(action, "add") == 0)
-                {
-                    NukiLock::NewTimeControlEntry entry;
-                    memset(&entry, 0, sizeof(entry));
-                    entry.weekdays = weekdaysInt;
+            if(weekdays.indexOf("mon") >= 0)
+            {
+                weekdaysInt += 64;
+            }
+            if(weekdays.indexOf("tue") >= 0)
+            {
+                weekdaysInt += 32;
+            }
+            if(weekdays.indexOf("wed") >= 0)
+            {
+                weekdaysInt += 16;
+            }
+            if(weekdays.indexOf("thu") >= 0)
+            {
+                weekdaysInt += 8;
+            }
+            if(weekdays.indexOf("fri") >= 0)
+            {
+                weekdaysInt += 4;
+            }
+            if(weekdays.indexOf("sat") >= 0)
+            {
+                weekdaysInt += 2;
+            }
+            if(weekdays.indexOf("sun") >= 0)
+            {
+                weekdaysInt += 1;
+            }
 
-                    if(time.length() > 0)
-                    {
-                        entry.timeHour = timeAr[0];
-                        entry.timeMin = timeAr[1];
-                    }
+            if(strcmp(action, "add") == 0)
+            {
+                NukiLock::NewTimeControlEntry entry;
+                memset(&entry, 0, sizeof(entry));
+                entry.weekdays = weekdaysInt;
 
-                    entry.lockAction = timeControlLockAction;
+                if(time.length() > 0)
+                {
+                    entry.timeHour = timeAr[0];
+                    entry.timeMin = timeAr[1];
+                }
 
-                    result = _nukiLock.addTimeControlEntry(entry);
+                entry.lockAction = timeControlLockAction;
+
+                attempt = [this, entry]()
+                {
+                    Nuki::CmdResult result = _nukiLock.addTimeControlEntry(entry);
                     Log->print(F("Add timecontrol: "));
                     Log->println((int)result);
-                }
-                else if (strcmp(action, "update") == 0)
+                    return result;
+                };
+            }
+            else if (strcmp(action, "update") == 0)
+            {
+                if(!idExists)
                 {
-                    if(!idExists)
-                    {
-                        _network->publishTimeControlCommandResult("noExistingEntryIdSet");
-                        return;
-                    }
-
-                    Nuki::CmdResult resultTc = _nukiLock.retrieveTimeControlEntries();
-                    bool foundExisting = false;
-
-                    if(resultTc == Nuki::CmdResult::Success)
-                    {
-                        delay(5000);
-                        std::list<NukiLock::TimeControlEntry> timeControlEntries;
-                        _nukiLock.getTimeControlEntries(&timeControlEntries);
-
-                        for(const auto& entry : timeControlEntries)
-                        {
-                            if (entryId != entry.entryId)
-                            {
-                                continue;
-                            }
-                            else
-                            {
-                                foundExisting = true;
-                            }
+                    _network->publishTimeControlCommandResult("noExistingEntryIdSet");
+                    return;
+                }
 
-                            if(enabled == 2)
-                            {
-                                enabled = entry.enabled;
-                            }
-                            if(weekdays.length() < 1)
-                            {
-                                weekdaysInt = entry.weekdays;
-                            }
-                            if(time.length() < 1)
-                            {
-                                time = "old";
-                                timeAr[0] = entry.timeHour;
-                                timeAr[1] = entry.timeMin;
-                            }
-                            if(lockAction.length() < 1)
-                            {
-                                timeControlLockAction = entry.lockAction;
-                            }
+                Nuki::CmdResult resultTc = _nukiLock.retrieveTimeControlEntries();
+                bool foundExisting = false;
+
+                if(resultTc == Nuki::CmdResult::Success)
+                {
+                    delay(5000);
+                    std::list<NukiLock::TimeControlEntry> timeControlEntries;
+                    _nukiLock.getTimeControlEntries(&timeControlEntries);
+
+                    for(const auto& entry : timeControlEntries)
+                    {
+                        if (entryId != entry.entryId)
+                        {
+                            continue;
+                        }
+                        else
+                        {
+                            foundExisting = true;
                         }
 
-                        if(!foundExisting)
+                        if(enabled == 2)
                         {
-                            _network->publishTimeControlCommandResult("failedToRetrieveExistingTimeControlEntry");
-                            return;
+                            enabled = entry.enabled;
+                        }
+                        if(weekdays.length() < 1)
+                        {
+                            weekdaysInt = entry.weekdays;
+                        }
+                        if(time.length() < 1)
+                        {
+                            time = "old";
+                            timeAr[0] = entry.timeHour;
+                            timeAr[1] = entry.timeMin;
+                        }
+                        if(lockAction.length() < 1)
+                        {
+                            timeControlLockAction = entry.lockAction;
                         }
                     }
-                    else
+
+                    if(!foundExisting)
                     {
                         _network->publishTimeControlCommandResult("failedToRetrieveExistingTimeControlEntry");
                         return;
                     }
+                }
+                else
+                {
+                    _network->publishTimeControlCommandResult("failedToRetrieveExistingTimeControlEntry");
+                    return;
+                }
 
-                    NukiLock::TimeControlEntry entry;
-                    memset(&entry, 0, sizeof(entry));
-                    entry.entryId = entryId;
-                    entry.enabled = enabled;
-                    entry.weekdays = weekdaysInt;
+                NukiLock::TimeControlEntry entry;
+                memset(&entry, 0, sizeof(entry));
+                entry.entryId = entryId;
+                entry.enabled = enabled;
+                entry.weekdays = weekdaysInt;
 
-                    if(time.length() > 0)
-                    {
-                        entry.timeHour = timeAr[0];
-                        entry.timeMin = timeAr[1];
-                    }
+                if(time.length() > 0)
+                {
+                    entry.timeHour = timeAr[0];
+                    entry.timeMin = timeAr[1];
+                }
 
-                    entry.lockAction = timeControlLockAction;
+                entry.lockAction = timeControlLockAction;
 
-                    result = _nukiLock.updateTimeControlEntry(entry);
+                attempt = [this, entry]()
+                {
+                    Nuki::CmdResult result = _nukiLock.updateTimeControlEntry(entry);
                     Log->print(F("Update timecontrol: "));
                     Log->println((int)result);
-                }
-            }
-            else
-            {
-                _network->publishTimeControlCommandResult("invalidAction");
-                return;
-            }
-
-            if(result != Nuki::CmdResult::Success)
-            {
-                ++retryCount;
-            }
-            else
-            {
-                break;
+                    return result;
+                };
             }
         }
+        else
+        {
+            _network->publishTimeControlCommandResult("invalidAction");
+            return;
+        }
 
-        if((int)result != -1)
+        _bleJobs.add("timeControlCommand", _nrOfRetries + 1, attempt, [this](Nuki::CmdResult result)
         {
             char resultStr[15];
             memset(&resultStr, 0, sizeof(resultStr));
             NukiLock::cmdResultToString(result, resultStr);
             _network->publishTimeControlCommandResult(resultStr);
-        }
 
-        _nextConfigUpdateTs = espMillis() + 300;
+            _nextConfigUpdateTs = espMillis() + 300;
+        });
     }
     else
     {
@@ -3573,432 +3593,428 @@ void NukiWrapper::onAuthCommandReceived(const char *value)
             idExists = std::find(_authIds.begin(), _authIds.end(), authId) != _authIds.end();
         }
 
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        RetryScheduler<Nuki::CmdResult>::Attempt attempt;
 
-        while(retryCount < _nrOfRetries)
+        if(strcmp(action, "delete") == 0)
         {
-            if(strcmp(action, "delete") == 0)
+            if(idExists)
             {
-                if(idExists)
+                attempt = [this, authId]()
                 {
-                    result = _nukiLock.deleteAuthorizationEntry(authId);
-                    delay(250);
+                    Nuki::CmdResult result = _nukiLock.deleteAuthorizationEntry(authId);
                     Log->print(F("Delete authorization: "));
                     Log->println((int)result);
-                }
-                else
-                {
-                    _network->publishAuthCommandResult("noExistingAuthIdSet");
-                    return;
-                }
+                    return result;
+                };
             }
-            else if(strcmp(action, "add") == 0 || strcmp(action, "update") == 0)
+            else
             {
-                if(name.length() < 1)
+                _network->publishAuthCommandResult("noExistingAuthIdSet");
+                return;
+            }
+        }
+        else if(strcmp(action, "add") == 0 || strcmp(action, "update") == 0)
+        {
+            if(name.length() < 1)
+            {
+                if (strcmp(action, "update") != 0)
                 {
-                    if (strcmp(action, "update") != 0)
-                    {
-                        _network->publishAuthCommandResult("noNameSet");
-                        return;
-                    }
+                    _network->publishAuthCommandResult("noNameSet");
+                    return;
                 }
+            }
 
-                /*
-                if(sharedKey.length() != 64)
-                {
-                    if (strcmp(action, "update") != 0)
-                    {
-                        _network->publishAuthCommandResult("noSharedKeySet");
-                        return;
-                    }
-                }
-                else
+            /*
+            if(sharedKey.length() != 64)
+            {
+                if (strcmp(action, "update") != 0)
                 {
-                    for(int i=0; i<sharedKey.length();i+=2) secretKeyK[(i/2)] = std::stoi(sharedKey.substring(i, i+2).c_str(), nullptr, 16);
+                    _network->publishAuthCommandResult("noSharedKeySet");
+                    return;
                 }
-                */
+            }
+            else
+            {
+                for(int i=0; i<sharedKey.length();i+=2) secretKeyK[(i/2)] = std::stoi(sharedKey.substring(i, i+2).c_str(), nullptr, 16);
+            }
+            */
 
-                unsigned int allowedFromAr[6];
-                unsigned int allowedUntilAr[6];
-                unsigned int allowedFromTimeAr[2];
-                unsigned int allowedUntilTimeAr[2];
-                uint8_t allowedWeekdaysInt = 0;
+            unsigned int allowedFromAr[6];
+            unsigned int allowedUntilAr[6];
+            unsigned int allowedFromTimeAr[2];
+            unsigned int allowedUntilTimeAr[2];
+            uint8_t allowedWeekdaysInt = 0;
 
-                if(timeLimited == 1)
+            if(timeLimited == 1)
+            {
+                if(allowedFrom.length() > 0)
                 {
-                    if(allowedFrom.length() > 0)
+                    if(allowedFrom.length() == 19)
                     {
-                        if(allowedFrom.length() == 19)
-                        {
-                            allowedFromAr[0] = (uint16_t)allowedFrom.substring(0, 4).toInt();
-                            allowedFromAr[1] = (uint8_t)allowedFrom.substring(5, 7).toInt();
-                            allowedFromAr[2] = (uint8_t)allowedFrom.substring(8, 10).toInt();
-                            allowedFromAr[3] = (uint8_t)allowedFrom.substring(11, 13).toInt();
-                            allowedFromAr[4] = (uint8_t)allowedFrom.substring(14, 16).toInt();
-                            allowedFromAr[5] = (uint8_t)allowedFrom.substring(17, 19).toInt();
-
-                            if(allowedFromAr[0] < 2000 || allowedFromAr[0] > 3000 || allowedFromAr[1] < 1 || allowedFromAr[1] > 12 || allowedFromAr[2] < 1 || allowedFromAr[2] > 31 || allowedFromAr[3] < 0 || allowedFromAr[3] > 23 || allowedFromAr[4] < 0 || allowedFromAr[4] > 59 || allowedFromAr[5] < 0 || allowedFromAr[5] > 59)
-                            {
-                                _network->publishAuthCommandResult("invalidAllowedFrom");
-                                return;
-                            }
-                        }
-                        else
+                        allowedFromAr[0] = (uint16_t)allowedFrom.substring(0, 4).toInt();
+                        allowedFromAr[1] = (uint8_t)allowedFrom.substring(5, 7).toInt();
+                        allowedFromAr[2] = (uint8_t)allowedFrom.substring(8, 10).toInt();
+                        allowedFromAr[3] = (uint8_t)allowedFrom.substring(11, 13).toInt();
+                        allowedFromAr[4] = (uint8_t)allowedFrom.substring(14, 16).toInt();
+                        allowedFromAr[5] = (uint8_t)allowedFrom.substring(17, 19).toInt();
+
+                        if(allowedFromAr[0] < 2000 || allowedFromAr[0] > 3000 || allowedFromAr[1] < 1 || allowedFromAr[1] > 12 || allowedFromAr[2] < 1 || allowedFromAr[2] > 31 || allowedFromAr[3] < 0 || allowedFromAr[3] > 23 || allowedFromAr[4] < 0 || allowedFromAr[4] > 59 || allowedFromAr[5] < 0 || allowedFromAr[5] > 59)
                         {
                             _network->publishAuthCommandResult("invalidAllowedFrom");
                             return;
                         }
                     }
-
-                    if(allowedUntil.length() > 0)
+                    else
                     {
-                        if(allowedUntil.length() == 19)
-                        {
-                            allowedUntilAr[0] = (uint16_t)allowedUntil.substring(0, 4).toInt();
-                            allowedUntilAr[1] = (uint8_t)allowedUntil.substring(5, 7).toInt();
-                            allowedUntilAr[2] = (uint8_t)allowedUntil.substring(8, 10).toInt();
-                            allowedUntilAr[3] = (uint8_t)allowedUntil.substring(11, 13).toInt();
-                            allowedUntilAr[4] = (uint8_t)allowedUntil.substring(14, 16).toInt();
-                            allowedUntilAr[5] = (uint8_t)allowedUntil.substring(17, 19).toInt();
+                        _network->publishAuthCommandResult("invalidAllowedFrom");
+                        return;
+                    }
+                }
 
-                            if(allowedUntilAr[0] < 2000 || allowedUntilAr[0] > 3000 || allowedUntilAr[1] < 1 || allowedUntilAr[1] > 12 || allowedUntilAr[2] < 1 || allowedUntilAr[2] > 31 || allowedUntilAr[3] < 0 || allowedUntilAr[3] > 23 || allowedUntilAr[4] < 0 || allowedUntilAr[4] > 59 || allowedUntilAr[5] < 0 || allowedUntilAr[5] > 59)
-                            {
-                                _network->publishAuthCommandResult("invalidAllowedUntil");
-                                return;
-                            }
-                        }
-                        else
+                if(allowedUntil.length() > 0)
+                {
+                    if(allowedUntil.length() == 19)
+                    {
+                        allowedUntilAr[0] = (uint16_t)allowedUntil.substring(0, 4).toInt();
+                        allowedUntilAr[1] = (uint8_t)allowedUntil.substring(5, 7).toInt();
+                        allowedUntilAr[2] = (uint8_t)allowedUntil.substring(8, 10).toInt();
+                        allowedUntilAr[3] = (uint8_t)allowedUntil.substring(11, 13).toInt();
+                        allowedUntilAr[4] = (uint8_t)allowedUntil.substring(14, 16).toInt();
+                        allowedUntilAr[5] = (uint8_t)allowedUntil.substring(17, 19).toInt();
+
+                        if(allowedUntilAr[0] < 2000 || allowedUntilAr[0] > 3000 || allowedUntilAr[1] < 1 || allowedUntilAr[1] > 12 || allowedUntilAr[2] < 1 || allowedUntilAr[2] > 31 || allowedUntilAr[3] < 0 || allowedUntilAr[3] > 23 || allowedUntilAr[4] < 0 || allowedUntilAr[4] > 59 || allowedUntilAr[5] < 0 || allowedUntilAr[5] > 59)
                         {
                             _network->publishAuthCommandResult("invalidAllowedUntil");
                             return;
                         }
                     }
+                    else
+                    {
+                        _network->publishAuthCommandResult("invalidAllowedUntil");
+                        return;
+                    }
+                }
 
-                    if(allowedFromTime.length() > 0)
+                if(allowedFromTime.length() > 0)
+                {
+                    if(allowedFromTime.length() == 5)
                     {
-                        if(allowedFromTime.length() == 5)
-                        {
-                            allowedFromTimeAr[0] = (uint8_t)allowedFromTime.substring(0, 2).toInt();
-                            allowedFromTimeAr[1] = (uint8_t)allowedFromTime.substring(3, 5).toInt();
+                        allowedFromTimeAr[0] = (uint8_t)allowedFromTime.substring(0, 2).toInt();
+                        allowedFromTimeAr[1] = (uint8_t)allowedFromTime.substring(3, 5).toInt();
 
-                            if(allowedFromTimeAr[0] < 0 || allowedFromTimeAr[0] > 23 || allowedFromTimeAr[1] < 0 || allowedFromTimeAr[1] > 59)
-                            {
-                                _network->publishAuthCommandResult("invalidAllowedFromTime");
-                                return;
-                            }
-                        }
-                        else
+                        if(allowedFromTimeAr[0] < 0 || allowedFromTimeAr[0] > 23 || allowedFromTimeAr[1] < 0 || allowedFromTimeAr[1] > 59)
                         {
                             _network->publishAuthCommandResult("invalidAllowedFromTime");
                             return;
                         }
                     }
+                    else
+                    {
+                        _network->publishAuthCommandResult("invalidAllowedFromTime");
+                        return;
+                    }
+                }
 
-                    if(allowedUntilTime.length() > 0)
+                if(allowedUntilTime.length() > 0)
+                {
+                    if(allowedUntilTime.length() == 5)
                     {
-                        if(allowedUntilTime.length() == 5)
-                        {
-                            allowedUntilTimeAr[0] = (uint8_t)allowedUntilTime.substring(0, 2).toInt();
-                            allowedUntilTimeAr[1] = (uint8_t)allowedUntilTime.substring(3, 5).toInt();
+                        allowedUntilTimeAr[0] = (uint8_t)allowedUntilTime.substring(0, 2).toInt();
+                        allowedUntilTimeAr[1] = (uint8_t)allowedUntilTime.substring(3, 5).toInt();
 
-                            if(allowedUntilTimeAr[0] < 0 || allowedUntilTimeAr[0] > 23 || allowedUntilTimeAr[1] < 0 || allowedUntilTimeAr[1] > 59)
-                            {
-                                _network->publishAuthCommandResult("invalidAllowedUntilTime");
-                                return;
-                            }
-                        }
-                        else
+                        if(allowedUntilTimeAr[0] < 0 || allowedUntilTimeAr[0] > 23 || allowedUntilTimeAr[1] < 0 || allowedUntilTimeAr[1] > 59)
                         {
                             _network->publishAuthCommandResult("invalidAllowedUntilTime");
                             return;
                         }
                     }
-
-                    if(allowedWeekdays.indexOf("mon") >= 0)
-                    {
-                        allowedWeekdaysInt += 64;
-                    }
-                    if(allowedWeekdays.indexOf("tue") >= 0)
-                    {
-                        allowedWeekdaysInt += 32;
-                    }
-                    if(allowedWeekdays.indexOf("wed") >= 0)
-                    {
-                        allowedWeekdaysInt += 16;
-                    }
-                    if(allowedWeekdays.indexOf("thu") >= 0)
-                    {
-                        allowedWeekdaysInt += 8;
-                    }
-                    if(allowedWeekdays.indexOf("fri") >= 0)
-                    {
-                        allowedWeekdaysInt += 4;
-                    }
-                    if(allowedWeekdays.indexOf("sat") >= 0)
-                    {
-                        allowedWeekdaysInt += 2;
-                    }
-                    if(allowedWeekdays.indexOf("sun") >= 0)
+                    else
                     {
-                        allowedWeekdaysInt += 1;
+                        _network->publishAuthCommandResult("invalidAllowedUntilTime");
+                        return;
                     }
                 }
 
-                if(strcmp(action, "add") == 0)
+                if(allowedWeekdays.indexOf("mon") >= 0)
                 {
-                    _network->publishAuthCommandResult("addActionNotSupported");
-                    return;
-
-                    NukiLock::NewAuthorizationEntry entry;
-                    memset(&entry, 0, sizeof(entry));
-                    size_t nameLen = name.length();
-                    memcpy(&entry.name, name.c_str(), nameLen > 32 ? 32 : nameLen);
-                    /*
-                    memcpy(&entry.sharedKey, secretKeyK, 32);
-
-                    if(idType != 1)
-                    {
-                        _network->publishAuthCommandResult("invalidIdType");
-                        return;
-                    }
+                    allowedWeekdaysInt += 64;
+                }
+                if(allowedWeekdays.indexOf("tue") >= 0)
+                {
+                    allowedWeekdaysInt += 32;
+                }
+                if(allowedWeekdays.indexOf("wed") >= 0)
+                {
+                    allowedWeekdaysInt += 16;
+                }
+                if(allowedWeekdays.indexOf("thu") >= 0)
+                {
+                    allowedWeekdaysInt += 8;
+                }
+                if(allowedWeekdays.indexOf("fri") >= 0)
+                {
+                    allowedWeekdaysInt += 4;
+                }
+                if(allowedWeekdays.indexOf("sat") >= 0)
+                {
+                    allowedWeekdaysInt += 2;
+                }
+                if(allowedWeekdays.indexOf("sun") >= 0)
+                {
+                    allowedWeekdaysInt += 1;
+                }
+            }
 
-                    entry.idType = idType;
-                    */
-                    entry.remoteAllowed = remoteAllowed == 1 ? 1 : 0;
-                    entry.timeLimited = timeLimited == 1 ? 1 : 0;
+            if(strcmp(action, "add") == 0)
+            {
+                _network->publishAuthCommandResult("addActionNotSupported");
+                return;
 
-                    if(allowedFrom.length() > 0)
-                    {
-                        entry.allowedFromYear = allowedFromAr[0];
-                        entry.allowedFromMonth = allowedFromAr[1];
-                        entry.allowedFromDay = allowedFromAr[2];
-                        entry.allowedFromHour = allowedFromAr[3];
-                        entry.allowedFromMinute = allowedFromAr[4];
-                        entry.allowedFromSecond = allowedFromAr[5];
-                    }
+                NukiLock::NewAuthorizationEntry entry;
+                memset(&entry, 0, sizeof(entry));
+                size_t nameLen = name.length();
+                memcpy(&entry.name, name.c_str(), nameLen > 32 ? 32 : nameLen);
+                /*
+                memcpy(&entry.sharedKey, secretKeyK, 32);
 
-                    if(allowedUntil.length() > 0)
-                    {
-                        entry.allowedUntilYear = allowedUntilAr[0];
-                        entry.allowedUntilMonth = allowedUntilAr[1];
-                        entry.allowedUntilDay = allowedUntilAr[2];
-                        entry.allowedUntilHour = allowedUntilAr[3];
-                        entry.allowedUntilMinute = allowedUntilAr[4];
-                        entry.allowedUntilSecond = allowedUntilAr[5];
-                    }
+                if(idType != 1)
+                {
+                    _network->publishAuthCommandResult("invalidIdType");
+                    return;
+                }
 
-                    entry.allowedWeekdays = allowedWeekdaysInt;
+                entry.idType = idType;
+                */
+                entry.remoteAllowed = remoteAllowed == 1 ? 1 : 0;
+                entry.timeLimited = timeLimited == 1 ? 1 : 0;
 
-                    if(allowedFromTime.length() > 0)
-                    {
-                        entry.allowedFromTimeHour = allowedFromTimeAr[0];
-                        entry.allowedFromTimeMin = allowedFromTimeAr[1];
-                    }
+                if(allowedFrom.length() > 0)
+                {
+                    entry.allowedFromYear = allowedFromAr[0];
+                    entry.allowedFromMonth = allowedFromAr[1];
+                    entry.allowedFromDay = allowedFromAr[2];
+                    entry.allowedFromHour = allowedFromAr[3];
+                    entry.allowedFromMinute = allowedFromAr[4];
+                    entry.allowedFromSecond = allowedFromAr[5];
+                }
 
-                    if(allowedUntilTime.length() > 0)
-                    {
-                        entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
-                        entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
-                    }
+                if(allowedUntil.length() > 0)
+                {
+                    entry.allowedUntilYear = allowedUntilAr[0];
+                    entry.allowedUntilMonth = allowedUntilAr[1];
+                    entry.allowedUntilDay = allowedUntilAr[2];
+                    entry.allowedUntilHour = allowedUntilAr[3];
+                    entry.allowedUntilMinute = allowedUntilAr[4];
+                    entry.allowedUntilSecond = allowedUntilAr[5];
+                }
 
-                    result = _nukiLock.addAuthorizationEntry(entry);
-                    delay(250);
+                entry.allowedWeekdays = allowedWeekdaysInt;
+
+                if(allowedFromTime.length() > 0)
+                {
+                    entry.allowedFromTimeHour = allowedFromTimeAr[0];
+                    entry.allowedFromTimeMin = allowedFromTimeAr[1];
+                }
+
+                if(allowedUntilTime.length() > 0)
+                {
+                    entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
+                    entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
+                }
+
+                attempt = [this, entry]()
+                {
+                    Nuki::CmdResult result = _nukiLock.addAuthorizationEntry(entry);
                     Log->print(F("Add authorization: "));
                     Log->println((int)result);
+                    return result;
+                };
+            }
+            else if (strcmp(action, "update") == 0)
+            {
+                if(!authId)
+                {
+                    _network->publishAuthCommandResult("noAuthIdSet");
+                    return;
                 }
-                else if (strcmp(action, "update") == 0)
+
+                if(!idExists)
                 {
-                    if(!authId)
-                    {
-                        _network->publishAuthCommandResult("noAuthIdSet");
-                        return;
-                    }
+                    _network->publishAuthCommandResult("noExistingAuthIdSet");
+                    return;
+                }
 
-                    if(!idExists)
-                    {
-                        _network->publishAuthCommandResult("noExistingAuthIdSet");
-                        return;
-                    }
+                Nuki::CmdResult resultAuth = _nukiLock.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
+                bool foundExisting = false;
 
-                    Nuki::CmdResult resultAuth = _nukiLock.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
-                    bool foundExisting = false;
+                if(resultAuth == Nuki::CmdResult::Success)
+                {
+                    delay(5000);
+                    std::list<NukiLock::AuthorizationEntry> entries;
+                    _nukiLock.getAuthorizationEntries(&entries);
 
-                    if(resultAuth == Nuki::CmdResult::Success)
+                    for(const auto& entry : entries)
                     {
-                        delay(5000);
-                        std::list<NukiLock::AuthorizationEntry> entries;
-                        _nukiLock.getAuthorizationEntries(&entries);
-
-                        for(const auto& entry : entries)
+                        if (authId != entry.authId)
                         {
-                            if (authId != entry.authId)
-                            {
-                                continue;
-                            }
-                            else
-                            {
-                                foundExisting = true;
-                            }
-
-                            if(name.length() < 1)
-                            {
-                                memset(oldName, 0, sizeof(oldName));
-                                memcpy(oldName, entry.name, sizeof(entry.name));
-                            }
-                            if(remoteAllowed == 2)
-                            {
-                                remoteAllowed = entry.remoteAllowed;
-                            }
-                            if(enabled == 2)
-                            {
-                                enabled = entry.enabled;
-                            }
-                            if(timeLimited == 2)
-                            {
-                                timeLimited = entry.timeLimited;
-                            }
-                            if(allowedFrom.length() < 1)
-                            {
-                                allowedFrom = "old";
-                                allowedFromAr[0] = entry.allowedFromYear;
-                                allowedFromAr[1] = entry.allowedFromMonth;
-                                allowedFromAr[2] = entry.allowedFromDay;
-                                allowedFromAr[3] = entry.allowedFromHour;
-                                allowedFromAr[4] = entry.allowedFromMinute;
-                                allowedFromAr[5] = entry.allowedFromSecond;
-                            }
-                            if(allowedUntil.length() < 1)
-                            {
-                                allowedUntil = "old";
-                                allowedUntilAr[0] = entry.allowedUntilYear;
-                                allowedUntilAr[1] = entry.allowedUntilMonth;
-                                allowedUntilAr[2] = entry.allowedUntilDay;
-                                allowedUntilAr[3] = entry.allowedUntilHour;
-                                allowedUntilAr[4] = entry.allowedUntilMinute;
-                                allowedUntilAr[5] = entry.allowedUntilSecond;
-                            }
-                            if(allowedWeekdays.length() < 1)
-                            {
-                                allowedWeekdaysInt = entry.allowedWeekdays;
-                            }
-                            if(allowedFromTime.length() < 1)
-                            {
-                                allowedFromTime = "old";
-                                allowedFromTimeAr[0] = entry.allowedFromTimeHour;
-                                allowedFromTimeAr[1] = entry.allowedFromTimeMin;
-                            }
+                            continue;
+                        }
+                        else
+                        {
+                            foundExisting = true;
+                        }
 
-                            if(allowedUntilTime.length() < 1)
-                            {
-                                allowedUntilTime = "old";
-                                allowedUntilTimeAr[0] = entry.allowedUntilTimeHour;
-                                allowedUntilTimeAr[1] = entry.allowedUntilTimeMin;
-                            }
+                        if(name.length() < 1)
+                        {
+                            memset(oldName, 0, sizeof(oldName));
+                            memcpy(oldName, entry.name, sizeof(entry.name));
+                        }
+                        if(remoteAllowed == 2)
+                        {
+                            remoteAllowed = entry.remoteAllowed;
+                        }
+                        if(enabled == 2)
+                        {
+                            enabled = entry.enabled;
+                        }
+                        if(timeLimited == 2)
+                        {
+                            timeLimited = entry.timeLimited;
+                        }
+                        if(allowedFrom.length() < 1)
+                        {
+                            allowedFrom = "old";
+                            allowedFromAr[0] = entry.allowedFromYear;
+                            allowedFromAr[1] = entry.allowedFromMonth;
+                            allowedFromAr[2] = entry.allowedFromDay;
+                            allowedFromAr[3] = entry.allowedFromHour;
+                            allowedFromAr[4] = entry.allowedFromMinute;
+                            allowedFromAr[5] = entry.allowedFromSecond;
+                        }
+                        if(allowedUntil.length() < 1)
+                        {
+                            allowedUntil = "old";
+                            allowedUntilAr[0] = entry.allowedUntilYear;
+                            allowedUntilAr[1] = entry.allowedUntilMonth;
+                            allowedUntilAr[2] = entry.allowedUntilDay;
+                            allowedUntilAr[3] = entry.allowedUntilHour;
+                            allowedUntilAr[4] = entry.allowedUntilMinute;
+                            allowedUntilAr[5] = entry.allowedUntilSecond;
+                        }
+                        if(allowedWeekdays.length() < 1)
+                        {
+                            allowedWeekdaysInt = entry.allowedWeekdays;
+                        }
+                        if(allowedFromTime.length() < 1)
+                        {
+                            allowedFromTime = "old";
+                            allowedFromTimeAr[0] = entry.allowedFromTimeHour;
+                            allowedFromTimeAr[1] = entry.allowedFromTimeMin;
                         }
 
-                        if(!foundExisting)
+                        if(allowedUntilTime.length() < 1)
                         {
-                            _network->publishAuthCommandResult("failedToRetrieveExistingAuthorizationEntry");
-                            return;
+                            allowedUntilTime = "old";
+                            allowedUntilTimeAr[0] = entry.allowedUntilTimeHour;
+                            allowedUntilTimeAr[1] = entry.allowedUntilTimeMin;
                         }
                     }
-                    else
+
+                    if(!foundExisting)
                     {
                         _network->publishAuthCommandResult("failedToRetrieveExistingAuthorizationEntry");
                         return;
                     }
+                }
+                else
+                {
+                    _network->publishAuthCommandResult("failedToRetrieveExistingAuthorizationEntry");
+                    return;
+                }
 
-                    NukiLock::UpdatedAuthorizationEntry entry;
+                NukiLock::UpdatedAuthorizationEntry entry;
 
-                    memset(&entry, 0, sizeof(entry));
-                    entry.authId = authId;
+                memset(&entry, 0, sizeof(entry));
+                entry.authId = authId;
 
-                    if(name.length() < 1)
-                    {
-                        size_t nameLen = strlen(oldName);
-                        memcpy(&entry.name, oldName, nameLen > 20 ? 20 : nameLen);
-                    }
-                    else
-                    {
-                        size_t nameLen = name.length();
-                        memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
-                    }
-                    entry.remoteAllowed = remoteAllowed;
-                    entry.enabled = enabled;
-                    entry.timeLimited = timeLimited;
+                if(name.length() < 1)
+                {
+                    size_t nameLen = strlen(oldName);
+                    memcpy(&entry.name, oldName, nameLen > 20 ? 20 : nameLen);
+                }
+                else
+                {
+                    size_t nameLen = name.length();
+                    memcpy(&entry.name, name.c_str(), nameLen > 20 ? 20 : nameLen);
+                }
+                entry.remoteAllowed = remoteAllowed;
+                entry.enabled = enabled;
+                entry.timeLimited = timeLimited;
 
-                    if(enabled == 1)
+                if(enabled == 1)
+                {
+                    if(timeLimited == 1)
                     {
-                        if(timeLimited == 1)
+                        if(allowedFrom.length() > 0)
                         {
-                            if(allowedFrom.length() > 0)
-                            {
-                                entry.allowedFromYear = allowedFromAr[0];
-                                entry.allowedFromMonth = allowedFromAr[1];
-                                entry.allowedFromDay = allowedFromAr[2];
-                                entry.allowedFromHour = allowedFromAr[3];
-                                entry.allowedFromMinute = allowedFromAr[4];
-                                entry.allowedFromSecond = allowedFromAr[5];
-                            }
+                            entry.allowedFromYear = allowedFromAr[0];
+                            entry.allowedFromMonth = allowedFromAr[1];
+                            entry.allowedFromDay = allowedFromAr[2];
+                            entry.allowedFromHour = allowedFromAr[3];
+                            entry.allowedFromMinute = allowedFromAr[4];
+                            entry.allowedFromSecond = allowedFromAr[5];
+                        }
 
-                            if(allowedUntil.length() > 0)
-                            {
-                                entry.allowedUntilYear = allowedUntilAr[0];
-                                entry.allowedUntilMonth = allowedUntilAr[1];
-                                entry.allowedUntilDay = allowedUntilAr[2];
-                                entry.allowedUntilHour = allowedUntilAr[3];
-                                entry.allowedUntilMinute = allowedUntilAr[4];
-                                entry.allowedUntilSecond = allowedUntilAr[5];
-                            }
+                        if(allowedUntil.length() > 0)
+                        {
+                            entry.allowedUntilYear = allowedUntilAr[0];
+                            entry.allowedUntilMonth = allowedUntilAr[1];
+                            entry.allowedUntilDay = allowedUntilAr[2];
+                            entry.allowedUntilHour = allowedUntilAr[3];
+                            entry.allowedUntilMinute = allowedUntilAr[4];
+                            entry.allowedUntilSecond = allowedUntilAr[5];
+                        }
 
-                            entry.allowedWeekdays = allowedWeekdaysInt;
+                        entry.allowedWeekdays = allowedWeekdaysInt;
 
-                            if(allowedFromTime.length() > 0)
-                            {
-                                entry.allowedFromTimeHour = allowedFromTimeAr[0];
-                                entry.allowedFromTimeMin = allowedFromTimeAr[1];
-                            }
+                        if(allowedFromTime.length() > 0)
+                        {
+                            entry.allowedFromTimeHour = allowedFromTimeAr[0];
+                            entry.allowedFromTimeMin = allowedFromTimeAr[1];
+                        }
 
-                            if(allowedUntilTime.length() > 0)
-                            {
-                                entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
-                                entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
-                            }
+                        if(allowedUntilTime.length() > 0)
+                        {
+                            entry.allowedUntilTimeHour = allowedUntilTimeAr[0];
+                            entry.allowedUntilTimeMin = allowedUntilTimeAr[1];
                         }
                     }
+                }
 
-                    result = _nukiLock.updateAuthorizationEntry(entry);
-                    delay(250);
+                attempt = [this, entry]()
+                {
+                    Nuki::CmdResult result = _nukiLock.updateAuthorizationEntry(entry);
                     Log->print(F("Update authorization: "));
                     Log->println((int)result);
-                }
-            }
-            else
-            {
-                _network->publishAuthCommandResult("invalidAction");
-                return;
-            }
-
-            if(result != Nuki::CmdResult::Success)
-            {
-                ++retryCount;
-            }
-            else
-            {
-                break;
+                    return result;
+                };
             }
         }
+        else
+        {
+            _network->publishAuthCommandResult("invalidAction");
+            return;
+        }
 
-        updateAuth(false);
-
-        if((int)result != -1)
+        _bleJobs.add("authCommand", _nrOfRetries, attempt, [this](Nuki::CmdResult result)
         {
+            updateAuth(false);
+
             char resultStr[15];
             memset(&resultStr, 0, sizeof(resultStr));
             NukiLock::cmdResultToString(result, resultStr);
             _network->publishAuthCommandResult(resultStr);
-        }
+        });
     }
     else
     {
@@ -4055,58 +4071,24 @@ void NukiWrapper::notify(Nuki::EventType eventType)
 
 void NukiWrapper::readConfig()
 {
-    Nuki::CmdResult result = (Nuki::CmdResult)-1;
-    int retryCount = 0;
-
-    while(retryCount < _nrOfRetries + 1)
-    {
-        result = _nukiLock.requestConfig(&_nukiConfig);
-        _nukiConfigValid = result == Nuki::CmdResult::Success;
-
-        char resultStr[20];
-        NukiLock::cmdResultToString(result, resultStr);
-        Log->print(F("Lock config result: "));
-        Log->println(resultStr);
+    Nuki::CmdResult result = _nukiLock.requestConfig(&_nukiConfig);
+    _nukiConfigValid = result == Nuki::CmdResult::Success;
 
-        if(result != Nuki::CmdResult::Success)
-        {
-            ++retryCount;
-            Log->println("Failed to retrieve lock config, retrying in 1s");
-            delay(1000);
-        }
-        else
-        {
-            break;
-        }
-    }
+    char resultStr[20];
+    NukiLock::cmdResultToString(result, resultStr);
+    Log->print(F("Lock config result: "));
+    Log->println(resultStr);
 }
 
 void NukiWrapper::readAdvancedConfig()
 {
-    Nuki::CmdResult result = (Nuki::CmdResult)-1;
-    int retryCount = 0;
-
-    while(retryCount < _nrOfRetries + 1)
-    {
-        result = _nukiLock.requestAdvancedConfig(&_nukiAdvancedConfig);
-        _nukiAdvancedConfigValid = result == Nuki::CmdResult::Success;
-
-        char resultStr[20];
-        NukiLock::cmdResultToString(result, resultStr);
-        Log->print(F("Lock advanced config result: "));
-        Log->println(resultStr);
+    Nuki::CmdResult result = _nukiLock.requestAdvancedConfig(&_nukiAdvancedConfig);
+    _nukiAdvancedConfigValid = result == Nuki::CmdResult::Success;
 
-        if(result != Nuki::CmdResult::Success)
-        {
-            ++retryCount;
-            Log->println("Failed to retrieve lock advanced config, retrying in 1s");
-            delay(1000);
-        }
-        else
-        {
-            break;
-        }
-    }
+    char resultStr[20];
+    NukiLock::cmdResultToString(result, resultStr);
+    Log->print(F("Lock advanced config result: "));
+    Log->println(resultStr);
 }
 
 bool NukiWrapper::hasDoorSensor() const
@@ -4138,6 +4120,11 @@ std::string NukiWrapper::hardwareVersion() const
     return _hardwareVersion;
 }
 
+const ActionLatency& NukiWrapper::actionLatency() const
+{
+    return _latency;
+}
+
 void NukiWrapper::disableWatchdog()
 {
     _restartBeaconTimeout = -1;
@@ -5,11 +5,16 @@
 #include "NukiDataTypes.h"
 #include "BleScanner.h"
 #include "NukiLock.h"
+#include "NukiDevice.h"
 #include "Gpio.h"
 #include "LockActionResult.h"
 #include "NukiDeviceId.h"
 #include "NukiOfficial.h"
 #include "EspMillis.h"
+#include "CommandQueue.h"
+#include "RetryJob.h"
+#include "RetryScheduler.h"
+#include "ActionLatency.h"
 
 class NukiWrapper : public Nuki::SmartlockEventHandler
 {
@@ -21,11 +26,11 @@ public:
     void readSettings();
     void update();
 
-    void lock();
-    void unlock();
-    void unlatch();
-    void lockngo();
-    void lockngounlatch();
+    void lock(CommandSource source = CommandSource::Local);
+    void unlock(CommandSource source = CommandSource::Local);
+    void unlatch(CommandSource source = CommandSource::Local);
+    void lockngo(CommandSource source = CommandSource::Local);
+    void lockngounlatch(CommandSource source = CommandSource::Local);
 
     bool isPinSet();
     bool isPinValid();
@@ -44,6 +49,7 @@ public:
 
     std::string firmwareVersion() const;
     std::string hardwareVersion() const;
+    const ActionLatency& actionLatency() const;
 
     void notify(Nuki::EventType eventType) override;
 
@@ -65,6 +71,10 @@ private:
     void onAuthCommandReceived(const char* value);
     void onGpioActionReceived(const GpioAction& action, const int& pin);
 
+    bool enqueueLockAction(NukiLock::LockAction action, CommandSource source);
+    static bool isOppositeLockAction(NukiLock::LockAction first, NukiLock::LockAction second);
+    static int latencyAction(NukiLock::LockAction action);
+
     bool updateKeyTurnerState();
     void updateBatteryState();
     void updateConfig();
@@ -90,7 +100,7 @@ private:
 
     std::string _deviceName;
     NukiDeviceId* _deviceId = nullptr;
-    NukiLock::NukiLock _nukiLock;
+    NukiLockDevice _nukiLock;
     BleScanner::Scanner* _bleScanner = nullptr;
     NukiNetworkLock* _network = nullptr;
     NukiOfficial* _nukiOfficial = nullptr;
@@ -139,7 +149,6 @@ private:
     int _nrOfRetries = 0;
     int _retryDelay = 0;
     int _retryConfigCount = 0;
-    int _retryLockstateCount = 0;
     int _rssiPublishInterval = 0;
     int64_t _statusUpdatedTs = 0;
     int64_t _nextRetryTs = 0;
@@ -152,11 +161,17 @@ private:
     int64_t _waitAuthUpdateTs = 0;
     int64_t _nextKeypadUpdateTs = 0;
     int64_t _nextRssiTs = 0;
-    int64_t _lastRssi = 0;
     int64_t _disableBleWatchdogTs = 0;
     uint32_t _basicLockConfigaclPrefs[16];
     uint32_t _advancedLockConfigaclPrefs[23];
     std::string _firmwareVersion = "";
     std::string _hardwareVersion = "";
-    volatile NukiLock::LockAction _nextLockAction = (NukiLock::LockAction)0xff;
+    CommandQueue<NukiLock::LockAction, NUKI_COMMAND_QUEUE_SIZE> _commandQueue;
+    QueuedCommand<NukiLock::LockAction> _lockActionCommand;
+    RetryJob _lockActionJob;
+    RetryJob _lockStateJob;
+    RetryJob _batteryJob;
+    RetryJob _configJob;
+    ActionLatency _latency;
+    RetryScheduler<Nuki::CmdResult> _bleJobs;
 };
@@ -57,6 +57,7 @@
 #define preference_webserver_enabled (char*)"websrvena"
 #define preference_update_from_mqtt (char*)"updMqtt"
 #define preference_disable_non_json (char*)"disnonjson"
+#define preference_publish_snapshot (char*)"pubSnapshot"
 #define preference_official_hybrid_enabled (char*)"offHybrid"
 #define preference_wifi_ssid (char*)"wifiSSID"
 #define preference_wifi_pass (char*)"wifiPass"
@@ -168,6 +169,7 @@ inline void initPreferences(Preferences* preferences)
         preferences->putBool(preference_official_hybrid_actions, false);
         preferences->putBool(preference_official_hybrid_retry, false);
         preferences->putBool(preference_disable_non_json, false);
+        preferences->putBool(preference_publish_snapshot, false);
         preferences->putBool(preference_update_from_mqtt, false);
         preferences->putBool(preference_ip_dhcp_enabled, true);
         preferences->putBool(preference_enable_bootloop_reset, false);
@@ -362,7 +364,8 @@ private:
             preference_network_custom_rst, preference_network_custom_cs, preference_network_custom_sck, preference_network_custom_miso, preference_network_custom_mosi,
             preference_network_custom_pwr, preference_network_custom_mdio, preference_ntw_reconfigure, preference_lock_max_auth_entry_count, preference_opener_max_auth_entry_count,
             preference_auth_control_enabled, preference_auth_topic_per_entry, preference_auth_info_enabled, preference_auth_max_entries, preference_wifi_ssid, preference_wifi_pass,
-            preference_keypad_check_code_enabled, preference_disable_network_not_connected, preference_mqtt_hass_enabled, preference_hass_device_discovery
+            preference_keypad_check_code_enabled, preference_disable_network_not_connected, preference_mqtt_hass_enabled, preference_hass_device_discovery,
+            preference_publish_snapshot
     };
     std::vector<char*> _redact =
     {
@@ -378,7 +381,8 @@ private:
             preference_publish_authdata, preference_publish_debug_info, preference_official_hybrid_enabled, preference_mqtt_hass_enabled,
             preference_official_hybrid_actions, preference_official_hybrid_retry, preference_conf_info_enabled, preference_disable_non_json, preference_update_from_mqtt,
             preference_auth_control_enabled, preference_auth_topic_per_entry, preference_auth_info_enabled, preference_webserial_enabled, preference_hass_device_discovery,
-            preference_ntw_reconfigure, preference_keypad_check_code_enabled, preference_disable_network_not_connected, preference_find_best_rssi
+            preference_ntw_reconfigure, preference_keypad_check_code_enabled, preference_disable_network_not_connected, preference_find_best_rssi,
+            preference_publish_snapshot
     };
     std::vector<char*> _bytePrefs =
     {
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+// Retry state of one BLE operation run from the Nuki task loop. Instead of sleeping between attempts,
+// a failed attempt schedules the next one and returns, so the loop keeps serving other work (and the
+// other device) until the job is due again.
+class RetryJob
+{
+public:
+    // Call after a failed attempt. Schedules the next attempt at retryTs and returns true while
+    // attempts are left, otherwise the job is reset and false is returned.
+    bool failed(int maxAttempts, int64_t retryTs)
+    {
+        if(++_failures < maxAttempts)
+        {
+            _retryTs = retryTs;
+            return true;
+        }
+        reset();
+        return false;
+    }
+
+    // Call after a successful attempt
+    void reset()
+    {
+        _failures = 0;
+        _retryTs = 0;
+    }
+
+    // A retry is scheduled
+    bool pending() const
+    {
+        return _failures > 0;
+    }
+
+    bool due(int64_t ts) const
+    {
+        return pending() && ts >= _retryTs;
+    }
+
+    int failures() const
+    {
+        return _failures;
+    }
+
+    // Number of the next attempt, starting at 1
+    int attempt() const
+    {
+        return _failures + 1;
+    }
+
+    int64_t retryTs() const
+    {
+        return _retryTs;
+    }
+
+private:
+    int _failures = 0;
+    int64_t _retryTs = 0;
+};
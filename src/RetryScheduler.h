@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include "EspMillis.h"
+#include "RetryJob.h"
+
+// Runs the BLE operations of one device (keypad, time control and authorization commands and queries)
+// as resumable jobs from the Nuki task loop. Any task can add jobs, run() is only called by the Nuki task
+// and makes at most one attempt per call, so lock actions and state updates of the device, and the other
+// device, are served between the attempts of a job. A failed attempt schedules the next one with its own
+// RetryJob instead of sleeping, and every attempt postpones the BLE watchdog.
+template<typename Result>
+class RetryScheduler
+{
+public:
+    typedef std::function<Result()> Attempt;
+    // Called once after the last attempt, with its result
+    typedef std::function<void(Result result)> Completion;
+
+    RetryScheduler(Result success, std::function<void()> postponeWatchdog)
+        : _success(success),
+          _postponeWatchdog(postponeWatchdog)
+    { }
+
+    void setRetryDelay(uint32_t retryDelay)
+    {
+        _retryDelay = retryDelay;
+    }
+
+    // maxAttempts includes the first attempt, which runs on the next call of run()
+    void add(const char* name, int maxAttempts, Attempt attempt, Completion completed = nullptr)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back({ name, maxAttempts, attempt, completed, RetryJob() });
+    }
+
+    // A job with this name is queued or waiting for a retry
+    bool pending(const char* name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(const auto& job : _jobs)
+        {
+            if(strcmp(job.name, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _jobs.size();
+    }
+
+    // Makes one attempt of the oldest job that is due, returns false if none was due
+    bool run(int64_t ts)
+    {
+        typename std::list<Job>::iterator job;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(job = _jobs.begin(); job != _jobs.end(); ++job)
+            {
+                if(!job->retry.pending() || job->retry.due(ts))
+                {
+                    break;
+                }
+            }
+            if(job == _jobs.end())
+            {
+                return false;
+            }
+        }
+
+        // jobs are only removed here, so job stays valid while other tasks add jobs
+        Result result = job->attempt();
+        _postponeWatchdog();
+
+        if(result != _success && job->retry.failed(job->maxAttempts, espMillis() + _retryDelay))
+        {
+            return true;
+        }
+
+        Completion completed = job->completed;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.erase(job);
+        }
+        if(completed)
+        {
+            completed(result);
+        }
+        return true;
+    }
+
+private:
+    struct Job
+    {
+        const char* name;
+        int maxAttempts;
+        Attempt attempt;
+        Completion completed;
+        RetryJob retry;
+    };
+
+    const Result _success;
+    std::function<void()> _postponeWatchdog;
+    uint32_t _retryDelay = 0;
+    std::mutex _mutex;
+    std::list<Job> _jobs;
+};
@@ -1916,6 +1916,16 @@ bool WebCfgServer::processArgs(PsychicRequest *request, String& message)
                 configChanged = true;
             }
         }
+        else if(key == "SNAPSHOT")
+        {
+            if(_preferences->getBool(preference_publish_snapshot, false) != (value == "1"))
+            {
+                _preferences->putBool(preference_publish_snapshot, (value == "1"));
+                Log->print(F("Setting changed: "));
+                Log->println(key);
+                configChanged = true;
+            }
+        }
         else if(key == "DHCPENA")
         {
             if(_preferences->getBool(preference_ip_dhcp_enabled, true) != (value == "1"))
@@ -3558,6 +3568,7 @@ esp_err_t WebCfgServer::buildMqttConfigHtml(PsychicRequest *request)
     printCheckBox(&response, "MQTTLOG", "Enable MQTT logging", _preferences->getBool(preference_mqtt_log_enabled), "");
     printCheckBox(&response, "UPDATEMQTT", "Allow updating using MQTT", _preferences->getBool(preference_update_from_mqtt), "");
     printCheckBox(&response, "DISNONJSON", "Disable some extraneous non-JSON topics", _preferences->getBool(preference_disable_non_json), "");
+    printCheckBox(&response, "SNAPSHOT", "Publish state as one snapshot document instead of separate topics", _preferences->getBool(preference_publish_snapshot), "");
     printCheckBox(&response, "OFFHYBRID", "Enable hybrid official MQTT and Nuki Hub setup", _preferences->getBool(preference_official_hybrid_enabled), "");
     printCheckBox(&response, "HYBRIDACT", "Enable sending actions through official MQTT", _preferences->getBool(preference_official_hybrid_actions), "");
     printInputField(&response, "HYBRIDTIMER", "Time between status updates when official MQTT is offline (seconds)", _preferences->getInt(preference_query_interval_hybrid_lockstate), 5, "");
@@ -4229,6 +4240,8 @@ esp_err_t WebCfgServer::buildInfoHtml(PsychicRequest *request)
     response.print(_preferences->getInt(preference_query_interval_battery, 1800));
     response.print("\nMost non-JSON MQTT topics disabled: ");
     response.print(_preferences->getBool(preference_disable_non_json, false) ? "Yes" : "No");
+    response.print("\nState snapshot enabled: ");
+    response.print(_preferences->getBool(preference_publish_snapshot, false) ? "Yes" : "No");
     response.print("\nPublish Nuki device config: ");
     response.print(_preferences->getBool(preference_conf_info_enabled, false) ? "Yes" : "No");
     response.print("\nConfig query interval (s): ");
@@ -4304,6 +4317,8 @@ esp_err_t WebCfgServer::buildInfoHtml(PsychicRequest *request)
         response.print(_preferences->getInt(preference_lock_max_timecontrol_entry_count, 0));
         response.print("\nRegister as: ");
         response.print(_preferences->getBool(preference_register_as_app, false) ? "App" : "Bridge");
+        response.print("\n\n------------ NUKI LOCK ACTION LATENCY (ms) ------------");
+        printActionLatency(&response, _nuki->actionLatency());
         response.print("\n\n------------ HYBRID MODE ------------");
         if(!_preferences->getBool(preference_official_hybrid_enabled, false))
         {
@@ -4499,6 +4514,8 @@ esp_err_t WebCfgServer::buildInfoHtml(PsychicRequest *request)
         response.print(_preferences->getBool(preference_register_opener_as_app, false) ? "App" : "Bridge");
         response.print("\nNuki Opener Lock/Unlock action set to Continuous mode in Home Assistant: ");
         response.print(_preferences->getBool(preference_opener_continuous_mode, false) ? "Yes" : "No");
+        response.print("\n\n------------ NUKI OPENER ACTION LATENCY (ms) ------------");
+        printActionLatency(&response, _nukiOpener->actionLatency());
         uint32_t basicOpenerConfigAclPrefs[14];
         _preferences->getBytes(preference_conf_opener_basic_acl, &basicOpenerConfigAclPrefs, sizeof(basicOpenerConfigAclPrefs));
         uint32_t advancedOpenerConfigAclPrefs[21];
@@ -4923,6 +4940,49 @@ void WebCfgServer::printParameter(PsychicStreamResponse *response, const char *d
 
 }
 
+void WebCfgServer::printActionLatency(PsychicStreamResponse *response, const ActionLatency& latency)
+{
+    if(!latency.enabled())
+    {
+        response->print("\nNot tracked, enable publishing debug information to track it");
+        return;
+    }
+
+    for(uint8_t i = 0; i < latency.actionCount(); i++)
+    {
+        const ActionLatency::Stages& stages = latency.stages(i);
+
+        response->print("\n");
+        response->print(latency.actionName(i));
+        response->print(": ");
+        response->print(stages.total.count());
+        response->print(" actions");
+        if(stages.total.count() == 0)
+        {
+            continue;
+        }
+        response->print(" (p50 / p90 / p99 / max)");
+        printLatencyStage(response, "Queued", stages.queue);
+        printLatencyStage(response, "BLE command", stages.ble);
+        printLatencyStage(response, "State published", stages.state);
+        printLatencyStage(response, "Total", stages.total);
+    }
+}
+
+void WebCfgServer::printLatencyStage(PsychicStreamResponse *response, const char* name, const LatencyHistogram& histogram)
+{
+    response->print("\n  ");
+    response->print(name);
+    response->print(": ");
+    response->print(histogram.percentile(50));
+    response->print(" / ");
+    response->print(histogram.percentile(90));
+    response->print(" / ");
+    response->print(histogram.percentile(99));
+    response->print(" / ");
+    response->print(histogram.max());
+}
+
 const std::vector<std::pair<String, String>> WebCfgServer::getNetworkDetectionOptions() const
 {
     std::vector<std::pair<String, String>> options;
@@ -85,6 +85,8 @@ private:
     String pinStateToString(uint8_t value);
 
     void printParameter(PsychicStreamResponse *response, const char* description, const char* value, const char *link = "", const char *id = "");
+    void printActionLatency(PsychicStreamResponse *response, const ActionLatency& latency);
+    void printLatencyStage(PsychicStreamResponse *response, const char* name, const LatencyHistogram& histogram);
 
     NukiWrapper* _nuki = nullptr;
     NukiOpenerWrapper* _nukiOpener = nullptr;
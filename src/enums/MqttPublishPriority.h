@@ -0,0 +1,8 @@
+#pragma once
+
+enum class MqttPublishPriority
+{
+    Low,
+    Normal,
+    High
+};
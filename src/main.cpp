@@ -171,7 +171,7 @@ void networkTask(void *pvParameters)
             }
         }
 
-        network->update();
+        bool mqttConnected = network->update();
         bool connected = network->isConnected();
 
 #ifdef DEBUG_NUKIHUB
@@ -213,6 +213,12 @@ void networkTask(void *pvParameters)
 
             restartEsp(RestartReason::RestartTimer);
         }
+
+        // Nothing to serve while WiFi or MQTT is down, don't keep the core busy waiting for the reconnect
+        if(!mqttConnected)
+        {
+            vTaskDelay(NETWORK_DISCONNECTED_LOOP_DELAY / portTICK_PERIOD_MS);
+        }
         esp_task_wdt_reset();
     }
 }
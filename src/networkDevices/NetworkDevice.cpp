@@ -18,6 +18,8 @@ void NetworkDevice::init()
     {
         Log->println(F("MQTT over TLS."));
         _mqttClientSecure = new espMqttClientSecure(espMqttClientTypes::UseInternalTask::NO);
+        _mqttClientSecure->setOutboxBudget(MQTT_OUTBOX_BUDGET);
+        _mqttClientSecure->setTxCoalescing(MQTT_TX_COALESCE_SIZE, MQTT_TX_COALESCE_DEADLINE);
         _mqttClientSecure->setCACert(_ca);
         if(crtLength > 1 && keyLength > 1) // length is 1 when empty
         {
@@ -30,6 +32,8 @@ void NetworkDevice::init()
     {
         Log->println(F("MQTT without TLS."));
         _mqttClient = new espMqttClient(espMqttClientTypes::UseInternalTask::NO);
+        _mqttClient->setOutboxBudget(MQTT_OUTBOX_BUDGET);
+        _mqttClient->setTxCoalescing(MQTT_TX_COALESCE_SIZE, MQTT_TX_COALESCE_DEADLINE);
     }
 
     if(_preferences->getBool(preference_mqtt_log_enabled, false) || _preferences->getBool(preference_webserial_enabled, false))
@@ -102,9 +106,9 @@ void NetworkDevice::mqttSetKeepAlive(uint16_t keepAlive)
     }
 }
 
-uint16_t NetworkDevice::mqttPublish(const char *topic, uint8_t qos, bool retain, const char *payload)
+uint16_t NetworkDevice::mqttPublish(const char *topic, uint8_t qos, bool retain, const char *payload, espMqttClientTypes::Priority priority, bool coalesce)
 {
-    return getMqttClient()->publish(topic, qos, retain, payload);
+    return getMqttClient()->publish(topic, qos, retain, payload, priority, coalesce);
 }
 
 uint16_t NetworkDevice::mqttPublish(const char *topic, uint8_t qos, bool retain, const uint8_t *payload, size_t length)
@@ -112,11 +116,31 @@ uint16_t NetworkDevice::mqttPublish(const char *topic, uint8_t qos, bool retain,
     return getMqttClient()->publish(topic, qos, retain, payload, length);
 }
 
+uint16_t NetworkDevice::mqttPublish(const char *topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadWriter writer, size_t length, espMqttClientTypes::Priority priority, bool coalesce)
+{
+    return getMqttClient()->publish(topic, qos, retain, writer, length, priority, coalesce);
+}
+
 bool NetworkDevice::mqttConnected() const
 {
     return getMqttClient()->connected();
 }
 
+bool NetworkDevice::mqttCongested(espMqttClientTypes::Priority priority) const
+{
+    return getMqttClient()->congested(priority);
+}
+
+size_t NetworkDevice::mqttOutboxBytes() const
+{
+    return getMqttClient()->outboxBytes();
+}
+
+size_t NetworkDevice::mqttPoolStats(espMqttClientTypes::PoolStats* stats, size_t count) const
+{
+    return getMqttClient()->poolStats(stats, count);
+}
+
 void NetworkDevice::mqttSetServer(const char *host, uint16_t port)
 {
     if (_useEncryption)
@@ -199,11 +223,28 @@ void NetworkDevice::mqttOnDisconnect(espMqttClientTypes::OnDisconnectCallback ca
     }
 }
 
+void NetworkDevice::mqttOnSubscribe(espMqttClientTypes::OnSubscribeCallback callback)
+{
+    if (_useEncryption)
+    {
+        _mqttClientSecure->onSubscribe(callback);
+    }
+    else
+    {
+        _mqttClient->onSubscribe(callback);
+    }
+}
+
 uint16_t NetworkDevice::mqttSubscribe(const char *topic, uint8_t qos)
 {
     return getMqttClient()->subscribe(topic, qos);
 }
 
+uint16_t NetworkDevice::mqttSubscribe(const espMqttClientTypes::Subscription* subscriptions, size_t count)
+{
+    return getMqttClient()->subscribe(subscriptions, count);
+}
+
 void NetworkDevice::mqttDisable()
 {
     getMqttClient()->disconnect();
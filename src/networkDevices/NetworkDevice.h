@@ -33,10 +33,18 @@ public:
     virtual bool mqttDisconnect(bool force);
     virtual void mqttDisable();
     virtual bool mqttConnected() const;
+    virtual bool mqttCongested(espMqttClientTypes::Priority priority) const;
+    virtual size_t mqttOutboxBytes() const;
+    virtual size_t mqttPoolStats(espMqttClientTypes::PoolStats* stats, size_t count) const;
 
-    virtual uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const char* payload);
+    // coalesce: replace a queued, not yet sent retained publish to the same topic instead of queueing another one
+    virtual uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const char* payload,
+                                 espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL, bool coalesce = false);
     virtual uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length);
+    virtual uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadWriter writer, size_t length,
+                                 espMqttClientTypes::Priority priority = espMqttClientTypes::Priority::NORMAL, bool coalesce = false);
     virtual uint16_t mqttSubscribe(const char* topic, uint8_t qos);
+    virtual uint16_t mqttSubscribe(const espMqttClientTypes::Subscription* subscriptions, size_t count);
     
     virtual void mqttSetServer(const char* host, uint16_t port);
     virtual void mqttSetClientId(const char* clientId);
@@ -48,6 +56,7 @@ public:
     virtual void mqttOnMessage(espMqttClientTypes::OnMessageCallback callback);
     virtual void mqttOnConnect(espMqttClientTypes::OnConnectCallback callback);
     virtual void mqttOnDisconnect(espMqttClientTypes::OnDisconnectCallback callback);
+    virtual void mqttOnSubscribe(espMqttClientTypes::OnSubscribeCallback callback);
     #endif
 
 protected:
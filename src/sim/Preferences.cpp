@@ -0,0 +1,325 @@
+#ifdef NUKI_HUB_SIM
+
+#include <cstring>
+#include <cmath>
+#include "Preferences.h"
+
+// NVS limits key names to 15 characters, keep that so preference keys that would break on the device fail here too
+#define SIM_PREFERENCES_MAX_KEY_LENGTH 15
+#define SIM_PREFERENCES_ENTRIES 630
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel)
+{
+    if(_started || name == nullptr)
+    {
+        return false;
+    }
+    _namespace = name;
+    _readOnly = readOnly;
+    _started = true;
+    return true;
+}
+
+void Preferences::end()
+{
+    _started = false;
+}
+
+bool Preferences::clear()
+{
+    if(!_started || _readOnly)
+    {
+        return false;
+    }
+
+    std::string prefix = _namespace + "/";
+    auto& entries = store();
+    for(auto it = entries.begin(); it != entries.end();)
+    {
+        it = it->first.compare(0, prefix.length(), prefix) == 0 ? entries.erase(it) : std::next(it);
+    }
+    return true;
+}
+
+bool Preferences::remove(const char* key)
+{
+    if(!_started || _readOnly || key == nullptr)
+    {
+        return false;
+    }
+    return store().erase(path(key)) > 0;
+}
+
+bool Preferences::isKey(const char* key)
+{
+    return find(key) != nullptr;
+}
+
+PreferenceType Preferences::getType(const char* key)
+{
+    const Entry* entry = find(key);
+    return entry == nullptr ? PT_INVALID : entry->type;
+}
+
+size_t Preferences::freeEntries()
+{
+    return store().size() < SIM_PREFERENCES_ENTRIES ? SIM_PREFERENCES_ENTRIES - store().size() : 0;
+}
+
+size_t Preferences::putChar(const char* key, int8_t value)
+{
+    return put(key, PT_I8, value);
+}
+
+size_t Preferences::putUChar(const char* key, uint8_t value)
+{
+    return put(key, PT_U8, value);
+}
+
+size_t Preferences::putShort(const char* key, int16_t value)
+{
+    return put(key, PT_I16, value);
+}
+
+size_t Preferences::putUShort(const char* key, uint16_t value)
+{
+    return put(key, PT_U16, value);
+}
+
+size_t Preferences::putInt(const char* key, int32_t value)
+{
+    return put(key, PT_I32, value);
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value)
+{
+    return put(key, PT_U32, value);
+}
+
+size_t Preferences::putLong(const char* key, int32_t value)
+{
+    return put(key, PT_I32, value);
+}
+
+size_t Preferences::putULong(const char* key, uint32_t value)
+{
+    return put(key, PT_U32, value);
+}
+
+size_t Preferences::putLong64(const char* key, int64_t value)
+{
+    return put(key, PT_I64, value);
+}
+
+size_t Preferences::putULong64(const char* key, uint64_t value)
+{
+    return put(key, PT_U64, value);
+}
+
+size_t Preferences::putFloat(const char* key, float value)
+{
+    return putBytes(key, &value, sizeof(value));
+}
+
+size_t Preferences::putDouble(const char* key, double value)
+{
+    return putBytes(key, &value, sizeof(value));
+}
+
+size_t Preferences::putBool(const char* key, bool value)
+{
+    return put(key, PT_U8, (uint8_t)(value ? 1 : 0));
+}
+
+
+size_t Preferences::putString(const char* key, const char* value)
+{
+    if(!_started || _readOnly || key == nullptr || value == nullptr || strlen(key) > SIM_PREFERENCES_MAX_KEY_LENGTH)
+    {
+        return 0;
+    }
+
+    Entry& entry = store()[path(key)];
+    entry.type = PT_STR;
+    entry.data.assign(value, value + strlen(value) + 1);
+    return strlen(value);
+}
+
+size_t Preferences::putString(const char* key, const String& value)
+{
+    return putString(key, value.c_str());
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len)
+{
+    if(!_started || _readOnly || key == nullptr || value == nullptr || len == 0 || strlen(key) > SIM_PREFERENCES_MAX_KEY_LENGTH)
+    {
+        return 0;
+    }
+
+    Entry& entry = store()[path(key)];
+    entry.type = PT_BLOB;
+    entry.data.assign((const uint8_t*)value, (const uint8_t*)value + len);
+    return len;
+}
+
+int8_t Preferences::getChar(const char* key, int8_t defaultValue)
+{
+    return get(key, PT_I8, defaultValue);
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue)
+{
+    return get(key, PT_U8, defaultValue);
+}
+
+int16_t Preferences::getShort(const char* key, int16_t defaultValue)
+{
+    return get(key, PT_I16, defaultValue);
+}
+
+uint16_t Preferences::getUShort(const char* key, uint16_t defaultValue)
+{
+    return get(key, PT_U16, defaultValue);
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue)
+{
+    return get(key, PT_I32, defaultValue);
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue)
+{
+    return get(key, PT_U32, defaultValue);
+}
+
+int32_t Preferences::getLong(const char* key, int32_t defaultValue)
+{
+    return get(key, PT_I32, defaultValue);
+}
+
+uint32_t Preferences::getULong(const char* key, uint32_t defaultValue)
+{
+    return get(key, PT_U32, defaultValue);
+}
+
+int64_t Preferences::getLong64(const char* key, int64_t defaultValue)
+{
+    return get(key, PT_I64, defaultValue);
+}
+
+uint64_t Preferences::getULong64(const char* key, uint64_t defaultValue)
+{
+    return get(key, PT_U64, defaultValue);
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue)
+{
+    return get(key, PT_U8, (uint8_t)(defaultValue ? 1 : 0)) != 0;
+}
+
+
+float Preferences::getFloat(const char* key, float defaultValue)
+{
+    float value = defaultValue;
+    getBytes(key, &value, sizeof(value));
+    return value;
+}
+
+double Preferences::getDouble(const char* key, double defaultValue)
+{
+    double value = defaultValue;
+    getBytes(key, &value, sizeof(value));
+    return value;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen)
+{
+    const Entry* entry = find(key);
+    if(entry == nullptr || entry->type != PT_STR || value == nullptr || entry->data.size() > maxLen)
+    {
+        return 0;
+    }
+    memcpy(value, entry->data.data(), entry->data.size());
+    return entry->data.size();
+}
+
+String Preferences::getString(const char* key, String defaultValue)
+{
+    const Entry* entry = find(key);
+    if(entry == nullptr || entry->type != PT_STR)
+    {
+        return defaultValue;
+    }
+    return String((const char*)entry->data.data());
+}
+
+size_t Preferences::getBytesLength(const char* key)
+{
+    const Entry* entry = find(key);
+    return entry == nullptr || entry->type != PT_BLOB ? 0 : entry->data.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen)
+{
+    size_t len = getBytesLength(key);
+    if(len == 0 || buf == nullptr || len > maxLen)
+    {
+        return 0;
+    }
+    memcpy(buf, find(key)->data.data(), len);
+    return len;
+}
+
+template<typename T>
+size_t Preferences::put(const char* key, PreferenceType type, T value)
+{
+    if(!_started || _readOnly || key == nullptr || strlen(key) > SIM_PREFERENCES_MAX_KEY_LENGTH)
+    {
+        return 0;
+    }
+
+    Entry& entry = store()[path(key)];
+    entry.type = type;
+    entry.data.assign((const uint8_t*)&value, (const uint8_t*)&value + sizeof(T));
+    return sizeof(T);
+}
+
+template<typename T>
+T Preferences::get(const char* key, PreferenceType type, T defaultValue)
+{
+    // like NVS, a value stored with a different type isn't found
+    const Entry* entry = find(key);
+    if(entry == nullptr || entry->type != type || entry->data.size() != sizeof(T))
+    {
+        return defaultValue;
+    }
+
+    T value;
+    memcpy(&value, entry->data.data(), sizeof(T));
+    return value;
+}
+
+const Preferences::Entry* Preferences::find(const char* key)
+{
+    if(!_started || key == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto it = store().find(path(key));
+    return it == store().end() ? nullptr : &it->second;
+}
+
+std::string Preferences::path(const char* key) const
+{
+    return _namespace + "/" + key;
+}
+
+std::map<std::string, Preferences::Entry>& Preferences::store()
+{
+    static std::map<std::string, Entry> entries;
+    return entries;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifdef NUKI_HUB_SIM
+
+#include "SimulatedBleLink.h"
+#include "SimulatedClock.h"
+
+#define SIM_BEACON_LOOKBACK 1000
+
+SimulatedBleLink::SimulatedBleLink(const SimulationProfile& profile)
+{
+    setProfile(profile);
+}
+
+void SimulatedBleLink::setProfile(const SimulationProfile& profile)
+{
+    _profile = profile;
+    _state = profile.seed != 0 ? profile.seed : 1;
+}
+
+const SimulationProfile& SimulatedBleLink::profile() const
+{
+    return _profile;
+}
+
+SimulatedBleLink::Outcome SimulatedBleLink::transact()
+{
+    _commands++;
+
+    if(next() % 100 < _profile.timeoutRate)
+    {
+        _failures++;
+        SimulatedClock::advance(_profile.timeout);
+        return Outcome::TimeOut;
+    }
+
+    uint32_t latency = _profile.minLatency;
+    if(_profile.maxLatency > _profile.minLatency)
+    {
+        latency += next() % (_profile.maxLatency - _profile.minLatency + 1);
+    }
+    SimulatedClock::advance(latency);
+
+    if(next() % 100 < _profile.failureRate)
+    {
+        _failures++;
+        return Outcome::Failed;
+    }
+    return Outcome::Success;
+}
+
+int64_t SimulatedBleLink::lastBeaconTs() const
+{
+    if(_profile.beaconInterval == 0)
+    {
+        return 0;
+    }
+
+    // whether a beacon is lost only depends on its number, so the answer doesn't change with the polling rate
+    int64_t beacon = SimulatedClock::millis() / _profile.beaconInterval;
+    for(int i = 0; i < SIM_BEACON_LOOKBACK && beacon > 0; i++, beacon--)
+    {
+        if(mix(_profile.seed ^ (uint32_t)beacon) % 100 >= _profile.beaconLossRate)
+        {
+            return beacon * _profile.beaconInterval;
+        }
+    }
+    return 0;
+}
+
+int SimulatedBleLink::rssi()
+{
+    return _profile.rssi - (int)(next() % 5);
+}
+
+uint32_t SimulatedBleLink::commands() const
+{
+    return _commands;
+}
+
+uint32_t SimulatedBleLink::failures() const
+{
+    return _failures;
+}
+
+uint32_t SimulatedBleLink::next()
+{
+    // xorshift32
+    _state ^= _state << 13;
+    _state ^= _state >> 17;
+    _state ^= _state << 5;
+    return _state;
+}
+
+uint32_t SimulatedBleLink::mix(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352d;
+    value ^= value >> 15;
+    value *= 0x846ca68b;
+    value ^= value >> 16;
+    return value;
+}
+
+#endif
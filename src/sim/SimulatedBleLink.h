@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+struct SimulationProfile
+{
+    // round trip of a command including connect, uniformly distributed between min and max
+    uint32_t minLatency = 150;
+    uint32_t maxLatency = 600;
+    // time spent before a command times out
+    uint32_t timeout = 3000;
+    // percentage of commands answered with an error, or not answered at all
+    uint8_t failureRate = 0;
+    uint8_t timeoutRate = 0;
+    // 0 disables beacons
+    uint32_t beaconInterval = 1000;
+    uint8_t beaconLossRate = 0;
+    int rssi = -60;
+    uint32_t seed = 1;
+};
+
+// Timing and failure model of the BLE connection to a simulated device.
+// All randomness comes from the seed of the profile, so a run can be repeated exactly.
+class SimulatedBleLink
+{
+public:
+    enum class Outcome
+    {
+        Success,
+        Failed,
+        TimeOut
+    };
+
+    explicit SimulatedBleLink(const SimulationProfile& profile);
+
+    void setProfile(const SimulationProfile& profile);
+    const SimulationProfile& profile() const;
+
+    // Advances the virtual clock by the duration of one command and returns how it ended
+    Outcome transact();
+    // Timestamp of the last beacon received up to now, 0 if none was received
+    int64_t lastBeaconTs() const;
+    int rssi();
+
+    uint32_t commands() const;
+    uint32_t failures() const;
+
+private:
+    uint32_t next();
+    static uint32_t mix(uint32_t value);
+
+    SimulationProfile _profile;
+    uint32_t _state;
+    uint32_t _commands = 0;
+    uint32_t _failures = 0;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Virtual millisecond clock for host builds. Time only moves when the simulation advances it,
+// so runs are deterministic and a simulated BLE round trip doesn't cost wall clock time.
+class SimulatedClock
+{
+public:
+    static int64_t millis()
+    {
+        return now();
+    }
+
+    static void advance(int64_t ms)
+    {
+        now() += ms;
+    }
+
+    static void set(int64_t ms)
+    {
+        now() = ms;
+    }
+
+private:
+    // function local so the header doesn't need C++17 inline variables
+    static int64_t& now()
+    {
+        static int64_t ms = 0;
+        return ms;
+    }
+};
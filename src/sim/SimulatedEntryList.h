@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+
+// Keypad codes, time control entries or authorizations stored on a simulated device.
+// retrieve() copies a page of entries that the following get call of the device returns,
+// like the library collects the entries a device sends in answer to a request.
+template<typename Entry, typename Id>
+class SimulatedEntryList
+{
+public:
+    explicit SimulatedEntryList(Id Entry::*id)
+        : _id(id)
+    { }
+
+    // Assigns the next free id to entry, returns a pointer to the stored copy
+    Entry* add(Entry entry)
+    {
+        entry.*_id = _nextId++;
+        _entries.push_back(entry);
+        return &_entries.back();
+    }
+
+    Entry* find(const Id id)
+    {
+        for(auto& entry : _entries)
+        {
+            if(entry.*_id == id)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    bool remove(const Id id)
+    {
+        size_t size = _entries.size();
+        Id Entry::*member = _id;
+        _entries.remove_if([id, member](const Entry& entry)
+        {
+            return entry.*member == id;
+        });
+        return _entries.size() != size;
+    }
+
+    void retrieve(const uint16_t offset, const uint16_t count)
+    {
+        _retrieved.clear();
+        uint16_t index = 0;
+        for(const auto& entry : _entries)
+        {
+            if(index >= offset && _retrieved.size() < count)
+            {
+                _retrieved.push_back(entry);
+            }
+            index++;
+        }
+    }
+
+    void retrieved(std::list<Entry>* entries) const
+    {
+        *entries = _retrieved;
+    }
+
+    size_t size() const
+    {
+        return _entries.size();
+    }
+
+private:
+    Id Entry::*_id;
+    Id _nextId = 1;
+    std::list<Entry> _entries;
+    std::list<Entry> _retrieved;
+};
+
+// Copies the time limits shared by new and updated keypad codes and authorizations.
+// The from and until dates aren't simulated, only the weekdays and times of day.
+template<typename From, typename To>
+void copySimulatedTimeLimits(const From& from, To& to)
+{
+    to.timeLimited = from.timeLimited;
+    to.allowedWeekdays = from.allowedWeekdays;
+    to.allowedFromTimeHour = from.allowedFromTimeHour;
+    to.allowedFromTimeMin = from.allowedFromTimeMin;
+    to.allowedUntilTimeHour = from.allowedUntilTimeHour;
+    to.allowedUntilTimeMin = from.allowedUntilTimeMin;
+}
@@ -0,0 +1,747 @@
+#ifdef NUKI_HUB_SIM
+
+#include <cstdio>
+#include <cstring>
+#include "SimulatedNukiLock.h"
+#include "SimulatedClock.h"
+
+#define SIM_LOG_SIZE 50
+
+SimulatedNukiLock::SimulatedNukiLock(const SimulationProfile& profile)
+    : SimulatedNukiLock("Nuki Hub", 0, profile)
+{
+}
+
+SimulatedNukiLock::SimulatedNukiLock(const std::string& deviceName, const uint32_t deviceId, const SimulationProfile& profile)
+    : _deviceName(deviceName),
+      _link(profile),
+      _keypadEntries(&NukiLock::KeypadEntry::codeId),
+      _timeControlEntries(&NukiLock::TimeControlEntry::entryId),
+      _authorizationEntries(&NukiLock::AuthorizationEntry::authId)
+{
+    memset(&_keyTurnerState, 0, sizeof(_keyTurnerState));
+    memset(&_batteryReport, 0, sizeof(_batteryReport));
+    memset(&_config, 0, sizeof(_config));
+    memset(&_advancedConfig, 0, sizeof(_advancedConfig));
+
+    _keyTurnerState.lockState = NukiLock::LockState::Locked;
+    _keyTurnerState.trigger = NukiLock::Trigger::System;
+    _keyTurnerState.lastLockAction = NukiLock::LockAction::Lock;
+    _keyTurnerState.lastLockActionCompletionStatus = NukiLock::CompletionStatus::Success;
+    _keyTurnerState.criticalBatteryState = 100 << 1;
+
+    _batteryReport.batteryVoltage = 6000;
+    _batteryReport.startVoltage = 6000;
+    _batteryReport.lowestVoltage = 5800;
+
+    _config.nukiId = 0x5a1e;
+    memcpy(_config.name, "Simulated Lock", strlen("Simulated Lock"));
+    _config.buttonEnabled = 1;
+    _config.ledEnabled = 1;
+    _config.ledBrightness = 3;
+    _config.firmwareVersion[0] = 4;
+    _config.hardwareRevision[0] = 4;
+
+    _advancedConfig.unlatchDuration = 3;
+    _advancedConfig.autoLockTimeOut = 300;
+}
+
+void SimulatedNukiLock::initialize()
+{
+}
+
+void SimulatedNukiLock::registerBleScanner(BleScanner::Scanner* bleScanner)
+{
+}
+
+void SimulatedNukiLock::setEventHandler(Nuki::SmartlockEventHandler* handler)
+{
+    _eventHandler = handler;
+}
+
+// The link is modelled per command, connection handling and TX power have no effect
+void SimulatedNukiLock::setConnectTimeout(const uint8_t timeout)
+{
+}
+
+void SimulatedNukiLock::setDisconnectTimeout(const uint32_t timeoutMs)
+{
+}
+
+void SimulatedNukiLock::setPower(const esp_power_level_t powerLevel)
+{
+}
+
+void SimulatedNukiLock::updateConnectionState()
+{
+}
+
+Nuki::PairingResult SimulatedNukiLock::pairNuki(const Nuki::AuthorizationIdType idType)
+{
+    if(_paired)
+    {
+        return Nuki::PairingResult::Success;
+    }
+    if(transact() != Nuki::CmdResult::Success)
+    {
+        return Nuki::PairingResult::Pairing;
+    }
+
+    NukiLock::AuthorizationEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, _deviceName.c_str(), _deviceName.length() < sizeof(entry.name) ? _deviceName.length() : sizeof(entry.name));
+    entry.idType = (uint8_t)idType;
+    entry.enabled = 1;
+    entry.remoteAllowed = 1;
+    _authorizationEntries.add(entry);
+    _paired = true;
+    return Nuki::PairingResult::Success;
+}
+
+// Like the library, only forgets the credentials, the authorization stays on the lock
+bool SimulatedNukiLock::unPairNuki()
+{
+    _paired = false;
+    return true;
+}
+
+bool SimulatedNukiLock::isPairedWithLock() const
+{
+    return _paired;
+}
+
+const BLEAddress SimulatedNukiLock::getBleAddress() const
+{
+    char address[18];
+    snprintf(address, sizeof(address), "54:d2:72:%02x:%02x:%02x", (uint8_t)(_config.nukiId >> 16), (uint8_t)(_config.nukiId >> 8), (uint8_t)_config.nukiId);
+    return BLEAddress(address);
+}
+
+uint32_t SimulatedNukiLock::getSecurityPincode()
+{
+    return _savedPincode;
+}
+
+bool SimulatedNukiLock::saveSecurityPincode(const uint32_t pinCode)
+{
+    _savedPincode = pinCode;
+    return true;
+}
+
+Nuki::CmdResult SimulatedNukiLock::verifySecurityPin()
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && _savedPincode != _pincode)
+    {
+        notify(Nuki::EventType::ERROR_BAD_PIN);
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::requestKeyTurnerState(NukiLock::KeyTurnerState* retrievedKeyTurnerState)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedKeyTurnerState, &_keyTurnerState, sizeof(_keyTurnerState));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::lockAction(const NukiLock::LockAction lockAction, const uint32_t nukiAppId, const uint8_t flags)
+{
+    NukiLock::LockState lockState;
+
+    switch(lockAction)
+    {
+    case NukiLock::LockAction::Unlock:
+    case NukiLock::LockAction::LockNgo:
+        lockState = NukiLock::LockState::Unlocked;
+        break;
+    case NukiLock::LockAction::Lock:
+    case NukiLock::LockAction::FullLock:
+        lockState = NukiLock::LockState::Locked;
+        break;
+    case NukiLock::LockAction::Unlatch:
+    case NukiLock::LockAction::LockNgoUnlatch:
+        lockState = NukiLock::LockState::Unlatched;
+        break;
+    default:
+        return Nuki::CmdResult::Failed;
+    }
+
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    _keyTurnerState.lockState = lockState;
+    _keyTurnerState.trigger = NukiLock::Trigger::System;
+    _keyTurnerState.lastLockAction = lockAction;
+    _keyTurnerState.lastLockActionTrigger = NukiLock::Trigger::System;
+    _keyTurnerState.lastLockActionCompletionStatus = NukiLock::CompletionStatus::Success;
+    _batteryReport.lockAction = lockAction;
+    addLogEntry(lockAction, NukiLock::Trigger::System);
+    notify(Nuki::EventType::KeyTurnerStatusUpdated);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::requestBatteryReport(NukiLock::BatteryReport* retrievedBatteryReport)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedBatteryReport, &_batteryReport, sizeof(_batteryReport));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::requestConfig(NukiLock::Config* retrievedConfig)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedConfig, &_config, sizeof(_config));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::requestAdvancedConfig(NukiLock::AdvancedConfig* retrievedAdvancedConfig)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedAdvancedConfig, &_advancedConfig, sizeof(_advancedConfig));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::requestReboot()
+{
+    return transact();
+}
+
+Nuki::CmdResult SimulatedNukiLock::retrieveKeypadEntries(const uint16_t offset, const uint16_t count)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        _keypadEntries.retrieve(offset, count);
+    }
+    return result;
+}
+
+void SimulatedNukiLock::getKeypadEntries(std::list<NukiLock::KeypadEntry>* requestedKeypadCodes)
+{
+    _keypadEntries.retrieved(requestedKeypadCodes);
+}
+
+Nuki::CmdResult SimulatedNukiLock::addKeypadEntry(NukiLock::NewKeypadEntry newKeypadEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiLock::KeypadEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.code = newKeypadEntry.code;
+    entry.enabled = 1;
+    memcpy(entry.name, newKeypadEntry.name, sizeof(entry.name));
+    copySimulatedTimeLimits(newKeypadEntry, entry);
+    _keypadEntries.add(entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::updateKeypadEntry(NukiLock::UpdatedKeypadEntry updatedKeypadEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiLock::KeypadEntry* entry = _keypadEntries.find(updatedKeypadEntry.codeId);
+    if(entry == nullptr)
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    entry->code = updatedKeypadEntry.code;
+    entry->enabled = updatedKeypadEntry.enabled;
+    memcpy(entry->name, updatedKeypadEntry.name, sizeof(entry->name));
+    copySimulatedTimeLimits(updatedKeypadEntry, *entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::deleteKeypadEntry(uint16_t id)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && !_keypadEntries.remove(id))
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::retrieveTimeControlEntries()
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        _timeControlEntries.retrieve(0, UINT16_MAX);
+    }
+    return result;
+}
+
+void SimulatedNukiLock::getTimeControlEntries(std::list<NukiLock::TimeControlEntry>* timeControlEntries)
+{
+    _timeControlEntries.retrieved(timeControlEntries);
+}
+
+Nuki::CmdResult SimulatedNukiLock::addTimeControlEntry(NukiLock::NewTimeControlEntry newTimeControlEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiLock::TimeControlEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.enabled = 1;
+    entry.weekdays = newTimeControlEntry.weekdays;
+    entry.timeHour = newTimeControlEntry.timeHour;
+    entry.timeMin = newTimeControlEntry.timeMin;
+    entry.lockAction = newTimeControlEntry.lockAction;
+    _timeControlEntries.add(entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::updateTimeControlEntry(NukiLock::TimeControlEntry timeControlEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiLock::TimeControlEntry* entry = _timeControlEntries.find(timeControlEntry.entryId);
+    if(entry == nullptr)
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    *entry = timeControlEntry;
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::removeTimeControlEntry(uint8_t entryId)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && !_timeControlEntries.remove(entryId))
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::retrieveAuthorizationEntries(const uint16_t offset, const uint16_t count)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        _authorizationEntries.retrieve(offset, count);
+    }
+    return result;
+}
+
+void SimulatedNukiLock::getAuthorizationEntries(std::list<NukiLock::AuthorizationEntry>* requestedAuthorizationEntries)
+{
+    _authorizationEntries.retrieved(requestedAuthorizationEntries);
+}
+
+Nuki::CmdResult SimulatedNukiLock::addAuthorizationEntry(NukiLock::NewAuthorizationEntry newAuthorizationEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiLock::AuthorizationEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.idType = newAuthorizationEntry.idType;
+    entry.enabled = 1;
+    entry.remoteAllowed = newAuthorizationEntry.remoteAllowed;
+    memcpy(entry.name, newAuthorizationEntry.name, sizeof(entry.name));
+    copySimulatedTimeLimits(newAuthorizationEntry, entry);
+    _authorizationEntries.add(entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::updateAuthorizationEntry(NukiLock::UpdatedAuthorizationEntry updatedAuthorizationEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiLock::AuthorizationEntry* entry = _authorizationEntries.find(updatedAuthorizationEntry.authId);
+    if(entry == nullptr)
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    entry->enabled = updatedAuthorizationEntry.enabled;
+    entry->remoteAllowed = updatedAuthorizationEntry.remoteAllowed;
+    memcpy(entry->name, updatedAuthorizationEntry.name, sizeof(entry->name));
+    copySimulatedTimeLimits(updatedAuthorizationEntry, *entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::deleteAuthorizationEntry(uint32_t id)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && !_authorizationEntries.remove(id))
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::retrieveLogEntries(const uint32_t startIndex, const uint16_t count, const uint8_t sortOrder, bool const totalCount)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    // sort order 1 is descending, newest entries first
+    _retrievedLogEntries.clear();
+    if(sortOrder == 1)
+    {
+        for(auto it = _logEntries.rbegin(); it != _logEntries.rend() && _retrievedLogEntries.size() < count; ++it)
+        {
+            if(startIndex == 0 || it->index <= startIndex)
+            {
+                _retrievedLogEntries.push_back(*it);
+            }
+        }
+    }
+    else
+    {
+        for(auto it = _logEntries.begin(); it != _logEntries.end() && _retrievedLogEntries.size() < count; ++it)
+        {
+            if(it->index >= startIndex)
+            {
+                _retrievedLogEntries.push_back(*it);
+            }
+        }
+    }
+    return result;
+}
+
+void SimulatedNukiLock::getLogEntries(std::list<NukiLock::LogEntry>* requestedLogEntries)
+{
+    *requestedLogEntries = _retrievedLogEntries;
+}
+
+Nuki::CmdResult SimulatedNukiLock::setName(const std::string& name)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memset(_config.name, 0, sizeof(_config.name));
+        memcpy(_config.name, name.c_str(), name.length() < sizeof(_config.name) ? name.length() : sizeof(_config.name));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::setLatitude(const float degrees)
+{
+    return setValue(_config.latitude, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setLongitude(const float degrees)
+{
+    return setValue(_config.longitude, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableAutoUnlatch(const bool enable)
+{
+    return setValue(_config.autoUnlatch, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enablePairing(const bool enable)
+{
+    return setValue(_config.pairingEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableButton(const bool enable)
+{
+    return setValue(_config.buttonEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableLedFlash(const bool enable)
+{
+    return setValue(_config.ledEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setLedBrightness(const uint8_t level)
+{
+    return setValue(_config.ledBrightness, level);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setTimeZoneOffset(const int16_t minutes)
+{
+    return setValue(_config.timeZoneOffset, minutes);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableDst(const bool enable)
+{
+    return setValue(_config.dstMode, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setFobAction(const uint8_t fobActionNr, const uint8_t fobAction)
+{
+    switch(fobActionNr)
+    {
+    case 1:
+        return setValue(_config.fobAction1, fobAction);
+    case 2:
+        return setValue(_config.fobAction2, fobAction);
+    case 3:
+        return setValue(_config.fobAction3, fobAction);
+    default:
+        return Nuki::CmdResult::Failed;
+    }
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableSingleLock(const bool enable)
+{
+    return setValue(_config.singleLock, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setAdvertisingMode(const Nuki::AdvertisingMode mode)
+{
+    return setValue(_config.advertisingMode, mode);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setTimeZoneId(const Nuki::TimeZoneId timeZoneId)
+{
+    return setValue(_config.timeZoneId, timeZoneId);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setUnlockedPositionOffsetDegrees(const int16_t degrees)
+{
+    return setValue(_advancedConfig.unlockedPositionOffsetDegrees, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setLockedPositionOffsetDegrees(const int16_t degrees)
+{
+    return setValue(_advancedConfig.lockedPositionOffsetDegrees, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setSingleLockedPositionOffsetDegrees(const int16_t degrees)
+{
+    return setValue(_advancedConfig.singleLockedPositionOffsetDegrees, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setUnlockedToLockedTransitionOffsetDegrees(const int16_t degrees)
+{
+    return setValue(_advancedConfig.unlockedToLockedTransitionOffsetDegrees, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setLockNgoTimeout(const uint8_t timeout)
+{
+    return setValue(_advancedConfig.lockNgoTimeout, timeout);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setSingleButtonPressAction(const NukiLock::ButtonPressAction action)
+{
+    return setValue(_advancedConfig.singleButtonPressAction, action);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setDoubleButtonPressAction(const NukiLock::ButtonPressAction action)
+{
+    return setValue(_advancedConfig.doubleButtonPressAction, action);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableDetachedCylinder(const bool enable)
+{
+    return setValue(_advancedConfig.detachedCylinder, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setBatteryType(const Nuki::BatteryType type)
+{
+    return setValue(_advancedConfig.batteryType, type);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableAutoBatteryTypeDetection(const bool enable)
+{
+    return setValue(_advancedConfig.automaticBatteryTypeDetection, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setUnlatchDuration(const uint8_t duration)
+{
+    return setValue(_advancedConfig.unlatchDuration, duration);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setAutoLockTimeOut(const uint16_t timeout)
+{
+    return setValue(_advancedConfig.autoLockTimeOut, timeout);
+}
+
+Nuki::CmdResult SimulatedNukiLock::disableAutoUnlock(const bool disable)
+{
+    return setValue(_advancedConfig.autoUnLockDisabled, disable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableNightMode(const bool enable)
+{
+    return setValue(_advancedConfig.nightModeEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::setNightModeStartTime(unsigned char starttime[2])
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(_advancedConfig.nightModeStartTime, starttime, sizeof(_advancedConfig.nightModeStartTime));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::setNightModeEndTime(unsigned char endtime[2])
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(_advancedConfig.nightModeEndTime, endtime, sizeof(_advancedConfig.nightModeEndTime));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableNightModeAutoLock(const bool enable)
+{
+    return setValue(_advancedConfig.nightModeAutoLockEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::disableNightModeAutoUnlock(const bool disable)
+{
+    return setValue(_advancedConfig.nightModeAutoUnlockDisabled, disable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableNightModeImmediateLockOnStart(const bool enable)
+{
+    return setValue(_advancedConfig.nightModeImmediateLockOnStart, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableAutoLock(const bool enable)
+{
+    return setValue(_advancedConfig.autoLockEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableImmediateAutoLock(const bool enable)
+{
+    return setValue(_advancedConfig.immediateAutoLockEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiLock::enableAutoUpdate(const bool enable)
+{
+    return setValue(_advancedConfig.autoUpdateEnabled, enable);
+}
+
+int64_t SimulatedNukiLock::getLastReceivedBeaconTs() const
+{
+    return _link.lastBeaconTs();
+}
+
+int SimulatedNukiLock::getRssi()
+{
+    return _link.rssi();
+}
+
+void SimulatedNukiLock::simulateLockState(const NukiLock::LockState lockState, const NukiLock::Trigger trigger)
+{
+    _keyTurnerState.lockState = lockState;
+    _keyTurnerState.trigger = trigger;
+
+    if(lockState == NukiLock::LockState::Locked || lockState == NukiLock::LockState::Unlocked)
+    {
+        NukiLock::LockAction action = lockState == NukiLock::LockState::Locked ? NukiLock::LockAction::Lock : NukiLock::LockAction::Unlock;
+        _keyTurnerState.lastLockAction = action;
+        _keyTurnerState.lastLockActionTrigger = trigger;
+        addLogEntry(action, trigger);
+    }
+    notify(Nuki::EventType::KeyTurnerStatusUpdated);
+}
+
+void SimulatedNukiLock::simulateBatteryState(const uint8_t criticalBatteryState)
+{
+    _keyTurnerState.criticalBatteryState = criticalBatteryState;
+    _batteryReport.criticalBatteryState = criticalBatteryState;
+    notify(Nuki::EventType::KeyTurnerStatusUpdated);
+}
+
+void SimulatedNukiLock::simulateSecurityPincode(const uint32_t pinCode)
+{
+    _pincode = pinCode;
+}
+
+SimulatedBleLink& SimulatedNukiLock::link()
+{
+    return _link;
+}
+
+Nuki::CmdResult SimulatedNukiLock::transact()
+{
+    switch(_link.transact())
+    {
+    case SimulatedBleLink::Outcome::Success:
+        return Nuki::CmdResult::Success;
+    case SimulatedBleLink::Outcome::TimeOut:
+        return Nuki::CmdResult::TimeOut;
+    default:
+        return Nuki::CmdResult::Failed;
+    }
+}
+
+void SimulatedNukiLock::notify(const Nuki::EventType eventType)
+{
+    if(_eventHandler != nullptr)
+    {
+        _eventHandler->notify(eventType);
+    }
+}
+
+void SimulatedNukiLock::addLogEntry(const NukiLock::LockAction action, const NukiLock::Trigger trigger)
+{
+    NukiLock::LogEntry entry;
+    memset(&entry, 0, sizeof(entry));
+
+    int64_t seconds = SimulatedClock::millis() / 1000;
+    entry.index = ++_logIndex;
+    entry.timeStampYear = 2024;
+    entry.timeStampMonth = 1;
+    entry.timeStampDay = 1 + (seconds / 86400) % 28;
+    entry.timeStampHour = (seconds / 3600) % 24;
+    entry.timeStampMinute = (seconds / 60) % 60;
+    entry.timeStampSecond = seconds % 60;
+    entry.loggingType = NukiLock::LoggingType::LockAction;
+    entry.data[0] = (uint8_t)action;
+    entry.data[1] = (uint8_t)trigger;
+    entry.data[3] = (uint8_t)NukiLock::CompletionStatus::Success;
+    memcpy(entry.name, _deviceName.c_str(), _deviceName.length() < sizeof(entry.name) ? _deviceName.length() : sizeof(entry.name));
+
+    _logEntries.push_back(entry);
+    if(_logEntries.size() > SIM_LOG_SIZE)
+    {
+        _logEntries.pop_front();
+    }
+}
+
+#endif
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include "NukiLock.h"
+#include "NukiLockConstants.h"
+#include "NimBLEAddress.h"
+#include "esp_bt.h"
+#include "SimulatedBleLink.h"
+#include "SimulatedEntryList.h"
+
+namespace BleScanner
+{
+class Scanner;
+}
+
+// Stand-in for NukiLock::NukiLock on host builds, see NukiDevice.h. Implements every call NukiWrapper makes,
+// with the library's names and parameters, on an in-memory lock. test/stubs/check_nuki_stubs.py checks both.
+// Every command costs one round trip on the simulated link, so latency and failures follow the profile.
+class SimulatedNukiLock
+{
+public:
+    explicit SimulatedNukiLock(const SimulationProfile& profile = SimulationProfile());
+    SimulatedNukiLock(const std::string& deviceName, const uint32_t deviceId, const SimulationProfile& profile = SimulationProfile());
+
+    void initialize();
+    void registerBleScanner(BleScanner::Scanner* bleScanner);
+    void setEventHandler(Nuki::SmartlockEventHandler* handler);
+    void setConnectTimeout(const uint8_t timeout);
+    void setDisconnectTimeout(const uint32_t timeoutMs);
+    void setPower(const esp_power_level_t powerLevel);
+    void updateConnectionState();
+
+    Nuki::PairingResult pairNuki(const Nuki::AuthorizationIdType idType = Nuki::AuthorizationIdType::Bridge);
+    bool unPairNuki();
+    bool isPairedWithLock() const;
+    const BLEAddress getBleAddress() const;
+    int64_t getLastReceivedBeaconTs() const;
+    int getRssi();
+
+    uint32_t getSecurityPincode();
+    bool saveSecurityPincode(const uint32_t pinCode);
+    Nuki::CmdResult verifySecurityPin();
+
+    Nuki::CmdResult requestKeyTurnerState(NukiLock::KeyTurnerState* retrievedKeyTurnerState);
+    Nuki::CmdResult lockAction(const NukiLock::LockAction lockAction, const uint32_t nukiAppId = 1, const uint8_t flags = 0);
+    Nuki::CmdResult requestBatteryReport(NukiLock::BatteryReport* retrievedBatteryReport);
+    Nuki::CmdResult requestConfig(NukiLock::Config* retrievedConfig);
+    Nuki::CmdResult requestAdvancedConfig(NukiLock::AdvancedConfig* retrievedAdvancedConfig);
+    Nuki::CmdResult requestReboot();
+
+    Nuki::CmdResult retrieveKeypadEntries(const uint16_t offset, const uint16_t count);
+    void getKeypadEntries(std::list<NukiLock::KeypadEntry>* requestedKeypadCodes);
+    Nuki::CmdResult addKeypadEntry(NukiLock::NewKeypadEntry newKeypadEntry);
+    Nuki::CmdResult updateKeypadEntry(NukiLock::UpdatedKeypadEntry updatedKeypadEntry);
+    Nuki::CmdResult deleteKeypadEntry(uint16_t id);
+
+    Nuki::CmdResult retrieveTimeControlEntries();
+    void getTimeControlEntries(std::list<NukiLock::TimeControlEntry>* timeControlEntries);
+    Nuki::CmdResult addTimeControlEntry(NukiLock::NewTimeControlEntry newTimeControlEntry);
+    Nuki::CmdResult updateTimeControlEntry(NukiLock::TimeControlEntry timeControlEntry);
+    Nuki::CmdResult removeTimeControlEntry(uint8_t entryId);
+
+    Nuki::CmdResult retrieveAuthorizationEntries(const uint16_t offset, const uint16_t count);
+    void getAuthorizationEntries(std::list<NukiLock::AuthorizationEntry>* requestedAuthorizationEntries);
+    Nuki::CmdResult addAuthorizationEntry(NukiLock::NewAuthorizationEntry newAuthorizationEntry);
+    Nuki::CmdResult updateAuthorizationEntry(NukiLock::UpdatedAuthorizationEntry updatedAuthorizationEntry);
+    Nuki::CmdResult deleteAuthorizationEntry(uint32_t id);
+
+    Nuki::CmdResult retrieveLogEntries(const uint32_t startIndex, const uint16_t count, const uint8_t sortOrder, bool const totalCount);
+    void getLogEntries(std::list<NukiLock::LogEntry>* requestedLogEntries);
+
+    Nuki::CmdResult setName(const std::string& name);
+    Nuki::CmdResult setLatitude(const float degrees);
+    Nuki::CmdResult setLongitude(const float degrees);
+    Nuki::CmdResult enableAutoUnlatch(const bool enable);
+    Nuki::CmdResult enablePairing(const bool enable);
+    Nuki::CmdResult enableButton(const bool enable);
+    Nuki::CmdResult enableLedFlash(const bool enable);
+    Nuki::CmdResult setLedBrightness(const uint8_t level);
+    Nuki::CmdResult setTimeZoneOffset(const int16_t minutes);
+    Nuki::CmdResult enableDst(const bool enable);
+    Nuki::CmdResult setFobAction(const uint8_t fobActionNr, const uint8_t fobAction);
+    Nuki::CmdResult enableSingleLock(const bool enable);
+    Nuki::CmdResult setAdvertisingMode(const Nuki::AdvertisingMode mode);
+    Nuki::CmdResult setTimeZoneId(const Nuki::TimeZoneId timeZoneId);
+
+    Nuki::CmdResult setUnlockedPositionOffsetDegrees(const int16_t degrees);
+    Nuki::CmdResult setLockedPositionOffsetDegrees(const int16_t degrees);
+    Nuki::CmdResult setSingleLockedPositionOffsetDegrees(const int16_t degrees);
+    Nuki::CmdResult setUnlockedToLockedTransitionOffsetDegrees(const int16_t degrees);
+    Nuki::CmdResult setLockNgoTimeout(const uint8_t timeout);
+    Nuki::CmdResult setSingleButtonPressAction(const NukiLock::ButtonPressAction action);
+    Nuki::CmdResult setDoubleButtonPressAction(const NukiLock::ButtonPressAction action);
+    Nuki::CmdResult enableDetachedCylinder(const bool enable);
+    Nuki::CmdResult setBatteryType(const Nuki::BatteryType type);
+    Nuki::CmdResult enableAutoBatteryTypeDetection(const bool enable);
+    Nuki::CmdResult setUnlatchDuration(const uint8_t duration);
+    Nuki::CmdResult setAutoLockTimeOut(const uint16_t timeout);
+    Nuki::CmdResult disableAutoUnlock(const bool disable);
+    Nuki::CmdResult enableNightMode(const bool enable);
+    Nuki::CmdResult setNightModeStartTime(unsigned char starttime[2]);
+    Nuki::CmdResult setNightModeEndTime(unsigned char endtime[2]);
+    Nuki::CmdResult enableNightModeAutoLock(const bool enable);
+    Nuki::CmdResult disableNightModeAutoUnlock(const bool disable);
+    Nuki::CmdResult enableNightModeImmediateLockOnStart(const bool enable);
+    Nuki::CmdResult enableAutoLock(const bool enable);
+    Nuki::CmdResult enableImmediateAutoLock(const bool enable);
+    Nuki::CmdResult enableAutoUpdate(const bool enable);
+
+    // Simulation control, e.g. the lock being turned by hand
+    void simulateLockState(const NukiLock::LockState lockState, const NukiLock::Trigger trigger);
+    void simulateBatteryState(const uint8_t criticalBatteryState);
+    void simulateSecurityPincode(const uint32_t pinCode);
+    SimulatedBleLink& link();
+
+private:
+    Nuki::CmdResult transact();
+    void notify(const Nuki::EventType eventType);
+    void addLogEntry(const NukiLock::LockAction action, const NukiLock::Trigger trigger);
+
+    template<typename T, typename V>
+    Nuki::CmdResult setValue(T& field, const V value)
+    {
+        Nuki::CmdResult result = transact();
+        if(result == Nuki::CmdResult::Success)
+        {
+            field = (T)value;
+        }
+        return result;
+    }
+
+    std::string _deviceName;
+    SimulatedBleLink _link;
+    Nuki::SmartlockEventHandler* _eventHandler = nullptr;
+    bool _paired = false;
+    uint32_t _savedPincode = 0;
+    uint32_t _pincode = 0;
+    NukiLock::KeyTurnerState _keyTurnerState;
+    NukiLock::BatteryReport _batteryReport;
+    NukiLock::Config _config;
+    NukiLock::AdvancedConfig _advancedConfig;
+    SimulatedEntryList<NukiLock::KeypadEntry, uint16_t> _keypadEntries;
+    SimulatedEntryList<NukiLock::TimeControlEntry, uint8_t> _timeControlEntries;
+    SimulatedEntryList<NukiLock::AuthorizationEntry, uint32_t> _authorizationEntries;
+    std::list<NukiLock::LogEntry> _logEntries;
+    std::list<NukiLock::LogEntry> _retrievedLogEntries;
+    uint32_t _logIndex = 0;
+};
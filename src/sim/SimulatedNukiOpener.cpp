@@ -0,0 +1,730 @@
+#ifdef NUKI_HUB_SIM
+
+#include <cstdio>
+#include <cstring>
+#include "SimulatedNukiOpener.h"
+#include "SimulatedClock.h"
+
+#define SIM_LOG_SIZE 50
+
+SimulatedNukiOpener::SimulatedNukiOpener(const SimulationProfile& profile)
+    : SimulatedNukiOpener("Nuki Hub", 0, profile)
+{
+}
+
+SimulatedNukiOpener::SimulatedNukiOpener(const std::string& deviceName, const uint32_t deviceId, const SimulationProfile& profile)
+    : _deviceName(deviceName),
+      _link(profile),
+      _keypadEntries(&NukiOpener::KeypadEntry::codeId),
+      _timeControlEntries(&NukiOpener::TimeControlEntry::entryId),
+      _authorizationEntries(&NukiOpener::AuthorizationEntry::authId)
+{
+    memset(&_openerState, 0, sizeof(_openerState));
+    memset(&_batteryReport, 0, sizeof(_batteryReport));
+    memset(&_config, 0, sizeof(_config));
+    memset(&_advancedConfig, 0, sizeof(_advancedConfig));
+
+    _openerState.nukiState = NukiOpener::State::DoorMode;
+    _openerState.lockState = NukiOpener::LockState::Locked;
+    _openerState.trigger = NukiOpener::Trigger::System;
+    _openerState.lastLockActionCompletionStatus = NukiOpener::CompletionStatus::Success;
+
+    _batteryReport.batteryVoltage = 4500;
+    _batteryReport.startVoltage = 4500;
+    _batteryReport.lowestVoltage = 4400;
+
+    _config.nukiId = 0x5a1f;
+    memcpy(_config.name, "Simulated Opener", strlen("Simulated Opener"));
+    _config.buttonEnabled = 1;
+    _config.ledFlashEnabled = 1;
+    _config.firmwareVersion[0] = 1;
+    _config.hardwareRevision[0] = 1;
+
+    _advancedConfig.soundLevel = 255;
+}
+
+void SimulatedNukiOpener::initialize()
+{
+}
+
+void SimulatedNukiOpener::registerBleScanner(BleScanner::Scanner* bleScanner)
+{
+}
+
+void SimulatedNukiOpener::setEventHandler(Nuki::SmartlockEventHandler* handler)
+{
+    _eventHandler = handler;
+}
+
+// The link is modelled per command, connection handling and TX power have no effect
+void SimulatedNukiOpener::setConnectTimeout(const uint8_t timeout)
+{
+}
+
+void SimulatedNukiOpener::setDisconnectTimeout(const uint32_t timeoutMs)
+{
+}
+
+void SimulatedNukiOpener::setPower(const esp_power_level_t powerLevel)
+{
+}
+
+void SimulatedNukiOpener::updateConnectionState()
+{
+}
+
+Nuki::PairingResult SimulatedNukiOpener::pairNuki(const Nuki::AuthorizationIdType idType)
+{
+    if(_paired)
+    {
+        return Nuki::PairingResult::Success;
+    }
+    if(transact() != Nuki::CmdResult::Success)
+    {
+        return Nuki::PairingResult::Pairing;
+    }
+
+    NukiOpener::AuthorizationEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, _deviceName.c_str(), _deviceName.length() < sizeof(entry.name) ? _deviceName.length() : sizeof(entry.name));
+    entry.idType = (uint8_t)idType;
+    entry.enabled = 1;
+    entry.remoteAllowed = 1;
+    _authorizationEntries.add(entry);
+    _paired = true;
+    return Nuki::PairingResult::Success;
+}
+
+// Like the library, only forgets the credentials, the authorization stays on the opener
+bool SimulatedNukiOpener::unPairNuki()
+{
+    _paired = false;
+    return true;
+}
+
+bool SimulatedNukiOpener::isPairedWithLock() const
+{
+    return _paired;
+}
+
+const BLEAddress SimulatedNukiOpener::getBleAddress() const
+{
+    char address[18];
+    snprintf(address, sizeof(address), "54:d2:72:%02x:%02x:%02x", (uint8_t)(_config.nukiId >> 16), (uint8_t)(_config.nukiId >> 8), (uint8_t)_config.nukiId);
+    return BLEAddress(address);
+}
+
+uint32_t SimulatedNukiOpener::getSecurityPincode()
+{
+    return _savedPincode;
+}
+
+bool SimulatedNukiOpener::saveSecurityPincode(const uint32_t pinCode)
+{
+    _savedPincode = pinCode;
+    return true;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::verifySecurityPin()
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && _savedPincode != _pincode)
+    {
+        notify(Nuki::EventType::ERROR_BAD_PIN);
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::requestOpenerState(NukiOpener::OpenerState* retrievedOpenerState)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedOpenerState, &_openerState, sizeof(_openerState));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::lockAction(const NukiOpener::LockAction lockAction, const uint32_t nukiAppId, const uint8_t flags)
+{
+    NukiOpener::LockState lockState = _openerState.lockState;
+    NukiOpener::State nukiState = _openerState.nukiState;
+
+    switch(lockAction)
+    {
+    case NukiOpener::LockAction::ActivateRTO:
+        lockState = NukiOpener::LockState::RTOactive;
+        break;
+    case NukiOpener::LockAction::DeactivateRTO:
+        lockState = NukiOpener::LockState::Locked;
+        break;
+    case NukiOpener::LockAction::ElectricStrikeActuation:
+        lockState = NukiOpener::LockState::Open;
+        break;
+    case NukiOpener::LockAction::ActivateCM:
+        nukiState = NukiOpener::State::ContinuousMode;
+        break;
+    case NukiOpener::LockAction::DeactivateCM:
+        nukiState = NukiOpener::State::DoorMode;
+        break;
+    default:
+        return Nuki::CmdResult::Failed;
+    }
+
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    _openerState.lockState = lockState;
+    _openerState.nukiState = nukiState;
+    _openerState.trigger = NukiOpener::Trigger::System;
+    _openerState.lastLockAction = lockAction;
+    _openerState.lastLockActionTrigger = NukiOpener::Trigger::System;
+    _openerState.lastLockActionCompletionStatus = NukiOpener::CompletionStatus::Success;
+    _batteryReport.lockAction = lockAction;
+    addLogEntry(NukiOpener::LoggingType::LockAction, (uint8_t)lockAction, (uint8_t)NukiOpener::Trigger::System);
+    notify(Nuki::EventType::KeyTurnerStatusUpdated);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::requestBatteryReport(NukiOpener::BatteryReport* retrievedBatteryReport)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedBatteryReport, &_batteryReport, sizeof(_batteryReport));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::requestConfig(NukiOpener::Config* retrievedConfig)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedConfig, &_config, sizeof(_config));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::requestAdvancedConfig(NukiOpener::AdvancedConfig* retrievedAdvancedConfig)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memcpy(retrievedAdvancedConfig, &_advancedConfig, sizeof(_advancedConfig));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::requestReboot()
+{
+    return transact();
+}
+
+Nuki::CmdResult SimulatedNukiOpener::retrieveKeypadEntries(const uint16_t offset, const uint16_t count)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        _keypadEntries.retrieve(offset, count);
+    }
+    return result;
+}
+
+void SimulatedNukiOpener::getKeypadEntries(std::list<NukiOpener::KeypadEntry>* requestedKeypadCodes)
+{
+    _keypadEntries.retrieved(requestedKeypadCodes);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::addKeypadEntry(NukiOpener::NewKeypadEntry newKeypadEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiOpener::KeypadEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.code = newKeypadEntry.code;
+    entry.enabled = 1;
+    memcpy(entry.name, newKeypadEntry.name, sizeof(entry.name));
+    copySimulatedTimeLimits(newKeypadEntry, entry);
+    _keypadEntries.add(entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::updateKeypadEntry(NukiOpener::UpdatedKeypadEntry updatedKeypadEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiOpener::KeypadEntry* entry = _keypadEntries.find(updatedKeypadEntry.codeId);
+    if(entry == nullptr)
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    entry->code = updatedKeypadEntry.code;
+    entry->enabled = updatedKeypadEntry.enabled;
+    memcpy(entry->name, updatedKeypadEntry.name, sizeof(entry->name));
+    copySimulatedTimeLimits(updatedKeypadEntry, *entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::deleteKeypadEntry(uint16_t id)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && !_keypadEntries.remove(id))
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::retrieveTimeControlEntries()
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        _timeControlEntries.retrieve(0, UINT16_MAX);
+    }
+    return result;
+}
+
+void SimulatedNukiOpener::getTimeControlEntries(std::list<NukiOpener::TimeControlEntry>* timeControlEntries)
+{
+    _timeControlEntries.retrieved(timeControlEntries);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::addTimeControlEntry(NukiOpener::NewTimeControlEntry newTimeControlEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiOpener::TimeControlEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.enabled = 1;
+    entry.weekdays = newTimeControlEntry.weekdays;
+    entry.timeHour = newTimeControlEntry.timeHour;
+    entry.timeMin = newTimeControlEntry.timeMin;
+    entry.lockAction = newTimeControlEntry.lockAction;
+    _timeControlEntries.add(entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::updateTimeControlEntry(NukiOpener::TimeControlEntry timeControlEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiOpener::TimeControlEntry* entry = _timeControlEntries.find(timeControlEntry.entryId);
+    if(entry == nullptr)
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    *entry = timeControlEntry;
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::removeTimeControlEntry(uint8_t entryId)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && !_timeControlEntries.remove(entryId))
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::retrieveAuthorizationEntries(const uint16_t offset, const uint16_t count)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        _authorizationEntries.retrieve(offset, count);
+    }
+    return result;
+}
+
+void SimulatedNukiOpener::getAuthorizationEntries(std::list<NukiOpener::AuthorizationEntry>* requestedAuthorizationEntries)
+{
+    _authorizationEntries.retrieved(requestedAuthorizationEntries);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::addAuthorizationEntry(NukiOpener::NewAuthorizationEntry newAuthorizationEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiOpener::AuthorizationEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.idType = newAuthorizationEntry.idType;
+    entry.enabled = 1;
+    entry.remoteAllowed = newAuthorizationEntry.remoteAllowed;
+    memcpy(entry.name, newAuthorizationEntry.name, sizeof(entry.name));
+    copySimulatedTimeLimits(newAuthorizationEntry, entry);
+    _authorizationEntries.add(entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::updateAuthorizationEntry(NukiOpener::UpdatedAuthorizationEntry updatedAuthorizationEntry)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    NukiOpener::AuthorizationEntry* entry = _authorizationEntries.find(updatedAuthorizationEntry.authId);
+    if(entry == nullptr)
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    entry->enabled = updatedAuthorizationEntry.enabled;
+    entry->remoteAllowed = updatedAuthorizationEntry.remoteAllowed;
+    memcpy(entry->name, updatedAuthorizationEntry.name, sizeof(entry->name));
+    copySimulatedTimeLimits(updatedAuthorizationEntry, *entry);
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::deleteAuthorizationEntry(uint32_t id)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success && !_authorizationEntries.remove(id))
+    {
+        return Nuki::CmdResult::Failed;
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::retrieveLogEntries(const uint32_t startIndex, const uint16_t count, const uint8_t sortOrder, bool const totalCount)
+{
+    Nuki::CmdResult result = transact();
+    if(result != Nuki::CmdResult::Success)
+    {
+        return result;
+    }
+
+    // sort order 1 is descending, newest entries first
+    _retrievedLogEntries.clear();
+    if(sortOrder == 1)
+    {
+        for(auto it = _logEntries.rbegin(); it != _logEntries.rend() && _retrievedLogEntries.size() < count; ++it)
+        {
+            if(startIndex == 0 || it->index <= startIndex)
+            {
+                _retrievedLogEntries.push_back(*it);
+            }
+        }
+    }
+    else
+    {
+        for(auto it = _logEntries.begin(); it != _logEntries.end() && _retrievedLogEntries.size() < count; ++it)
+        {
+            if(it->index >= startIndex)
+            {
+                _retrievedLogEntries.push_back(*it);
+            }
+        }
+    }
+    return result;
+}
+
+void SimulatedNukiOpener::getLogEntries(std::list<NukiOpener::LogEntry>* requestedLogEntries)
+{
+    *requestedLogEntries = _retrievedLogEntries;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setName(const std::string& name)
+{
+    Nuki::CmdResult result = transact();
+    if(result == Nuki::CmdResult::Success)
+    {
+        memset(_config.name, 0, sizeof(_config.name));
+        memcpy(_config.name, name.c_str(), name.length() < sizeof(_config.name) ? name.length() : sizeof(_config.name));
+    }
+    return result;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setLatitude(const float degrees)
+{
+    return setValue(_config.latitude, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setLongitude(const float degrees)
+{
+    return setValue(_config.longitude, degrees);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enablePairing(const bool enable)
+{
+    return setValue(_config.pairingEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enableButton(const bool enable)
+{
+    return setValue(_config.buttonEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enableLedFlash(const bool enable)
+{
+    return setValue(_config.ledFlashEnabled, enable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setTimeZoneOffset(const int16_t minutes)
+{
+    return setValue(_config.timeZoneOffset, minutes);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enableDst(const bool enable)
+{
+    return setValue(_config.dstMode, enable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setFobAction(const uint8_t fobActionNr, const uint8_t fobAction)
+{
+    switch(fobActionNr)
+    {
+    case 1:
+        return setValue(_config.fobAction1, fobAction);
+    case 2:
+        return setValue(_config.fobAction2, fobAction);
+    case 3:
+        return setValue(_config.fobAction3, fobAction);
+    default:
+        return Nuki::CmdResult::Failed;
+    }
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setOperatingMode(const uint8_t opMode)
+{
+    return setValue(_config.operatingMode, opMode);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setAdvertisingMode(const Nuki::AdvertisingMode mode)
+{
+    return setValue(_config.advertisingMode, mode);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setTimeZoneId(const Nuki::TimeZoneId timeZoneId)
+{
+    return setValue(_config.timeZoneId, timeZoneId);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setIntercomID(const uint16_t intercomID)
+{
+    return setValue(_advancedConfig.intercomID, intercomID);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setBusModeSwitch(const bool analogueMode)
+{
+    return setValue(_advancedConfig.busModeSwitch, analogueMode);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setShortCircuitDuration(const uint16_t duration)
+{
+    return setValue(_advancedConfig.shortCircuitDuration, duration);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setElectricStrikeDelay(const uint16_t delay)
+{
+    return setValue(_advancedConfig.electricStrikeDelay, delay);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enableRandomElectricStrikeDelay(const bool enable)
+{
+    return setValue(_advancedConfig.randomElectricStrikeDelay, enable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setElectricStrikeDuration(const uint16_t duration)
+{
+    return setValue(_advancedConfig.electricStrikeDuration, duration);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::disableRtoAfterRing(const bool disable)
+{
+    return setValue(_advancedConfig.disableRtoAfterRing, disable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setRtoTimeout(const uint8_t timeout)
+{
+    return setValue(_advancedConfig.rtoTimeout, timeout);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setDoorbellSuppression(const uint8_t suppression)
+{
+    return setValue(_advancedConfig.doorbellSuppression, suppression);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setDoorbellSuppressionDuration(const uint16_t duration)
+{
+    return setValue(_advancedConfig.doorbellSuppressionDuration, duration);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setSoundRing(const uint8_t sound)
+{
+    return setValue(_advancedConfig.soundRing, sound);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setSoundOpen(const uint8_t sound)
+{
+    return setValue(_advancedConfig.soundOpen, sound);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setSoundRto(const uint8_t sound)
+{
+    return setValue(_advancedConfig.soundRto, sound);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setSoundCm(const uint8_t sound)
+{
+    return setValue(_advancedConfig.soundCm, sound);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enableSoundConfirmation(const bool enable)
+{
+    return setValue(_advancedConfig.soundConfirmation, enable);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setSoundLevel(const uint8_t value)
+{
+    return setValue(_advancedConfig.soundLevel, value);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setSingleButtonPressAction(const NukiOpener::ButtonPressAction action)
+{
+    return setValue(_advancedConfig.singleButtonPressAction, action);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setDoubleButtonPressAction(const NukiOpener::ButtonPressAction action)
+{
+    return setValue(_advancedConfig.doubleButtonPressAction, action);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::setBatteryType(const Nuki::BatteryType type)
+{
+    return setValue(_advancedConfig.batteryType, type);
+}
+
+Nuki::CmdResult SimulatedNukiOpener::enableAutoBatteryTypeDetection(const bool enable)
+{
+    return setValue(_advancedConfig.automaticBatteryTypeDetection, enable);
+}
+
+int64_t SimulatedNukiOpener::getLastReceivedBeaconTs() const
+{
+    return _link.lastBeaconTs();
+}
+
+int SimulatedNukiOpener::getRssi()
+{
+    return _link.rssi();
+}
+
+void SimulatedNukiOpener::simulateRing()
+{
+    // the doorbell recognition entry carries the active mode, 1 is ring to open and 2 continuous mode
+    uint8_t mode = 0;
+    if(_openerState.nukiState == NukiOpener::State::ContinuousMode)
+    {
+        mode = 2;
+    }
+    else if(_openerState.lockState == NukiOpener::LockState::RTOactive)
+    {
+        mode = 1;
+    }
+
+    addLogEntry(NukiOpener::LoggingType::DoorbellRecognition, mode, 0);
+
+    if(mode != 0)
+    {
+        _openerState.lockState = NukiOpener::LockState::Open;
+        _openerState.trigger = NukiOpener::Trigger::Manual;
+        notify(Nuki::EventType::KeyTurnerStatusUpdated);
+    }
+}
+
+void SimulatedNukiOpener::simulateBatteryState(const uint8_t criticalBatteryState)
+{
+    _openerState.criticalBatteryState = criticalBatteryState;
+    _batteryReport.criticalBatteryState = criticalBatteryState;
+    notify(Nuki::EventType::KeyTurnerStatusUpdated);
+}
+
+void SimulatedNukiOpener::simulateSecurityPincode(const uint32_t pinCode)
+{
+    _pincode = pinCode;
+}
+
+SimulatedBleLink& SimulatedNukiOpener::link()
+{
+    return _link;
+}
+
+Nuki::CmdResult SimulatedNukiOpener::transact()
+{
+    switch(_link.transact())
+    {
+    case SimulatedBleLink::Outcome::Success:
+        return Nuki::CmdResult::Success;
+    case SimulatedBleLink::Outcome::TimeOut:
+        return Nuki::CmdResult::TimeOut;
+    default:
+        return Nuki::CmdResult::Failed;
+    }
+}
+
+void SimulatedNukiOpener::notify(const Nuki::EventType eventType)
+{
+    if(_eventHandler != nullptr)
+    {
+        _eventHandler->notify(eventType);
+    }
+}
+
+void SimulatedNukiOpener::addLogEntry(const NukiOpener::LoggingType loggingType, const uint8_t data0, const uint8_t data1)
+{
+    NukiOpener::LogEntry entry;
+    memset(&entry, 0, sizeof(entry));
+
+    int64_t seconds = SimulatedClock::millis() / 1000;
+    entry.index = ++_logIndex;
+    entry.timeStampYear = 2024;
+    entry.timeStampMonth = 1;
+    entry.timeStampDay = 1 + (seconds / 86400) % 28;
+    entry.timeStampHour = (seconds / 3600) % 24;
+    entry.timeStampMinute = (seconds / 60) % 60;
+    entry.timeStampSecond = seconds % 60;
+    entry.loggingType = loggingType;
+    entry.data[0] = data0;
+    entry.data[1] = data1;
+    if(loggingType == NukiOpener::LoggingType::LockAction)
+    {
+        entry.data[3] = (uint8_t)NukiOpener::CompletionStatus::Success;
+    }
+    memcpy(entry.name, _deviceName.c_str(), _deviceName.length() < sizeof(entry.name) ? _deviceName.length() : sizeof(entry.name));
+
+    _logEntries.push_back(entry);
+    if(_logEntries.size() > SIM_LOG_SIZE)
+    {
+        _logEntries.pop_front();
+    }
+}
+
+#endif
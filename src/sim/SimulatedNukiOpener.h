@@ -0,0 +1,144 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include "NukiOpener.h"
+#include "NukiOpenerConstants.h"
+#include "NimBLEAddress.h"
+#include "esp_bt.h"
+#include "SimulatedBleLink.h"
+#include "SimulatedEntryList.h"
+
+namespace BleScanner
+{
+class Scanner;
+}
+
+// Stand-in for NukiOpener::NukiOpener on host builds, the opener counterpart of SimulatedNukiLock.
+// Implements every call NukiOpenerWrapper makes.
+class SimulatedNukiOpener
+{
+public:
+    explicit SimulatedNukiOpener(const SimulationProfile& profile = SimulationProfile());
+    SimulatedNukiOpener(const std::string& deviceName, const uint32_t deviceId, const SimulationProfile& profile = SimulationProfile());
+
+    void initialize();
+    void registerBleScanner(BleScanner::Scanner* bleScanner);
+    void setEventHandler(Nuki::SmartlockEventHandler* handler);
+    void setConnectTimeout(const uint8_t timeout);
+    void setDisconnectTimeout(const uint32_t timeoutMs);
+    void setPower(const esp_power_level_t powerLevel);
+    void updateConnectionState();
+
+    Nuki::PairingResult pairNuki(const Nuki::AuthorizationIdType idType = Nuki::AuthorizationIdType::Bridge);
+    bool unPairNuki();
+    bool isPairedWithLock() const;
+    const BLEAddress getBleAddress() const;
+    int64_t getLastReceivedBeaconTs() const;
+    int getRssi();
+
+    uint32_t getSecurityPincode();
+    bool saveSecurityPincode(const uint32_t pinCode);
+    Nuki::CmdResult verifySecurityPin();
+
+    Nuki::CmdResult requestOpenerState(NukiOpener::OpenerState* retrievedOpenerState);
+    Nuki::CmdResult lockAction(const NukiOpener::LockAction lockAction, const uint32_t nukiAppId = 1, const uint8_t flags = 0);
+    Nuki::CmdResult requestBatteryReport(NukiOpener::BatteryReport* retrievedBatteryReport);
+    Nuki::CmdResult requestConfig(NukiOpener::Config* retrievedConfig);
+    Nuki::CmdResult requestAdvancedConfig(NukiOpener::AdvancedConfig* retrievedAdvancedConfig);
+    Nuki::CmdResult requestReboot();
+
+    Nuki::CmdResult retrieveKeypadEntries(const uint16_t offset, const uint16_t count);
+    void getKeypadEntries(std::list<NukiOpener::KeypadEntry>* requestedKeypadCodes);
+    Nuki::CmdResult addKeypadEntry(NukiOpener::NewKeypadEntry newKeypadEntry);
+    Nuki::CmdResult updateKeypadEntry(NukiOpener::UpdatedKeypadEntry updatedKeypadEntry);
+    Nuki::CmdResult deleteKeypadEntry(uint16_t id);
+
+    Nuki::CmdResult retrieveTimeControlEntries();
+    void getTimeControlEntries(std::list<NukiOpener::TimeControlEntry>* timeControlEntries);
+    Nuki::CmdResult addTimeControlEntry(NukiOpener::NewTimeControlEntry newTimeControlEntry);
+    Nuki::CmdResult updateTimeControlEntry(NukiOpener::TimeControlEntry timeControlEntry);
+    Nuki::CmdResult removeTimeControlEntry(uint8_t entryId);
+
+    Nuki::CmdResult retrieveAuthorizationEntries(const uint16_t offset, const uint16_t count);
+    void getAuthorizationEntries(std::list<NukiOpener::AuthorizationEntry>* requestedAuthorizationEntries);
+    Nuki::CmdResult addAuthorizationEntry(NukiOpener::NewAuthorizationEntry newAuthorizationEntry);
+    Nuki::CmdResult updateAuthorizationEntry(NukiOpener::UpdatedAuthorizationEntry updatedAuthorizationEntry);
+    Nuki::CmdResult deleteAuthorizationEntry(uint32_t id);
+
+    Nuki::CmdResult retrieveLogEntries(const uint32_t startIndex, const uint16_t count, const uint8_t sortOrder, bool const totalCount);
+    void getLogEntries(std::list<NukiOpener::LogEntry>* requestedLogEntries);
+
+    Nuki::CmdResult setName(const std::string& name);
+    Nuki::CmdResult setLatitude(const float degrees);
+    Nuki::CmdResult setLongitude(const float degrees);
+    Nuki::CmdResult enablePairing(const bool enable);
+    Nuki::CmdResult enableButton(const bool enable);
+    Nuki::CmdResult enableLedFlash(const bool enable);
+    Nuki::CmdResult setTimeZoneOffset(const int16_t minutes);
+    Nuki::CmdResult enableDst(const bool enable);
+    Nuki::CmdResult setFobAction(const uint8_t fobActionNr, const uint8_t fobAction);
+    Nuki::CmdResult setOperatingMode(const uint8_t opMode);
+    Nuki::CmdResult setAdvertisingMode(const Nuki::AdvertisingMode mode);
+    Nuki::CmdResult setTimeZoneId(const Nuki::TimeZoneId timeZoneId);
+
+    Nuki::CmdResult setIntercomID(const uint16_t intercomID);
+    Nuki::CmdResult setBusModeSwitch(const bool analogueMode);
+    Nuki::CmdResult setShortCircuitDuration(const uint16_t duration);
+    Nuki::CmdResult setElectricStrikeDelay(const uint16_t delay);
+    Nuki::CmdResult enableRandomElectricStrikeDelay(const bool enable);
+    Nuki::CmdResult setElectricStrikeDuration(const uint16_t duration);
+    Nuki::CmdResult disableRtoAfterRing(const bool disable);
+    Nuki::CmdResult setRtoTimeout(const uint8_t timeout);
+    Nuki::CmdResult setDoorbellSuppression(const uint8_t suppression);
+    Nuki::CmdResult setDoorbellSuppressionDuration(const uint16_t duration);
+    Nuki::CmdResult setSoundRing(const uint8_t sound);
+    Nuki::CmdResult setSoundOpen(const uint8_t sound);
+    Nuki::CmdResult setSoundRto(const uint8_t sound);
+    Nuki::CmdResult setSoundCm(const uint8_t sound);
+    Nuki::CmdResult enableSoundConfirmation(const bool enable);
+    Nuki::CmdResult setSoundLevel(const uint8_t value);
+    Nuki::CmdResult setSingleButtonPressAction(const NukiOpener::ButtonPressAction action);
+    Nuki::CmdResult setDoubleButtonPressAction(const NukiOpener::ButtonPressAction action);
+    Nuki::CmdResult setBatteryType(const Nuki::BatteryType type);
+    Nuki::CmdResult enableAutoBatteryTypeDetection(const bool enable);
+
+    // Simulation control, a ring opens the door if ring to open is active
+    void simulateRing();
+    void simulateBatteryState(const uint8_t criticalBatteryState);
+    void simulateSecurityPincode(const uint32_t pinCode);
+    SimulatedBleLink& link();
+
+private:
+    Nuki::CmdResult transact();
+    void notify(const Nuki::EventType eventType);
+    void addLogEntry(const NukiOpener::LoggingType loggingType, const uint8_t data0, const uint8_t data1);
+
+    template<typename T, typename V>
+    Nuki::CmdResult setValue(T& field, const V value)
+    {
+        Nuki::CmdResult result = transact();
+        if(result == Nuki::CmdResult::Success)
+        {
+            field = (T)value;
+        }
+        return result;
+    }
+
+    std::string _deviceName;
+    SimulatedBleLink _link;
+    Nuki::SmartlockEventHandler* _eventHandler = nullptr;
+    bool _paired = false;
+    uint32_t _savedPincode = 0;
+    uint32_t _pincode = 0;
+    NukiOpener::OpenerState _openerState;
+    NukiOpener::BatteryReport _batteryReport;
+    NukiOpener::Config _config;
+    NukiOpener::AdvancedConfig _advancedConfig;
+    SimulatedEntryList<NukiOpener::KeypadEntry, uint16_t> _keypadEntries;
+    SimulatedEntryList<NukiOpener::TimeControlEntry, uint8_t> _timeControlEntries;
+    SimulatedEntryList<NukiOpener::AuthorizationEntry, uint32_t> _authorizationEntries;
+    std::list<NukiOpener::LogEntry> _logEntries;
+    std::list<NukiOpener::LogEntry> _retrievedLogEntries;
+    uint32_t _logIndex = 0;
+};
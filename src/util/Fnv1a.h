@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// 32 bit FNV-1a, used for topic hashes, payload digests and checksums. Data can be hashed in parts
+// by passing the previous result as hash.
+class Fnv1a
+{
+public:
+    static const uint32_t OffsetBasis = 2166136261u;
+    static const uint32_t Prime = 16777619u;
+
+    static uint32_t add(uint32_t hash, uint8_t c)
+    {
+        return (hash ^ c) * Prime;
+    }
+
+    static uint32_t hash(const uint8_t* data, size_t length, uint32_t hash = OffsetBasis)
+    {
+        for(size_t i = 0; i < length; i++)
+        {
+            hash = add(hash, data[i]);
+        }
+        return hash;
+    }
+
+    // Null terminated string, length is set to the string length
+    static uint32_t hash(const char* str, size_t& length)
+    {
+        uint32_t hash = OffsetBasis;
+        length = 0;
+        while(str[length] != 0x00)
+        {
+            hash = add(hash, (uint8_t)str[length]);
+            ++length;
+        }
+        return hash;
+    }
+
+    static uint32_t hash(const char* str)
+    {
+        size_t length;
+        return hash(str, length);
+    }
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "JsonWriter.h"
+
+// Compile time payload schemas for JsonWriter. A schema is a constexpr array of JsonField, one per key
+// in payload order, and writeJsonFields() streams an object's fields straight into the writer.
+// Enum values are written through constexpr JsonName tables, so no name is copied into a temporary buffer.
+
+struct JsonName
+{
+    int32_t value;
+    const char* name;
+};
+
+template<typename T>
+struct JsonField
+{
+    enum class Type : uint8_t
+    {
+        Number,
+        // fixed point number, see JsonWriter::addFixed()
+        Fixed,
+        // name of an enum value, looked up in names
+        Name,
+        // string formatted by text into a small stack buffer
+        Text
+    };
+
+    const char* key;
+    Type type;
+    int64_t (*value)(const T& object);
+    uint8_t decimals;
+    const JsonName* names;
+    size_t nameCount;
+    void (*text)(const T& object, char* buffer, size_t size);
+};
+
+template<typename T, typename M, M T::*Member>
+int64_t jsonMemberValue(const T& object)
+{
+    return (int64_t)(object.*Member);
+}
+
+#define JSON_MEMBER(type, member) &jsonMemberValue<type, decltype(type::member), &type::member>
+#define JSON_NUMBER(type, key, member) { key, JsonField<type>::Type::Number, JSON_MEMBER(type, member), 0, nullptr, 0, nullptr }
+#define JSON_FIXED(type, key, member, decimals) { key, JsonField<type>::Type::Fixed, JSON_MEMBER(type, member), decimals, nullptr, 0, nullptr }
+#define JSON_NAME(type, key, member, names) { key, JsonField<type>::Type::Name, JSON_MEMBER(type, member), 0, names, sizeof(names) / sizeof(names[0]), nullptr }
+#define JSON_TEXT(type, key, format) { key, JsonField<type>::Type::Text, nullptr, 0, nullptr, 0, format }
+
+template<typename T, size_t N>
+void writeJsonFields(JsonWriter& json, const T& object, const JsonField<T> (&fields)[N])
+{
+    char text[48];
+
+    for(size_t i = 0; i < N; i++)
+    {
+        const JsonField<T>& field = fields[i];
+
+        switch(field.type)
+        {
+        case JsonField<T>::Type::Number:
+            json.add(field.key, field.value(object));
+            break;
+        case JsonField<T>::Type::Fixed:
+            json.addFixed(field.key, (int32_t)field.value(object), field.decimals);
+            break;
+        case JsonField<T>::Type::Name:
+        {
+            const char* name = "undefined";
+            int64_t value = field.value(object);
+            for(size_t j = 0; j < field.nameCount; j++)
+            {
+                if(field.names[j].value == value)
+                {
+                    name = field.names[j].name;
+                    break;
+                }
+            }
+            json.add(field.key, name);
+            break;
+        }
+        case JsonField<T>::Type::Text:
+            text[0] = '\0';
+            field.text(object, text, sizeof(text));
+            json.add(field.key, text);
+            break;
+        }
+    }
+}
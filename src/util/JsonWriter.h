@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+// Writes a flat JSON object straight into a caller owned buffer without any heap allocation.
+// Output matches what ArduinoJson serializes for the same values, so payloads built with either are interchangeable.
+// If the buffer is too small the object is truncated and overflowed() returns true.
+class JsonWriter
+{
+public:
+    JsonWriter(char* buffer, size_t size)
+        : _buffer(buffer),
+          _size(size)
+    {
+        append('{');
+    }
+
+    JsonWriter& add(const char* key, const char* value)
+    {
+        writeKey(key);
+        writeString(value);
+        return *this;
+    }
+
+    template<typename T, typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value) && !std::is_same<T, bool>::value, int>::type = 0>
+    JsonWriter& add(const char* key, T value)
+    {
+        char str[24];
+        int length = std::is_signed<typename Underlying<T>::type>::value ? snprintf(str, sizeof(str), "%lld", (long long)value) : snprintf(str, sizeof(str), "%llu", (unsigned long long)value);
+        writeKey(key);
+        append(str, length);
+        return *this;
+    }
+
+    JsonWriter& add(const char* key, bool value)
+    {
+        writeKey(key);
+        append(value ? "true" : "false", value ? 4 : 5);
+        return *this;
+    }
+
+    // Fixed point value, e.g. millivolts with decimals 3, trailing zeros are dropped like ArduinoJson does
+    JsonWriter& addFixed(const char* key, int32_t value, uint8_t decimals)
+    {
+        char str[24];
+        int32_t divisor = 1;
+        for(uint8_t i = 0; i < decimals; i++)
+        {
+            divisor *= 10;
+        }
+        int64_t absolute = value < 0 ? -(int64_t)value : value;
+        int length = snprintf(str, sizeof(str), "%s%lld.%0*lld", value < 0 ? "-" : "", (long long)(absolute / divisor), (int)decimals, (long long)(absolute % divisor));
+        while(length > 0 && str[length - 1] == '0')
+        {
+            --length;
+        }
+        if(length > 0 && str[length - 1] == '.')
+        {
+            --length;
+        }
+        writeKey(key);
+        append(str, length);
+        return *this;
+    }
+
+    // Closes the object and terminates the buffer, returns the payload
+    const char* finish()
+    {
+        if(!_finished)
+        {
+            append('}');
+            _finished = true;
+        }
+        _buffer[_length < _size ? _length : _size - 1] = '\0';
+        return _buffer;
+    }
+
+    size_t length() const
+    {
+        return _length;
+    }
+
+    bool overflowed() const
+    {
+        return _length >= _size;
+    }
+
+private:
+    template<typename T, bool = std::is_enum<T>::value>
+    struct Underlying
+    {
+        typedef T type;
+    };
+
+    template<typename T>
+    struct Underlying<T, true>
+    {
+        typedef typename std::underlying_type<T>::type type;
+    };
+
+    void writeKey(const char* key)
+    {
+        if(_fields++ > 0)
+        {
+            append(',');
+        }
+        writeString(key);
+        append(':');
+    }
+
+    void writeString(const char* value)
+    {
+        append('"');
+        for(const char* c = value; *c != '\0'; c++)
+        {
+            switch(*c)
+            {
+            case '"':
+                append("\\\"", 2);
+                break;
+            case '\\':
+                append("\\\\", 2);
+                break;
+            case '\n':
+                append("\\n", 2);
+                break;
+            case '\r':
+                append("\\r", 2);
+                break;
+            case '\t':
+                append("\\t", 2);
+                break;
+            default:
+                if((uint8_t)*c < 0x20)
+                {
+                    char escaped[7];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)*c);
+                    append(escaped, 6);
+                }
+                else
+                {
+                    append(*c);
+                }
+                break;
+            }
+        }
+        append('"');
+    }
+
+    void append(char c)
+    {
+        if(_length + 1 < _size)
+        {
+            _buffer[_length] = c;
+        }
+        ++_length;
+    }
+
+    void append(const char* str, size_t length)
+    {
+        for(size_t i = 0; i < length; i++)
+        {
+            append(str[i]);
+        }
+    }
+
+    char* _buffer;
+    const size_t _size;
+    size_t _length = 0;
+    size_t _fields = 0;
+    bool _finished = false;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Latency histogram in milliseconds, log-linear like HdrHistogram: values below 8 ms are counted exactly,
+// every power of two range above is split into 8 linear buckets, so a percentile is accurate to within
+// 1/8 of its value at constant memory. Values from 65536 ms on share the last bucket, the maximum is exact.
+class LatencyHistogram
+{
+public:
+    void record(uint32_t ms)
+    {
+        ++_counts[bucketIndex(ms)];
+        ++_count;
+        if(ms > _max)
+        {
+            _max = ms;
+        }
+    }
+
+    uint32_t count() const
+    {
+        return _count;
+    }
+
+    uint32_t max() const
+    {
+        return _max;
+    }
+
+    // Highest value of the bucket the percentile falls in, capped at the maximum
+    uint32_t percentile(uint8_t percent) const
+    {
+        if(_count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t target = ((uint64_t)_count * percent + 99) / 100;
+        uint64_t seen = 0;
+
+        for(size_t i = 0; i < BucketCount; i++)
+        {
+            seen += _counts[i];
+            if(seen >= target && seen > 0)
+            {
+                uint32_t value = bucketHighest(i);
+                return value < _max ? value : _max;
+            }
+        }
+        return _max;
+    }
+
+private:
+    static const uint8_t SubBucketBits = 3;
+    static const uint32_t SubBuckets = 1 << SubBucketBits;
+    static const uint8_t HighestBit = 15;
+    static const size_t BucketCount = (HighestBit - SubBucketBits + 2) * SubBuckets;
+
+    static size_t bucketIndex(uint32_t ms)
+    {
+        if(ms < SubBuckets)
+        {
+            return ms;
+        }
+
+        uint8_t bit = 31 - __builtin_clz(ms);
+        if(bit > HighestBit)
+        {
+            return BucketCount - 1;
+        }
+        return (bit - SubBucketBits + 1) * SubBuckets + ((ms >> (bit - SubBucketBits)) & (SubBuckets - 1));
+    }
+
+    static uint32_t bucketHighest(size_t index)
+    {
+        if(index < SubBuckets)
+        {
+            return index;
+        }
+
+        uint8_t shift = index / SubBuckets - 1;
+        uint32_t lowest = (SubBuckets + index % SubBuckets) << shift;
+        return lowest + (1 << shift) - 1;
+    }
+
+    uint32_t _counts[BucketCount] = {0};
+    uint32_t _count = 0;
+    uint32_t _max = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+// Host stand-in for the NimBLE address class, only keeps the string form
+class NimBLEAddress
+{
+public:
+    NimBLEAddress() = default;
+
+    explicit NimBLEAddress(const std::string& address)
+        : _address(address)
+    { }
+
+    std::string toString() const
+    {
+        return _address;
+    }
+
+private:
+    std::string _address = "00:00:00:00:00:00";
+};
+
+typedef NimBLEAddress BLEAddress;
@@ -0,0 +1,7 @@
+#pragma once
+
+// The nuki_ble library is a submodule that isn't built on the host. These stubs declare the subset
+// of its types and helpers the simulator in src/sim and NukiPayloads use, so both can be built by the native tests.
+// check_nuki_stubs.py compares them with the library before every native build when the submodule is checked out.
+#include "NukiConstants.h"
+#include "NukiLockConstants.h"
@@ -0,0 +1,5 @@
+#pragma once
+
+// See NukiLock.h
+#include "NukiConstants.h"
+#include "NukiOpenerConstants.h"
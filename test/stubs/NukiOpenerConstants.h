@@ -0,0 +1,416 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "NukiConstants.h"
+
+namespace NukiOpener
+{
+using Nuki::PairingResult;
+
+enum class LockState : uint8_t
+{
+    Uncalibrated = 0x00,
+    Locked = 0x01,
+    RTOactive = 0x03,
+    Open = 0x05,
+    Opening = 0x07,
+    Undefined = 0xFF
+};
+
+enum class LockAction : uint8_t
+{
+    ActivateRTO = 0x01,
+    DeactivateRTO = 0x02,
+    ElectricStrikeActuation = 0x03,
+    ActivateCM = 0x04,
+    DeactivateCM = 0x05,
+    FobAction1 = 0x81,
+    FobAction2 = 0x82,
+    FobAction3 = 0x83
+};
+
+enum class ButtonPressAction : uint8_t
+{
+    NoAction = 0x00,
+    ToggleRTO = 0x01,
+    ActivateRTO = 0x02,
+    DeactivateRTO = 0x03,
+    ToggleCM = 0x04,
+    ActivateCM = 0x05,
+    DectivateCM = 0x06,
+    Open = 0x07
+};
+
+enum class Trigger : uint8_t
+{
+    System = 0x00,
+    Manual = 0x01,
+    Button = 0x02,
+    Automatic = 0x03,
+    AutoLock = 0x06,
+    Undefined = 0xFF
+};
+
+enum class CompletionStatus : uint8_t
+{
+    Success = 0x00,
+    Canceled = 0x02,
+    TooRecent = 0x03,
+    Busy = 0x04,
+    OtherError = 0xFE,
+    Unknown = 0xFF
+};
+
+enum class State : uint8_t
+{
+    Uninitialized = 0x00,
+    PairingMode = 0x01,
+    DoorMode = 0x02,
+    ContinuousMode = 0x03,
+    MaintenanceMode = 0x04
+};
+
+enum class LoggingType : uint8_t
+{
+    LoggingEnabled = 0x01,
+    LockAction = 0x02,
+    Calibration = 0x03,
+    InitializationRun = 0x04,
+    KeypadAction = 0x05,
+    DoorbellRecognition = 0x06
+};
+
+struct OpenerState
+{
+    State nukiState;
+    LockState lockState;
+    Trigger trigger;
+    uint16_t currentTimeYear;
+    uint8_t currentTimeMonth;
+    uint8_t currentTimeDay;
+    uint8_t currentTimeHour;
+    uint8_t currentTimeMinute;
+    uint8_t currentTimeSecond;
+    int16_t timeZoneOffset;
+    uint8_t criticalBatteryState;
+    uint8_t ringToOpenTimer;
+    LockAction lastLockAction;
+    Trigger lastLockActionTrigger;
+    CompletionStatus lastLockActionCompletionStatus;
+    uint8_t doorSensorState;
+};
+
+struct BatteryReport
+{
+    uint16_t batteryDrain;
+    uint16_t batteryVoltage;
+    uint8_t criticalBatteryState;
+    LockAction lockAction;
+    uint16_t startVoltage;
+    uint16_t lowestVoltage;
+};
+
+struct Config
+{
+    uint32_t nukiId;
+    uint8_t name[32];
+    float latitude;
+    float longitude;
+    uint8_t capabilities;
+    uint8_t pairingEnabled;
+    uint8_t buttonEnabled;
+    uint8_t ledFlashEnabled;
+    uint16_t currentTimeYear;
+    uint8_t currentTimeMonth;
+    uint8_t currentTimeDay;
+    uint8_t currentTimeHour;
+    uint8_t currentTimeMinute;
+    uint8_t currentTimeSecond;
+    int16_t timeZoneOffset;
+    uint8_t dstMode;
+    uint8_t hasFob;
+    uint8_t fobAction1;
+    uint8_t fobAction2;
+    uint8_t fobAction3;
+    uint8_t operatingMode;
+    Nuki::AdvertisingMode advertisingMode;
+    uint8_t hasKeypad;
+    uint8_t firmwareVersion[3];
+    uint8_t hardwareRevision[2];
+    Nuki::TimeZoneId timeZoneId;
+    uint8_t hasKeypadV2;
+};
+
+struct AdvancedConfig
+{
+    uint16_t intercomID;
+    uint8_t busModeSwitch;
+    uint16_t shortCircuitDuration;
+    uint16_t electricStrikeDelay;
+    uint8_t randomElectricStrikeDelay;
+    uint16_t electricStrikeDuration;
+    uint8_t disableRtoAfterRing;
+    uint8_t rtoTimeout;
+    uint8_t doorbellSuppression;
+    uint16_t doorbellSuppressionDuration;
+    uint8_t soundRing;
+    uint8_t soundOpen;
+    uint8_t soundRto;
+    uint8_t soundCm;
+    uint8_t soundConfirmation;
+    uint8_t soundLevel;
+    ButtonPressAction singleButtonPressAction;
+    ButtonPressAction doubleButtonPressAction;
+    Nuki::BatteryType batteryType;
+    uint8_t automaticBatteryTypeDetection;
+};
+
+struct KeypadEntry
+{
+    uint16_t codeId;
+    uint32_t code;
+    uint8_t name[20];
+    uint8_t enabled;
+    uint16_t dateCreatedYear;
+    uint8_t dateCreatedMonth;
+    uint8_t dateCreatedDay;
+    uint8_t dateCreatedHour;
+    uint8_t dateCreatedMin;
+    uint8_t dateCreatedSec;
+    uint16_t dateLastActiveYear;
+    uint8_t dateLastActiveMonth;
+    uint8_t dateLastActiveDay;
+    uint8_t dateLastActiveHour;
+    uint8_t dateLastActiveMin;
+    uint8_t dateLastActiveSec;
+    uint16_t lockCount;
+    uint8_t timeLimited;
+    uint16_t allowedFromYear;
+    uint8_t allowedFromMonth;
+    uint8_t allowedFromDay;
+    uint8_t allowedFromHour;
+    uint8_t allowedFromMin;
+    uint8_t allowedFromSec;
+    uint16_t allowedUntilYear;
+    uint8_t allowedUntilMonth;
+    uint8_t allowedUntilDay;
+    uint8_t allowedUntilHour;
+    uint8_t allowedUntilMin;
+    uint8_t allowedUntilSec;
+    uint8_t allowedWeekdays;
+    uint8_t allowedFromTimeHour;
+    uint8_t allowedFromTimeMin;
+    uint8_t allowedUntilTimeHour;
+    uint8_t allowedUntilTimeMin;
+};
+
+struct NewKeypadEntry
+{
+    uint32_t code;
+    uint8_t name[20];
+    uint8_t timeLimited;
+    uint16_t allowedFromYear;
+    uint8_t allowedFromMonth;
+    uint8_t allowedFromDay;
+    uint8_t allowedFromHour;
+    uint8_t allowedFromMin;
+    uint8_t allowedFromSec;
+    uint16_t allowedUntilYear;
+    uint8_t allowedUntilMonth;
+    uint8_t allowedUntilDay;
+    uint8_t allowedUntilHour;
+    uint8_t allowedUntilMin;
+    uint8_t allowedUntilSec;
+    uint8_t allowedWeekdays;
+    uint8_t allowedFromTimeHour;
+    uint8_t allowedFromTimeMin;
+    uint8_t allowedUntilTimeHour;
+    uint8_t allowedUntilTimeMin;
+};
+
+struct UpdatedKeypadEntry
+{
+    uint16_t codeId;
+    uint32_t code;
+    uint8_t name[20];
+    uint8_t enabled;
+    uint8_t timeLimited;
+    uint16_t allowedFromYear;
+    uint8_t allowedFromMonth;
+    uint8_t allowedFromDay;
+    uint8_t allowedFromHour;
+    uint8_t allowedFromMin;
+    uint8_t allowedFromSec;
+    uint16_t allowedUntilYear;
+    uint8_t allowedUntilMonth;
+    uint8_t allowedUntilDay;
+    uint8_t allowedUntilHour;
+    uint8_t allowedUntilMin;
+    uint8_t allowedUntilSec;
+    uint8_t allowedWeekdays;
+    uint8_t allowedFromTimeHour;
+    uint8_t allowedFromTimeMin;
+    uint8_t allowedUntilTimeHour;
+    uint8_t allowedUntilTimeMin;
+};
+
+struct TimeControlEntry
+{
+    uint8_t entryId;
+    uint8_t enabled;
+    uint8_t weekdays;
+    uint8_t timeHour;
+    uint8_t timeMin;
+    LockAction lockAction;
+};
+
+struct NewTimeControlEntry
+{
+    uint8_t weekdays;
+    uint8_t timeHour;
+    uint8_t timeMin;
+    LockAction lockAction;
+};
+
+struct AuthorizationEntry
+{
+    uint32_t authId;
+    uint8_t idType;
+    uint8_t name[32];
+    uint8_t enabled;
+    uint8_t remoteAllowed;
+    uint16_t createdYear;
+    uint8_t createdMonth;
+    uint8_t createdDay;
+    uint8_t createdHour;
+    uint8_t createdMinute;
+    uint8_t createdSecond;
+    uint16_t lastActYear;
+    uint8_t lastActMonth;
+    uint8_t lastActDay;
+    uint8_t lastActHour;
+    uint8_t lastActMinute;
+    uint8_t lastActSecond;
+    uint16_t lockCount;
+    uint8_t timeLimited;
+    uint16_t allowedFromYear;
+    uint8_t allowedFromMonth;
+    uint8_t allowedFromDay;
+    uint8_t allowedFromHour;
+    uint8_t allowedFromMinute;
+    uint8_t allowedFromSecond;
+    uint16_t allowedUntilYear;
+    uint8_t allowedUntilMonth;
+    uint8_t allowedUntilDay;
+    uint8_t allowedUntilHour;
+    uint8_t allowedUntilMinute;
+    uint8_t allowedUntilSecond;
+    uint8_t allowedWeekdays;
+    uint8_t allowedFromTimeHour;
+    uint8_t allowedFromTimeMin;
+    uint8_t allowedUntilTimeHour;
+    uint8_t allowedUntilTimeMin;
+};
+
+struct NewAuthorizationEntry
+{
+    uint8_t name[32];
+    uint8_t idType;
+    uint8_t sharedKey[32];
+    uint8_t remoteAllowed;
+    uint8_t timeLimited;
+    uint16_t allowedFromYear;
+    uint8_t allowedFromMonth;
+    uint8_t allowedFromDay;
+    uint8_t allowedFromHour;
+    uint8_t allowedFromMinute;
+    uint8_t allowedFromSecond;
+    uint16_t allowedUntilYear;
+    uint8_t allowedUntilMonth;
+    uint8_t allowedUntilDay;
+    uint8_t allowedUntilHour;
+    uint8_t allowedUntilMinute;
+    uint8_t allowedUntilSecond;
+    uint8_t allowedWeekdays;
+    uint8_t allowedFromTimeHour;
+    uint8_t allowedFromTimeMin;
+    uint8_t allowedUntilTimeHour;
+    uint8_t allowedUntilTimeMin;
+};
+
+struct UpdatedAuthorizationEntry
+{
+    uint32_t authId;
+    uint8_t name[32];
+    uint8_t enabled;
+    uint8_t remoteAllowed;
+    uint8_t timeLimited;
+    uint16_t allowedFromYear;
+    uint8_t allowedFromMonth;
+    uint8_t allowedFromDay;
+    uint8_t allowedFromHour;
+    uint8_t allowedFromMinute;
+    uint8_t allowedFromSecond;
+    uint16_t allowedUntilYear;
+    uint8_t allowedUntilMonth;
+    uint8_t allowedUntilDay;
+    uint8_t allowedUntilHour;
+    uint8_t allowedUntilMinute;
+    uint8_t allowedUntilSecond;
+    uint8_t allowedWeekdays;
+    uint8_t allowedFromTimeHour;
+    uint8_t allowedFromTimeMin;
+    uint8_t allowedUntilTimeHour;
+    uint8_t allowedUntilTimeMin;
+};
+
+struct LogEntry
+{
+    uint32_t index;
+    uint16_t timeStampYear;
+    uint8_t timeStampMonth;
+    uint8_t timeStampDay;
+    uint8_t timeStampHour;
+    uint8_t timeStampMinute;
+    uint8_t timeStampSecond;
+    uint32_t authId;
+    uint8_t name[32];
+    LoggingType loggingType;
+    uint8_t data[5];
+};
+
+inline void lockactionToString(const LockAction action, char* str)
+{
+    switch(action)
+    {
+    case LockAction::ActivateRTO:
+        strcpy(str, "ActivateRTO");
+        break;
+    case LockAction::DeactivateRTO:
+        strcpy(str, "DeactivateRTO");
+        break;
+    case LockAction::ElectricStrikeActuation:
+        strcpy(str, "ElectricStrikeActuation");
+        break;
+    case LockAction::ActivateCM:
+        strcpy(str, "ActivateCM");
+        break;
+    case LockAction::DeactivateCM:
+        strcpy(str, "DeactivateCM");
+        break;
+    case LockAction::FobAction1:
+        strcpy(str, "FobAction1");
+        break;
+    case LockAction::FobAction2:
+        strcpy(str, "FobAction2");
+        break;
+    case LockAction::FobAction3:
+        strcpy(str, "FobAction3");
+        break;
+    default:
+        strcpy(str, "undefined");
+        break;
+    }
+}
+}
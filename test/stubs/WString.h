@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+// Arduino String as far as the host builds use it
+class String
+{
+public:
+    String() = default;
+
+    String(const char* str)
+        : _str(str == nullptr ? "" : str)
+    {
+    }
+
+    const char* c_str() const
+    {
+        return _str.c_str();
+    }
+
+    unsigned int length() const
+    {
+        return _str.length();
+    }
+
+    bool operator==(const String& other) const
+    {
+        return _str == other._str;
+    }
+
+    bool operator!=(const String& other) const
+    {
+        return _str != other._str;
+    }
+
+private:
+    std::string _str;
+};
@@ -0,0 +1,163 @@
+# Checks the host stubs of the nuki_ble library and the simulated devices in src/sim:
+# - every call NukiWrapper and NukiOpenerWrapper make on their device is declared by the simulated device
+# - when the lib/nuki_ble submodule is checked out, every enum value and struct field declared in test/stubs
+#   matches the library and every method of the simulated devices exists in the library with the same arity
+# Runs before the native build (extra_scripts of env:native) and standalone: python3 test/stubs/check_nuki_stubs.py
+import os, re, sys
+
+try:
+    Import("env")
+    ROOT = env.subst("$PROJECT_DIR")
+except NameError:
+    env = None
+    ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+STUBS = os.path.join(ROOT, "test", "stubs")
+LIBRARY = os.path.join(ROOT, "lib", "nuki_ble", "src")
+
+DEVICES = [
+    ("src/NukiWrapper.cpp", "_nukiLock", "src/sim/SimulatedNukiLock.h", "SimulatedNukiLock", "NukiLock"),
+    ("src/NukiOpenerWrapper.cpp", "_nukiOpener", "src/sim/SimulatedNukiOpener.h", "SimulatedNukiOpener", "NukiOpener"),
+]
+
+def read(path):
+    with open(path, "r") as file:
+        text = file.read()
+    text = re.sub(r"/\*.*?\*/", "", text, flags = re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+def headers(directory):
+    result = []
+    for base, dirs, files in os.walk(directory):
+        result += [os.path.join(base, f) for f in files if f.endswith((".h", ".hpp"))]
+    return sorted(result)
+
+def block(text, start):
+    depth = 0
+    for i in range(start, len(text)):
+        if text[i] == "{":
+            depth += 1
+        elif text[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return text[start + 1:i]
+    return text[start + 1:]
+
+def namespace_at(text, position):
+    names = []
+    for match in re.finditer(r"namespace\s+(\w+)\s*{", text[:position]):
+        if match.end() + len(block(text, match.end() - 1)) >= position:
+            names.append(match.group(1))
+    return "::".join(names)
+
+# Types are compared without namespace, the library omits it inside its own namespaces
+def unqualified(declaration):
+    return " ".join(word.split("::")[-1] for word in declaration.split())
+
+def declarations(paths):
+    enums = {}
+    structs = {}
+    for path in paths:
+        text = read(path)
+        for match in re.finditer(r"enum\s+(?:class\s+)?(\w+)\s*(?::\s*[\w:]+\s*)?{", text):
+            name = namespace_at(text, match.start()) + "::" + match.group(1)
+            values = {}
+            value = -1
+            for item in block(text, match.end() - 1).split(","):
+                item = item.strip()
+                if not item:
+                    continue
+                key, _, expression = item.partition("=")
+                value = int(expression.strip(), 0) if expression.strip() else value + 1
+                values[key.strip()] = value
+            enums[name] = values
+        for match in re.finditer(r"struct\s+(\w+)\s*{", text):
+            name = namespace_at(text, match.start()) + "::" + match.group(1)
+            fields = {}
+            for item in block(text, match.end() - 1).split(";"):
+                field = re.match(r"\s*([\w:]+(?:\s+[\w:]+)*?)\s+(\w+)\s*(\[\s*\w+\s*\])?\s*$", item)
+                if field:
+                    fields[field.group(2)] = unqualified(field.group(1)) + (field.group(3) or "").replace(" ", "")
+            structs[name] = fields
+    return enums, structs
+
+def arity(parameters):
+    parameters = parameters.strip()
+    if not parameters or parameters == "void":
+        return (0, 0)
+    items = [p for p in re.split(r",(?![^<]*>)", parameters)]
+    required = len([p for p in items if "=" not in p])
+    return (required, len(items))
+
+def methods(text, className):
+    match = re.search(r"class\s+" + className + r"\b[^;{]*{", text)
+    if not match:
+        return {}
+    # only the public part, up to the first private or protected section
+    body = re.split(r"\b(?:private|protected)\s*:", block(text, match.end() - 1))[0]
+    result = {}
+    for method in re.finditer(r"(\w+)\s*\(([^()]*(?:\([^()]*\)[^()]*)*)\)\s*(?:const\s*)?(?:override\s*)?[;{]", body):
+        result.setdefault(method.group(1), []).append(arity(method.group(2)))
+    return result
+
+def check_wrapper_calls(errors):
+    for wrapper, member, header, className, libraryClass in DEVICES:
+        declared = methods(read(os.path.join(ROOT, header)), className)
+        for call in sorted(set(re.findall(member + r"\.(\w+)\s*\(", read(os.path.join(ROOT, wrapper))))):
+            if call not in declared:
+                errors.append("%s calls %s.%s(), which %s doesn't declare" % (wrapper, member, call, className))
+
+def check_library(errors):
+    libraryHeaders = headers(LIBRARY)
+    libraryEnums, libraryStructs = declarations(libraryHeaders)
+    stubEnums, stubStructs = declarations(headers(STUBS))
+
+    for name, values in stubEnums.items():
+        if name not in libraryEnums:
+            errors.append("enum %s isn't declared by the library" % name)
+            continue
+        for key, value in values.items():
+            if libraryEnums[name].get(key) != value:
+                errors.append("%s::%s is %s in the stub and %s in the library" % (name, key, value, libraryEnums[name].get(key)))
+
+    for name, fields in stubStructs.items():
+        if name not in libraryStructs:
+            errors.append("struct %s isn't declared by the library" % name)
+            continue
+        for field, declaration in fields.items():
+            if libraryStructs[name].get(field) != declaration:
+                errors.append("%s::%s is %s in the stub and %s in the library" % (name, field, declaration, libraryStructs[name].get(field)))
+
+    libraryMethods = {}
+    for path in libraryHeaders:
+        text = read(path)
+        for className in ("NukiBle", "NukiLock", "NukiOpener"):
+            for method, arities in methods(text, className).items():
+                libraryMethods.setdefault(className, {}).setdefault(method, []).extend(arities)
+
+    for wrapper, member, header, className, libraryClass in DEVICES:
+        available = dict(libraryMethods.get("NukiBle", {}))
+        available.update(libraryMethods.get(libraryClass, {}))
+        for method, arities in methods(read(os.path.join(ROOT, header)), className).items():
+            if method == className or method.startswith("simulate") or method == "link":
+                continue
+            if method not in available:
+                errors.append("%s::%s() isn't declared by the library" % (className, method))
+            elif not any(required == libraryRequired for required, _ in arities for libraryRequired, _ in available[method]):
+                errors.append("%s::%s() takes %s arguments, the library %s" % (className, method, arities, available[method]))
+
+def check():
+    errors = []
+    check_wrapper_calls(errors)
+    if os.path.isdir(LIBRARY):
+        check_library(errors)
+    else:
+        print("check_nuki_stubs: lib/nuki_ble isn't checked out, only checking the wrapper calls")
+    for error in errors:
+        print("check_nuki_stubs: " + error)
+    return len(errors) == 0
+
+if env is not None:
+    if not check():
+        env.Exit(1)
+elif __name__ == "__main__":
+    sys.exit(0 if check() else 1)
@@ -0,0 +1,3 @@
+#pragma once
+
+// Host builds have no ESP-IDF configuration, Config.h falls back to its defaults
@@ -0,0 +1,139 @@
+#include <unity.h>
+#include <cstring>
+#include <type_traits>
+#include "ActionLatency.h"
+#include "util/LatencyHistogram.h"
+#include "util/JsonWriter.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const char* const actionNames[] = { "lock", "unlock", "unlatch" };
+
+void test_percentiles()
+{
+    LatencyHistogram histogram;
+    for(uint32_t ms = 1; ms <= 1000; ms++)
+    {
+        histogram.record(ms);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.count());
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.max());
+    // a percentile is the highest value of its bucket, at most 1/8 above the exact value
+    TEST_ASSERT_TRUE(histogram.percentile(50) >= 500 && histogram.percentile(50) <= 500 + 500 / 8);
+    TEST_ASSERT_TRUE(histogram.percentile(90) >= 900 && histogram.percentile(90) <= 900 + 900 / 8);
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.percentile(100));
+    TEST_ASSERT_EQUAL_UINT32(0, LatencyHistogram().percentile(50));
+}
+
+// More samples in one bucket than a 16 bit counter holds must not shift the percentiles
+void test_manySamplesInOneBucket()
+{
+    LatencyHistogram histogram;
+    for(int i = 0; i < 70000; i++)
+    {
+        histogram.record(5);
+    }
+    histogram.record(1000);
+
+    TEST_ASSERT_EQUAL_UINT32(70001, histogram.count());
+    TEST_ASSERT_EQUAL_UINT32(5, histogram.percentile(50));
+    TEST_ASSERT_EQUAL_UINT32(5, histogram.percentile(99));
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.max());
+
+    for(int i = 0; i < 10000; i++)
+    {
+        histogram.record(1000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, histogram.percentile(50));
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.percentile(90));
+}
+
+void test_stages()
+{
+    ActionLatency latency(actionNames, 3, true);
+
+    latency.sent(1, 1000, 1050);
+    latency.completed(true, 1350);
+    TEST_ASSERT_EQUAL_INT(1, latency.statePublished(1400));
+    TEST_ASSERT_EQUAL_INT(-1, latency.statePublished(1500));
+
+    const ActionLatency::Stages& stages = latency.stages(1);
+    TEST_ASSERT_EQUAL_UINT32(50, stages.queue.max());
+    TEST_ASSERT_EQUAL_UINT32(300, stages.ble.max());
+    TEST_ASSERT_EQUAL_UINT32(50, stages.state.max());
+    TEST_ASSERT_EQUAL_UINT32(400, stages.total.max());
+    TEST_ASSERT_EQUAL_UINT32(0, latency.stages(0).total.count());
+}
+
+// A command can be stamped by its producer after the Nuki task read the clock, the negative delta counts as 0
+void test_negativeDeltasClamped()
+{
+    ActionLatency latency(actionNames, 3, true);
+
+    latency.sent(0, 2000, 1990);
+    latency.completed(true, 1980);
+    TEST_ASSERT_EQUAL_INT(0, latency.statePublished(1970));
+
+    const ActionLatency::Stages& stages = latency.stages(0);
+    TEST_ASSERT_EQUAL_UINT32(1, stages.total.count());
+    TEST_ASSERT_EQUAL_UINT32(0, stages.queue.max());
+    TEST_ASSERT_EQUAL_UINT32(0, stages.ble.max());
+    TEST_ASSERT_EQUAL_UINT32(0, stages.state.max());
+    TEST_ASSERT_EQUAL_UINT32(0, stages.total.max());
+}
+
+void test_failedActionNotRecorded()
+{
+    ActionLatency latency(actionNames, 3, true);
+
+    latency.sent(2, 0, 10);
+    latency.completed(false, 500);
+    TEST_ASSERT_EQUAL_INT(-1, latency.statePublished(600));
+    TEST_ASSERT_EQUAL_UINT32(0, latency.stages(2).total.count());
+}
+
+void test_writeJson()
+{
+    ActionLatency latency(actionNames, 3, true);
+    latency.sent(0, 0, 20);
+    latency.completed(true, 320);
+    latency.statePublished(400);
+
+    char buffer[400];
+    JsonWriter json(buffer, sizeof(buffer));
+    latency.writeJson(0, json);
+
+    const char* payload = json.finish();
+    TEST_ASSERT_FALSE(json.overflowed());
+    TEST_ASSERT_NOT_NULL(strstr(payload, "\"count\":1,"));
+    TEST_ASSERT_NOT_NULL(strstr(payload, "\"queueMax\":20"));
+    TEST_ASSERT_NOT_NULL(strstr(payload, "\"totalMax\":400"));
+}
+
+// Without debug information nothing is allocated or recorded
+void test_disabled()
+{
+    static_assert(!std::is_copy_constructible<ActionLatency>::value, "ActionLatency owns its histograms");
+    ActionLatency latency(actionNames, 3, false);
+
+    TEST_ASSERT_FALSE(latency.enabled());
+    latency.sent(0, 0, 20);
+    latency.completed(true, 320);
+    TEST_ASSERT_EQUAL_INT(-1, latency.statePublished(400));
+    TEST_ASSERT_EQUAL_UINT8(3, latency.actionCount());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_manySamplesInOneBucket);
+    RUN_TEST(test_stages);
+    RUN_TEST(test_negativeDeltasClamped);
+    RUN_TEST(test_failedActionNotRecorded);
+    RUN_TEST(test_writeJson);
+    RUN_TEST(test_disabled);
+    return UNITY_END();
+}
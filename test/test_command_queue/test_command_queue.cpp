@@ -0,0 +1,182 @@
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "CommandQueue.h"
+
+enum class Action : uint8_t
+{
+    Unlock,
+    Lock,
+    Unlatch
+};
+
+static bool opposite(Action first, Action second)
+{
+    return (first == Action::Unlock && second == Action::Lock) || (first == Action::Lock && second == Action::Unlock);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_priorityThenFifo()
+{
+    CommandQueue<Action, 8> queue;
+    QueuedCommand<Action> command;
+
+    uint32_t first = queue.push(Action::Lock, CommandSource::Mqtt, CommandPriority::Normal);
+    queue.push(Action::Unlock, CommandSource::Mqtt, CommandPriority::Normal);
+    uint32_t high = queue.push(Action::Unlatch, CommandSource::Gpio, CommandPriority::High);
+
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(high, command.id);
+    TEST_ASSERT_TRUE(command.source == CommandSource::Gpio);
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(first, command.id);
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_TRUE(command.action == Action::Unlock);
+    TEST_ASSERT_FALSE(queue.pop(command));
+}
+
+void test_fullQueueRejects()
+{
+    const size_t capacity = 4;
+    CommandQueue<uint32_t, capacity> queue;
+    QueuedCommand<uint32_t> command;
+
+    for(uint32_t i = 0; i < capacity; i++)
+    {
+        TEST_ASSERT_TRUE(queue.push(i, CommandSource::Mqtt, CommandPriority::Normal) != 0);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, queue.push(100, CommandSource::Mqtt, CommandPriority::Normal));
+    TEST_ASSERT_EQUAL_UINT32(1, queue.rejected());
+
+    // the consumer moves the ring into its pending list, which frees the ring for as many commands again
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(0, command.action);
+    for(uint32_t i = capacity; i < 2 * capacity; i++)
+    {
+        TEST_ASSERT_TRUE(queue.push(i, CommandSource::Mqtt, CommandPriority::Normal) != 0);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, queue.push(101, CommandSource::Mqtt, CommandPriority::Normal));
+    TEST_ASSERT_EQUAL_UINT32(2, queue.rejected());
+
+    // the consumer only takes from the ring what fits its pending list, nothing is evicted to make room
+    TEST_ASSERT_FALSE(queue.empty());
+    TEST_ASSERT_TRUE(queue.push(2 * capacity, CommandSource::Mqtt, CommandPriority::Normal) != 0);
+    TEST_ASSERT_EQUAL_UINT32(0, queue.push(102, CommandSource::Mqtt, CommandPriority::Normal));
+    TEST_ASSERT_EQUAL_UINT32(3, queue.rejected());
+
+    for(uint32_t i = 1; i <= 2 * capacity; i++)
+    {
+        TEST_ASSERT_TRUE(queue.pop(command));
+        TEST_ASSERT_EQUAL_UINT32(i, command.action);
+    }
+    TEST_ASSERT_FALSE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(0, queue.coalesced());
+}
+
+void test_duplicateKeepsHigherPriority()
+{
+    CommandQueue<Action, 8> queue;
+    queue.setCoalescing(COMMAND_COALESCE_DUPLICATES, opposite);
+    QueuedCommand<Action> command;
+
+    queue.push(Action::Lock, CommandSource::Mqtt, CommandPriority::Normal);
+    uint32_t unlock = queue.push(Action::Unlock, CommandSource::Mqtt, CommandPriority::Normal);
+    queue.push(Action::Unlock, CommandSource::Gpio, CommandPriority::High);
+
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_TRUE(command.action == Action::Unlock);
+    TEST_ASSERT_TRUE(command.priority == CommandPriority::High);
+    TEST_ASSERT_EQUAL_UINT32(unlock, command.id);
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_TRUE(command.action == Action::Lock);
+    TEST_ASSERT_FALSE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(1, queue.coalesced());
+
+    // a duplicate of lower priority doesn't downgrade the queued command
+    queue.push(Action::Unlatch, CommandSource::Gpio, CommandPriority::High);
+    queue.push(Action::Unlatch, CommandSource::Mqtt, CommandPriority::Normal);
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_TRUE(command.priority == CommandPriority::High);
+    TEST_ASSERT_FALSE(queue.pop(command));
+}
+
+void test_oppositesCancel()
+{
+    CommandQueue<Action, 8> queue;
+    queue.setCoalescing(COMMAND_COALESCE_OPPOSITES, opposite);
+    QueuedCommand<Action> command;
+
+    queue.push(Action::Unlatch, CommandSource::Mqtt, CommandPriority::Normal);
+    queue.push(Action::Unlock, CommandSource::Mqtt, CommandPriority::Normal);
+    queue.push(Action::Lock, CommandSource::Mqtt, CommandPriority::Normal);
+
+    TEST_ASSERT_TRUE(queue.pop(command));
+    TEST_ASSERT_TRUE(command.action == Action::Unlatch);
+    TEST_ASSERT_FALSE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(2, queue.coalesced());
+}
+
+// Producers push numbered commands while the consumer pops, every command arrives once and in order per producer
+void test_multipleProducers()
+{
+    const uint32_t producers = 4;
+    const uint32_t commandsPerProducer = 20000;
+    CommandQueue<uint32_t, 8> queue;
+    std::atomic<uint32_t> rejected{0};
+
+    std::vector<std::thread> threads;
+    for(uint32_t producer = 0; producer < producers; producer++)
+    {
+        threads.emplace_back([&queue, &rejected, producer, commandsPerProducer]()
+        {
+            for(uint32_t i = 0; i < commandsPerProducer; i++)
+            {
+                while(queue.push(producer << 24 | i, CommandSource::Mqtt, CommandPriority::Normal) == 0)
+                {
+                    rejected.fetch_add(1);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(producers, 0);
+    uint32_t received = 0;
+    QueuedCommand<uint32_t> command;
+    while(received < producers * commandsPerProducer)
+    {
+        if(!queue.pop(command))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t producer = command.action >> 24;
+        TEST_ASSERT_TRUE(producer < producers);
+        TEST_ASSERT_EQUAL_UINT32(next[producer], command.action & 0xFFFFFF);
+        next[producer]++;
+        received++;
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    TEST_ASSERT_FALSE(queue.pop(command));
+    TEST_ASSERT_EQUAL_UINT32(rejected.load(), queue.rejected());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.coalesced());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_priorityThenFifo);
+    RUN_TEST(test_fullQueueRejects);
+    RUN_TEST(test_duplicateKeepsHigherPriority);
+    RUN_TEST(test_oppositesCancel);
+    RUN_TEST(test_multipleProducers);
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "EventJournal.h"
+
+static const uint8_t lock = 0;
+static const uint8_t opener = 1;
+
+static EventJournal::Storage storage;
+
+void setUp()
+{
+    memset(&storage, 0, sizeof(storage));
+}
+
+void tearDown() {}
+
+struct Published
+{
+    uint8_t source;
+    uint32_t sequence;
+    std::string value;
+};
+
+static std::vector<Published> publishAll(EventJournal& journal)
+{
+    std::vector<Published> published;
+    EventJournal::Event event;
+
+    while(journal.peek(event))
+    {
+        published.push_back({ event.source, event.sequence, event.value });
+        journal.published(event.source, event.sequence);
+    }
+    return published;
+}
+
+void test_sequencePerSource()
+{
+    EventJournal journal;
+    journal.begin(&storage);
+
+    journal.record(lock, "lockState", "locked", "", 1);
+    journal.record(opener, "lockState", "online", "", 2);
+    journal.record(lock, "lockState", "unlocked", "", 3);
+    journal.record(opener, "lockState", "rto active", "", 4);
+    journal.record(lock, "lockAction", "lock", "", 5);
+
+    std::vector<Published> published = publishAll(journal);
+
+    TEST_ASSERT_EQUAL_size_t(5, published.size());
+    const uint8_t sources[] = { lock, opener, lock, opener, lock };
+    const uint32_t sequences[] = { 1, 1, 2, 2, 3 };
+    for(size_t i = 0; i < published.size(); i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(sources[i], published[i].source);
+        TEST_ASSERT_EQUAL_UINT32(sequences[i], published[i].sequence);
+    }
+}
+
+void test_replayOnlySource()
+{
+    EventJournal journal;
+    journal.begin(&storage);
+
+    for(int i = 0; i < 4; i++)
+    {
+        journal.record(lock, "lockState", "locked", "", i);
+        journal.record(opener, "lockState", "online", "", i);
+    }
+    publishAll(journal);
+
+    journal.replayAfter(opener, 2);
+    std::vector<Published> published = publishAll(journal);
+
+    TEST_ASSERT_EQUAL_size_t(2, published.size());
+    TEST_ASSERT_EQUAL_UINT8(opener, published[0].source);
+    TEST_ASSERT_EQUAL_UINT32(3, published[0].sequence);
+    TEST_ASSERT_EQUAL_UINT8(opener, published[1].source);
+    TEST_ASSERT_EQUAL_UINT32(4, published[1].sequence);
+
+    // unknown sequence of the lock replays all of its events
+    journal.replayAfter(lock, 100);
+    published = publishAll(journal);
+    TEST_ASSERT_EQUAL_size_t(4, published.size());
+    for(const Published& event : published)
+    {
+        TEST_ASSERT_EQUAL_UINT8(lock, event.source);
+    }
+}
+
+void test_fullRingDropsOldest()
+{
+    EventJournal journal;
+    journal.begin(&storage);
+
+    for(int i = 0; i < EVENT_JOURNAL_SIZE; i++)
+    {
+        journal.record(opener, "lockState", "online", "", i);
+    }
+    journal.record(lock, "lockState", "locked", "", 100);
+    journal.record(lock, "lockState", "unlocked", "", 101);
+
+    std::vector<Published> published = publishAll(journal);
+
+    TEST_ASSERT_EQUAL_size_t(EVENT_JOURNAL_SIZE, published.size());
+    TEST_ASSERT_EQUAL_UINT8(opener, published[0].source);
+    TEST_ASSERT_EQUAL_UINT32(3, published[0].sequence);
+    TEST_ASSERT_EQUAL_UINT8(lock, published[EVENT_JOURNAL_SIZE - 1].source);
+    TEST_ASSERT_EQUAL_UINT32(2, published[EVENT_JOURNAL_SIZE - 1].sequence);
+}
+
+void test_keptAcrossRestart()
+{
+    EventJournal journal;
+    journal.begin(&storage);
+    journal.record(lock, "lockState", "locked", "", 1);
+    journal.record(opener, "lockState", "online", "", 2);
+    journal.record(opener, "lockState", "rto active", "", 3);
+    publishAll(journal);
+    journal.record(lock, "lockState", "unlocked", "", 4);
+
+    EventJournal restarted;
+    restarted.begin(&storage);
+    TEST_ASSERT_EQUAL_UINT32(1, restarted.boot());
+
+    std::vector<Published> published = publishAll(restarted);
+    TEST_ASSERT_EQUAL_size_t(1, published.size());
+    TEST_ASSERT_EQUAL_STRING("unlocked", published[0].value.c_str());
+    TEST_ASSERT_EQUAL_UINT32(2, published[0].sequence);
+
+    restarted.record(opener, "lockState", "online", "", 5);
+    published = publishAll(restarted);
+    TEST_ASSERT_EQUAL_size_t(1, published.size());
+    TEST_ASSERT_EQUAL_UINT32(3, published[0].sequence);
+}
+
+void test_unknownSourceIgnored()
+{
+    EventJournal journal;
+    journal.begin(&storage);
+    journal.record(EVENT_JOURNAL_SOURCES, "lockState", "locked", "", 1);
+
+    EventJournal::Event event;
+    TEST_ASSERT_FALSE(journal.peek(event));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sequencePerSource);
+    RUN_TEST(test_replayOnlySource);
+    RUN_TEST(test_fullRingDropsOldest);
+    RUN_TEST(test_keptAcrossRestart);
+    RUN_TEST(test_unknownSourceIgnored);
+    return UNITY_END();
+}
@@ -0,0 +1,51 @@
+#include <unity.h>
+#include <cstring>
+#include "util/Fnv1a.h"
+#include "MqttPublishCache.h"
+#include "MqttTopicRouter.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Hashes are stored in RTC memory across restarts and must not change
+void test_referenceValues()
+{
+    TEST_ASSERT_EQUAL_UINT32(0x811c9dc5, Fnv1a::hash(""));
+    TEST_ASSERT_EQUAL_UINT32(0xe40c292c, Fnv1a::hash("a"));
+    TEST_ASSERT_EQUAL_UINT32(0xbf9cf968, Fnv1a::hash("foobar"));
+}
+
+void test_hashInParts()
+{
+    const char* str = "nukihub/lock/state";
+    size_t length;
+    uint32_t whole = Fnv1a::hash(str, length);
+
+    TEST_ASSERT_EQUAL_size_t(strlen(str), length);
+    uint32_t parts = Fnv1a::hash((const uint8_t*)str, 7);
+    parts = Fnv1a::hash((const uint8_t*)str + 7, length - 7, parts);
+    TEST_ASSERT_EQUAL_UINT32(whole, parts);
+}
+
+void test_sameHashEverywhere()
+{
+    const char* payload = "{\"lock_state\":\"locked\"}";
+
+    MqttPublishCache::Digest digest;
+    digest.write((const uint8_t*)payload, 5);
+    digest.write((uint8_t)payload[5]);
+    digest.write((const uint8_t*)payload + 6, strlen(payload) - 6);
+
+    TEST_ASSERT_EQUAL_UINT32(Fnv1a::hash(payload), digest.value());
+    TEST_ASSERT_EQUAL_size_t(strlen(payload), digest.length());
+    TEST_ASSERT_EQUAL_UINT32(Fnv1a::hash(payload), MqttTopicRouter::hashTopic(payload));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_referenceValues);
+    RUN_TEST(test_hashInParts);
+    RUN_TEST(test_sameHashEverywhere);
+    return UNITY_END();
+}
@@ -0,0 +1,49 @@
+#include <unity.h>
+#include <cstring>
+#include <ArduinoJson.h>
+#include "util/JsonWriter.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_valuesAndEscapes()
+{
+    char buffer[200];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.add("name", "Front \"door\"\n");
+    json.add("enabled", true);
+    json.add("offset", -120);
+    json.addFixed("voltage", -1500, 3);
+    json.addFixed("zero", 0, 3);
+
+    JsonDocument document;
+    document["name"] = "Front \"door\"\n";
+    document["enabled"] = true;
+    document["offset"] = -120;
+    document["voltage"] = -1.5;
+    document["zero"] = 0;
+    char expected[200];
+    serializeJson(document, expected, sizeof(expected));
+
+    TEST_ASSERT_EQUAL_STRING(expected, json.finish());
+    TEST_ASSERT_FALSE(json.overflowed());
+}
+
+void test_overflow()
+{
+    char buffer[16];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.add("batteryDrain", 1234);
+
+    const char* payload = json.finish();
+    TEST_ASSERT_TRUE(json.overflowed());
+    TEST_ASSERT_EQUAL_size_t(sizeof(buffer) - 1, strlen(payload));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_valuesAndEscapes);
+    RUN_TEST(test_overflow);
+    return UNITY_END();
+}
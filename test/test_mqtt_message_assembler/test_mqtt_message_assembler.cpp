@@ -0,0 +1,153 @@
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include "MqttMessageAssembler.h"
+
+void setUp() {}
+void tearDown() {}
+
+static espMqttClientTypes::MessageProperties properties(uint16_t packetId)
+{
+    espMqttClientTypes::MessageProperties props;
+    props.qos = 1;
+    props.dup = false;
+    props.retain = false;
+    props.packetId = packetId;
+    return props;
+}
+
+// Hands payload to the assembler in chunks of chunkSize like espMqttClient does, returns the result of the last chunk
+static uint8_t* addChunked(MqttMessageAssembler& assembler, uint16_t packetId, const std::string& payload, size_t chunkSize)
+{
+    uint8_t* result = nullptr;
+    for(size_t index = 0; index < payload.size(); index += chunkSize)
+    {
+        size_t len = payload.size() - index < chunkSize ? payload.size() - index : chunkSize;
+        uint8_t* value = assembler.add(properties(packetId), (const uint8_t*)payload.data() + index, len, index, payload.size());
+        if(index + len < payload.size())
+        {
+            TEST_ASSERT_NULL(value);
+        }
+        result = value;
+    }
+    return result;
+}
+
+void test_singleChunk()
+{
+    MqttMessageAssembler assembler(4096);
+    const char* payload = "{\"action\":\"lock\"}";
+
+    uint8_t* value = assembler.add(properties(1), (const uint8_t*)payload, strlen(payload), 0, strlen(payload));
+
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING(payload, (const char*)value);
+    TEST_ASSERT_EQUAL_UINT32(0, assembler.droppedMessages());
+}
+
+void test_reassemblesChunks()
+{
+    MqttMessageAssembler assembler(4096);
+    std::string payload;
+    while(payload.size() < 3000)
+    {
+        payload += "{\"id\":1,\"name\":\"keypad code\",\"code\":123456,\"enabled\":1},";
+    }
+
+    uint8_t* value = addChunked(assembler, 7, payload, 1024);
+
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_size_t(payload.size(), strlen((const char*)value));
+    TEST_ASSERT_EQUAL_STRING(payload.c_str(), (const char*)value);
+
+    // the buffer is reused for the next message
+    std::string next = payload.substr(0, 1500);
+    uint8_t* nextValue = addChunked(assembler, 8, next, 1024);
+    TEST_ASSERT_TRUE(nextValue == value);
+    TEST_ASSERT_EQUAL_STRING(next.c_str(), (const char*)nextValue);
+    TEST_ASSERT_EQUAL_UINT32(0, assembler.droppedMessages());
+}
+
+void test_nullTerminated()
+{
+    MqttMessageAssembler assembler(16);
+    std::string longer(16, 'a');
+    std::string shorter = "bbb";
+
+    TEST_ASSERT_NOT_NULL(addChunked(assembler, 1, longer, 5));
+    uint8_t* value = addChunked(assembler, 2, shorter, 2);
+
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_UINT8(0x00, value[shorter.size()]);
+    TEST_ASSERT_EQUAL_STRING("bbb", (const char*)value);
+
+    // a message of exactly maxSize still has room for the terminator
+    value = addChunked(assembler, 3, longer, 16);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_UINT8(0x00, value[16]);
+}
+
+void test_oversizedMessageDropped()
+{
+    MqttMessageAssembler assembler(4096);
+    std::string atCap(4096, 'x');
+    std::string overCap(4097, 'x');
+
+    TEST_ASSERT_NOT_NULL(addChunked(assembler, 1, atCap, 1024));
+    TEST_ASSERT_EQUAL_UINT32(0, assembler.droppedMessages());
+
+    // every chunk of the oversized message is ignored, the drop is counted once
+    for(size_t index = 0; index < overCap.size(); index += 1024)
+    {
+        size_t len = overCap.size() - index < 1024 ? overCap.size() - index : 1024;
+        TEST_ASSERT_NULL(assembler.add(properties(2), (const uint8_t*)overCap.data() + index, len, index, overCap.size()));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.droppedMessages());
+
+    TEST_ASSERT_NOT_NULL(addChunked(assembler, 3, "ok", 1024));
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.droppedMessages());
+}
+
+void test_interruptedMessageDropped()
+{
+    MqttMessageAssembler assembler(4096);
+    std::string first(2000, 'a');
+    std::string second = "{\"action\":\"unlock\"}";
+
+    TEST_ASSERT_NULL(assembler.add(properties(1), (const uint8_t*)first.data(), 1024, 0, first.size()));
+
+    // a new message starts before the first one completed
+    uint8_t* value = assembler.add(properties(2), (const uint8_t*)second.data(), second.size(), 0, second.size());
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING(second.c_str(), (const char*)value);
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.droppedMessages());
+
+    // the late rest of the first message is ignored
+    TEST_ASSERT_NULL(assembler.add(properties(1), (const uint8_t*)first.data() + 1024, first.size() - 1024, 1024, first.size()));
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.droppedMessages());
+}
+
+void test_outOfOrderChunkDropped()
+{
+    MqttMessageAssembler assembler(4096);
+    std::string payload(3000, 'a');
+
+    TEST_ASSERT_NULL(assembler.add(properties(1), (const uint8_t*)payload.data(), 1000, 0, payload.size()));
+    TEST_ASSERT_NULL(assembler.add(properties(1), (const uint8_t*)payload.data() + 2000, 1000, 2000, payload.size()));
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.droppedMessages());
+
+    TEST_ASSERT_NULL(assembler.add(properties(1), (const uint8_t*)payload.data() + 1000, 1000, 1000, payload.size()));
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.droppedMessages());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_singleChunk);
+    RUN_TEST(test_reassemblesChunks);
+    RUN_TEST(test_nullTerminated);
+    RUN_TEST(test_oversizedMessageDropped);
+    RUN_TEST(test_interruptedMessageDropped);
+    RUN_TEST(test_outOfOrderChunkDropped);
+    return UNITY_END();
+}
@@ -0,0 +1,115 @@
+#include <unity.h>
+#include "MqttPublishCache.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void publish(MqttPublishCache& cache, const char* topic, const char* payload, uint8_t qos)
+{
+    if(cache.changed(topic, payload))
+    {
+        cache.queued(topic, qos);
+    }
+}
+
+void test_unchangedValueSkipped()
+{
+    MqttPublishCache cache;
+    TEST_ASSERT_TRUE(cache.changed("lock/state", "locked"));
+    cache.queued("lock/state", 1);
+    TEST_ASSERT_FALSE(cache.changed("lock/state", "locked"));
+    TEST_ASSERT_TRUE(cache.changed("lock/state", "unlocked"));
+}
+
+void test_discardUndeliveredKeepsDelivered()
+{
+    MqttPublishCache cache;
+    publish(cache, "lock/state", "locked", 1);
+    publish(cache, "lock/info", "info", 0);
+    cache.delivered(cache.revision());
+    publish(cache, "lock/battery", "80", 1);
+
+    cache.discardUndelivered();
+
+    // QoS 1, left the outbox before the disconnect
+    TEST_ASSERT_FALSE(cache.changed("lock/state", "locked"));
+    // QoS 0 may have been dropped
+    TEST_ASSERT_TRUE(cache.changed("lock/info", "info"));
+    // still in the outbox when the connection was lost
+    TEST_ASSERT_TRUE(cache.changed("lock/battery", "80"));
+}
+
+void test_deliveredRevisionReadBeforeQueue()
+{
+    MqttPublishCache cache;
+    uint32_t revision = cache.revision();
+    publish(cache, "lock/state", "locked", 1);
+    cache.delivered(revision);
+
+    cache.discardUndelivered();
+    TEST_ASSERT_TRUE(cache.changed("lock/state", "locked"));
+}
+
+void test_changedValueNotDeliveredUntilQueued()
+{
+    MqttPublishCache cache;
+    publish(cache, "lock/state", "locked", 1);
+    cache.delivered(cache.revision());
+
+    // accepted, but the publish failed and the entry wasn't queued
+    TEST_ASSERT_TRUE(cache.changed("lock/state", "unlocked"));
+    cache.delivered(cache.revision());
+    cache.discardUndelivered();
+    TEST_ASSERT_TRUE(cache.changed("lock/state", "unlocked"));
+}
+
+void test_snapshotOnlyHoldsDelivered()
+{
+    MqttPublishCache cache;
+    publish(cache, "lock/state", "locked", 1);
+    publish(cache, "lock/info", "info", 0);
+    cache.delivered(cache.revision());
+    publish(cache, "lock/battery", "80", 1);
+    publish(cache, "lock/forced", "1", 1);
+    cache.setForced("lock/forced");
+    cache.delivered(cache.revision());
+    publish(cache, "lock/config", "{}", 1);
+
+    MqttPublishCache::Record records[8];
+    TEST_ASSERT_EQUAL(2, cache.snapshot(records, 8));
+
+    MqttPublishCache restored;
+    restored.restore(records, 2);
+    TEST_ASSERT_FALSE(restored.changed("lock/state", "locked"));
+    TEST_ASSERT_FALSE(restored.changed("lock/battery", "80"));
+    TEST_ASSERT_TRUE(restored.changed("lock/info", "info"));
+    TEST_ASSERT_TRUE(restored.changed("lock/config", "{}"));
+}
+
+void test_restoredEntriesSurviveReconnect()
+{
+    MqttPublishCache cache;
+    publish(cache, "lock/state", "locked", 1);
+    cache.delivered(cache.revision());
+    MqttPublishCache::Record records[4];
+    size_t count = cache.snapshot(records, 4);
+
+    MqttPublishCache restored;
+    restored.restore(records, count);
+    uint32_t delivered = restored.deliveredRevision();
+    restored.discardUndelivered();
+    TEST_ASSERT_FALSE(restored.changed("lock/state", "locked"));
+    TEST_ASSERT_EQUAL_UINT32(delivered, restored.deliveredRevision());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unchangedValueSkipped);
+    RUN_TEST(test_discardUndeliveredKeepsDelivered);
+    RUN_TEST(test_deliveredRevisionReadBeforeQueue);
+    RUN_TEST(test_changedValueNotDeliveredUntilQueued);
+    RUN_TEST(test_snapshotOnlyHoldsDelivered);
+    RUN_TEST(test_restoredEntriesSurviveReconnect);
+    return UNITY_END();
+}
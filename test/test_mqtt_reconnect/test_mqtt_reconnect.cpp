@@ -0,0 +1,207 @@
+#include <unity.h>
+#include <cstdint>
+#include <vector>
+#include "MqttReconnectScheduler.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Broker that refuses the first connects and answers the accepted ones after connAckDelay, or never
+struct FakeBroker
+{
+    int refuseConnects = 0;
+    int64_t connAckDelay = 100;
+    bool dropConnAck = false;
+
+    std::vector<int64_t> connectTs;
+    int64_t connAckTs = -1;
+
+    bool connect(int64_t ts)
+    {
+        connectTs.push_back(ts);
+        if(refuseConnects > 0)
+        {
+            --refuseConnects;
+            return false;
+        }
+        connAckTs = dropConnAck ? -1 : ts + connAckDelay;
+        return true;
+    }
+
+    bool connAckReceived(int64_t ts) const
+    {
+        return connAckTs >= 0 && ts >= connAckTs;
+    }
+};
+
+// Same steps as NukiNetwork::reconnect, returns true once connected
+static bool reconnect(MqttReconnectScheduler& scheduler, FakeBroker& broker, int64_t ts, uint32_t random)
+{
+    if(scheduler.state() == MqttReconnectScheduler::State::Idle)
+    {
+        if(!scheduler.attemptDue(ts))
+        {
+            return false;
+        }
+        if(!broker.connect(ts))
+        {
+            scheduler.attemptFailed(ts, random);
+            return false;
+        }
+        scheduler.attemptStarted(ts);
+        return false;
+    }
+
+    if(!broker.connAckReceived(ts))
+    {
+        if(!scheduler.connAckTimedOut(ts))
+        {
+            return false;
+        }
+        broker.connAckTs = -1;
+        scheduler.attemptFailed(ts, random);
+        return false;
+    }
+
+    scheduler.connected();
+    return true;
+}
+
+// Runs the network loop every 10 ms until connected or until ts
+static int64_t runUntilConnected(MqttReconnectScheduler& scheduler, FakeBroker& broker, int64_t ts, int64_t endTs, uint32_t random = 0)
+{
+    for(; ts < endTs; ts += 10)
+    {
+        if(reconnect(scheduler, broker, ts, random))
+        {
+            return ts;
+        }
+    }
+    return -1;
+}
+
+void test_backoffSchedule()
+{
+    MqttReconnectScheduler scheduler;
+    const int64_t expected[] = { 5000, 10000, 20000, 40000, 80000, 120000, 120000, 120000 };
+
+    for(int64_t backoff : expected)
+    {
+        scheduler.attemptFailed(1000, 0);
+        TEST_ASSERT_EQUAL(1000 + backoff, scheduler.nextAttemptTs());
+    }
+    TEST_ASSERT_EQUAL_UINT8(8, scheduler.failedAttempts());
+}
+
+void test_jitterAtMostQuarter()
+{
+    MqttReconnectScheduler scheduler;
+    const int64_t expected[] = { 5000, 10000, 20000, 40000, 80000, 120000, 120000 };
+
+    for(int64_t backoff : expected)
+    {
+        scheduler.attemptFailed(0, UINT32_MAX);
+        TEST_ASSERT_TRUE(scheduler.nextAttemptTs() >= backoff);
+        TEST_ASSERT_TRUE(scheduler.nextAttemptTs() <= backoff + backoff / 4);
+    }
+
+    MqttReconnectScheduler other;
+    for(uint32_t random = 0; random < 5000; random += 7)
+    {
+        other.connected();
+        other.attemptFailed(0, random);
+        TEST_ASSERT_TRUE(other.nextAttemptTs() <= 5000 + 1250);
+    }
+}
+
+void test_refusedConnectsBackOff()
+{
+    MqttReconnectScheduler scheduler;
+    FakeBroker broker;
+    broker.refuseConnects = 3;
+
+    int64_t connectedTs = runUntilConnected(scheduler, broker, 0, 100000);
+
+    TEST_ASSERT_EQUAL_size_t(4, broker.connectTs.size());
+    TEST_ASSERT_EQUAL(0, broker.connectTs[0]);
+    TEST_ASSERT_EQUAL(5000, broker.connectTs[1]);
+    TEST_ASSERT_EQUAL(15000, broker.connectTs[2]);
+    TEST_ASSERT_EQUAL(35000, broker.connectTs[3]);
+    TEST_ASSERT_EQUAL(35100, connectedTs);
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler.failedAttempts());
+}
+
+void test_delayedConnAck()
+{
+    MqttReconnectScheduler scheduler;
+    FakeBroker broker;
+    broker.connAckDelay = 30000;
+
+    int64_t connectedTs = runUntilConnected(scheduler, broker, 0, 100000);
+
+    TEST_ASSERT_EQUAL_size_t(1, broker.connectTs.size());
+    TEST_ASSERT_EQUAL(30000, connectedTs);
+}
+
+void test_droppedConnAckTimesOut()
+{
+    MqttReconnectScheduler scheduler;
+    FakeBroker broker;
+    broker.dropConnAck = true;
+
+    TEST_ASSERT_EQUAL(-1, runUntilConnected(scheduler, broker, 0, 59990));
+    TEST_ASSERT_EQUAL_size_t(1, broker.connectTs.size());
+    TEST_ASSERT_TRUE(scheduler.state() == MqttReconnectScheduler::State::AwaitingConnAck);
+
+    // Timed out at 60 s, next attempt after the first backoff
+    TEST_ASSERT_EQUAL(-1, runUntilConnected(scheduler, broker, 59990, 60010));
+    TEST_ASSERT_TRUE(scheduler.state() == MqttReconnectScheduler::State::Idle);
+    TEST_ASSERT_EQUAL(65000, scheduler.nextAttemptTs());
+
+    broker.dropConnAck = false;
+    int64_t connectedTs = runUntilConnected(scheduler, broker, 60010, 200000);
+
+    TEST_ASSERT_EQUAL_size_t(2, broker.connectTs.size());
+    TEST_ASSERT_EQUAL(65000, broker.connectTs[1]);
+    TEST_ASSERT_EQUAL(65100, connectedTs);
+}
+
+void test_connectResetsBackoff()
+{
+    MqttReconnectScheduler scheduler;
+    for(int i = 0; i < 6; i++)
+    {
+        scheduler.attemptFailed(0, 0);
+    }
+    TEST_ASSERT_EQUAL(120000, scheduler.nextAttemptTs());
+
+    scheduler.attemptStarted(120000);
+    scheduler.connected();
+    TEST_ASSERT_TRUE(scheduler.state() == MqttReconnectScheduler::State::Idle);
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler.failedAttempts());
+
+    scheduler.attemptFailed(200000, 0);
+    TEST_ASSERT_EQUAL(205000, scheduler.nextAttemptTs());
+}
+
+void test_retryInDoesNotCount()
+{
+    MqttReconnectScheduler scheduler;
+    scheduler.retryIn(0, 5000);
+    TEST_ASSERT_FALSE(scheduler.attemptDue(4999));
+    TEST_ASSERT_TRUE(scheduler.attemptDue(5000));
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler.failedAttempts());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_backoffSchedule);
+    RUN_TEST(test_jitterAtMostQuarter);
+    RUN_TEST(test_refusedConnectsBackOff);
+    RUN_TEST(test_delayedConnAck);
+    RUN_TEST(test_droppedConnAckTimesOut);
+    RUN_TEST(test_connectResetsBackoff);
+    RUN_TEST(test_retryInDoesNotCount);
+    return UNITY_END();
+}
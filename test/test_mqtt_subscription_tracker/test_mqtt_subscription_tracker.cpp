@@ -0,0 +1,112 @@
+#include <unity.h>
+#include "MqttSubscriptionTracker.h"
+
+using espMqttClientTypes::SubscribeReturncode;
+
+void setUp() {}
+void tearDown() {}
+
+static const SubscribeReturncode granted[] = { SubscribeReturncode::QOS1, SubscribeReturncode::QOS1, SubscribeReturncode::QOS0 };
+static const SubscribeReturncode oneFailed[] = { SubscribeReturncode::QOS1, SubscribeReturncode::FAIL, SubscribeReturncode::QOS1 };
+
+void test_subscribedOnceAllAcknowledged()
+{
+    MqttSubscriptionTracker tracker;
+    TEST_ASSERT_FALSE(tracker.subscribed(5));
+
+    tracker.started(5);
+    tracker.sent(10);
+    tracker.sent(11);
+    TEST_ASSERT_TRUE(tracker.pending());
+
+    tracker.acknowledged(11, granted, 2);
+    TEST_ASSERT_FALSE(tracker.subscribed(5));
+    tracker.acknowledged(10, granted, 3);
+    TEST_ASSERT_FALSE(tracker.pending());
+    TEST_ASSERT_TRUE(tracker.subscribed(5));
+
+    // a disconnect after all acknowledgements keeps the session subscriptions
+    tracker.disconnected();
+    TEST_ASSERT_TRUE(tracker.subscribed(5));
+
+    // topics added since then aren't part of the session
+    TEST_ASSERT_FALSE(tracker.subscribed(6));
+}
+
+void test_disconnectBeforeSubAck()
+{
+    MqttSubscriptionTracker tracker;
+    tracker.started(5);
+    tracker.sent(10);
+    tracker.sent(11);
+    tracker.acknowledged(10, granted, 3);
+
+    tracker.disconnected();
+    TEST_ASSERT_FALSE(tracker.pending());
+    TEST_ASSERT_FALSE(tracker.subscribed(5));
+
+    // a late acknowledgement of the dropped round doesn't count either
+    tracker.acknowledged(11, granted, 2);
+    TEST_ASSERT_FALSE(tracker.subscribed(5));
+}
+
+void test_failureCode()
+{
+    MqttSubscriptionTracker tracker;
+    tracker.started(3);
+    tracker.sent(20);
+    tracker.acknowledged(20, oneFailed, 3);
+
+    TEST_ASSERT_FALSE(tracker.pending());
+    TEST_ASSERT_FALSE(tracker.subscribed(3));
+}
+
+void test_packetNotQueued()
+{
+    MqttSubscriptionTracker tracker;
+    tracker.started(5);
+    tracker.sent(30);
+    tracker.sent(0);
+    tracker.acknowledged(30, granted, 3);
+
+    TEST_ASSERT_FALSE(tracker.subscribed(5));
+}
+
+void test_unknownPacketIgnored()
+{
+    MqttSubscriptionTracker tracker;
+    tracker.started(3);
+    tracker.sent(40);
+    tracker.acknowledged(41, granted, 3);
+
+    TEST_ASSERT_TRUE(tracker.pending());
+    TEST_ASSERT_FALSE(tracker.subscribed(3));
+}
+
+void test_newRoundResets()
+{
+    MqttSubscriptionTracker tracker;
+    tracker.started(3);
+    tracker.sent(50);
+    tracker.acknowledged(50, granted, 3);
+    TEST_ASSERT_TRUE(tracker.subscribed(3));
+
+    // e.g. the broker lost the session, everything is subscribed again
+    tracker.started(3);
+    TEST_ASSERT_FALSE(tracker.subscribed(3));
+    tracker.sent(51);
+    tracker.acknowledged(51, granted, 3);
+    TEST_ASSERT_TRUE(tracker.subscribed(3));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_subscribedOnceAllAcknowledged);
+    RUN_TEST(test_disconnectBeforeSubAck);
+    RUN_TEST(test_failureCode);
+    RUN_TEST(test_packetNotQueued);
+    RUN_TEST(test_unknownPacketIgnored);
+    RUN_TEST(test_newRoundResets);
+    return UNITY_END();
+}
@@ -0,0 +1,74 @@
+#include <unity.h>
+#include "MqttTelemetryFilter.h"
+#include "MqttTopicPolicy.h"
+#include "MqttTopics.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const char* rssiPath = "nukihub/lock/rssi";
+
+// RSSI is sampled every publish interval, a large change must go out with the next sample
+void test_rssiChangePublishedWithNextSample()
+{
+    MqttTelemetryFilter filter;
+    const MqttTopicPolicy& policy = MqttTopicPolicy::get(mqtt_topic_lock_rssi);
+
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-60", policy, 0));
+    TEST_ASSERT_FALSE(filter.accept(rssiPath, "-61", policy, 60000));
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-80", policy, 120000));
+    TEST_ASSERT_FALSE(filter.accept(rssiPath, "-80", policy, 180000));
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-77", policy, 181000));
+}
+
+void test_deadbandAgainstLastPublished()
+{
+    MqttTelemetryFilter filter;
+    const MqttTopicPolicy& policy = MqttTopicPolicy::get(mqtt_topic_wifi_rssi);
+
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-60", policy, 0));
+    TEST_ASSERT_FALSE(filter.accept(rssiPath, "-62", policy, 1000));
+    TEST_ASSERT_FALSE(filter.accept(rssiPath, "-58", policy, 2000));
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-63", policy, 3000));
+}
+
+void test_failedPublishSentAgain()
+{
+    MqttTelemetryFilter filter;
+    const MqttTopicPolicy& policy = MqttTopicPolicy::get(mqtt_topic_lock_rssi);
+
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-60", policy, 0));
+    filter.invalidate(rssiPath);
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "-60", policy, 1000));
+}
+
+void test_minInterval()
+{
+    MqttTelemetryFilter filter;
+    const MqttTopicPolicy& policy = MqttTopicPolicy::get(mqtt_topic_uptime);
+    const char* path = "nukihub/maintenance/uptime";
+
+    TEST_ASSERT_TRUE(filter.accept(path, "1", policy, 60000));
+    TEST_ASSERT_FALSE(filter.accept(path, "2", policy, 120000));
+    TEST_ASSERT_TRUE(filter.accept(path, "6", policy, 360000));
+}
+
+void test_nonNumericPasses()
+{
+    MqttTelemetryFilter filter;
+    const MqttTopicPolicy& policy = MqttTopicPolicy::get(mqtt_topic_lock_rssi);
+
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "unknown", policy, 0));
+    TEST_ASSERT_TRUE(filter.accept(rssiPath, "unknown", policy, 0));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rssiChangePublishedWithNextSample);
+    RUN_TEST(test_deadbandAgainstLastPublished);
+    RUN_TEST(test_failedPublishSentAgain);
+    RUN_TEST(test_minInterval);
+    RUN_TEST(test_nonNumericPasses);
+    return UNITY_END();
+}
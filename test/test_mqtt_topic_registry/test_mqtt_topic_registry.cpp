@@ -0,0 +1,203 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include "MqttTopicRegistry.h"
+#include "MqttTopicPolicy.h"
+#include "MqttTopics.h"
+
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    void* p = malloc(size == 0 ? 1 : size);
+    if(p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static const char* lockPath = "nukihub/lock";
+
+// Topics NukiNetworkLock::publishKeyTurnerState publishes on a state change
+static const char* keyTurnerTopics[] =
+{
+    mqtt_topic_lock_state, mqtt_topic_lock_trigger, mqtt_topic_lock_last_lock_action, mqtt_topic_lock_completionStatus,
+    mqtt_topic_lock_door_sensor_state, mqtt_topic_battery_critical, mqtt_topic_battery_charging, mqtt_topic_battery_level,
+    mqtt_topic_battery_keypad_critical, mqtt_topic_battery_basic_json, mqtt_topic_lock_json
+};
+static const size_t keyTurnerTopicCount = sizeof(keyTurnerTopics) / sizeof(keyTurnerTopics[0]);
+
+struct Published
+{
+    const char* path;
+    const MqttTopicPolicy* policy;
+};
+
+static size_t bytesCopied = 0;
+
+// Publish path as it was done before the registry, see NukiNetwork::publish(prefix, topic, ...)
+static Published buildPath(char* path, const char* prefix, const char* topic)
+{
+    size_t offset = strlen(prefix);
+    memcpy(path, prefix, offset);
+    if(topic[0] != '/')
+    {
+        path[offset++] = '/';
+    }
+    size_t length = strlen(topic) + 1;
+    memcpy(path + offset, topic, length);
+    bytesCopied += offset + length;
+
+    Published published;
+    published.path = path;
+    published.policy = &MqttTopicPolicy::get(topic);
+    return published;
+}
+
+void test_internReturnsSameId()
+{
+    MqttTopicRegistry registry(lockPath, 8);
+
+    uint16_t id = registry.intern(mqtt_topic_lock_state);
+    TEST_ASSERT_EQUAL_UINT16(id, registry.intern(mqtt_topic_lock_state));
+    TEST_ASSERT_EQUAL_STRING("nukihub/lock/state", registry.path(id));
+    TEST_ASSERT_TRUE(&registry.policy(id) == &MqttTopicPolicy::get(mqtt_topic_lock_state));
+    TEST_ASSERT_EQUAL_size_t(1, registry.size());
+}
+
+void test_fullRegistryReturnsInvalidId()
+{
+    MqttTopicRegistry registry(lockPath, 2);
+
+    TEST_ASSERT_TRUE(registry.intern(keyTurnerTopics[0]) != MqttTopicRegistry::InvalidId);
+    TEST_ASSERT_TRUE(registry.intern(keyTurnerTopics[1]) != MqttTopicRegistry::InvalidId);
+    TEST_ASSERT_EQUAL_UINT16(MqttTopicRegistry::InvalidId, registry.intern(keyTurnerTopics[2]));
+    TEST_ASSERT_EQUAL_size_t(2, registry.size());
+}
+
+void test_publishDoesNotAllocate()
+{
+    MqttTopicRegistry registry(lockPath, 128);
+    uint16_t ids[keyTurnerTopicCount];
+
+    for(size_t i = 0; i < keyTurnerTopicCount; i++)
+    {
+        ids[i] = registry.intern(keyTurnerTopics[i]);
+    }
+
+    size_t before = allocations;
+    size_t length = 0;
+    for(int round = 0; round < 100; round++)
+    {
+        for(size_t i = 0; i < keyTurnerTopicCount; i++)
+        {
+            length += strlen(registry.path(registry.intern(keyTurnerTopics[i])));
+            length += strlen(registry.path(ids[i]));
+        }
+    }
+
+    TEST_ASSERT_TRUE(length > 0);
+    TEST_ASSERT_EQUAL_size_t(before, allocations);
+}
+
+void test_onlyStateTopicsCoalesce()
+{
+    TEST_ASSERT_TRUE(MqttTopicPolicy::get(mqtt_topic_lock_state).coalesce);
+    TEST_ASSERT_TRUE(MqttTopicPolicy::get(mqtt_topic_lock_json).coalesce);
+    TEST_ASSERT_TRUE(MqttTopicPolicy::get(mqtt_topic_config_basic_json).coalesce);
+
+    // every entry of a burst has to reach the broker
+    TEST_ASSERT_FALSE(MqttTopicPolicy::get(mqtt_topic_lock_log_rolling).coalesce);
+    TEST_ASSERT_FALSE(MqttTopicPolicy::get(mqtt_topic_lock_ring).coalesce);
+    TEST_ASSERT_FALSE(MqttTopicPolicy::get(mqtt_topic_lock_binary_ring).coalesce);
+    TEST_ASSERT_FALSE(MqttTopicPolicy::get(mqtt_topic_lock_action_command_result).coalesce);
+    TEST_ASSERT_FALSE(MqttTopicPolicy::get(mqtt_topic_events).coalesce);
+    TEST_ASSERT_FALSE(MqttTopicPolicy::getDefault().coalesce);
+}
+
+template<typename Publish>
+static double nsPerPublish(Publish publish)
+{
+    const int rounds = 100000;
+    size_t sink = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int round = 0; round < rounds; round++)
+    {
+        for(size_t i = 0; i < keyTurnerTopicCount; i++)
+        {
+            Published published = publish(i);
+            sink += published.path[round % 12] + published.policy->qos;
+        }
+    }
+    std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - start;
+
+    TEST_ASSERT_TRUE(sink > 0);
+    return std::chrono::duration<double, std::nano>(duration).count() / (rounds * keyTurnerTopicCount);
+}
+
+void test_keyTurnerStateBenchmark()
+{
+    MqttTopicRegistry registry(lockPath, 128);
+    uint16_t ids[keyTurnerTopicCount];
+
+    for(size_t i = 0; i < keyTurnerTopicCount; i++)
+    {
+        ids[i] = registry.intern(keyTurnerTopics[i]);
+    }
+
+    char path[200];
+    bytesCopied = 0;
+    double built = nsPerPublish([&path](size_t i)
+    {
+        return buildPath(path, lockPath, keyTurnerTopics[i]);
+    });
+    size_t builtBytes = bytesCopied / (100000 * keyTurnerTopicCount);
+
+    double byTopic = nsPerPublish([&registry](size_t i)
+    {
+        uint16_t id = registry.intern(keyTurnerTopics[i]);
+        Published published = { registry.path(id), &registry.policy(id) };
+        return published;
+    });
+
+    double byId = nsPerPublish([&registry, &ids](size_t i)
+    {
+        Published published = { registry.path(ids[i]), &registry.policy(ids[i]) };
+        return published;
+    });
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "publish path: %.0f ns/publish and %u bytes copied building it, %.0f ns/publish by topic lookup, %.0f ns/publish by id, 0 bytes copied",
+             built, (unsigned int)builtBytes, byTopic, byId);
+    TEST_MESSAGE(msg);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_internReturnsSameId);
+    RUN_TEST(test_fullRegistryReturnsInvalidId);
+    RUN_TEST(test_publishDoesNotAllocate);
+    RUN_TEST(test_onlyStateTopicsCoalesce);
+    RUN_TEST(test_keyTurnerStateBenchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include <unity.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "MqttTopicRouter.h"
+#include "MqttTopics.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const char* lockPath = "nukihub/lock";
+static const char* officialPath = "nuki/3A2B1C0D";
+
+static const char* lockTopics[] =
+{
+    mqtt_topic_lock_action, mqtt_topic_lock_log_rolling_last, mqtt_topic_keypad_command_action, mqtt_topic_keypad_command_id,
+    mqtt_topic_keypad_command_name, mqtt_topic_keypad_command_code, mqtt_topic_keypad_command_enabled, mqtt_topic_query_config,
+    mqtt_topic_query_lockstate, mqtt_topic_query_keypad, mqtt_topic_query_battery, mqtt_topic_config_action,
+    mqtt_topic_keypad_json_action, mqtt_topic_timecontrol_action, mqtt_topic_auth_action
+};
+
+static const char* officialTopics[] =
+{
+    mqtt_topic_official_state, mqtt_topic_official_batteryCritical, mqtt_topic_official_batteryChargeState,
+    mqtt_topic_official_batteryCharging, mqtt_topic_official_keypadBatteryCritical, mqtt_topic_official_doorsensorState,
+    mqtt_topic_official_doorsensorBatteryCritical, mqtt_topic_official_connected, mqtt_topic_official_commandResponse,
+    mqtt_topic_official_lockActionEvent
+};
+
+// Dispatch as it was done before the router: every handler builds its prefixed path into a stack buffer and compares
+static void buildPrefixedPath(const char* prefix, const char* path, char* outPath)
+{
+    size_t offset = strlen(prefix);
+    memcpy(outPath, prefix, offset);
+    strcpy(outPath + offset, path);
+}
+
+static bool comparePrefixedPath(const char* prefix, const char* fullPath, const char* subPath)
+{
+    char prefixedPath[500];
+    buildPrefixedPath(prefix, subPath, prefixedPath);
+    return strcmp(fullPath, prefixedPath) == 0;
+}
+
+static const char* legacyDispatch(const char* topic)
+{
+    const char* matched = nullptr;
+
+    for(const char* path : officialTopics)
+    {
+        if(comparePrefixedPath(officialPath, topic, path))
+        {
+            matched = path;
+        }
+    }
+    for(const char* path : lockTopics)
+    {
+        if(comparePrefixedPath(lockPath, topic, path))
+        {
+            matched = path;
+        }
+    }
+    return matched;
+}
+
+static void addRoutes(MqttTopicRouter& router)
+{
+    for(const char* path : lockTopics)
+    {
+        router.add(lockPath, path);
+    }
+    for(const char* path : officialTopics)
+    {
+        router.add(officialPath, path);
+    }
+}
+
+// Mostly official state updates, some commands and queries, and topics of other devices the broker also delivers
+static std::vector<std::string> topicMix()
+{
+    std::vector<std::string> topics;
+
+    for(int i = 0; i < 1000; i++)
+    {
+        switch(i % 10)
+        {
+        case 0:
+        case 1:
+        case 2:
+            topics.push_back(std::string(officialPath) + officialTopics[i % 10]);
+            break;
+        case 3:
+            topics.push_back(std::string(officialPath) + mqtt_topic_official_commandResponse);
+            break;
+        case 4:
+            topics.push_back(std::string(lockPath) + mqtt_topic_lock_action);
+            break;
+        case 5:
+            topics.push_back(std::string(lockPath) + lockTopics[(i / 10) % (sizeof(lockTopics) / sizeof(lockTopics[0]))]);
+            break;
+        case 6:
+            topics.push_back(std::string(lockPath) + mqtt_topic_lock_state);
+            break;
+        case 7:
+            topics.push_back("homeassistant/status");
+            break;
+        default:
+            topics.push_back("nukihub/opener/action");
+            break;
+        }
+    }
+    return topics;
+}
+
+void test_match()
+{
+    MqttTopicRouter router;
+    addRoutes(router);
+
+    TEST_ASSERT_EQUAL_size_t(25, router.size());
+    TEST_ASSERT_TRUE(MqttTopicRouter::equals(router.match("nukihub/lock/action"), mqtt_topic_lock_action));
+    TEST_ASSERT_TRUE(MqttTopicRouter::equals(router.match("nuki/3A2B1C0D/state"), mqtt_topic_official_state));
+    TEST_ASSERT_NULL(router.match("nukihub/lock/actio"));
+    TEST_ASSERT_NULL(router.match("nukihub/lock/action/"));
+    TEST_ASSERT_NULL(router.match(nullptr));
+
+    router.clear();
+    TEST_ASSERT_NULL(router.match("nukihub/lock/action"));
+}
+
+void test_sameAsLegacyDispatch()
+{
+    MqttTopicRouter router;
+    addRoutes(router);
+
+    for(const std::string& topic : topicMix())
+    {
+        const char* expected = legacyDispatch(topic.c_str());
+        const char* matched = router.match(topic.c_str());
+        TEST_ASSERT_TRUE(expected == nullptr ? matched == nullptr : MqttTopicRouter::equals(matched, expected));
+    }
+}
+
+template<typename Dispatch>
+static double nsPerMessage(const std::vector<std::string>& topics, Dispatch dispatch)
+{
+    const int rounds = 200;
+    size_t matched = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int round = 0; round < rounds; round++)
+    {
+        for(const std::string& topic : topics)
+        {
+            if(dispatch(topic.c_str()) != nullptr)
+            {
+                ++matched;
+            }
+        }
+    }
+    std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - start;
+
+    TEST_ASSERT_TRUE(matched > 0);
+    return std::chrono::duration<double, std::nano>(duration).count() / (rounds * topics.size());
+}
+
+void test_dispatchBenchmark()
+{
+    MqttTopicRouter router;
+    addRoutes(router);
+    std::vector<std::string> topics = topicMix();
+
+    double legacy = nsPerMessage(topics, legacyDispatch);
+    double routed = nsPerMessage(topics, [&router](const char* topic)
+    {
+        return router.match(topic);
+    });
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "dispatch: %.0f ns/message with prefixed path compares, %.0f ns/message with the router", legacy, routed);
+    TEST_MESSAGE(msg);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_match);
+    RUN_TEST(test_sameAsLegacyDispatch);
+    RUN_TEST(test_dispatchBenchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,458 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <ArduinoJson.h>
+#include "NukiPayloads.h"
+
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    void* p = malloc(size == 0 ? 1 : size);
+    if(p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+// ArduinoJson allocates through malloc, count those too
+struct CountingAllocator : ArduinoJson::Allocator
+{
+    void* allocate(size_t size) override
+    {
+        ++allocations;
+        return malloc(size);
+    }
+
+    void deallocate(void* p) override
+    {
+        free(p);
+    }
+
+    void* reallocate(void* p, size_t size) override
+    {
+        ++allocations;
+        return realloc(p, size);
+    }
+};
+
+static CountingAllocator allocator;
+
+static NukiLock::BatteryReport lockBatteryReport;
+static NukiLock::Config lockConfig;
+static NukiLock::AdvancedConfig lockAdvancedConfig;
+static NukiOpener::BatteryReport openerBatteryReport;
+static NukiOpener::Config openerConfig;
+static NukiOpener::AdvancedConfig openerAdvancedConfig;
+
+void setUp()
+{
+    memset(&lockBatteryReport, 0, sizeof(lockBatteryReport));
+    lockBatteryReport.batteryDrain = 1234;
+    lockBatteryReport.batteryVoltage = 5210;
+    lockBatteryReport.lockAction = NukiLock::LockAction::Unlock;
+    lockBatteryReport.startVoltage = 5240;
+    lockBatteryReport.lowestVoltage = 4980;
+    lockBatteryReport.lockDistance = 350;
+    lockBatteryReport.startTemperature = -4;
+    lockBatteryReport.maxTurnCurrent = 1200;
+    lockBatteryReport.batteryResistance = 150;
+
+    memset(&lockConfig, 0, sizeof(lockConfig));
+    lockConfig.nukiId = 0x2a7b11c4;
+    memcpy(lockConfig.name, "Front \"door\"", strlen("Front \"door\""));
+    lockConfig.pairingEnabled = 1;
+    lockConfig.buttonEnabled = 1;
+    lockConfig.ledEnabled = 1;
+    lockConfig.ledBrightness = 3;
+    lockConfig.currentTimeYear = 2024;
+    lockConfig.currentTimeMonth = 5;
+    lockConfig.currentTimeDay = 7;
+    lockConfig.currentTimeHour = 9;
+    lockConfig.currentTimeMinute = 3;
+    lockConfig.currentTimeSecond = 59;
+    lockConfig.timeZoneOffset = -60;
+    lockConfig.dstMode = 1;
+    lockConfig.hasFob = 1;
+    lockConfig.fobAction1 = 1;
+    lockConfig.fobAction2 = 3;
+    lockConfig.fobAction3 = 9;
+    lockConfig.advertisingMode = Nuki::AdvertisingMode::Slow;
+    lockConfig.hasKeypadV2 = 1;
+    lockConfig.firmwareVersion[0] = 4;
+    lockConfig.firmwareVersion[1] = 3;
+    lockConfig.firmwareVersion[2] = 12;
+    lockConfig.hardwareRevision[0] = 6;
+    lockConfig.hardwareRevision[1] = 1;
+    lockConfig.homeKitStatus = 3;
+    lockConfig.timeZoneId = Nuki::TimeZoneId::America_Argentina_Buenos_Aires;
+
+    memset(&lockAdvancedConfig, 0, sizeof(lockAdvancedConfig));
+    lockAdvancedConfig.totalDegrees = 1080;
+    lockAdvancedConfig.unlockedPositionOffsetDegrees = -90;
+    lockAdvancedConfig.lockedPositionOffsetDegrees = 45;
+    lockAdvancedConfig.lockNgoTimeout = 20;
+    lockAdvancedConfig.singleButtonPressAction = NukiLock::ButtonPressAction::Intelligent;
+    lockAdvancedConfig.doubleButtonPressAction = NukiLock::ButtonPressAction::LockNgo;
+    lockAdvancedConfig.batteryType = Nuki::BatteryType::Lithium;
+    lockAdvancedConfig.unlatchDuration = 3;
+    lockAdvancedConfig.autoLockTimeOut = 1800;
+    lockAdvancedConfig.nightModeEnabled = 1;
+    lockAdvancedConfig.nightModeStartTime[0] = 22;
+    lockAdvancedConfig.nightModeEndTime[0] = 6;
+    lockAdvancedConfig.nightModeEndTime[1] = 30;
+    lockAdvancedConfig.autoLockEnabled = 1;
+
+    memset(&openerBatteryReport, 0, sizeof(openerBatteryReport));
+    openerBatteryReport.batteryVoltage = 3000;
+    openerBatteryReport.criticalBatteryState = 1;
+    openerBatteryReport.lockAction = NukiOpener::LockAction::ElectricStrikeActuation;
+    openerBatteryReport.startVoltage = 3100;
+    openerBatteryReport.lowestVoltage = 2905;
+
+    memset(&openerConfig, 0, sizeof(openerConfig));
+    openerConfig.nukiId = 0x1f00aa;
+    memcpy(openerConfig.name, "Opener", strlen("Opener"));
+    openerConfig.capabilities = 1;
+    openerConfig.buttonEnabled = 1;
+    openerConfig.currentTimeYear = 2024;
+    openerConfig.currentTimeMonth = 12;
+    openerConfig.currentTimeDay = 31;
+    openerConfig.currentTimeHour = 23;
+    openerConfig.fobAction1 = 7;
+    openerConfig.fobAction2 = 8;
+    openerConfig.fobAction3 = 4;
+    openerConfig.operatingMode = 11;
+    openerConfig.advertisingMode = Nuki::AdvertisingMode::Automatic;
+    openerConfig.firmwareVersion[0] = 1;
+    openerConfig.firmwareVersion[1] = 10;
+    openerConfig.hardwareRevision[0] = 2;
+    openerConfig.timeZoneId = Nuki::TimeZoneId::None;
+
+    memset(&openerAdvancedConfig, 0, sizeof(openerAdvancedConfig));
+    openerAdvancedConfig.intercomID = 305;
+    openerAdvancedConfig.shortCircuitDuration = 500;
+    openerAdvancedConfig.electricStrikeDelay = 100;
+    openerAdvancedConfig.electricStrikeDuration = 3000;
+    openerAdvancedConfig.rtoTimeout = 20;
+    openerAdvancedConfig.doorbellSuppression = 5;
+    openerAdvancedConfig.doorbellSuppressionDuration = 1000;
+    openerAdvancedConfig.soundRing = 1;
+    openerAdvancedConfig.soundOpen = 3;
+    openerAdvancedConfig.soundCm = 6;
+    openerAdvancedConfig.soundLevel = 255;
+    openerAdvancedConfig.singleButtonPressAction = NukiOpener::ButtonPressAction::DectivateCM;
+    openerAdvancedConfig.doubleButtonPressAction = NukiOpener::ButtonPressAction::Open;
+    openerAdvancedConfig.batteryType = Nuki::BatteryType::Accumulators;
+    openerAdvancedConfig.automaticBatteryTypeDetection = 1;
+}
+
+void tearDown() {}
+
+// The payloads as NukiNetworkLock and NukiNetworkOpener built them with JsonDocument, enum names as
+// their ToString helpers returned them for the values set up above.
+
+static size_t lockBatteryReportDocument(char* buffer, size_t size)
+{
+    JsonDocument json(&allocator);
+    json["batteryDrain"] = lockBatteryReport.batteryDrain;
+    json["batteryVoltage"] = (float)lockBatteryReport.batteryVoltage / 1000.0;
+    json["critical"] = lockBatteryReport.criticalBatteryState;
+    json["lockAction"] = "Unlock";
+    json["startVoltage"] = (float)lockBatteryReport.startVoltage / 1000.0;
+    json["lowestVoltage"] = (float)lockBatteryReport.lowestVoltage / 1000.0;
+    json["lockDistance"] = (float)lockBatteryReport.lockDistance / 1000.0;
+    json["startTemperature"] = lockBatteryReport.startTemperature;
+    json["maxTurnCurrent"] = (float)lockBatteryReport.maxTurnCurrent / 1000.0;
+    json["batteryResistance"] = (float)lockBatteryReport.batteryResistance / 1000.0;
+    return serializeJson(json, buffer, size);
+}
+
+static size_t lockConfigDocument(char* buffer, size_t size)
+{
+    const NukiLock::Config& config = lockConfig;
+    JsonDocument json(&allocator);
+    json["nukiID"] = "2a7b11c4";
+    json["name"] = (const char*)config.name;
+    json["autoUnlatch"] = config.autoUnlatch;
+    json["pairingEnabled"] = config.pairingEnabled;
+    json["buttonEnabled"] = config.buttonEnabled;
+    json["ledEnabled"] = config.ledEnabled;
+    json["ledBrightness"] = config.ledBrightness;
+    json["currentTime"] = "2024-05-07 09:03:59";
+    json["timeZoneOffset"] = config.timeZoneOffset;
+    json["dstMode"] = config.dstMode;
+    json["hasFob"] = config.hasFob;
+    json["fobAction1"] = "Unlock";
+    json["fobAction2"] = "Lock n Go";
+    json["fobAction3"] = "undefined";
+    json["singleLock"] = config.singleLock;
+    json["advertisingMode"] = "Slow";
+    json["hasKeypad"] = config.hasKeypad;
+    json["hasKeypadV2"] = config.hasKeypadV2;
+    json["firmwareVersion"] = std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]);
+    json["hardwareRevision"] = std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]);
+    json["homeKitStatus"] = "Enabled & Paired";
+    json["timeZone"] = "America/Argentina/Buenos_Aires";
+    return serializeJson(json, buffer, size);
+}
+
+static size_t lockAdvancedConfigDocument(char* buffer, size_t size)
+{
+    const NukiLock::AdvancedConfig& config = lockAdvancedConfig;
+    JsonDocument json(&allocator);
+    json["totalDegrees"] = config.totalDegrees;
+    json["unlockedPositionOffsetDegrees"] = config.unlockedPositionOffsetDegrees;
+    json["lockedPositionOffsetDegrees"] = config.lockedPositionOffsetDegrees;
+    json["singleLockedPositionOffsetDegrees"] = config.singleLockedPositionOffsetDegrees;
+    json["unlockedToLockedTransitionOffsetDegrees"] = config.unlockedToLockedTransitionOffsetDegrees;
+    json["lockNgoTimeout"] = config.lockNgoTimeout;
+    json["singleButtonPressAction"] = "Intelligent";
+    json["doubleButtonPressAction"] = "Lock n Go";
+    json["detachedCylinder"] = config.detachedCylinder;
+    json["batteryType"] = "Lithium";
+    json["automaticBatteryTypeDetection"] = config.automaticBatteryTypeDetection;
+    json["unlatchDuration"] = config.unlatchDuration;
+    json["autoLockTimeOut"] = config.autoLockTimeOut;
+    json["autoUnLockDisabled"] = config.autoUnLockDisabled;
+    json["nightModeEnabled"] = config.nightModeEnabled;
+    json["nightModeStartTime"] = "22:00";
+    json["nightModeEndTime"] = "06:30";
+    json["nightModeAutoLockEnabled"] = config.nightModeAutoLockEnabled;
+    json["nightModeAutoUnlockDisabled"] = config.nightModeAutoUnlockDisabled;
+    json["nightModeImmediateLockOnStart"] = config.nightModeImmediateLockOnStart;
+    json["autoLockEnabled"] = config.autoLockEnabled;
+    json["immediateAutoLockEnabled"] = config.immediateAutoLockEnabled;
+    json["autoUpdateEnabled"] = config.autoUpdateEnabled;
+    json["rebootNuki"] = 0;
+    return serializeJson(json, buffer, size);
+}
+
+static size_t openerBatteryReportDocument(char* buffer, size_t size)
+{
+    JsonDocument json(&allocator);
+    json["batteryVoltage"] = (float)openerBatteryReport.batteryVoltage / 1000.0;
+    json["critical"] = openerBatteryReport.criticalBatteryState;
+    json["lockAction"] = "ElectricStrikeActuation";
+    json["startVoltage"] = (float)openerBatteryReport.startVoltage / 1000.0;
+    json["lowestVoltage"] = (float)openerBatteryReport.lowestVoltage / 1000.0;
+    return serializeJson(json, buffer, size);
+}
+
+static size_t openerConfigDocument(char* buffer, size_t size)
+{
+    const NukiOpener::Config& config = openerConfig;
+    JsonDocument json(&allocator);
+    json["nukiID"] = "1f00aa";
+    json["name"] = (const char*)config.name;
+    json["capabilities"] = "Both";
+    json["pairingEnabled"] = config.pairingEnabled;
+    json["buttonEnabled"] = config.buttonEnabled;
+    json["ledFlashEnabled"] = config.ledFlashEnabled;
+    json["currentTime"] = "2024-12-31 23:00:00";
+    json["timeZoneOffset"] = config.timeZoneOffset;
+    json["dstMode"] = config.dstMode;
+    json["hasFob"] = config.hasFob;
+    json["fobAction1"] = "Open";
+    json["fobAction2"] = "Ring";
+    json["fobAction3"] = "undefined";
+    json["operatingMode"] = "Urmet BiBus";
+    json["advertisingMode"] = "Automatic";
+    json["hasKeypad"] = config.hasKeypad;
+    json["hasKeypadV2"] = config.hasKeypadV2;
+    json["firmwareVersion"] = std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]);
+    json["hardwareRevision"] = std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]);
+    json["timeZone"] = "None";
+    return serializeJson(json, buffer, size);
+}
+
+static size_t openerAdvancedConfigDocument(char* buffer, size_t size)
+{
+    const NukiOpener::AdvancedConfig& config = openerAdvancedConfig;
+    JsonDocument json(&allocator);
+    json["intercomID"] = config.intercomID;
+    json["busModeSwitch"] = config.busModeSwitch;
+    json["shortCircuitDuration"] = config.shortCircuitDuration;
+    json["electricStrikeDelay"] = config.electricStrikeDelay;
+    json["randomElectricStrikeDelay"] = config.randomElectricStrikeDelay;
+    json["electricStrikeDuration"] = config.electricStrikeDuration;
+    json["disableRtoAfterRing"] = config.disableRtoAfterRing;
+    json["rtoTimeout"] = config.rtoTimeout;
+    json["doorbellSuppression"] = "CM & Ring";
+    json["doorbellSuppressionDuration"] = config.doorbellSuppressionDuration;
+    json["soundRing"] = "Sound 1";
+    json["soundOpen"] = "Sound 3";
+    json["soundRto"] = "No Sound";
+    json["soundCm"] = "undefined";
+    json["soundConfirmation"] = config.soundConfirmation;
+    json["soundLevel"] = config.soundLevel;
+    json["singleButtonPressAction"] = "Deactivate CM";
+    json["doubleButtonPressAction"] = "Open";
+    json["batteryType"] = "Accumulators";
+    json["automaticBatteryTypeDetection"] = config.automaticBatteryTypeDetection;
+    json["rebootNuki"] = 0;
+    return serializeJson(json, buffer, size);
+}
+
+static size_t lockBatteryReportPayload(char* buffer, size_t size)
+{
+    JsonWriter json(buffer, size);
+    NukiPayloads::lockBatteryReport(json, lockBatteryReport);
+    json.finish();
+    return json.length();
+}
+
+static size_t lockConfigPayload(char* buffer, size_t size)
+{
+    JsonWriter json(buffer, size);
+    NukiPayloads::lockConfig(json, lockConfig);
+    json.finish();
+    return json.length();
+}
+
+static size_t lockAdvancedConfigPayload(char* buffer, size_t size)
+{
+    JsonWriter json(buffer, size);
+    NukiPayloads::lockAdvancedConfig(json, lockAdvancedConfig);
+    json.finish();
+    return json.length();
+}
+
+static size_t openerBatteryReportPayload(char* buffer, size_t size)
+{
+    JsonWriter json(buffer, size);
+    NukiPayloads::openerBatteryReport(json, openerBatteryReport);
+    json.finish();
+    return json.length();
+}
+
+static size_t openerConfigPayload(char* buffer, size_t size)
+{
+    JsonWriter json(buffer, size);
+    NukiPayloads::openerConfig(json, openerConfig);
+    json.finish();
+    return json.length();
+}
+
+static size_t openerAdvancedConfigPayload(char* buffer, size_t size)
+{
+    JsonWriter json(buffer, size);
+    NukiPayloads::openerAdvancedConfig(json, openerAdvancedConfig);
+    json.finish();
+    return json.length();
+}
+
+typedef size_t (*Write)(char* buffer, size_t size);
+
+struct Payload
+{
+    const char* name;
+    Write document;
+    Write writer;
+};
+
+static const Payload payloads[] =
+{
+    { "lock battery report", lockBatteryReportDocument, lockBatteryReportPayload },
+    { "lock config", lockConfigDocument, lockConfigPayload },
+    { "lock advanced config", lockAdvancedConfigDocument, lockAdvancedConfigPayload },
+    { "opener battery report", openerBatteryReportDocument, openerBatteryReportPayload },
+    { "opener config", openerConfigDocument, openerConfigPayload },
+    { "opener advanced config", openerAdvancedConfigDocument, openerAdvancedConfigPayload },
+};
+
+void test_sameAsJsonDocument()
+{
+    for(const Payload& payload : payloads)
+    {
+        char expected[1000];
+        char actual[1000];
+        payload.document(expected, sizeof(expected));
+        payload.writer(actual, sizeof(actual));
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, payload.name);
+    }
+}
+
+void test_nameUsesWholeField()
+{
+    memset(lockConfig.name, 'x', sizeof(lockConfig.name));
+    char name[33];
+    NukiPayloads::name(lockConfig, name, sizeof(name));
+    TEST_ASSERT_EQUAL_size_t(32, strlen(name));
+
+    char payload[1000];
+    lockConfigPayload(payload, sizeof(payload));
+    TEST_ASSERT_NOT_NULL(strstr(payload, "\"name\":\"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\","));
+}
+
+void test_payloadsDoNotAllocate()
+{
+    for(const Payload& payload : payloads)
+    {
+        char buffer[1000];
+        size_t before = allocations;
+        payload.writer(buffer, sizeof(buffer));
+        TEST_ASSERT_EQUAL_size_t_MESSAGE(before, allocations, payload.name);
+    }
+}
+
+static double nsPerPayload(Write write, size_t& allocationsPerPayload)
+{
+    const int rounds = 20000;
+    char buffer[1000];
+    size_t length = 0;
+    size_t before = allocations;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int round = 0; round < rounds; round++)
+    {
+        length += write(buffer, sizeof(buffer));
+    }
+    std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - start;
+
+    TEST_ASSERT_TRUE(length > 0);
+    allocationsPerPayload = (allocations - before) / rounds;
+    return std::chrono::duration<double, std::nano>(duration).count() / rounds;
+}
+
+void test_benchmark()
+{
+    for(const Payload& payload : payloads)
+    {
+        size_t documentAllocations;
+        size_t writerAllocations;
+        double document = nsPerPayload(payload.document, documentAllocations);
+        double writer = nsPerPayload(payload.writer, writerAllocations);
+
+        char msg[200];
+        snprintf(msg, sizeof(msg), "%s: %.0f ns/payload and %u allocations with JsonDocument, %.0f ns/payload and %u allocations with NukiPayloads",
+                 payload.name, document, (unsigned int)documentAllocations, writer, (unsigned int)writerAllocations);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL_size_t(0, writerAllocations);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sameAsJsonDocument);
+    RUN_TEST(test_nameUsesWholeField);
+    RUN_TEST(test_payloadsDoNotAllocate);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
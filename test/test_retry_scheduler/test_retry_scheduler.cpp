@@ -0,0 +1,153 @@
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "RetryScheduler.h"
+
+enum class Result
+{
+    Success,
+    Failed
+};
+
+static int watchdogPostponed = 0;
+
+void setUp()
+{
+    SimulatedClock::set(1000);
+    watchdogPostponed = 0;
+}
+
+void tearDown() {}
+
+void test_completesOnceAfterSuccess()
+{
+    RetryScheduler<Result> scheduler(Result::Success, []() { watchdogPostponed++; });
+    int attempts = 0;
+    std::vector<Result> completions;
+
+    scheduler.add("keypad", 3, [&attempts]()
+    {
+        attempts++;
+        return Result::Success;
+    },
+    [&completions](Result result)
+    {
+        completions.push_back(result);
+    });
+
+    TEST_ASSERT_TRUE(scheduler.pending("keypad"));
+    TEST_ASSERT_FALSE(scheduler.pending("auth"));
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_FALSE(scheduler.run(SimulatedClock::millis()));
+
+    TEST_ASSERT_EQUAL_INT(1, attempts);
+    TEST_ASSERT_EQUAL_size_t(1, completions.size());
+    TEST_ASSERT_TRUE(completions[0] == Result::Success);
+    TEST_ASSERT_EQUAL_INT(1, watchdogPostponed);
+    TEST_ASSERT_FALSE(scheduler.pending("keypad"));
+}
+
+void test_retriesAfterDelayWithoutBlocking()
+{
+    RetryScheduler<Result> scheduler(Result::Success, []() { watchdogPostponed++; });
+    scheduler.setRetryDelay(200);
+    int attempts = 0;
+    int completions = 0;
+    Result last = Result::Success;
+
+    scheduler.add("authCommand", 3, [&attempts]()
+    {
+        attempts++;
+        return Result::Failed;
+    },
+    [&completions, &last](Result result)
+    {
+        completions++;
+        last = result;
+    });
+
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_EQUAL_INT(1, attempts);
+
+    // the retry isn't due yet, run() returns instead of waiting for it
+    SimulatedClock::advance(199);
+    TEST_ASSERT_FALSE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_EQUAL_INT(1, attempts);
+
+    SimulatedClock::advance(1);
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    SimulatedClock::advance(200);
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    SimulatedClock::advance(200);
+    TEST_ASSERT_FALSE(scheduler.run(SimulatedClock::millis()));
+
+    TEST_ASSERT_EQUAL_INT(3, attempts);
+    TEST_ASSERT_EQUAL_INT(1, completions);
+    TEST_ASSERT_TRUE(last == Result::Failed);
+    TEST_ASSERT_EQUAL_INT(3, watchdogPostponed);
+    TEST_ASSERT_EQUAL_size_t(0, scheduler.size());
+}
+
+void test_waitingJobDoesNotHoldBackOthers()
+{
+    RetryScheduler<Result> scheduler(Result::Success, []() { watchdogPostponed++; });
+    scheduler.setRetryDelay(500);
+    std::string order;
+
+    scheduler.add("keypadCommand", 2, [&order]()
+    {
+        order += "k";
+        return Result::Failed;
+    });
+    scheduler.add("timecontrol", 1, [&order]()
+    {
+        order += "t";
+        return Result::Success;
+    });
+
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_FALSE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_EQUAL_STRING("kt", order.c_str());
+
+    SimulatedClock::advance(500);
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_EQUAL_STRING("ktk", order.c_str());
+    TEST_ASSERT_EQUAL_size_t(0, scheduler.size());
+}
+
+void test_completionCanAddJob()
+{
+    RetryScheduler<Result> scheduler(Result::Success, []() { watchdogPostponed++; });
+    int refreshes = 0;
+
+    // like a keypad command that queries the codes again once it completed
+    scheduler.add("keypadCommand", 1, []()
+    {
+        return Result::Success;
+    },
+    [&scheduler, &refreshes](Result result)
+    {
+        scheduler.add("keypad", 1, [&refreshes]()
+        {
+            refreshes++;
+            return Result::Success;
+        });
+    });
+
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_TRUE(scheduler.pending("keypad"));
+    TEST_ASSERT_TRUE(scheduler.run(SimulatedClock::millis()));
+    TEST_ASSERT_EQUAL_INT(1, refreshes);
+    TEST_ASSERT_EQUAL_size_t(0, scheduler.size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_completesOnceAfterSuccess);
+    RUN_TEST(test_retriesAfterDelayWithoutBlocking);
+    RUN_TEST(test_waitingJobDoesNotHoldBackOthers);
+    RUN_TEST(test_completionCanAddJob);
+    return UNITY_END();
+}
@@ -0,0 +1,222 @@
+#include <type_traits>
+#include <unity.h>
+#include "EspMillis.h"
+#include "sim/SimulatedClock.h"
+#include "NukiDevice.h"
+#include "sim/Preferences.h"
+
+void setUp()
+{
+    SimulatedClock::set(0);
+}
+
+void tearDown() {}
+
+void test_lockActionAndStateRead()
+{
+    SimulatedNukiLock lock;
+    NukiLock::KeyTurnerState state;
+
+    TEST_ASSERT_TRUE(lock.requestKeyTurnerState(&state) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(state.lockState == NukiLock::LockState::Locked);
+
+    int64_t sentTs = espMillis();
+    TEST_ASSERT_TRUE(lock.lockAction(NukiLock::LockAction::Unlock) == Nuki::CmdResult::Success);
+    int64_t roundTrip = espMillis() - sentTs;
+    TEST_ASSERT_TRUE(roundTrip >= 150);
+    TEST_ASSERT_TRUE(roundTrip <= 600);
+
+    TEST_ASSERT_TRUE(lock.requestKeyTurnerState(&state) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(state.lockState == NukiLock::LockState::Unlocked);
+    TEST_ASSERT_TRUE(state.lastLockAction == NukiLock::LockAction::Unlock);
+    TEST_ASSERT_EQUAL_UINT32(3, lock.link().commands());
+}
+
+void test_failedLockActionKeepsState()
+{
+    SimulationProfile profile;
+    profile.failureRate = 100;
+    SimulatedNukiLock lock(profile);
+
+    TEST_ASSERT_TRUE(lock.lockAction(NukiLock::LockAction::Unlock) == Nuki::CmdResult::Failed);
+
+    lock.link().setProfile(SimulationProfile());
+    NukiLock::KeyTurnerState state;
+    TEST_ASSERT_TRUE(lock.requestKeyTurnerState(&state) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(state.lockState == NukiLock::LockState::Locked);
+}
+
+void test_timeoutCostsTimeout()
+{
+    SimulationProfile profile;
+    profile.timeoutRate = 100;
+    SimulatedNukiLock lock(profile);
+
+    NukiLock::KeyTurnerState state;
+    TEST_ASSERT_TRUE(lock.requestKeyTurnerState(&state) == Nuki::CmdResult::TimeOut);
+    TEST_ASSERT_EQUAL(profile.timeout, espMillis());
+}
+
+void test_openerActionAndStateRead()
+{
+    SimulatedNukiOpener opener;
+    NukiOpener::OpenerState state;
+
+    TEST_ASSERT_TRUE(opener.lockAction(NukiOpener::LockAction::ActivateRTO) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(opener.requestOpenerState(&state) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(state.lockState == NukiOpener::LockState::RTOactive);
+}
+
+class EventCounter : public Nuki::SmartlockEventHandler
+{
+public:
+    void notify(Nuki::EventType eventType) override
+    {
+        if(eventType == Nuki::EventType::KeyTurnerStatusUpdated)
+        {
+            updates++;
+        }
+    }
+
+    int updates = 0;
+};
+
+void test_wrappersUseSimulatedDevices()
+{
+    TEST_ASSERT_TRUE((std::is_same<NukiLockDevice, SimulatedNukiLock>::value));
+    TEST_ASSERT_TRUE((std::is_same<NukiOpenerDevice, SimulatedNukiOpener>::value));
+}
+
+void test_pairingAddsAuthorization()
+{
+    NukiLockDevice lock("NukiHub", 0x2020002);
+    EventCounter events;
+    lock.setEventHandler(&events);
+
+    TEST_ASSERT_TRUE(lock.pairNuki(Nuki::AuthorizationIdType::Bridge) == Nuki::PairingResult::Success);
+    TEST_ASSERT_TRUE(lock.isPairedWithLock());
+
+    std::list<NukiLock::AuthorizationEntry> entries;
+    TEST_ASSERT_TRUE(lock.retrieveAuthorizationEntries(0, 10) == Nuki::CmdResult::Success);
+    lock.getAuthorizationEntries(&entries);
+    TEST_ASSERT_EQUAL_size_t(1, entries.size());
+    TEST_ASSERT_EQUAL_STRING("NukiHub", (const char*)entries.front().name);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)Nuki::AuthorizationIdType::Bridge, entries.front().idType);
+
+    NukiLock::UpdatedAuthorizationEntry update;
+    memset(&update, 0, sizeof(update));
+    update.authId = entries.front().authId;
+    memcpy(update.name, "Renamed", 7);
+    TEST_ASSERT_TRUE(lock.updateAuthorizationEntry(update) == Nuki::CmdResult::Success);
+    update.authId = 99;
+    TEST_ASSERT_TRUE(lock.updateAuthorizationEntry(update) == Nuki::CmdResult::Failed);
+
+    lock.retrieveAuthorizationEntries(0, 10);
+    lock.getAuthorizationEntries(&entries);
+    TEST_ASSERT_EQUAL_STRING("Renamed", (const char*)entries.front().name);
+    TEST_ASSERT_EQUAL_UINT8(0, entries.front().enabled);
+
+    TEST_ASSERT_TRUE(lock.lockAction(NukiLock::LockAction::Unlock) == Nuki::CmdResult::Success);
+    lock.simulateLockState(NukiLock::LockState::Locked, NukiLock::Trigger::Manual);
+    TEST_ASSERT_EQUAL_INT(2, events.updates);
+}
+
+void test_keypadAndTimeControlEntries()
+{
+    NukiLockDevice lock("NukiHub", 1);
+
+    NukiLock::NewKeypadEntry newCode;
+    memset(&newCode, 0, sizeof(newCode));
+    newCode.code = 123456;
+    memcpy(newCode.name, "Door", 4);
+    TEST_ASSERT_TRUE(lock.addKeypadEntry(newCode) == Nuki::CmdResult::Success);
+
+    std::list<NukiLock::KeypadEntry> codes;
+    lock.retrieveKeypadEntries(0, 10);
+    lock.getKeypadEntries(&codes);
+    TEST_ASSERT_EQUAL_size_t(1, codes.size());
+
+    NukiLock::UpdatedKeypadEntry updatedCode;
+    memset(&updatedCode, 0, sizeof(updatedCode));
+    updatedCode.codeId = codes.front().codeId;
+    updatedCode.code = 654321;
+    updatedCode.enabled = 1;
+    memcpy(updatedCode.name, "Door", 4);
+    TEST_ASSERT_TRUE(lock.updateKeypadEntry(updatedCode) == Nuki::CmdResult::Success);
+    lock.retrieveKeypadEntries(0, 10);
+    lock.getKeypadEntries(&codes);
+    TEST_ASSERT_EQUAL_UINT32(654321, codes.front().code);
+
+    NukiLock::NewTimeControlEntry newEntry;
+    memset(&newEntry, 0, sizeof(newEntry));
+    newEntry.weekdays = 0x7f;
+    newEntry.timeHour = 22;
+    newEntry.lockAction = NukiLock::LockAction::Lock;
+    TEST_ASSERT_TRUE(lock.addTimeControlEntry(newEntry) == Nuki::CmdResult::Success);
+
+    std::list<NukiLock::TimeControlEntry> entries;
+    TEST_ASSERT_TRUE(lock.retrieveTimeControlEntries() == Nuki::CmdResult::Success);
+    lock.getTimeControlEntries(&entries);
+    TEST_ASSERT_EQUAL_size_t(1, entries.size());
+    TEST_ASSERT_EQUAL_UINT8(1, entries.front().enabled);
+
+    NukiLock::TimeControlEntry entry = entries.front();
+    entry.timeHour = 23;
+    TEST_ASSERT_TRUE(lock.updateTimeControlEntry(entry) == Nuki::CmdResult::Success);
+    lock.retrieveTimeControlEntries();
+    lock.getTimeControlEntries(&entries);
+    TEST_ASSERT_EQUAL_UINT8(23, entries.front().timeHour);
+
+    TEST_ASSERT_TRUE(lock.removeTimeControlEntry(entry.entryId) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(lock.removeTimeControlEntry(entry.entryId) == Nuki::CmdResult::Failed);
+}
+
+void test_configSettersAndSecurityPin()
+{
+    NukiOpenerDevice opener("NukiHub", 1);
+
+    TEST_ASSERT_TRUE(opener.setIntercomID(42) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(opener.setSoundRing(3) == Nuki::CmdResult::Success);
+    TEST_ASSERT_TRUE(opener.setFobAction(4, 1) == Nuki::CmdResult::Failed);
+
+    NukiOpener::AdvancedConfig config;
+    TEST_ASSERT_TRUE(opener.requestAdvancedConfig(&config) == Nuki::CmdResult::Success);
+    TEST_ASSERT_EQUAL_UINT16(42, config.intercomID);
+    TEST_ASSERT_EQUAL_UINT8(3, config.soundRing);
+
+    opener.simulateSecurityPincode(1234);
+    opener.saveSecurityPincode(4321);
+    TEST_ASSERT_TRUE(opener.verifySecurityPin() == Nuki::CmdResult::Failed);
+    opener.saveSecurityPincode(1234);
+    TEST_ASSERT_TRUE(opener.verifySecurityPin() == Nuki::CmdResult::Success);
+}
+
+void test_preferencesSharedPerNamespace()
+{
+    Preferences writer;
+    Preferences reader;
+    writer.begin("nukihub");
+    reader.begin("nukihub", true);
+
+    writer.putInt("rssipb", 60);
+    writer.putString("mqttpath", "nukihub");
+
+    TEST_ASSERT_EQUAL_INT(60, reader.getInt("rssipb"));
+    TEST_ASSERT_EQUAL_STRING("nukihub", reader.getString("mqttpath").c_str());
+    TEST_ASSERT_EQUAL_size_t(0, reader.putInt("rssipb", 30));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_lockActionAndStateRead);
+    RUN_TEST(test_failedLockActionKeepsState);
+    RUN_TEST(test_timeoutCostsTimeout);
+    RUN_TEST(test_openerActionAndStateRead);
+    RUN_TEST(test_wrappersUseSimulatedDevices);
+    RUN_TEST(test_pairingAddsAuthorization);
+    RUN_TEST(test_keypadAndTimeControlEntries);
+    RUN_TEST(test_configSettersAndSecurityPin);
+    RUN_TEST(test_preferencesSharedPerNamespace);
+    return UNITY_END();
+}